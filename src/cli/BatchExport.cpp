@@ -0,0 +1,320 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#include "BatchExport.h"
+
+#include <core/Basics/Playlist.h>
+#include <core/Object.h>
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QProcess>
+#include <QThread>
+
+#include <algorithm>
+#include <iostream>
+
+using namespace H2Core;
+
+BatchExport::BatchExport( const QString& sExecutable )
+	: m_sExecutable( sExecutable )
+	, m_nWorkers( 0 )
+	, m_nTotalTimeMs( 0 )
+{
+}
+
+bool BatchExport::loadManifest( const QString& sManifestPath )
+{
+	QFile file( sManifestPath );
+	if ( ! file.open( QIODevice::ReadOnly ) ) {
+		___ERRORLOG( QString( "Unable to open manifest [%1]: %2" )
+					 .arg( sManifestPath ).arg( file.errorString() ) );
+		return false;
+	}
+
+	QJsonParseError error;
+	const QJsonDocument doc = QJsonDocument::fromJson( file.readAll(), &error );
+	if ( doc.isNull() || ! doc.isObject() ) {
+		___ERRORLOG( QString( "Unable to parse manifest [%1]: %2" )
+					 .arg( sManifestPath ).arg( error.errorString() ) );
+		return false;
+	}
+
+	const QJsonObject root = doc.object();
+	const QString sBaseDir = QFileInfo( sManifestPath ).absolutePath();
+
+	m_jobs.clear();
+	for ( const auto& eentry : root.value( "jobs" ).toArray() ) {
+		if ( ! eentry.isObject() ) {
+			___ERRORLOG( QString( "Invalid job in manifest [%1]" )
+						 .arg( sManifestPath ) );
+			return false;
+		}
+		if ( ! addJobs( eentry.toObject(), root, sBaseDir ) ) {
+			return false;
+		}
+	}
+
+	if ( m_jobs.empty() ) {
+		___ERRORLOG( QString( "No jobs found in manifest [%1]" )
+					 .arg( sManifestPath ) );
+		return false;
+	}
+
+	return true;
+}
+
+bool BatchExport::addJobs( const QJsonObject& entry, const QJsonObject& defaults,
+						   const QString& sBaseDir )
+{
+	// Job specific values take precedence over the top-level ones.
+	auto value = [&]( const QString& sKey ) {
+		return entry.contains( sKey ) ? entry.value( sKey ) : defaults.value( sKey );
+	};
+	auto resolve = [&]( const QString& sPath ) {
+		return QFileInfo( QDir( sBaseDir ), sPath ).absoluteFilePath();
+	};
+
+	QStringList songs;
+	if ( entry.contains( "song" ) ) {
+		songs << resolve( entry.value( "song" ).toString() );
+	}
+	else if ( entry.contains( "playlist" ) ) {
+		const QString sPlaylist = resolve( entry.value( "playlist" ).toString() );
+		Playlist* pPlaylist = Playlist::load_file( sPlaylist, false );
+		if ( pPlaylist == nullptr ) {
+			___ERRORLOG( QString( "Unable to load playlist [%1]" ).arg( sPlaylist ) );
+			return false;
+		}
+		for ( int ii = 0; ii < pPlaylist->size(); ++ii ) {
+			songs << pPlaylist->get( ii )->filePath;
+		}
+		delete pPlaylist;
+	}
+	else {
+		___ERRORLOG( "Job does neither contain a song nor a playlist" );
+		return false;
+	}
+
+	QStringList formats;
+	for ( const auto& fformat : value( "formats" ).toArray() ) {
+		formats << fformat.toString();
+	}
+
+	const QString sOutDir = value( "outdir" ).toString().isEmpty() ? sBaseDir :
+		resolve( value( "outdir" ).toString() );
+
+	for ( const auto& ssSong : songs ) {
+		// An explicit output file is only supported for single songs.
+		QString sOutFile;
+		if ( entry.contains( "outfile" ) && songs.size() == 1 ) {
+			sOutFile = resolve( entry.value( "outfile" ).toString() );
+		} else {
+			sOutFile = QDir( sOutDir ).filePath( QFileInfo( ssSong ).completeBaseName() );
+		}
+
+		QStringList jobFormats = formats;
+		if ( jobFormats.isEmpty() ) {
+			const QString sSuffix = QFileInfo( sOutFile ).suffix();
+			jobFormats << ( sSuffix.isEmpty() ? "wav" : sSuffix );
+		}
+
+		const QFileInfo outInfo( sOutFile );
+		const QString sOutBase = outInfo.suffix().isEmpty() ? sOutFile :
+			outInfo.absoluteDir().filePath( outInfo.completeBaseName() );
+
+		Job job;
+		job.sSong = ssSong;
+		for ( const auto& ssFormat : jobFormats ) {
+			job.outFiles << sOutBase + "." + ssFormat.toLower();
+		}
+		job.nSampleRate = value( "rate" ).toInt( 44100 );
+		job.nSampleDepth = value( "bits" ).toInt( 16 );
+		job.nInterpolation = value( "interpolation" ).toInt( 0 );
+		job.bStems = value( "stems" ).toBool( false );
+		job.sDrumkit = value( "drumkit" ).toString();
+		job.nExitCode = -1;
+		job.nRenderTimeMs = 0;
+		m_jobs.push_back( job );
+	}
+
+	return true;
+}
+
+QStringList BatchExport::argumentsFor( const Job& job ) const
+{
+	QStringList args;
+	// Exporting switches to the DiskWriterDriver anyway. Workers
+	// must neither open the audio device configured in the
+	// Preferences nor start realtime threads for it.
+	args << "--driver" << "null";
+	args << "--song" << job.sSong;
+	for ( const auto& ssOutFile : job.outFiles ) {
+		args << "--outfile" << ssOutFile;
+	}
+	args << "--rate" << QString::number( job.nSampleRate )
+		 << "--bits" << QString::number( job.nSampleDepth )
+		 << "--interpolation" << QString::number( job.nInterpolation );
+	if ( job.bStems ) {
+		args << "--stems";
+	}
+	if ( ! job.sDrumkit.isEmpty() ) {
+		args << "--drumkit" << job.sDrumkit;
+	}
+	return args;
+}
+
+int BatchExport::run( int nWorkers )
+{
+	if ( nWorkers < 1 ) {
+		nWorkers = std::max( 1, QThread::idealThreadCount() );
+	}
+	m_nWorkers = nWorkers;
+
+	struct Worker {
+		QProcess* pProcess;
+		size_t nJob;
+		QElapsedTimer timer;
+	};
+
+	QElapsedTimer totalTimer;
+	totalTimer.start();
+
+	std::vector<Worker> running;
+	size_t nNextJob = 0;
+	size_t nDone = 0;
+	int nFailed = 0;
+
+	auto finishJob = [&]( Job& job ) {
+		++nDone;
+		if ( job.nExitCode != 0 ) {
+			++nFailed;
+		}
+		std::cout << "[" << nDone << "/" << m_jobs.size() << "] "
+				  << ( job.nExitCode == 0 ? "Rendered " : "FAILED " )
+				  << job.outFiles.join( ", " ).toLocal8Bit().data()
+				  << " (" << job.nRenderTimeMs << " ms)" << std::endl;
+	};
+
+	while ( nNextJob < m_jobs.size() || ! running.empty() ) {
+
+		while ( static_cast<int>(running.size()) < nWorkers &&
+				nNextJob < m_jobs.size() ) {
+			Job& job = m_jobs[ nNextJob ];
+
+			QDir().mkpath( QFileInfo( job.outFiles.first() ).absolutePath() );
+
+			Worker worker;
+			worker.pProcess = new QProcess;
+			worker.nJob = nNextJob;
+			// The progress output of the workers would only clutter
+			// the terminal. Errors are still forwarded.
+			worker.pProcess->setStandardOutputFile( QProcess::nullDevice() );
+			worker.pProcess->setProcessChannelMode( QProcess::ForwardedErrorChannel );
+			worker.timer.start();
+			worker.pProcess->start( m_sExecutable, argumentsFor( job ) );
+			++nNextJob;
+
+			if ( ! worker.pProcess->waitForStarted() ) {
+				___ERRORLOG( QString( "Unable to start worker [%1]: %2" )
+							 .arg( m_sExecutable )
+							 .arg( worker.pProcess->errorString() ) );
+				delete worker.pProcess;
+				finishJob( job );
+				continue;
+			}
+			running.push_back( worker );
+		}
+
+		// There is no event loop in h2cli. The state of the workers
+		// is only updated in the waitFor* functions.
+		for ( auto it = running.begin(); it != running.end(); ) {
+			if ( it->pProcess->state() != QProcess::NotRunning &&
+				 ! it->pProcess->waitForFinished( 20 ) ) {
+				++it;
+				continue;
+			}
+
+			Job& job = m_jobs[ it->nJob ];
+			job.nRenderTimeMs = it->timer.elapsed();
+			if ( it->pProcess->exitStatus() == QProcess::NormalExit ) {
+				job.nExitCode = it->pProcess->exitCode();
+			}
+			delete it->pProcess;
+			it = running.erase( it );
+			finishJob( job );
+		}
+	}
+
+	m_nTotalTimeMs = totalTimer.elapsed();
+
+	return nFailed;
+}
+
+bool BatchExport::writeSummary( const QString& sPath ) const
+{
+	QJsonArray jobs;
+	int nFailed = 0;
+	for ( const auto& jjob : m_jobs ) {
+		QJsonObject job;
+		job.insert( "song", jjob.sSong );
+		job.insert( "outfiles", QJsonArray::fromStringList( jjob.outFiles ) );
+		job.insert( "rate", jjob.nSampleRate );
+		job.insert( "bits", jjob.nSampleDepth );
+		job.insert( "stems", jjob.bStems );
+		job.insert( "success", jjob.nExitCode == 0 );
+		job.insert( "exitCode", jjob.nExitCode );
+		job.insert( "renderTimeMs", static_cast<double>(jjob.nRenderTimeMs) );
+		jobs.append( job );
+
+		if ( jjob.nExitCode != 0 ) {
+			++nFailed;
+		}
+	}
+
+	QJsonObject summary;
+	summary.insert( "workers", m_nWorkers );
+	summary.insert( "jobs", jobs );
+	summary.insert( "succeeded", static_cast<int>(m_jobs.size()) - nFailed );
+	summary.insert( "failed", nFailed );
+	summary.insert( "totalTimeMs", static_cast<double>(m_nTotalTimeMs) );
+
+	const QByteArray content = QJsonDocument( summary ).toJson( QJsonDocument::Indented );
+
+	if ( sPath.isEmpty() ) {
+		std::cout << content.constData();
+		return true;
+	}
+
+	QFile file( sPath );
+	if ( ! file.open( QIODevice::WriteOnly | QIODevice::Truncate ) ||
+		 file.write( content ) != content.size() ) {
+		___ERRORLOG( QString( "Unable to write summary [%1]: %2" )
+					 .arg( sPath ).arg( file.errorString() ) );
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,117 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#ifndef H2CLI_BATCH_EXPORT_H
+#define H2CLI_BATCH_EXPORT_H
+
+#include <QJsonObject>
+#include <QString>
+#include <QStringList>
+
+#include <vector>
+
+/**
+ * Renders a list of songs read from a JSON manifest.
+ *
+ * Since the audio engine of Hydrogen is a singleton, only a single
+ * song can be rendered per process. Each job is therefore handed to
+ * a separate h2cli worker process and up to @a nWorkers of them are
+ * run in parallel.
+ *
+ * The manifest has the following layout (all fields but "jobs" and
+ * "song"/"playlist" are optional and the top-level values are used
+ * as defaults for all jobs):
+ *
+ * \code{.json}
+ * {
+ *   "outdir": "renders",
+ *   "formats": [ "wav", "flac" ],
+ *   "rate": 48000,
+ *   "bits": 24,
+ *   "stems": false,
+ *   "jobs": [
+ *     { "song": "songs/first.h2song", "outfile": "first_master" },
+ *     { "playlist": "nightly.h2playlist", "stems": true },
+ *     { "song": "songs/second.h2song", "drumkit": "GMRockKit",
+ *       "interpolation": 2 }
+ *   ]
+ * }
+ * \endcode
+ *
+ * Relative paths are resolved with respect to the folder containing
+ * the manifest. Each song of a playlist becomes a job on its own. All
+ * requested formats of a song are written from a single render.
+ */
+class BatchExport
+{
+public:
+	struct Job {
+		QString sSong;
+		/** One file per requested format.*/
+		QStringList outFiles;
+		int nSampleRate;
+		int nSampleDepth;
+		int nInterpolation;
+		bool bStems;
+		QString sDrumkit;
+
+		int nExitCode;
+		qint64 nRenderTimeMs;
+	};
+
+	/** \param sExecutable Path to the h2cli binary used for the
+	 * worker processes.*/
+	explicit BatchExport( const QString& sExecutable );
+
+	/** \return true if the manifest could be read and contains at
+	 * least one job.*/
+	bool loadManifest( const QString& sManifestPath );
+
+	/** Renders all jobs.
+	 *
+	 * \param nWorkers Maximum number of worker processes running at
+	 *   the same time. Values smaller than 1 select the number of
+	 *   available cores.
+	 *
+	 * \return Number of failed jobs.*/
+	int run( int nWorkers );
+
+	/** Writes a JSON summary containing the outcome and render time
+	 * of every job. If @a sPath is empty, the summary is printed to
+	 * stdout.*/
+	bool writeSummary( const QString& sPath ) const;
+
+	const std::vector<Job>& getJobs() const {
+		return m_jobs;
+	}
+
+private:
+	bool addJobs( const QJsonObject& entry, const QJsonObject& defaults,
+				  const QString& sBaseDir );
+	QStringList argumentsFor( const Job& job ) const;
+
+	QString m_sExecutable;
+	std::vector<Job> m_jobs;
+	int m_nWorkers;
+	qint64 m_nTotalTimeMs;
+};
+
+#endif
@@ -20,6 +20,10 @@
  *
  */
 
+#include <QElapsedTimer>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
 #include <QLibraryInfo>
 #include <QStringList>
 #include <QThread>
@@ -34,6 +38,7 @@
 #include <core/Basics/Song.h>
 #include <core/MidiMap.h>
 #include <core/AudioEngine/AudioEngine.h>
+#include <core/IO/AudioOutput.h>
 #include <core/Hydrogen.h>
 #include <core/Basics/InstrumentList.h>
 #include <core/Basics/Instrument.h>
@@ -42,11 +47,20 @@
 #include <core/Preferences/Preferences.h>
 #include <core/H2Exception.h>
 #include <core/Basics/Playlist.h>
+#include <core/Basics/Pattern.h>
+#include <core/Basics/PatternList.h>
 #include <core/Sampler/Interpolation.h>
 #include <core/Helpers/Filesystem.h>
 
+#include "BatchExport.h"
+
 #include <iostream>
 #include <signal.h>
+#include <unistd.h>
+
+#ifndef WIN32
+#include <sys/resource.h>
+#endif
 
 using namespace H2Core;
 
@@ -71,6 +85,17 @@ static struct option long_opts[] = {
 	{"extract", required_argument, nullptr, 'x'},
 	{"target", required_argument, nullptr, 't'},
 	{"drumkit", required_argument, nullptr, 'k'},
+	{"rt-priority", required_argument, nullptr, 'P'},
+	{"cpu", required_argument, nullptr, 'C'},
+	{"mlock", 0, nullptr, 'M'},
+	{"double-buffer", 0, nullptr, 'D'},
+	{"daemon", 0, nullptr, 'n'},
+	{"osc-port", required_argument, nullptr, 'O'},
+	{"pid-file", required_argument, nullptr, 'F'},
+	{"stems", 0, nullptr, 'S'},
+	{"batch", required_argument, nullptr, 'B'},
+	{"jobs", required_argument, nullptr, 'j'},
+	{"summary", required_argument, nullptr, 'J'},
 	{nullptr, 0, nullptr, 0},
 };
 
@@ -83,12 +108,31 @@ public:
 };
 
 volatile bool quit = false;
+volatile sig_atomic_t nCaughtSignal = 0;
 void signal_handler ( int signum )
 {
-	if ( signum == SIGINT ) {
-		std::cout << "Terminate signal caught" << std::endl;
-		quit = true;
+	// Printing is done in the main loop since iostreams are not
+	// async-signal-safe.
+	nCaughtSignal = signum;
+	quit = true;
+}
+
+/** Peak resident set size of the process in kB or -1 if not
+	available.*/
+long getMaxResidentSetSize()
+{
+#ifndef WIN32
+	struct rusage usage;
+	if ( getrusage( RUSAGE_SELF, &usage ) == 0 ) {
+#ifdef __APPLE__
+		// Reported in bytes on macOS.
+		return usage.ru_maxrss / 1024;
+#else
+		return usage.ru_maxrss;
+#endif
 	}
+#endif
+	return -1;
 }
 
 void show_playlist (uint active )
@@ -108,6 +152,44 @@ void show_playlist (uint active )
 	std::cout << std::endl;
 }
 
+/** Whether at least one note of the song uses @a pInstrument.*/
+bool instrumentHasNotes( std::shared_ptr<Song> pSong, std::shared_ptr<Instrument> pInstrument )
+{
+	for ( const auto& pPattern : *pSong->getPatternList() ) {
+		if ( pPattern->references( pInstrument ) ) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/** Exports the instrument at position @a nInstrument of the current
+ * song into files named after @a outFiles and the instrument.*/
+void startExportStem( Hydrogen* pHydrogen, int nInstrument, const QStringList& outFiles )
+{
+	InstrumentList* pInstrumentList = pHydrogen->getSong()->getInstrumentList();
+	auto pInstrument = pInstrumentList->get( nInstrument );
+
+	// Instrument names do not have to be unique.
+	QString sStemName = pInstrument->get_name();
+	for ( int i = 0; i < pInstrumentList->size(); i++ ) {
+		pInstrumentList->get( i )->set_currently_exported( i == nInstrument );
+		if ( i != nInstrument &&
+			 pInstrumentList->get( i )->get_name() == pInstrument->get_name() ) {
+			sStemName = QString( "%1_%2" ).arg( pInstrument->get_name() )
+				.arg( pInstrument->get_id() );
+		}
+	}
+
+	QStringList stemFiles;
+	for ( const auto& ssOutFile : outFiles ) {
+		QFileInfo info( ssOutFile );
+		stemFiles << info.absoluteDir().filePath(
+			info.completeBaseName() + "-" + sStemName + "." + info.suffix() );
+	}
+	pHydrogen->startExportSong( stemFiles );
+}
+
 QString makePathAbsolute( const char* path ) {
 
 	QString sPath = QString::fromLocal8Bit( path );
@@ -124,6 +206,8 @@ QString makePathAbsolute( const char* path ) {
 int main(int argc, char *argv[])
 {
 	int nReturnCode = 0;
+	QElapsedTimer startupTimer;
+	startupTimer.start();
 	
 	try {
 		// Options...
@@ -146,12 +230,12 @@ int main(int argc, char *argv[])
 		// Deal with the options
 		QString songFilename;
 		QString playlistFilename;
-		QString outFilename = nullptr;
+		QStringList outFilenames;
 		QString sSelectedDriver;
 		bool showVersionOpt = false;
 		const char* logLevelOpt = "Error";
 		bool showHelpOpt = false;
-		QString drumkitName;
+		QStringList drumkitsToInstall;
 		QString drumkitToLoad;
 		QString sDrumkitToValidate;
 		bool bValidateDrumkit = false;
@@ -163,6 +247,17 @@ int main(int argc, char *argv[])
 		short bits = 16;
 		int rate = 44100;
 		short interpolation = 0;
+		int nDriverPriority = -1;
+		int nDriverCpu = -2;
+		bool bLockMemory = false;
+		bool bDoubleBuffering = false;
+		bool bDaemon = false;
+		int nOscPort = -1;
+		QString sPidFile;
+		bool bExportStems = false;
+		QString sBatchManifest;
+		int nBatchJobs = 0;
+		QString sBatchSummary;
 		int c;
 		while ( 1 ) {
 			c = getopt_long(argc, argv, opts, long_opts, nullptr);
@@ -179,11 +274,27 @@ int main(int argc, char *argv[])
 				playlistFilename = QString::fromLocal8Bit(optarg);
 				break;
 			case 'o':
-				outFilename = QString::fromLocal8Bit(optarg);
+				// Several files are written from a single render.
+				outFilenames << QString::fromLocal8Bit(optarg);
+				break;
+			case 'I':
+				interpolation = strtol(optarg, nullptr, 10);
+				break;
+			case 'S':
+				bExportStems = true;
+				break;
+			case 'B':
+				sBatchManifest = makePathAbsolute( optarg );
+				break;
+			case 'j':
+				nBatchJobs = strtol(optarg, nullptr, 10);
+				break;
+			case 'J':
+				sBatchSummary = makePathAbsolute( optarg );
 				break;
 			case 'i':
 				//install h2drumkit
-				drumkitName = makePathAbsolute( optarg );
+				drumkitsToInstall << makePathAbsolute( optarg );
 				break;
 			case 'c':
 				//validate h2drumkit
@@ -213,6 +324,27 @@ int main(int argc, char *argv[])
 			case 'b':
 				bits = strtol(optarg, nullptr, 10);
 				break;
+			case 'P':
+				nDriverPriority = strtol(optarg, nullptr, 10);
+				break;
+			case 'C':
+				nDriverCpu = strtol(optarg, nullptr, 10);
+				break;
+			case 'M':
+				bLockMemory = true;
+				break;
+			case 'D':
+				bDoubleBuffering = true;
+				break;
+			case 'n':
+				bDaemon = true;
+				break;
+			case 'O':
+				nOscPort = strtol(optarg, nullptr, 10);
+				break;
+			case 'F':
+				sPidFile = makePathAbsolute( optarg );
+				break;
 			case 'v':
 				showVersionOpt = true;
 				break;
@@ -226,6 +358,14 @@ int main(int argc, char *argv[])
 			}
 		}
 
+		// All remaining arguments following --install are considered
+		// additional drumkits to install.
+		if ( ! drumkitsToInstall.isEmpty() ) {
+			for ( int ii = optind; ii < argc; ++ii ) {
+				drumkitsToInstall << makePathAbsolute( argv[ ii ] );
+			}
+		}
+
 		if ( showVersionOpt ) {
 			std::cout << get_version() << std::endl;
 			exit(0);
@@ -257,8 +397,31 @@ int main(int argc, char *argv[])
 		LashClient* lashClient = LashClient::get_instance();
 #endif
 
-		if ( ! drumkitName.isEmpty() ){
-			Drumkit::install( drumkitName );
+		if ( ! sBatchManifest.isEmpty() ) {
+			// The workers are instances of this very binary.
+			QString sExecutable = QString::fromLocal8Bit( argv[ 0 ] );
+			if ( QFileInfo( "/proc/self/exe" ).exists() ) {
+				sExecutable = QFileInfo( "/proc/self/exe" ).canonicalFilePath();
+			}
+
+			BatchExport batchExport( sExecutable );
+			if ( ! batchExport.loadManifest( sBatchManifest ) ) {
+				std::cerr << "Unable to load manifest [" <<
+					sBatchManifest.toLocal8Bit().data() << "]" << std::endl;
+				exit(1);
+			}
+			const int nFailed = batchExport.run( nBatchJobs );
+			if ( ! batchExport.writeSummary( sBatchSummary ) || nFailed > 0 ) {
+				exit(1);
+			}
+			exit(0);
+		}
+
+		if ( ! drumkitsToInstall.isEmpty() ){
+			if ( ! Drumkit::install( drumkitsToInstall ) ) {
+				std::cout << "Unable to install all provided drumkits" << std::endl;
+				exit(1);
+			}
 			exit(0);
 		}
 
@@ -280,6 +443,36 @@ int main(int argc, char *argv[])
 		else if (sSelectedDriver == "PulseAudio") {
 			preferences->m_sAudioDriver = "PulseAudio";
 		}
+		else if ( sSelectedDriver == "null" ) {
+			preferences->m_sAudioDriver = "NullDriver";
+		}
+
+		if ( nDriverPriority >= 0 ) {
+			preferences->m_nDriverThreadPriority = nDriverPriority;
+		}
+		if ( nDriverCpu >= -1 ) {
+			preferences->m_nDriverThreadCpu = nDriverCpu;
+		}
+		if ( bLockMemory ) {
+			preferences->m_bDriverThreadLockMemory = true;
+		}
+		if ( bDoubleBuffering ) {
+			preferences->m_bDriverThreadDoubleBuffering = true;
+		}
+
+		if ( bDaemon ) {
+#ifndef H2CORE_HAVE_OSC
+			std::cerr << "Daemon mode requires Hydrogen to be built with OSC support" << std::endl;
+			exit(1);
+#endif
+			if ( ! outFilenames.isEmpty() ) {
+				std::cerr << "Daemon mode can not be combined with exporting a song" << std::endl;
+				exit(1);
+			}
+			if ( nOscPort > 0 ) {
+				preferences->setOscServerPort( nOscPort );
+			}
+		}
 
 #ifdef H2CORE_HAVE_LASH
 		if ( preferences->useLash() && lashClient->isConnected() ) {
@@ -336,14 +529,23 @@ int main(int argc, char *argv[])
 			if ( !songFilename.isEmpty() ) {
 				pSong = Song::load( songFilename );
 			} else {
-				/* Try load last song */
-				bool restoreLastSong = preferences->isRestoreLastSongEnabled();
+				/* Try load last song. Skipped in daemon mode to keep
+				 * startup fast and predictable. */
+				bool restoreLastSong = ! bDaemon &&
+					preferences->isRestoreLastSongEnabled();
 				QString filename = preferences->getLastSongFilename();
 				if ( restoreLastSong && ( !filename.isEmpty() )) {
 					pSong = Song::load( filename );
 				}
 			}
 
+			// Exporting an empty song instead would hide the error.
+			if ( ! pSong && ! outFilenames.isEmpty() && ! songFilename.isEmpty() ) {
+				std::cerr << "Unable to load song [" <<
+					songFilename.toLocal8Bit().data() << "]" << std::endl;
+				exit(1);
+			}
+
 			/* Still not loaded */
 			if (! pSong) {
 				___INFOLOG("Starting with empty song");
@@ -382,18 +584,40 @@ int main(int argc, char *argv[])
 		EventQueue *pQueue = EventQueue::get_instance();
 
 		signal(SIGINT, signal_handler);
+#ifndef WIN32
+		signal(SIGTERM, signal_handler);
+		signal(SIGHUP, signal_handler);
+#endif
 
 		
 		bool ExportMode = false;
-		if ( ! outFilename.isEmpty() ) {
+		// Instruments to be exported into separate files in case
+		// of --stems.
+		std::vector<int> stems;
+		size_t nCurrentStem = 0;
+		if ( ! outFilenames.isEmpty() ) {
 			InstrumentList *pInstrumentList = pSong->getInstrumentList();
 			for (auto i = 0; i < pInstrumentList->size(); i++) {
 				pInstrumentList->get(i)->set_currently_exported( true );
+				if ( bExportStems && instrumentHasNotes( pSong, pInstrumentList->get(i) ) ) {
+					stems.push_back( i );
+				}
+			}
+
+			if ( bExportStems && stems.empty() ) {
+				std::cerr << "Song does not contain any notes to export" << std::endl;
+				nReturnCode = -1;
+				quit = true;
+			} else {
+				pHydrogen->startExportSession(rate, bits);
+				if ( bExportStems ) {
+					startExportStem( pHydrogen, stems[ 0 ], outFilenames );
+				} else {
+					pHydrogen->startExportSong( outFilenames );
+				}
+				std::cout << "Export Progress ... ";
+				ExportMode = true;
 			}
-			pHydrogen->startExportSession(rate, bits);
-			pHydrogen->startExportSong( outFilename );
-			std::cout << "Export Progress ... ";
-			ExportMode = true;
 		}
 
 		auto pCoreActionController = pHydrogen->getCoreActionController();
@@ -457,6 +681,30 @@ int main(int argc, char *argv[])
 			}
 		} else {
 
+			if ( bDaemon ) {
+				if ( ! sPidFile.isEmpty() ) {
+					QFile pidFile( sPidFile );
+					if ( pidFile.open( QIODevice::WriteOnly | QIODevice::Truncate ) ) {
+						pidFile.write( QString( "%1\n" ).arg( getpid() ).toLocal8Bit() );
+						pidFile.close();
+					} else {
+						___ERRORLOG( QString( "Unable to write PID file [%1]" ).arg( sPidFile ) );
+					}
+				}
+
+				// Startup time and memory footprint are reported to
+				// allow for comparing the headless with the GUI
+				// version.
+				int nOscPortUsed = preferences->m_nOscTemporaryPort != -1 ?
+					preferences->m_nOscTemporaryPort :
+					preferences->getOscServerPort();
+				std::cout << "Hydrogen daemon ready. PID: " << getpid()
+						  << ", OSC port: " << nOscPortUsed
+						  << ", startup time: " << startupTimer.elapsed() << " ms"
+						  << ", max RSS: " << getMaxResidentSetSize() << " kB"
+						  << std::endl;
+			}
+
 			// Interactive mode
 			while ( ! quit ) {
 				/* FIXME: Someday here will be The Real CLI ;-) */
@@ -470,6 +718,11 @@ int main(int argc, char *argv[])
 	
 					if ( event.value < 100 ) {
 						std::cout << "\rExport Progress ... " << event.value << "%";
+					} else if ( ++nCurrentStem < stems.size() ) {
+						std::cout << "\rExport Progress ... stem " << nCurrentStem
+								  << "/" << stems.size() << " DONE" << std::endl;
+						pHydrogen->stopExportSong();
+						startExportStem( pHydrogen, stems[ nCurrentStem ], outFilenames );
 					} else {
 						pHydrogen->stopExportSession();
 						std::cout << "\rExport Progress ... DONE" << std::endl;
@@ -490,6 +743,14 @@ int main(int argc, char *argv[])
 						}
 					}
 					break;
+				case EVENT_ERROR:
+					if ( ExportMode &&
+						 event.value == Hydrogen::ERROR_EXPORTING_FILE ) {
+						std::cerr << "\nUnable to write export file. See the log for details."
+								  << std::endl;
+						nReturnCode = -1;
+					}
+					break;
 				case EVENT_NONE: /* Sleep if there is no more events */
 					Sleeper::msleep ( 100 );
 					break;
@@ -505,14 +766,30 @@ int main(int argc, char *argv[])
 			}
 		}
 
+		if ( nCaughtSignal != 0 ) {
+			std::cout << "Terminate signal caught" << std::endl;
+		}
+
 		if ( pHydrogen->getAudioEngine()->getState() == H2Core::AudioEngine::State::Playing ) {
 			pHydrogen->sequencer_stop();
 		}
 
+		if ( ! ExportMode && pHydrogen->getAudioOutput() != nullptr &&
+			 pHydrogen->getAudioOutput()->getXRuns() > 0 ) {
+			std::cout << "XRuns: " << pHydrogen->getAudioOutput()->getXRuns() << std::endl;
+		}
+
 		pSong = nullptr;
 		delete Playlist::get_instance();
 
-		preferences->savePreferences();
+		// In daemon mode all changes of the preferences are done via
+		// OSC and have to be stored explicitly using the
+		// SAVE_PREFERENCES command.
+		// Exports do not store the preferences either since
+		// several of them might be run in parallel (see --batch).
+		if ( ! bDaemon && ! ExportMode ) {
+			preferences->savePreferences();
+		}
 		delete pHydrogen;
 		delete pQueue;
 		delete preferences;
@@ -526,6 +803,10 @@ int main(int argc, char *argv[])
 		if (H2Core::Base::count_active()) {
 			H2Core::Base::write_objects_map_to_cerr();
 		}
+
+		if ( ! sPidFile.isEmpty() ) {
+			QFile::remove( sPidFile );
+		}
 	}
 	catch ( const H2Exception& ex ) {
 		std::cerr << "[main] Exception: " << ex.what() << std::endl;
@@ -576,7 +857,7 @@ void showUsage()
 #ifdef H2CORE_HAVE_COREAUDIO
 	availableAudioDrivers << "coreaudio";
 #endif
-	availableAudioDrivers << "auto";
+	availableAudioDrivers << "null" << "auto";
 
 		
 	std::cout << "Usage: h2cli OPTION [ARGS]" << std::endl;
@@ -591,12 +872,22 @@ void showUsage()
 		.toLocal8Bit().data() << std::endl;
 	std::cout << "   -s, --song FILE - Load a song (*.h2song) at startup" << std::endl;
 	std::cout << "   -p, --playlist FILE - Load a playlist (*.h2playlist) at startup" << std::endl;
-	std::cout << "   -o, --outfile FILE - Output to file (export)" << std::endl;
+	std::cout << "   -o, --outfile FILE - Output to file (export). Can be provided" << std::endl;
+	std::cout << "                        several times to write multiple formats" << std::endl;
+	std::cout << "                        from a single render" << std::endl;
 	std::cout << "   -r, --rate RATE - Set bitrate while exporting file" << std::endl;
 	std::cout << "   -b, --bits BITS - Set bits depth while exporting file" << std::endl;
+	std::cout << "   -S, --stems - Export each instrument into a separate file" << std::endl;
+	std::cout << "                 named after --outfile and the instrument" << std::endl;
 	std::cout << "   -k, --kit drumkit_name - Load a drumkit at startup" << std::endl;
 	std::cout << "   -I, --interpolate INT - Interpolation" << std::endl;
 	std::cout << "       [0:linear (default), 1:cosine, 2:third, 3:cubic, 4:hermite]" << std::endl;
+	std::cout << "   -P, --rt-priority PRIO - Realtime priority of the audio driver thread" << std::endl;
+	std::cout << "       (ALSA, OSS). 0 disables realtime scheduling" << std::endl;
+	std::cout << "   -C, --cpu CPU - Pin the audio driver thread to CPU (-1 disables pinning)" << std::endl;
+	std::cout << "   -M, --mlock - Lock all memory of Hydrogen into RAM" << std::endl;
+	std::cout << "   -D, --double-buffer - Render the next period while the current one" << std::endl;
+	std::cout << "       is written to the device" << std::endl;
 
 #ifdef H2CORE_HAVE_LASH
 	std::cout << "   --lash-no-start-server - If LASH server not running, don't start" << std::endl
@@ -610,7 +901,9 @@ void showUsage()
 
 	std::cout << std::endl;
 	std::cout << "Drumkit handling:" << std::endl;
-	std::cout << "   -i, --install FILE - install a drumkit (*.h2drumkit)" << std::endl;
+	std::cout << "   -i, --install FILE [FILE...] - install one or more drumkits" << std::endl;
+	std::cout << "                        (*.h2drumkit). Several drumkits are" << std::endl;
+	std::cout << "                        installed concurrently." << std::endl;
 	std::cout << "   -c, --check FILE - validates a drumkit (*.h2drumkit)" << std::endl;
 	std::cout << "   -u, --upgrade FILE - upgrades a drumkit. FILE can be either" << std::endl;
 	std::cout << "                        an absolute path to a folder containing a" << std::endl;
@@ -631,6 +924,35 @@ void showUsage()
 	std::cout << std::endl;
 	std::cout << "Example: h2cli -c /usr/share/hydrogen/data/drumkits/GMRockKit" << std::endl;
 
+	std::cout << std::endl;
+	std::cout << "Batch export:" << std::endl;
+	std::cout << "   -B, --batch MANIFEST - render all songs and playlists listed in" << std::endl;
+	std::cout << "                          a JSON manifest using separate worker" << std::endl;
+	std::cout << "                          processes running in parallel" << std::endl;
+	std::cout << "   -j, --jobs N - maximum number of parallel workers (default:" << std::endl;
+	std::cout << "                  number of cores)" << std::endl;
+	std::cout << "   -J, --summary FILE - write a JSON summary including the render" << std::endl;
+	std::cout << "                        times to FILE instead of stdout" << std::endl;
+	std::cout << std::endl;
+	std::cout << "Example: h2cli --batch nightly.json --jobs 8 --summary summary.json" << std::endl;
+
+	std::cout << std::endl;
+	std::cout << "Headless server:" << std::endl;
+	std::cout << "   -n, --daemon - Run without any interaction and control Hydrogen" << std::endl;
+	std::cout << "                  via OSC only. The last song is not restored and the" << std::endl;
+	std::cout << "                  preferences are not saved on exit (use the OSC" << std::endl;
+	std::cout << "                  command /Hydrogen/SAVE_PREFERENCES instead). On" << std::endl;
+	std::cout << "                  startup the PID, the time it took to start, and" << std::endl;
+	std::cout << "                  the peak memory usage are printed. SIGINT, SIGTERM," << std::endl;
+	std::cout << "                  and SIGHUP as well as /Hydrogen/QUIT shut it down." << std::endl;
+	std::cout << "                  /Hydrogen/HEALTH is answered with the PID, the" << std::endl;
+	std::cout << "                  audio engine state, the number of xruns, and the" << std::endl;
+	std::cout << "                  audio driver in use." << std::endl;
+	std::cout << "   -O, --osc-port PORT - Port the OSC server listens on" << std::endl;
+	std::cout << "   -F, --pid-file FILE - Write the PID to FILE. It is removed on exit" << std::endl;
+	std::cout << std::endl;
+	std::cout << "Example: h2cli -n -d jack -s ./live.h2song -O 9000 -F /run/user/1000/h2.pid" << std::endl;
+
 	std::cout << std::endl;
 	std::cout << "Miscellaneous:" << std::endl;
 	std::cout << "   -V[Level], --verbose[=Level] - Set verbosity level" << std::endl;
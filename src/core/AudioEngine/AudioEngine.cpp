@@ -51,6 +51,8 @@
 #include <core/IO/CoreMidiDriver.h>
 #include <core/IO/OssDriver.h>
 #include <core/IO/FakeDriver.h>
+#include <core/IO/LoopbackDriver.h>
+#include <core/IO/LoopbackMidiDriver.h>
 #include <core/IO/AlsaAudioDriver.h>
 #include <core/IO/PortAudioDriver.h>
 #include <core/IO/DiskWriterDriver.h>
@@ -60,6 +62,7 @@
 #include <core/IO/CoreAudioDriver.h>
 #include <core/IO/PulseAudioDriver.h>
 
+#include <core/AudioEngine/WorkerPool.h>
 #include <core/Hydrogen.h>	// TODO: remove this line as soon as possible
 #include <core/Preferences/Preferences.h>
 #include <cassert>
@@ -100,6 +103,20 @@ inline timeval currentTime2()
 	return now;
 }
 
+#ifdef H2CORE_HAVE_LADSPA
+/** Effects processed by the FX worker pool within one cycle.*/
+struct FXTasks {
+	LadspaFX* fx[ MAX_FX ];
+	uint32_t nFrames;
+};
+
+static void processFXTask( void* pData, int nTask )
+{
+	auto pTasks = static_cast<FXTasks*>( pData );
+	pTasks->fx[ nTask ]->processFX( pTasks->nFrames );
+}
+#endif
+
 AudioEngine::AudioEngine()
 		: TransportInfo()
 		, m_pSampler( nullptr )
@@ -114,8 +131,7 @@ AudioEngine::AudioEngine()
 		, m_nPatternSize( MAX_NOTES )
 		, m_fSongSizeInTicks( 0 )
 		, m_nRealtimeFrames( 0 )
-		, m_fMasterPeak_L( 0.0f )
-		, m_fMasterPeak_R( 0.0f )
+		, m_masterMeter( true )
 		, m_nColumn( -1 )
 		, m_nextState( State::Ready )
 		, m_fProcessTime( 0.0f )
@@ -160,12 +176,38 @@ AudioEngine::AudioEngine()
 
 #ifdef H2CORE_HAVE_LADSPA
 	Effects::create_instance();
+	m_pFXWorkerPool = nullptr;
+	createFXWorkerPool( true );
 #endif
 }
 
+#ifdef H2CORE_HAVE_LADSPA
+void AudioEngine::createFXWorkerPool( bool bRealtime )
+{
+	delete m_pFXWorkerPool;
+
+	int nFXWorkers = Preferences::get_instance()->m_nFXWorkerThreads;
+	if ( nFXWorkers < 0 ) {
+		nFXWorkers = WorkerPool::defaultWorkers( MAX_FX - 1 );
+	}
+	m_pFXWorkerPool = new WorkerPool( "LADSPA", std::min( nFXWorkers, MAX_FX - 1 ),
+									  DriverThread::settingsFromPreferences( bRealtime ) );
+	m_bFXWorkerPoolRealtime = bRealtime;
+}
+#endif
+
 AudioEngine::~AudioEngine()
 {
 	stopAudioDrivers();
+
+#ifdef H2CORE_HAVE_LADSPA
+	// Only used from within the process callback, which is not
+	// called anymore. Its threads have to be joined even if the
+	// engine is in an unexpected state.
+	delete m_pFXWorkerPool;
+	m_pFXWorkerPool = nullptr;
+#endif
+
 	if ( getState() != State::Initialized ) {
 		ERRORLOG( "Error the audio engine is not in State::Initialized" );
 		return;
@@ -328,9 +370,6 @@ void AudioEngine::stopPlayback()
 void AudioEngine::reset( bool bWithJackBroadcast ) {
 	const auto pHydrogen = Hydrogen::get_instance();
 	
-	m_fMasterPeak_L = 0.0f;
-	m_fMasterPeak_R = 0.0f;
-
 	setFrames( 0 );
 	setTick( 0 );
 	setColumn( -1 );
@@ -1058,8 +1097,7 @@ void AudioEngine::clearAudioBuffers( uint32_t nFrames )
 			if ( pFX ) {
 				assert( pFX->m_pBuffer_L );
 				assert( pFX->m_pBuffer_R );
-				memset( pFX->m_pBuffer_L, 0, nFrames * sizeof( float ) );
-				memset( pFX->m_pBuffer_R, 0, nFrames * sizeof( float ) );
+				pFX->clearBuffers( nFrames );
 			}
 		}
 	}
@@ -1103,6 +1141,10 @@ AudioOutput* AudioEngine::createAudioDriver( const QString& sDriver )
 		WARNINGLOG( "*** Using FAKE audio driver ***" );
 		pAudioDriver = new FakeDriver( m_AudioProcessCallback );
 	}
+	else if ( sDriver == "Loopback" ) {
+		WARNINGLOG( "*** Using loopback audio driver ***" );
+		pAudioDriver = new LoopbackDriver( m_AudioProcessCallback );
+	}
 	else if ( sDriver == "DiskWriterDriver" ) {
 		pAudioDriver = new DiskWriterDriver( m_AudioProcessCallback );
 	}
@@ -1129,6 +1171,20 @@ AudioOutput* AudioEngine::createAudioDriver( const QString& sDriver )
 		return nullptr;
 	}
 
+#ifdef H2CORE_HAVE_LADSPA
+	// Drivers rendering offline must not put the FX workers into
+	// realtime scheduling, pin them, or lock the memory of the
+	// whole process. No driver is running at this point, so the
+	// pool is idle.
+	const bool bRealtime =
+		dynamic_cast<DiskWriterDriver*>( pAudioDriver ) == nullptr &&
+		dynamic_cast<FakeDriver*>( pAudioDriver ) == nullptr &&
+		dynamic_cast<NullDriver*>( pAudioDriver ) == nullptr;
+	if ( bRealtime != m_bFXWorkerPoolRealtime ) {
+		createFXWorkerPool( bRealtime );
+	}
+#endif
+
 	this->lock( RIGHT_HERE );
 	QMutexLocker mx(&m_MutexOutputPointer);
 
@@ -1265,6 +1321,12 @@ void AudioEngine::startAudioDrivers()
 		m_pMidiDriver->open();
 		m_pMidiDriver->setActive( true );
 #endif
+	} else if ( pPref->m_sMidiDriver == "Loopback" ) {
+		LoopbackMidiDriver* pLoopbackMidiDriver = new LoopbackMidiDriver();
+		m_pMidiDriverOut = pLoopbackMidiDriver;
+		m_pMidiDriver = pLoopbackMidiDriver;
+		m_pMidiDriver->open();
+		m_pMidiDriver->setActive( true );
 	}
 	
 	mx.unlock();
@@ -1705,31 +1767,62 @@ void AudioEngine::processAudio( uint32_t nFrames ) {
 	assert( pBuffer_L != nullptr && pBuffer_R != nullptr );
 
 	// SAMPLER
+	// Silent outputs are not mixed.
 	getSampler()->process( nFrames, pSong );
-	float* out_L = getSampler()->m_pMainOut_L;
-	float* out_R = getSampler()->m_pMainOut_R;
-	for ( unsigned i = 0; i < nFrames; ++i ) {
-		pBuffer_L[ i ] += out_L[ i ];
-		pBuffer_R[ i ] += out_R[ i ];
+	if ( getSampler()->isMainOutActive() ) {
+		float* out_L = getSampler()->m_pMainOut_L;
+		float* out_R = getSampler()->m_pMainOut_R;
+		for ( unsigned i = 0; i < nFrames; ++i ) {
+			pBuffer_L[ i ] += out_L[ i ];
+			pBuffer_R[ i ] += out_R[ i ];
+		}
 	}
 
 	// SYNTH
 	getSynth()->process( nFrames );
-	out_L = getSynth()->m_pOut_L;
-	out_R = getSynth()->m_pOut_R;
-	for ( unsigned i = 0; i < nFrames; ++i ) {
-		pBuffer_L[ i ] += out_L[ i ];
-		pBuffer_R[ i ] += out_R[ i ];
+	if ( getSynth()->isActive() ) {
+		float* out_L = getSynth()->m_pOut_L;
+		float* out_R = getSynth()->m_pOut_R;
+		for ( unsigned i = 0; i < nFrames; ++i ) {
+			pBuffer_L[ i ] += out_L[ i ];
+			pBuffer_R[ i ] += out_R[ i ];
+		}
 	}
 
 	timeval ladspaTime_start = currentTime2();
 
 #ifdef H2CORE_HAVE_LADSPA
-	// Process LADSPA FX
+	// Effects which did not receive any input for longer than their
+	// tail time are neither processed nor mixed.
+	const auto pPref = Preferences::get_instance();
+	long long nTailFrames = -1;
+	if ( pPref->m_bFXAutoBypass ) {
+		nTailFrames = static_cast<long long>(
+			pPref->m_fFXTailTime * m_pAudioDriver->getSampleRate() );
+	}
+
+	// Process LADSPA FX. The slots are independent of each other
+	// and processed in parallel. Mixing them into the master output
+	// is done afterwards in a fixed order.
+	Effects* pEffects = Effects::get_instance();
+	FXTasks tasks;
+	tasks.nFrames = nFrames;
+	int nActiveFX = 0;
+	bool bProcessed[ MAX_FX ];
 	for ( unsigned nFX = 0; nFX < MAX_FX; ++nFX ) {
-		LadspaFX *pFX = Effects::get_instance()->getLadspaFX( nFX );
-		if ( ( pFX ) && ( pFX->isEnabled() ) ) {
-			pFX->processFX( nFrames );
+		LadspaFX *pFX = pEffects->getLadspaFX( nFX );
+		bProcessed[ nFX ] = ( pFX ) && ( pFX->isEnabled() ) &&
+			pFX->checkActivity( nFrames, nTailFrames );
+		if ( bProcessed[ nFX ] ) {
+			tasks.fx[ nActiveFX ] = pFX;
+			++nActiveFX;
+		}
+	}
+	m_pFXWorkerPool->run( nActiveFX, processFXTask, &tasks );
+
+	for ( unsigned nFX = 0; nFX < MAX_FX; ++nFX ) {
+		if ( bProcessed[ nFX ] ) {
+			LadspaFX *pFX = pEffects->getLadspaFX( nFX );
 
 			float *buf_L, *buf_R;
 			if ( pFX->getPluginType() == LadspaFX::STEREO_FX ) {
@@ -1740,18 +1833,15 @@ void AudioEngine::processAudio( uint32_t nFrames ) {
 				buf_R = buf_L;
 			}
 
+			Meter::Accumulator meter;
 			for ( unsigned i = 0; i < nFrames; ++i ) {
 				pBuffer_L[ i ] += buf_L[ i ];
 				pBuffer_R[ i ] += buf_R[ i ];
-				if ( buf_L[ i ] > m_fFXPeak_L[nFX] ) {
-					m_fFXPeak_L[nFX] = buf_L[ i ];
-				}
-
-				if ( buf_R[ i ] > m_fFXPeak_R[nFX] ) {
-					m_fFXPeak_R[nFX] = buf_R[ i ];
-				}
+				meter.process( buf_L[ i ], buf_R[ i ] );
 			}
+			m_fxMeters[ nFX ].add( meter );
 		}
+		m_fxMeters[ nFX ].publish( nFrames );
 	}
 #endif
 	timeval ladspaTime_end = currentTime2();
@@ -1759,35 +1849,21 @@ void AudioEngine::processAudio( uint32_t nFrames ) {
 			( ladspaTime_end.tv_sec - ladspaTime_start.tv_sec ) * 1000.0
 			+ ( ladspaTime_end.tv_usec - ladspaTime_start.tv_usec ) / 1000.0;
 
-	// update master peaks
-	float val_L, val_R;
-	for ( unsigned i = 0; i < nFrames; ++i ) {
-		val_L = pBuffer_L[i];
-		val_R = pBuffer_R[i];
-
-		if ( val_L > m_fMasterPeak_L ) {
-			m_fMasterPeak_L = val_L;
-		}
+	m_masterMeter.process( pBuffer_L, pBuffer_R, nFrames );
+	m_masterMeter.publish( nFrames );
 
-		if ( val_R > m_fMasterPeak_R ) {
-			m_fMasterPeak_R = val_R;
+	// The meters of the instruments and drumkit components were
+	// already fed by the Sampler while rendering the notes. Only the
+	// accumulated values have to be handed over.
+	if ( pSong != nullptr ) {
+		for ( const auto& pInstrument : *pSong->getInstrumentList() ) {
+			pInstrument->get_meter().publish( nFrames );
 		}
-
-		for (std::vector<DrumkitComponent*>::iterator it = pSong->getComponents()->begin() ; it != pSong->getComponents()->end(); ++it) {
-			DrumkitComponent* drumkit_component = *it;
-
-			float compo_val_L = drumkit_component->get_out_L(i);
-			float compo_val_R = drumkit_component->get_out_R(i);
-
-			if( compo_val_L > drumkit_component->get_peak_l() ) {
-				drumkit_component->set_peak_l( compo_val_L );
-			}
-			if( compo_val_R > drumkit_component->get_peak_r() ) {
-				drumkit_component->set_peak_r( compo_val_R );
-			}
+		for ( const auto& pComponent : *pSong->getComponents() ) {
+			pComponent->get_meter().publish( nFrames );
 		}
 	}
-
+	getSampler()->getPlaybackTrackInstrument()->get_meter().publish( nFrames );
 }
 
 void AudioEngine::setState( AudioEngine::State state ) {
@@ -4462,20 +4538,7 @@ QString AudioEngine::toQString( const QString& sPrefix, bool bShort ) const {
 			.append( QString( "%1%2m_pMidiDriver: \n" ).arg( sPrefix ).arg( s ) )
 			.append( QString( "%1%2m_pMidiDriverOut: \n" ).arg( sPrefix ).arg( s ) )
 			.append( QString( "%1%2m_pEventQueue: \n" ).arg( sPrefix ).arg( s ) );
-#ifdef H2CORE_HAVE_LADSPA
-		sOutput.append( QString( "%1%2m_fFXPeak_L: [" ).arg( sPrefix ).arg( s ) );
-		for ( auto ii : m_fFXPeak_L ) {
-			sOutput.append( QString( " %1" ).arg( ii ) );
-		}
-		sOutput.append( QString( "]\n%1%2m_fFXPeak_R: [" ).arg( sPrefix ).arg( s ) );
-		for ( auto ii : m_fFXPeak_R ) {
-			sOutput.append( QString( " %1" ).arg( ii ) );
-		}
-		sOutput.append( QString( " ]\n" ) );
-#endif
-		sOutput.append( QString( "%1%2m_fMasterPeak_L: %3\n" ).arg( sPrefix ).arg( s ).arg( m_fMasterPeak_L ) )
-			.append( QString( "%1%2m_fMasterPeak_R: %3\n" ).arg( sPrefix ).arg( s ).arg( m_fMasterPeak_R ) )
-			.append( QString( "%1%2m_fProcessTime: %3\n" ).arg( sPrefix ).arg( s ).arg( m_fProcessTime ) )
+		sOutput.append( QString( "%1%2m_fProcessTime: %3\n" ).arg( sPrefix ).arg( s ).arg( m_fProcessTime ) )
 			.append( QString( "%1%2m_fMaxProcessTime: %3\n" ).arg( sPrefix ).arg( s ).arg( m_fMaxProcessTime ) )
 			.append( QString( "%1%2m_pNextPatterns: %3\n" ).arg( sPrefix ).arg( s ).arg( m_pNextPatterns->toQString( sPrefix + s ), bShort ) )
 			.append( QString( "%1%2m_pPlayingPatterns: %3\n" ).arg( sPrefix ).arg( s ).arg( m_pPlayingPatterns->toQString( sPrefix + s ), bShort ) )
@@ -4513,20 +4576,7 @@ QString AudioEngine::toQString( const QString& sPrefix, bool bShort ) const {
 			.append( QString( ", m_pMidiDriver:" ) )
 			.append( QString( ", m_pMidiDriverOut:" ) )
 			.append( QString( ", m_pEventQueue:" ) );
-#ifdef H2CORE_HAVE_LADSPA
-		sOutput.append( QString( ", m_fFXPeak_L: [" ) );
-		for ( auto ii : m_fFXPeak_L ) {
-			sOutput.append( QString( " %1" ).arg( ii ) );
-		}
-		sOutput.append( QString( "], m_fFXPeak_R: [" ) );
-		for ( auto ii : m_fFXPeak_R ) {
-			sOutput.append( QString( " %1" ).arg( ii ) );
-		}
-		sOutput.append( QString( " ]" ) );
-#endif
-		sOutput.append( QString( ", m_fMasterPeak_L: %1" ).arg( m_fMasterPeak_L ) )
-			.append( QString( ", m_fMasterPeak_R: %1" ).arg( m_fMasterPeak_R ) )
-			.append( QString( ", m_fProcessTime: %1" ).arg( m_fProcessTime ) )
+		sOutput.append( QString( ", m_fProcessTime: %1" ).arg( m_fProcessTime ) )
 			.append( QString( ", m_fMaxProcessTime: %1" ).arg( m_fMaxProcessTime ) )
 			.append( QString( ", m_pNextPatterns: %1" ).arg( m_pNextPatterns->toQString( sPrefix + s ), bShort ) )
 			.append( QString( ", m_pPlayingPatterns: %1" ).arg( m_pPlayingPatterns->toQString( sPrefix + s ), bShort ) )
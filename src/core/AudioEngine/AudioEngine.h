@@ -29,6 +29,7 @@
 #include <core/Sampler/Sampler.h>
 #include <core/Synth/Synth.h>
 #include <core/Basics/Note.h>
+#include <core/AudioEngine/Meter.h>
 #include <core/AudioEngine/TransportInfo.h>
 #include <core/CoreActionController.h>
 
@@ -68,6 +69,7 @@ namespace H2Core
 	class PatternList;
 	class Drumkit;
 	class Song;
+	class WorkerPool;
 	
 /**
  * Audio Engine main class.
@@ -319,6 +321,14 @@ public:
 	void			restartAudioDrivers();
 					
 	void			setupLadspaFX();
+#ifdef H2CORE_HAVE_LADSPA
+	/** (Re)creates #m_pFXWorkerPool. Must not be called while
+	 * an audio driver is running.
+	 *
+	 * \param bRealtime Whether the workers are scheduled like the
+	 *   DriverThread of a realtime driver.*/
+	void			createFXWorkerPool( bool bRealtime );
+#endif
 	
 	/**
 	 * Hands the provided Song to JackAudioDriver::makeTrackOutputs() if
@@ -340,11 +350,13 @@ public:
 	
 	State 			getState() const;
 
-	void 			setMasterPeak_L( float value );
-	float 			getMasterPeak_L() const;
-
-	void	 		setMasterPeak_R( float value );
-	float 			getMasterPeak_R() const;
+	/** Meter of the master output including true peak
+	 * estimation.*/
+	Meter&			getMasterMeter();
+#if defined(H2CORE_HAVE_LADSPA) || _DOXYGEN_
+	/** Meter of the return of the LADSPA effect in slot @a nFX.*/
+	Meter&			getFXMeter( int nFX );
+#endif
 
 	float			getProcessTime() const;
 	float			getMaxProcessTime() const;
@@ -777,15 +789,17 @@ private:
 	EventQueue* 		m_pEventQueue;
 
 	#if defined(H2CORE_HAVE_LADSPA) || _DOXYGEN_
-	float				m_fFXPeak_L[MAX_FX];
-	float				m_fFXPeak_R[MAX_FX];
+	Meter				m_fxMeters[MAX_FX];
+	/** Threads processing the LADSPA effects in parallel. The
+	 * slots do not depend on each other since each of them has
+	 * its own send buffers.*/
+	WorkerPool*			m_pFXWorkerPool;
+	/** Whether #m_pFXWorkerPool uses the realtime settings of the
+	 * DriverThread.*/
+	bool				m_bFXWorkerPoolRealtime;
 	#endif
 
-	//Master peak (left channel)
-	float				m_fMasterPeak_L;
-
-	//Master peak (right channel)
-	float				m_fMasterPeak_R;
+	Meter				m_masterMeter;
 
 	/**
 	 * Mutex for synchronizing the access to the Song object and
@@ -993,21 +1007,16 @@ inline void AudioEngine::assertLocked( ) {
 #endif
 }
 
-inline void	AudioEngine::setMasterPeak_L( float value ) {
-	m_fMasterPeak_L = value;
+inline Meter& AudioEngine::getMasterMeter() {
+	return m_masterMeter;
 }
 
-inline float AudioEngine::getMasterPeak_L() const {
-	return m_fMasterPeak_L;
-}
-
-inline void	AudioEngine::setMasterPeak_R( float value ) {
-	m_fMasterPeak_R = value;
-}
-
-inline float AudioEngine::getMasterPeak_R() const {
-	return m_fMasterPeak_R;
+#ifdef H2CORE_HAVE_LADSPA
+inline Meter& AudioEngine::getFXMeter( int nFX ) {
+	assert( nFX >= 0 && nFX < MAX_FX );
+	return m_fxMeters[ nFX ];
 }
+#endif
 
 inline float AudioEngine::getProcessTime() const {
 	return m_fProcessTime;
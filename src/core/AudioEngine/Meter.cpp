@@ -0,0 +1,137 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#include <core/AudioEngine/Meter.h>
+#include <core/Sampler/Interpolation.h>
+
+#include <algorithm>
+
+namespace H2Core
+{
+
+void Meter::Values::clear() {
+	fPeak_L = 0;
+	fPeak_R = 0;
+	fTruePeak_L = 0;
+	fTruePeak_R = 0;
+	fSumSquares_L = 0;
+	fSumSquares_R = 0;
+	nFrames = 0;
+}
+
+Meter::Meter( bool bTruePeak )
+	: m_nBack( 0 )
+	, m_nFront( 1 )
+	, m_nMiddle( 2 )
+	, m_bTruePeak( bTruePeak )
+{
+	for ( auto& slot : m_slots ) {
+		slot.clear();
+	}
+	for ( int ii = 0; ii < 3; ++ii ) {
+		m_history_L[ ii ] = 0;
+		m_history_R[ ii ] = 0;
+	}
+}
+
+Meter::~Meter() {
+}
+
+void Meter::add( const Accumulator& accumulator ) {
+	Values& values = m_slots[ m_nBack ];
+	if ( accumulator.fPeak_L > values.fPeak_L ) {
+		values.fPeak_L = accumulator.fPeak_L;
+	}
+	if ( accumulator.fPeak_R > values.fPeak_R ) {
+		values.fPeak_R = accumulator.fPeak_R;
+	}
+	values.fSumSquares_L += accumulator.fSumSquares_L;
+	values.fSumSquares_R += accumulator.fSumSquares_R;
+}
+
+void Meter::process( const float* pBuffer_L, const float* pBuffer_R,
+					 uint32_t nFrames ) {
+	Accumulator accumulator;
+	for ( uint32_t ii = 0; ii < nFrames; ++ii ) {
+		accumulator.process( pBuffer_L[ ii ], pBuffer_R[ ii ] );
+	}
+	add( accumulator );
+
+	if ( ! m_bTruePeak ) {
+		return;
+	}
+
+	// Estimate the inter-sample peaks by evaluating the Hermite
+	// interpolation between two consecutive samples at three
+	// positions (4x oversampling). The segment between the last two
+	// samples of the history is evaluated once the next sample is
+	// known, so there is a delay of one frame.
+	auto truePeak = [&]( const float* pBuffer, float* pHistory, float fPeak ) {
+		for ( uint32_t ii = 0; ii < nFrames; ++ii ) {
+			const float fNext = pBuffer[ ii ];
+			for ( const double fMu : { 0.25, 0.5, 0.75 } ) {
+				const float fVal = std::fabs(
+					Interpolation::hermite_Interpolate( pHistory[ 0 ], pHistory[ 1 ],
+														pHistory[ 2 ], fNext, fMu ) );
+				if ( fVal > fPeak ) {
+					fPeak = fVal;
+				}
+			}
+			pHistory[ 0 ] = pHistory[ 1 ];
+			pHistory[ 1 ] = pHistory[ 2 ];
+			pHistory[ 2 ] = fNext;
+		}
+		return fPeak;
+	};
+
+	Values& values = m_slots[ m_nBack ];
+	values.fTruePeak_L = std::max( truePeak( pBuffer_L, m_history_L, values.fTruePeak_L ),
+								   values.fPeak_L );
+	values.fTruePeak_R = std::max( truePeak( pBuffer_R, m_history_R, values.fTruePeak_R ),
+								   values.fPeak_R );
+}
+
+void Meter::publish( uint32_t nFrames ) {
+	m_slots[ m_nBack ].nFrames += nFrames;
+
+	const int nPrevious = m_nMiddle.exchange( m_nBack | nDirtyFlag,
+											  std::memory_order_acq_rel );
+	m_nBack = nPrevious & nIndexMask;
+
+	// In case the GUI did not pick up the previous values, we keep
+	// accumulating into them and they will be part of the next
+	// publication.
+	if ( ! ( nPrevious & nDirtyFlag ) ) {
+		m_slots[ m_nBack ].clear();
+	}
+}
+
+bool Meter::read( Values& values ) {
+	bool bNew = false;
+	if ( m_nMiddle.load( std::memory_order_relaxed ) & nDirtyFlag ) {
+		m_nFront = m_nMiddle.exchange( m_nFront, std::memory_order_acq_rel ) & nIndexMask;
+		bNew = true;
+	}
+	values = m_slots[ m_nFront ];
+	return bNew;
+}
+
+};
@@ -0,0 +1,164 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#ifndef METER_H
+#define METER_H
+
+#include <core/Object.h>
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+
+namespace H2Core
+{
+
+/**
+ * Level meter of a single stereo strip (instrument, drumkit
+ * component, FX return, or the master output).
+ *
+ * The absolute peak, the sum of squares (for the RMS) and,
+ * optionally, an estimate of the true peak are accumulated by the
+ * audio thread directly within the render loops. Once per period
+ * the accumulated values are handed over to the GUI using publish().
+ *
+ * Publishing is done via a lock-free triple buffer. The audio thread
+ * accumulates into the back slot and swaps it with the middle one,
+ * the GUI swaps the middle slot with its front one in read(). Both
+ * sides never block and never touch the same slot. In case the GUI
+ * did not pick up the last published values, they are not discarded
+ * but merged into the next publication.
+ *
+ * The Meter does not apply any ballistics. Fall off and peak hold
+ * are up to the GUI.
+ *
+ * There must be at most one thread calling the audio side methods
+ * and at most one calling read().
+ */
+/** \ingroup docCore docAudioEngine */
+class Meter : public H2Core::Object<Meter>
+{
+	H2_OBJECT(Meter)
+public:
+
+	struct Values {
+		float fPeak_L;
+		float fPeak_R;
+		/** Only set in case true peak metering is enabled.*/
+		float fTruePeak_L;
+		float fTruePeak_R;
+		float fSumSquares_L;
+		float fSumSquares_R;
+		/** Number of frames contained in the sums of squares.*/
+		uint32_t nFrames;
+
+		float getRms_L() const {
+			return nFrames > 0 ? std::sqrt( fSumSquares_L / nFrames ) : 0;
+		}
+		float getRms_R() const {
+			return nFrames > 0 ? std::sqrt( fSumSquares_R / nFrames ) : 0;
+		}
+		void clear();
+	};
+
+	/**
+	 * Light-weight accumulator meant to be placed on the stack of a
+	 * render loop and merged into the Meter using add() afterwards.
+	 */
+	struct Accumulator {
+		float fPeak_L = 0;
+		float fPeak_R = 0;
+		float fSumSquares_L = 0;
+		float fSumSquares_R = 0;
+
+		inline void process( float fVal_L, float fVal_R ) {
+			const float fAbs_L = std::fabs( fVal_L );
+			const float fAbs_R = std::fabs( fVal_R );
+			if ( fAbs_L > fPeak_L ) {
+				fPeak_L = fAbs_L;
+			}
+			if ( fAbs_R > fPeak_R ) {
+				fPeak_R = fAbs_R;
+			}
+			fSumSquares_L += fVal_L * fVal_L;
+			fSumSquares_R += fVal_R * fVal_R;
+		}
+	};
+
+	/** \param bTruePeak Whether process() should estimate the true
+	 * (inter-sample) peak too.*/
+	Meter( bool bTruePeak = false );
+	~Meter();
+
+	Meter( const Meter& ) = delete;
+	Meter& operator=( const Meter& ) = delete;
+
+	bool isTruePeakEnabled() const {
+		return m_bTruePeak;
+	}
+
+	/** Audio side. Merges the values accumulated in a render loop.
+	 *
+	 * In case several overlapping voices are added within the same
+	 * period (e.g. multiple notes of an instrument) the resulting
+	 * RMS is the one of their uncorrelated sum.*/
+	void add( const Accumulator& accumulator );
+	/** Audio side. Meters the first @a nFrames of two complete
+	 * buffers. This is the only way to obtain true peak values since
+	 * they require a continuous signal.*/
+	void process( const float* pBuffer_L, const float* pBuffer_R, uint32_t nFrames );
+	/** Audio side. Hands the values accumulated since the last call
+	 * over to the GUI. To be called once per period.
+	 *
+	 * \param nFrames Size of the period. The RMS is calculated with
+	 * respect to it regardless of how many frames were actually
+	 * metered.*/
+	void publish( uint32_t nFrames );
+
+	/** GUI side. Retrieves the most recently published values.
+	 *
+	 * \return true in case new values were published since the last
+	 * call. If false, @a values still contains the last ones.*/
+	bool read( Values& values );
+
+private:
+	static constexpr int nDirtyFlag = 0x4;
+	static constexpr int nIndexMask = 0x3;
+
+	Values m_slots[ 3 ];
+	/** Slot the audio thread accumulates into.*/
+	int m_nBack;
+	/** Slot currently read by the GUI.*/
+	int m_nFront;
+	/** Index of the slot in between and #nDirtyFlag in case it
+	 * contains values not read yet.*/
+	std::atomic<int> m_nMiddle;
+
+	bool m_bTruePeak;
+	/** Last three samples of the previous process() call used to
+	 * interpolate across period boundaries.*/
+	float m_history_L[ 3 ];
+	float m_history_R[ 3 ];
+};
+
+};
+
+#endif
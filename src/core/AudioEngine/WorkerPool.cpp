@@ -0,0 +1,145 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#include <core/AudioEngine/WorkerPool.h>
+
+#include <algorithm>
+
+namespace H2Core
+{
+
+WorkerPool::WorkerPool( const QString& sName, int nWorkers,
+						const DriverThread::Settings& settings )
+	: m_sName( sName )
+	, m_settings( settings )
+	, m_pContext( EngineContext::current() )
+	, m_nGeneration( 0 )
+	, m_nBusyWorkers( 0 )
+	, m_bShutdown( false )
+	, m_task( nullptr )
+	, m_pData( nullptr )
+	, m_nTasks( 0 )
+	, m_nNextTask( 0 )
+	, m_nDoneTasks( 0 )
+{
+	// Pinning all workers to the same CPU would render them useless.
+	m_settings.nCpu = -1;
+	m_settings.bDoubleBuffering = false;
+
+	for ( int ii = 0; ii < nWorkers; ++ii ) {
+		m_workers.emplace_back( &WorkerPool::workerLoop, this );
+	}
+	INFOLOG( QString( "[%1] %2 worker threads started" )
+			 .arg( m_sName ).arg( nWorkers ) );
+}
+
+WorkerPool::~WorkerPool()
+{
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+		m_bShutdown = true;
+	}
+	m_wakeUp.notify_all();
+	for ( auto& worker : m_workers ) {
+		worker.join();
+	}
+}
+
+int WorkerPool::defaultWorkers( int nMaxWorkers )
+{
+	const int nCores = static_cast<int>( std::thread::hardware_concurrency() );
+	return std::max( 0, std::min( nMaxWorkers, nCores - 1 ) );
+}
+
+void WorkerPool::run( int nTasks, Task task, void* pData )
+{
+	if ( nTasks <= 0 ) {
+		return;
+	}
+	if ( m_workers.empty() || nTasks == 1 ) {
+		for ( int ii = 0; ii < nTasks; ++ii ) {
+			task( pData, ii );
+		}
+		return;
+	}
+
+	{
+		std::unique_lock<std::mutex> lock( m_mutex );
+		// Workers woken up late for the previous generation might
+		// still be looking for tasks.
+		m_finished.wait( lock, [&]{ return m_nBusyWorkers == 0; } );
+
+		m_task = task;
+		m_pData = pData;
+		m_nTasks = nTasks;
+		m_nDoneTasks = 0;
+		m_nNextTask = 0;
+		++m_nGeneration;
+	}
+	m_wakeUp.notify_all();
+
+	work();
+
+	std::unique_lock<std::mutex> lock( m_mutex );
+	m_finished.wait( lock, [&]{
+		return m_nDoneTasks == m_nTasks && m_nBusyWorkers == 0; } );
+}
+
+void WorkerPool::work()
+{
+	int nTask;
+	while ( ( nTask = m_nNextTask.fetch_add( 1 ) ) < m_nTasks ) {
+		m_task( m_pData, nTask );
+		if ( m_nDoneTasks.fetch_add( 1 ) + 1 == m_nTasks ) {
+			std::lock_guard<std::mutex> lock( m_mutex );
+			m_finished.notify_all();
+		}
+	}
+}
+
+void WorkerPool::workerLoop()
+{
+	EngineContext::Scope scope( m_pContext );
+	DriverThread::applySettings( m_sName, m_settings );
+
+	unsigned long long nGeneration = 0;
+	std::unique_lock<std::mutex> lock( m_mutex );
+	while ( true ) {
+		m_wakeUp.wait( lock, [&]{
+			return m_bShutdown || m_nGeneration != nGeneration; } );
+		if ( m_bShutdown ) {
+			return;
+		}
+		nGeneration = m_nGeneration;
+		++m_nBusyWorkers;
+		lock.unlock();
+
+		work();
+
+		lock.lock();
+		--m_nBusyWorkers;
+		if ( m_nBusyWorkers == 0 ) {
+			m_finished.notify_all();
+		}
+	}
+}
+
+};
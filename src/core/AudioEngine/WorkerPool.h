@@ -0,0 +1,121 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <core/Object.h>
+#include <core/EngineContext.h>
+#include <core/IO/DriverThread.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace H2Core
+{
+
+/**
+ * Fixed set of threads executing independent tasks of a single
+ * cycle of the audio engine in parallel, e.g. the LADSPA effect
+ * slots.
+ *
+ * The threads are created up front and sleep in between two calls
+ * of run(). They are scheduled according to the provided
+ * DriverThread::Settings (CPU pinning is ignored, since it would
+ * serialize the workers again) and use the EngineContext of the
+ * thread creating the pool.
+ */
+/** \ingroup docCore docAudioEngine */
+class WorkerPool : public H2Core::Object<WorkerPool>
+{
+	H2_OBJECT(WorkerPool)
+public:
+	/** Function executing task number @a nTask using the data
+	 * passed to run().*/
+	typedef void (*Task)( void* pData, int nTask );
+
+	/**
+	 * \param sName Name used in log messages.
+	 * \param nWorkers Number of threads in addition to the one
+	 *   calling run().
+	 * \param settings Scheduling settings of the workers.
+	 */
+	WorkerPool( const QString& sName, int nWorkers,
+				const DriverThread::Settings& settings );
+	~WorkerPool();
+
+	WorkerPool( const WorkerPool& ) = delete;
+	WorkerPool& operator=( const WorkerPool& ) = delete;
+
+	/**
+	 * Executes @a task for all task numbers in [0, @a nTasks) and
+	 * returns once all of them are done. The calling thread
+	 * processes tasks as well. Each task is executed exactly once
+	 * but in no particular order.
+	 *
+	 * Must not be called concurrently.
+	 */
+	void run( int nTasks, Task task, void* pData );
+
+	int getWorkers() const {
+		return static_cast<int>( m_workers.size() );
+	}
+
+	/** Number of workers used in case the user did not specify
+	 * one: one less than the number of available cores, at most
+	 * @a nMaxWorkers.*/
+	static int defaultWorkers( int nMaxWorkers );
+
+private:
+	void workerLoop();
+	/** Processes tasks until none is left.*/
+	void work();
+
+	QString m_sName;
+	DriverThread::Settings m_settings;
+	EngineContext* m_pContext;
+	std::vector<std::thread> m_workers;
+
+	std::mutex m_mutex;
+	std::condition_variable m_wakeUp;
+	std::condition_variable m_finished;
+	/** Incremented for each call of run(). Workers compare it with
+	 * the last generation they processed in order to detect new
+	 * work.*/
+	unsigned long long m_nGeneration;
+	/** Number of workers inside work(). Task data is only altered
+	 * once it dropped to zero.*/
+	int m_nBusyWorkers;
+	bool m_bShutdown;
+
+	Task m_task;
+	void* m_pData;
+	int m_nTasks;
+	std::atomic<int> m_nNextTask;
+	std::atomic<int> m_nDoneTasks;
+};
+
+};
+
+#endif
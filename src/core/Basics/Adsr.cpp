@@ -277,6 +277,9 @@ void ADSR::attack()
 {
 	__state = ATTACK;
 	__ticks = 0;
+	// A release before the first frame was processed must not pick
+	// up the value of a previous note.
+	__value = 0;
 	m_fQ = fAttackInit;
 }
 
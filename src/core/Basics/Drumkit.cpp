@@ -45,10 +45,130 @@
 #include <core/Helpers/Legacy.h>
 
 #include <core/Hydrogen.h>
+#include <core/EventQueue.h>
+
+#include <sndfile.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <thread>
 
 namespace H2Core
 {
 
+#ifdef H2CORE_HAVE_LIBARCHIVE
+namespace {
+
+/** Decodes samples extracted from a drumkit archive in a separate
+ * thread while the extraction of the remaining entries is still
+ * ongoing.*/
+class SampleVerifier {
+public:
+	SampleVerifier() : m_bFinished( false )
+					 , m_nFailures( 0 )
+					 , m_thread( [this]{ run(); } ) {
+	}
+	~SampleVerifier() {
+		finish();
+	}
+
+	void add( const QString& sPath ) {
+		{
+			std::lock_guard<std::mutex> lock( m_mutex );
+			m_queue.push_back( sPath );
+		}
+		m_condition.notify_one();
+	}
+
+	/** Waits till all queued samples are verified.
+	 *
+	 * \return Number of samples which could not be decoded.*/
+	int finish() {
+		{
+			std::lock_guard<std::mutex> lock( m_mutex );
+			m_bFinished = true;
+		}
+		m_condition.notify_one();
+		if ( m_thread.joinable() ) {
+			m_thread.join();
+		}
+		return m_nFailures;
+	}
+
+	static bool isSample( const QString& sPath ) {
+		// Only formats supported by libsndfile in all its builds are
+		// checked.
+		static const QStringList suffixes = { "wav", "flac", "aif", "aiff",
+											  "aifc", "au", "caf", "w64" };
+		return suffixes.contains( QFileInfo( sPath ).suffix(),
+								  Qt::CaseInsensitive );
+	}
+
+private:
+	void run() {
+		while ( true ) {
+			QString sPath;
+			{
+				std::unique_lock<std::mutex> lock( m_mutex );
+				m_condition.wait( lock, [this]{
+					return m_bFinished || ! m_queue.empty(); } );
+				if ( m_queue.empty() ) {
+					return;
+				}
+				sPath = m_queue.front();
+				m_queue.pop_front();
+			}
+
+			if ( ! verify( sPath ) ) {
+				++m_nFailures;
+			}
+		}
+	}
+
+	static bool verify( const QString& sPath ) {
+		SF_INFO info;
+		memset( &info, 0, sizeof( info ) );
+		SNDFILE* pFile = sf_open( sPath.toLocal8Bit(), SFM_READ, &info );
+		if ( pFile == nullptr ) {
+			___ERRORLOG( QString( "Unable to open sample [%1]: %2" )
+						 .arg( sPath ).arg( sf_strerror( nullptr ) ) );
+			return false;
+		}
+
+		const int nBufferFrames = 4096;
+		std::vector<float> buffer( nBufferFrames * std::max( 1, info.channels ) );
+		sf_count_t nFrames = 0, nRead;
+		while ( ( nRead = sf_readf_float( pFile, buffer.data(),
+										  nBufferFrames ) ) > 0 ) {
+			nFrames += nRead;
+		}
+		sf_close( pFile );
+
+		if ( nFrames != info.frames ) {
+			___ERRORLOG( QString( "Sample [%1] is truncated: %2 of %3 frames decoded" )
+						 .arg( sPath ).arg( nFrames ).arg( info.frames ) );
+			return false;
+		}
+
+		return true;
+	}
+
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+	std::deque<QString> m_queue;
+	bool m_bFinished;
+	std::atomic<int> m_nFailures;
+	std::thread m_thread;
+};
+
+};
+#endif
+
 Drumkit::Drumkit() : __samples_loaded( false ),
 					 __instruments( nullptr ),
 					 __name( "empty" ),
@@ -709,7 +829,98 @@ bool Drumkit::isUserDrumkit() const {
 	return true;
 }
 	
+void Drumkit::reportProgress( int nProgress )
+{
+	// Drumkits might be installed without an engine running (e.g. by
+	// h2cli).
+	EventQueue* pEventQueue = EngineContext::current()->getEventQueue();
+	if ( pEventQueue != nullptr ) {
+		pEventQueue->push_event( EVENT_DRUMKIT_PROGRESS, nProgress );
+	}
+}
+
 bool Drumkit::install( const QString& sSourcePath, const QString& sTargetPath, bool bSilent )
+{
+	int nLastProgress = -1;
+	return installArchive( sSourcePath, sTargetPath, bSilent,
+						   [&]( int nProgress ) {
+							   if ( nProgress != nLastProgress ) {
+								   nLastProgress = nProgress;
+								   reportProgress( nProgress );
+							   }
+						   } );
+}
+
+bool Drumkit::install( const QStringList& sourcePaths, const QString& sTargetPath, bool bSilent )
+{
+	const int nArchives = sourcePaths.size();
+	if ( nArchives == 0 ) {
+		return true;
+	}
+
+	const int nThreads =
+		std::min( nArchives,
+				  std::max( 1, static_cast<int>(std::thread::hardware_concurrency()) ) );
+	if ( ! bSilent ) {
+		_INFOLOG( QString( "Installing [%1] drumkits using [%2] threads" )
+				  .arg( nArchives ).arg( nThreads ) );
+	}
+
+	std::vector<std::atomic<int>> progressPerArchive( nArchives );
+	for ( auto& nnProgress : progressPerArchive ) {
+		nnProgress = 0;
+	}
+	std::atomic<int> nNextArchive( 0 );
+	std::atomic<int> nFailures( 0 );
+	std::mutex progressMutex;
+	int nLastProgress = -1;
+
+	auto updateProgress = [&]( int nArchive, int nProgress ) {
+		progressPerArchive[ nArchive ] = nProgress;
+
+		int nSum = 0;
+		for ( const auto& nnProgress : progressPerArchive ) {
+			nSum += nnProgress;
+		}
+		const int nTotal = nSum / nArchives;
+
+		std::lock_guard<std::mutex> lock( progressMutex );
+		if ( nTotal > nLastProgress ) {
+			nLastProgress = nTotal;
+			reportProgress( nTotal );
+		}
+	};
+
+	EngineContext* pContext = EngineContext::current();
+	auto worker = [&]() {
+		EngineContext::Scope scope( pContext );
+		int nArchive;
+		while ( ( nArchive = nNextArchive++ ) < nArchives ) {
+			if ( ! installArchive( sourcePaths[ nArchive ], sTargetPath, bSilent,
+								   [&, nArchive]( int nProgress ) {
+									   updateProgress( nArchive, nProgress );
+								   } ) ) {
+				_ERRORLOG( QString( "Unable to install drumkit [%1]" )
+						   .arg( sourcePaths[ nArchive ] ) );
+				++nFailures;
+			}
+			updateProgress( nArchive, 100 );
+		}
+	};
+
+	std::vector<std::thread> threads;
+	for ( int ii = 1; ii < nThreads; ++ii ) {
+		threads.emplace_back( worker );
+	}
+	worker();
+	for ( auto& tthread : threads ) {
+		tthread.join();
+	}
+
+	return nFailures == 0;
+}
+
+bool Drumkit::installArchive( const QString& sSourcePath, const QString& sTargetPath, bool bSilent, std::function<void(int)> progress )
 {
 	if ( sTargetPath.isEmpty() ) {
 		if ( ! bSilent ) {
@@ -768,6 +979,14 @@ bool Drumkit::install( const QString& sSourcePath, const QString& sTargetPath, b
 	} else {
 		dk_dir = Filesystem::usr_drumkits_dir() + "/";
 	}
+
+	// Used to estimate the progress of the extraction.
+	const qint64 nArchiveSize = std::max( QFileInfo( sSourcePath ).size(),
+										  static_cast<qint64>(1) );
+
+	// Samples are handed over to the verifier as soon as they are
+	// written to disk.
+	SampleVerifier verifier;
 		
 	while ( ( r = archive_read_next_header( arch, &entry ) ) != ARCHIVE_EOF ) {
 		if ( r != ARCHIVE_OK ) {
@@ -779,21 +998,78 @@ bool Drumkit::install( const QString& sSourcePath, const QString& sTargetPath, b
 		}
 		QString np = dk_dir + archive_entry_pathname( entry );
 
-		QByteArray newpath = np.toLocal8Bit();
+		if ( archive_entry_filetype( entry ) == AE_IFREG ) {
+			// Regular files are streamed block by block into their
+			// destination.
+			QFileInfo info( np );
+			if ( ! QDir().mkpath( info.absolutePath() ) ) {
+				_ERRORLOG( QString( "Unable to create folder [%1]" )
+						   .arg( info.absolutePath() ) );
+				ret = false;
+				break;
+			}
+			QFile file( np );
+			if ( ! file.open( QIODevice::WriteOnly | QIODevice::Truncate ) ) {
+				_ERRORLOG( QString( "Unable to write [%1]: %2" )
+						   .arg( np ).arg( file.errorString() ) );
+				ret = false;
+				break;
+			}
 
-		archive_entry_set_pathname( entry, newpath.data() );
-		r = archive_read_extract( arch, entry, 0 );
-		if ( r == ARCHIVE_WARN ) {
-			_WARNINGLOG( QString( "archive_read_extract() [%1] %2" )
-						 .arg( archive_errno( arch ) )
-						 .arg( archive_error_string( arch ) ) );
-		} else if ( r != ARCHIVE_OK ) {
-			_ERRORLOG( QString( "archive_read_extract() [%1] %2" )
-					   .arg( archive_errno( arch ) )
-					   .arg( archive_error_string( arch ) ) );
-			ret = false;
-			break;
+			const void* pBuffer;
+			size_t nSize;
+#if ARCHIVE_VERSION_NUMBER < 3000000
+			off_t nOffset;
+#else
+			la_int64_t nOffset;
+#endif
+			while ( ( r = archive_read_data_block( arch, &pBuffer, &nSize,
+												   &nOffset ) ) == ARCHIVE_OK ) {
+				if ( ! file.seek( nOffset ) ||
+					 file.write( static_cast<const char*>(pBuffer),
+								 nSize ) != static_cast<qint64>(nSize) ) {
+					r = ARCHIVE_FATAL;
+					break;
+				}
+			}
+			file.close();
+			if ( r != ARCHIVE_EOF ) {
+				_ERRORLOG( QString( "Unable to extract [%1]: [%2] %3" )
+						   .arg( np )
+						   .arg( archive_errno( arch ) )
+						   .arg( archive_error_string( arch ) ) );
+				ret = false;
+				break;
+			}
+
+			if ( SampleVerifier::isSample( np ) ) {
+				verifier.add( np );
+			}
+		} else {
+			QByteArray newpath = np.toLocal8Bit();
+
+			archive_entry_set_pathname( entry, newpath.data() );
+			r = archive_read_extract( arch, entry, 0 );
+			if ( r == ARCHIVE_WARN ) {
+				_WARNINGLOG( QString( "archive_read_extract() [%1] %2" )
+							 .arg( archive_errno( arch ) )
+							 .arg( archive_error_string( arch ) ) );
+			} else if ( r != ARCHIVE_OK ) {
+				_ERRORLOG( QString( "archive_read_extract() [%1] %2" )
+						   .arg( archive_errno( arch ) )
+						   .arg( archive_error_string( arch ) ) );
+				ret = false;
+				break;
+			}
 		}
+
+#if ARCHIVE_VERSION_NUMBER < 3000000
+		const qint64 nBytesRead = archive_position_compressed( arch );
+#else
+		const qint64 nBytesRead = archive_filter_bytes( arch, -1 );
+#endif
+		// 100 is reported only once the samples are verified.
+		progress( std::min( static_cast<int>(nBytesRead * 100 / nArchiveSize), 99 ) );
 	}
 	archive_read_close( arch );
 
@@ -803,6 +1079,17 @@ bool Drumkit::install( const QString& sSourcePath, const QString& sTargetPath, b
 	archive_read_free( arch );
 #endif
 
+	const int nCorruptSamples = verifier.finish();
+	if ( nCorruptSamples > 0 ) {
+		_ERRORLOG( QString( "[%1] samples of drumkit [%2] could not be decoded" )
+				   .arg( nCorruptSamples ).arg( sSourcePath ) );
+		ret = false;
+	}
+
+	if ( ret ) {
+		progress( 100 );
+	}
+
 	return ret;
 #else // H2CORE_HAVE_LIBARCHIVE
 #ifndef WIN32
@@ -854,6 +1141,9 @@ bool Drumkit::install( const QString& sSourcePath, const QString& sTargetPath, b
 				   .arg( QString::fromLocal8Bit( strerror( errno ) ) ) );
 		ret = false;
 	}
+	if ( ret ) {
+		progress( 100 );
+	}
 	return ret;
 #else // WIN32
 	_ERRORLOG( "WIN32 NOT IMPLEMENTED" );
@@ -1031,10 +1321,6 @@ bool Drumkit::exportTo( const QString& sTargetDir, const QString& sComponentName
 
 	struct archive *a;
 	struct archive_entry *entry;
-	struct stat st;
-	char buff[8192];
-	int len;
-	FILE *f;
 
 	a = archive_write_new();
 
@@ -1054,38 +1340,92 @@ bool Drumkit::exportTo( const QString& sTargetDir, const QString& sComponentName
 		return false;
 	}
 
-	bool bFoundFileInRightComponent;
+	// Small sanity check since the libarchive code won't fail
+	// gracefully but segfaults if the provided file does not
+	// exist.
 	for ( const auto& sFilename : filesUsed ) {
-		QFileInfo ffileInfo( sFilename );
-		QString sTargetFilename = sDrumkitName + "/" + ffileInfo.fileName();
-
-		// Small sanity check since the libarchive code won't fail
-		// gracefully but segfaults if the provided file does not
-		// exist.
 		if ( ! Filesystem::file_readable( sFilename, true ) ) {
 			ERRORLOG( QString( "Unable to export drumkit. File [%1] does not exists or is not readable." )
 					  .arg( sFilename ) );
+			archive_write_close(a);
+	#if ARCHIVE_VERSION_NUMBER < 3000000
+			archive_write_finish(a);
+	#else
+			archive_write_free(a);
+	#endif
 			set_name( sOldDrumkitName );
 			return false;
 		}
+	}
+
+	// The content of the next file is read in a separate thread
+	// while the current one is compressed.
+	auto readFile = []( const QString& sFilename ) -> std::optional<QByteArray> {
+		QFile file( sFilename );
+		if ( ! file.open( QIODevice::ReadOnly ) ) {
+			return std::nullopt;
+		}
+		const QByteArray content = file.readAll();
+		if ( file.error() != QFileDevice::NoError ) {
+			return std::nullopt;
+		}
+		return content;
+	};
+
+	std::future<std::optional<QByteArray>> nextContent;
+	if ( filesUsed.size() > 0 ) {
+		nextContent = std::async( std::launch::async, readFile, filesUsed[ 0 ] );
+	}
+
+	bool bSuccess = true;
+	for ( int ii = 0; ii < filesUsed.size(); ++ii ) {
+		const QString& sFilename = filesUsed[ ii ];
+		QFileInfo ffileInfo( sFilename );
+		QString sTargetFilename = sDrumkitName + "/" + ffileInfo.fileName();
+
+		const auto content = nextContent.get();
+		if ( ! content ) {
+			ERRORLOG( QString( "Unable to export drumkit. File [%1] could not be read." )
+					  .arg( sFilename ) );
+			bSuccess = false;
+			break;
+		}
+		if ( ii + 1 < filesUsed.size() ) {
+			nextContent = std::async( std::launch::async, readFile,
+									  filesUsed[ ii + 1 ] );
+		}
 
-		stat( sFilename.toUtf8().constData(), &st );
 		entry = archive_entry_new();
 		archive_entry_set_pathname(entry, sTargetFilename.toUtf8().constData());
-		archive_entry_set_size(entry, st.st_size);
+		archive_entry_set_size(entry, content->size());
 		archive_entry_set_filetype(entry, AE_IFREG);
 		archive_entry_set_perm(entry, 0644);
-		archive_write_header(a, entry);
-		f = fopen( sFilename.toUtf8().constData(), "rb" );
-		len = fread(buff, sizeof(char), sizeof(buff), f);
-		while ( len > 0 ) {
-				archive_write_data(a, buff, len);
-				len = fread(buff, sizeof(char), sizeof(buff), f);
+		ret = archive_write_header(a, entry);
+		if ( ret == ARCHIVE_OK && content->size() > 0 &&
+			 archive_write_data(a, content->constData(), content->size()) !=
+			 content->size() ) {
+			ret = ARCHIVE_FATAL;
 		}
-		fclose(f);
 		archive_entry_free(entry);
+		if ( ret != ARCHIVE_OK ) {
+			ERRORLOG( QString( "Unable to export drumkit. File [%1] could not be added to [%2]: %3" )
+					  .arg( sFilename ).arg( sTargetName )
+					  .arg( archive_error_string( a ) ) );
+			bSuccess = false;
+			break;
+		}
+
+		reportProgress( ( ii + 1 ) * 100 / filesUsed.size() );
+	}
+	if ( nextContent.valid() ) {
+		// Do not leave a pending read behind after an abort.
+		nextContent.wait();
+	}
+	if ( archive_write_close(a) != ARCHIVE_OK && bSuccess ) {
+		ERRORLOG( QString( "Unable to finish archive [%1]: %2" )
+				  .arg( sTargetName ).arg( archive_error_string( a ) ) );
+		bSuccess = false;
 	}
-	archive_write_close(a);
 
 	#if ARCHIVE_VERSION_NUMBER < 3000000
 		archive_write_finish(a);
@@ -1093,6 +1433,13 @@ bool Drumkit::exportTo( const QString& sTargetDir, const QString& sComponentName
 		archive_write_free(a);
 	#endif
 
+	if ( ! bSuccess ) {
+		// Do not leave an incomplete archive behind.
+		QFile::remove( sTargetName );
+		set_name( sOldDrumkitName );
+		return false;
+	}
+
 	sourceFilesList.clear();
 
 	// Only clean up the temp folder when everything was
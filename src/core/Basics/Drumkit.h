@@ -28,6 +28,8 @@
 #include <core/License.h>
 #include <core/Basics/InstrumentList.h>
 
+#include <functional>
+
 namespace H2Core
 {
 
@@ -265,9 +267,31 @@ class Drumkit : public H2Core::Object<Drumkit>
 		 * \param bSilent Whether debug and info messages should be
 		 * logged.
 		 *
+		 * While extracting, the progress (in percent) is reported
+		 * using #EVENT_DRUMKIT_PROGRESS. Extracted samples are decoded in a
+		 * separate thread in order to verify them without blocking
+		 * the extraction of the remaining entries.
+		 *
 		 * \return true on success
 		 */
 	static bool install( const QString& sSourcePath, const QString& sTargetPath = "", bool bSilent = false );
+	/**
+	 * Extracts several .h2drumkit files concurrently.
+	 *
+	 * The archives are distributed among a number of threads bounded
+	 * by the number of available cores. The overall progress is
+	 * reported using #EVENT_DRUMKIT_PROGRESS.
+	 *
+	 * \param sourcePaths Absolute paths to the drumkit archives
+	 * \param sTargetPath Absolute path to where the drumkits should
+	 * be extracted to. If left empty, the user's drumkit folder will
+	 * be used.
+	 * \param bSilent Whether debug and info messages should be
+	 * logged.
+	 *
+	 * \return true in case all archives were installed successfully.
+	 */
+	static bool install( const QStringList& sourcePaths, const QString& sTargetPath = "", bool bSilent = false );
 
 	/**
 	 * Compresses the drumkit into a .h2drumkit file.
@@ -288,7 +312,9 @@ class Drumkit : public H2Core::Object<Drumkit>
 	 * \param bSilent Whether debug and info messages should be
 	 * logged.
 	 *
-	 * \return true on success 
+	 * \return true on success. In case one of the files could not
+	 * be read or written, the export is aborted and no archive is
+	 * left behind.
 	 */
 	bool exportTo( const QString& sTargetDir, const QString& sComponentName = "", bool bRecentVersion = true, bool bSilent = false );
 		/**
@@ -369,6 +395,17 @@ class Drumkit : public H2Core::Object<Drumkit>
 		QString toQString( const QString& sPrefix, bool bShort = true ) const override;
 
 	private:
+		/**
+		 * Does the actual work of install().
+		 *
+		 * \param progress Called with the progress of the extraction
+		 * in percent.
+		 */
+		static bool installArchive( const QString& sSourcePath, const QString& sTargetPath, bool bSilent, std::function<void(int)> progress );
+		/** Pushes #EVENT_DRUMKIT_PROGRESS in case the current EngineContext
+		 * holds an EventQueue.*/
+		static void reportProgress( int nProgress );
+
 		QString __path;					///< absolute drumkit path
 		QString __name;					///< drumkit name
 		QString __author;				///< drumkit author
@@ -22,7 +22,9 @@
 
 #include <core/Basics/DrumkitComponent.h>
 
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <memory>
 
 #include <core/Hydrogen.h>
@@ -50,11 +52,12 @@ DrumkitComponent::DrumkitComponent( const int id, const QString& name )
 	, __soloed( false )
 	, __out_L( nullptr )
 	, __out_R( nullptr )
-	, __peak_l( 0.0 )
-	, __peak_r( 0.0 )
+	, __active_frames( 0 )
 {
 	__out_L = new float[ MAX_BUFFER_SIZE ];
 	__out_R = new float[ MAX_BUFFER_SIZE ];
+	memset( __out_L, 0, MAX_BUFFER_SIZE * sizeof( float ) );
+	memset( __out_R, 0, MAX_BUFFER_SIZE * sizeof( float ) );
 }
 
 DrumkitComponent::DrumkitComponent( DrumkitComponent* other )
@@ -65,11 +68,12 @@ DrumkitComponent::DrumkitComponent( DrumkitComponent* other )
 	, __soloed( other->__soloed )
 	, __out_L( nullptr )
 	, __out_R( nullptr )
-	, __peak_l( 0.0 )
-	, __peak_r( 0.0 )
+	, __active_frames( 0 )
 {
 	__out_L = new float[ MAX_BUFFER_SIZE ];
 	__out_R = new float[ MAX_BUFFER_SIZE ];
+	memset( __out_L, 0, MAX_BUFFER_SIZE * sizeof( float ) );
+	memset( __out_R, 0, MAX_BUFFER_SIZE * sizeof( float ) );
 }
 
 DrumkitComponent::~DrumkitComponent()
@@ -80,8 +84,13 @@ DrumkitComponent::~DrumkitComponent()
 
 void DrumkitComponent::reset_outs( uint32_t nFrames )
 {
-	memset( __out_L, 0, nFrames * sizeof( float ) );
-	memset( __out_R, 0, nFrames * sizeof( float ) );
+	// Only the part written to since the last reset has to be
+	// cleared. Silent components are skipped altogether.
+	if ( __active_frames > 0 ) {
+		memset( __out_L, 0, __active_frames * sizeof( float ) );
+		memset( __out_R, 0, __active_frames * sizeof( float ) );
+		__active_frames = 0;
+	}
 }
 
 float DrumkitComponent::get_out_L( int nBufferPos )
@@ -135,9 +144,7 @@ QString DrumkitComponent::toQString( const QString& sPrefix, bool bShort ) const
 			.append( QString( "%1%2name: %3\n" ).arg( sPrefix ).arg( s ).arg( __name ) )
 			.append( QString( "%1%2volume: %3\n" ).arg( sPrefix ).arg( s ).arg( __volume ) )
 			.append( QString( "%1%2muted: %3\n" ).arg( sPrefix ).arg( s ).arg( __muted ) )
-			.append( QString( "%1%2soloed: %3\n" ).arg( sPrefix ).arg( s ).arg( __soloed ) )
-			.append( QString( "%1%2peak_l: %3\n" ).arg( sPrefix ).arg( s ).arg( __peak_l ) )
-			.append( QString( "%1%2peak_r: %3\n" ).arg( sPrefix ).arg( s ).arg( __peak_r ) );
+			.append( QString( "%1%2soloed: %3\n" ).arg( sPrefix ).arg( s ).arg( __soloed ) );
 	} else {
 
 		sOutput = QString( "[DrumkitComponent]" )
@@ -145,9 +152,7 @@ QString DrumkitComponent::toQString( const QString& sPrefix, bool bShort ) const
 			.append( QString( ", name: %1" ).arg( __name ) )
 			.append( QString( ", volume: %1" ).arg( __volume ) )
 			.append( QString( ", muted: %1" ).arg( __muted ) )
-			.append( QString( ", soloed: %1" ).arg( __soloed ) )
-			.append( QString( ", peak_l: %1" ).arg( __peak_l ) )
-			.append( QString( ", peak_r: %1" ).arg( __peak_r ) );
+			.append( QString( ", soloed: %1" ).arg( __soloed ) );
 	}
 	return sOutput;
 }
@@ -26,6 +26,7 @@
 #include <cassert>
 #include <inttypes.h>
 #include <core/Object.h>
+#include <core/AudioEngine/Meter.h>
 
 namespace H2Core
 {
@@ -64,13 +65,17 @@ class DrumkitComponent : public H2Core::Object<DrumkitComponent>
 		void						set_soloed( bool soloed );
 		bool						is_soloed() const;
 
-		void						set_peak_l( float val );
-		float						get_peak_l() const;
-		void						set_peak_r( float val );
-		float						get_peak_r() const;
+		/** Level meter fed by the Sampler while rendering notes
+		 * into the component.*/
+		Meter&						get_meter();
 
 		void						reset_outs( uint32_t nFrames );
 		void						set_outs( int nBufferPos, float valL, float valR );
+		/** Marks the first @a nFrames frames of the output buffers
+		 * as written to. Has to be called by everyone using
+		 * set_outs() in order for reset_outs() to take them into
+		 * account.*/
+		void						mark_outs( uint32_t nFrames );
 		float						get_out_L( int nBufferPos );
 		float						get_out_R( int nBufferPos );
 		/** Formatted string version for debugging purposes.
@@ -91,11 +96,13 @@ class DrumkitComponent : public H2Core::Object<DrumkitComponent>
 		bool		__muted;
 		bool		__soloed;
 
-		float		__peak_l;
-		float		__peak_r;
+		Meter		__meter;
 
 		float *		__out_L;
 		float *		__out_R;
+		/** Number of frames at the beginning of #__out_L and
+		 * #__out_R written to since the last reset_outs().*/
+		uint32_t	__active_frames;
 };
 
 // DEFINITIONS
@@ -152,24 +159,9 @@ inline bool DrumkitComponent::is_soloed() const
 	return __soloed;
 }
 
-inline void DrumkitComponent::set_peak_l( float val )
+inline Meter& DrumkitComponent::get_meter()
 {
-	__peak_l = val;
-}
-
-inline float DrumkitComponent::get_peak_l() const
-{
-	return __peak_l;
-}
-
-inline void DrumkitComponent::set_peak_r( float val )
-{
-	__peak_r = val;
-}
-
-inline float DrumkitComponent::get_peak_r() const
-{
-	return __peak_r;
+	return __meter;
 }
 
 inline void DrumkitComponent::set_outs( int nBufferPos, float valL, float valR )
@@ -178,6 +170,13 @@ inline void DrumkitComponent::set_outs( int nBufferPos, float valL, float valR )
 	__out_R[nBufferPos] += valR;
 }
 
+inline void DrumkitComponent::mark_outs( uint32_t nFrames )
+{
+	if ( nFrames > __active_frames ) {
+		__active_frames = nFrames;
+	}
+}
+
 };
 
 #endif
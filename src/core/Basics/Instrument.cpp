@@ -48,8 +48,6 @@ Instrument::Instrument( const int id, const QString& name, std::shared_ptr<ADSR>
 	, __gain( 1.0 )
 	, __volume( 1.0 )
 	, m_fPan( 0.f )
-	, __peak_l( 0.0 )
-	, __peak_r( 0.0 )
 	, __adsr( adsr )
 	, __filter_active( false )
 	, __filter_cutoff( 1.0 )
@@ -99,8 +97,6 @@ Instrument::Instrument( std::shared_ptr<Instrument> other )
 	, __gain( other->__gain )
 	, __volume( other->get_volume() )
 	, m_fPan( other->getPan() )
-	, __peak_l( other->get_peak_l() )
-	, __peak_r( other->get_peak_r() )
 	, __adsr( std::make_shared<ADSR>( *( other->get_adsr() ) ) )
 	, __filter_active( other->is_filter_active() )
 	, __filter_cutoff( other->get_filter_cutoff() )
@@ -202,10 +198,30 @@ void Instrument::load_from( Drumkit* pDrumkit, std::shared_ptr<Instrument> pInst
 		}
 	}
 
-	this->set_id( pInstrument->get_id() );
-	this->set_name( pInstrument->get_name() );
 	this->set_drumkit_name( pDrumkit->get_name() );
 	this->set_drumkit_lookup( lookup );
+	load_parameters_from( pInstrument );
+}
+
+void Instrument::swap_from( std::shared_ptr<Instrument> pInstrument )
+{
+	if ( pInstrument == nullptr ) {
+		ERRORLOG( "Invalid instrument supplied" );
+		return;
+	}
+
+	std::swap( __components, pInstrument->__components );
+
+	this->set_missing_samples( pInstrument->has_missing_samples() );
+	this->set_drumkit_name( pInstrument->get_drumkit_name() );
+	this->set_drumkit_lookup( pInstrument->get_drumkit_lookup() );
+	load_parameters_from( pInstrument );
+}
+
+void Instrument::load_parameters_from( std::shared_ptr<Instrument> pInstrument )
+{
+	this->set_id( pInstrument->get_id() );
+	this->set_name( pInstrument->get_name() );
 	this->set_gain( pInstrument->get_gain() );
 	this->set_volume( pInstrument->get_volume() );
 	this->setPan( pInstrument->getPan() );
@@ -571,8 +587,6 @@ QString Instrument::toQString( const QString& sPrefix, bool bShort ) const {
 			.append( QString( "%1%2gain: %3\n" ).arg( sPrefix ).arg( s ).arg( __gain ) )
 			.append( QString( "%1%2volume: %3\n" ).arg( sPrefix ).arg( s ).arg( __volume ) )
 			.append( QString( "%1%2pan: %3\n" ).arg( sPrefix ).arg( s ).arg( m_fPan ) )
-			.append( QString( "%1%2peak_l: %3\n" ).arg( sPrefix ).arg( s ).arg( __peak_l ) )
-			.append( QString( "%1%2peak_r: %3\n" ).arg( sPrefix ).arg( s ).arg( __peak_r ) )
 			.append( QString( "%1" ).arg( __adsr->toQString( sPrefix + s, bShort ) ) )
 			.append( QString( "%1%2filter_active: %3\n" ).arg( sPrefix ).arg( s ).arg( __filter_active ) )
 			.append( QString( "%1%2filter_cutoff: %3\n" ).arg( sPrefix ).arg( s ).arg( __filter_cutoff ) )
@@ -616,8 +630,6 @@ QString Instrument::toQString( const QString& sPrefix, bool bShort ) const {
 			.append( QString( ", gain: %1" ).arg( __gain ) )
 			.append( QString( ", volume: %1" ).arg( __volume ) )
 			.append( QString( ", pan: %1" ).arg( m_fPan ) )
-			.append( QString( ", peak_l: %1" ).arg( __peak_l ) )
-			.append( QString( ", peak_r: %1" ).arg( __peak_r ) )
 			.append( QString( ", [%1" ).arg( __adsr->toQString( sPrefix + s, bShort ).replace( "\n", "]" ) ) )
 			.append( QString( ", filter_active: %1" ).arg( __filter_active ) )
 			.append( QString( ", filter_cutoff: %1" ).arg( __filter_cutoff ) )
@@ -27,6 +27,7 @@
 #include <memory>
 
 #include <core/Object.h>
+#include <core/AudioEngine/Meter.h>
 #include <core/Basics/Adsr.h>
 #include <core/Helpers/Filesystem.h>
 #include <core/License.h>
@@ -101,6 +102,21 @@ class Instrument : public H2Core::Object<Instrument>
 		 */
 		void load_from( Drumkit* drumkit, std::shared_ptr<Instrument> instrument, Filesystem::Lookup lookup = Filesystem::Lookup::stacked );
 
+		/**
+		 * Takes over the components - including their already
+		 * loaded samples - and all parameters of @a pInstrument.
+		 *
+		 * In contrast to load_from() no samples are read from disk
+		 * and no layers are allocated. This makes it cheap enough
+		 * to be called while the AudioEngine is locked. Afterwards
+		 * @a pInstrument holds the previous components of this
+		 * instrument. They will be freed as soon as @a pInstrument
+		 * is destroyed, which should happen after unlocking.
+		 *
+		 * \param pInstrument Instrument prepared using load_from().
+		 */
+		void swap_from( std::shared_ptr<Instrument> pInstrument );
+
 		/**
 		 * Calls the InstrumentLayer::load_sample() member
 		 * function of all layers of each component of the
@@ -224,14 +240,8 @@ class Instrument : public H2Core::Object<Instrument>
 		/** get the filter cutoff of the instrument */
 		float get_filter_cutoff() const;
 
-		/** set the left peak of the instrument */
-		void set_peak_l( float val );
-		/** get the left peak of the instrument */
-		float get_peak_l() const;
-		/** set the right peak of the instrument */
-		void set_peak_r( float val );
-		/** get the right peak of the instrument */
-		float get_peak_r() const;
+		/** level meter of the instrument, fed by the Sampler */
+		Meter& get_meter();
 
 		/** set the fx level of the instrument */
 		void set_fx_level( float level, int index );
@@ -320,6 +330,10 @@ class Instrument : public H2Core::Object<Instrument>
 		QString toQString( const QString& sPrefix, bool bShort = true ) const override;
 
 	private:
+		/** Copies all parameters except for the components, the
+		 * drumkit name, and the lookup of @a pInstrument.*/
+		void load_parameters_from( std::shared_ptr<Instrument> pInstrument );
+
 	        /** Identifier of an instrument, which should be
 		    unique. It is set by set_id() and accessed via
 	        get_id().*/
@@ -332,8 +346,7 @@ class Instrument : public H2Core::Object<Instrument>
 	float					__gain;					///< gain of the instrument
 		float					__volume;				///< volume of the instrument
 		float					m_fPan;	///< pan of the instrument, [-1;1] from left to right, as requested by Sampler PanLaws
-		float					__peak_l;				///< left current peak value
-		float					__peak_r;				///< right current peak value
+		Meter					__meter;				///< peak and RMS of the rendered notes
 		std::shared_ptr<ADSR>					__adsr;					///< attack delay sustain release instance
 		bool					__filter_active;		///< is filter active?
 		float					__filter_cutoff;		///< filter cutoff (0..1)
@@ -515,24 +528,9 @@ inline float Instrument::get_filter_cutoff() const
 	return __filter_cutoff;
 }
 
-inline void Instrument::set_peak_l( float val )
-{
-	__peak_l = val;
-}
-
-inline float Instrument::get_peak_l() const
-{
-	return __peak_l;
-}
-
-inline void Instrument::set_peak_r( float val )
-{
-	__peak_r = val;
-}
-
-inline float Instrument::get_peak_r() const
+inline Meter& Instrument::get_meter()
 {
-	return __peak_r;
+	return __meter;
 }
 
 inline void Instrument::set_fx_level( float level, int index )
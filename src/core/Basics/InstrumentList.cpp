@@ -107,6 +107,52 @@ InstrumentList* InstrumentList::load_from( XMLNode* pNode, const QString& sDrumk
 	return pInstrumentList;
 }
 
+InstrumentList* InstrumentList::load_from( XMLStreamReader* pReader, const QString& sDrumkitPath, const QString& sDrumkitName, const License& license, bool bSilent )
+{
+	InstrumentList* pInstrumentList = new InstrumentList();
+	int nCount = 0;
+	while ( pReader->readNextStartElement() ) {
+		if ( pReader->name() != QLatin1String( "instrument" ) ) {
+			pReader->skipCurrentElement();
+			continue;
+		}
+		if ( nCount >= MAX_INSTRUMENTS ) {
+			ERRORLOG( QString( "instrument nCount >= %1 (MAX_INSTRUMENTS), stop reading instruments" )
+					  .arg( MAX_INSTRUMENTS ) );
+			// Move past the end of the list.
+			pReader->skipCurrentElement();
+			while ( pReader->readNextStartElement() ) {
+				pReader->skipCurrentElement();
+			}
+			break;
+		}
+		nCount++;
+
+		// Only the DOM of a single instrument is held in memory at a
+		// time.
+		XMLDoc doc;
+		XMLNode instrumentNode = pReader->read_node( &doc );
+		auto pInstrument = Instrument::load_from( &instrumentNode, sDrumkitPath,
+												  sDrumkitName, license, bSilent );
+		if ( pInstrument != nullptr ) {
+			( *pInstrumentList ) << pInstrument;
+		}
+		else {
+			ERRORLOG( QString( "Unable to load instrument [%1]. The drumkit is corrupted. Skipping instrument" )
+					  .arg( nCount ) );
+			nCount--;
+		}
+	}
+
+	if ( nCount == 0 ) {
+		ERRORLOG( "Newly created instrument list does not contain any instruments. Aborting." );
+		delete pInstrumentList;
+		return nullptr;
+	}
+
+	return pInstrumentList;
+}
+
 void InstrumentList::save_to( XMLNode* node, int component_id, bool bRecentVersion, bool bFull )
 {
 	XMLNode instruments_node = node->createNode( "instrumentList" );
@@ -32,6 +32,7 @@ namespace H2Core
 {
 
 class XMLNode;
+class XMLStreamReader;
 class Instrument;
 class DrumkitComponent;
 
@@ -200,6 +201,28 @@ class InstrumentList : public H2Core::Object<InstrumentList>
 									  const QString& dk_name,
 									  const License& license = License(),
 									  bool bSilent = false );
+	/**
+	 * load an instrument list from the current 'instrumentList'
+	 * element of an XMLStreamReader.
+	 *
+	 * The instruments themselves are read one at a time using the
+	 * XMLNode-based Instrument::load_from() in order to retain its
+	 * legacy handling.
+	 *
+	 * \param pReader the reader positioned at the 'instrumentList' element
+	 * \param dk_path
+	 * \param dk_name
+	 * \param license License assigned to all Samples that will be
+	 * loaded. If empty, the license will be read from @a dk_path.
+	 * \param bSilent if set to true, all log messages except of
+	 * errors and warnings are suppressed.
+	 *
+	 * \return a new InstrumentList instance
+	 */
+	static InstrumentList* load_from( XMLStreamReader* pReader, const QString& dk_path,
+									  const QString& dk_name,
+									  const License& license = License(),
+									  bool bSilent = false );
 	/**
 	 * Returns vector of lists containing instrument name, component
 	 * name, file name, the license of all associated samples.
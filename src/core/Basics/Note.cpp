@@ -24,6 +24,8 @@
 
 #include <cassert>
 
+#include <QLocale>
+
 #include <core/Helpers/Xml.h>
 #include <core/AudioEngine/AudioEngine.h>
 #include <core/Basics/Adsr.h>
@@ -452,6 +454,78 @@ Note* Note::load_from( XMLNode* node, InstrumentList* instruments, bool bSilent
 	return note;
 }
 
+Note* Note::load_from( XMLStreamReader* pReader, InstrumentList* instruments, bool bSilent )
+{
+	int nPosition = 0;
+	int nLength = -1;
+	int nInstrumentId = EMPTY_INSTR_ID;
+	float fVelocity = 0.8f;
+	float fPan = 0.f;
+	float fPitch = 0.f;
+	float fLeadLag = 0.f;
+	float fProbability = 1.0f;
+	// Pan in the old fashion (version <= 1.1)
+	float fPanL = 1.f;
+	float fPanR = 1.f;
+	bool bPanFound = false;
+	int nOldPanFound = 0;
+	bool bNoteOff = false;
+	QString sKey = "C0";
+
+	while ( pReader->readNextStartElement() ) {
+		const auto sName = pReader->name();
+		if ( sName == QLatin1String( "position" ) ) {
+			nPosition = pReader->read_int( nPosition );
+		} else if ( sName == QLatin1String( "leadlag" ) ) {
+			fLeadLag = pReader->read_float( fLeadLag );
+		} else if ( sName == QLatin1String( "velocity" ) ) {
+			fVelocity = pReader->read_float( fVelocity );
+		} else if ( sName == QLatin1String( "pan" ) ) {
+			const QString sPan = pReader->read_string();
+			if ( ! sPan.isEmpty() ) {
+				fPan = QLocale::c().toFloat( sPan );
+				bPanFound = true;
+			}
+		} else if ( sName == QLatin1String( "pan_L" ) ) {
+			fPanL = pReader->read_float( fPanL );
+			++nOldPanFound;
+		} else if ( sName == QLatin1String( "pan_R" ) ) {
+			fPanR = pReader->read_float( fPanR );
+			++nOldPanFound;
+		} else if ( sName == QLatin1String( "pitch" ) ) {
+			fPitch = pReader->read_float( fPitch );
+		} else if ( sName == QLatin1String( "key" ) ) {
+			sKey = pReader->read_string( sKey );
+		} else if ( sName == QLatin1String( "length" ) ) {
+			nLength = pReader->read_int( nLength );
+		} else if ( sName == QLatin1String( "instrument" ) ) {
+			nInstrumentId = pReader->read_int( nInstrumentId );
+		} else if ( sName == QLatin1String( "note_off" ) ) {
+			bNoteOff = pReader->read_bool( bNoteOff );
+		} else if ( sName == QLatin1String( "probability" ) ) {
+			fProbability = pReader->read_float( fProbability );
+		} else {
+			pReader->skipCurrentElement();
+		}
+	}
+
+	if ( ! bPanFound && nOldPanFound == 2 ) {
+		fPan = Sampler::getRatioPan( fPanL, fPanR );  // convert to single pan parameter
+	}
+
+	Note* note = new Note( nullptr, nPosition, fVelocity, fPan, nLength, fPitch );
+	note->set_lead_lag( fLeadLag );
+	note->set_key_octave( sKey );
+	note->set_note_off( bNoteOff );
+	note->set_instrument_id( nInstrumentId );
+	if ( instruments != nullptr ) {
+		note->map_instrument( instruments );
+	}
+	note->set_probability( fProbability );
+
+	return note;
+}
+
 QString Note::toQString( const QString& sPrefix, bool bShort ) const {
 	QString s = Base::sPrintIndention;
 	QString sOutput;
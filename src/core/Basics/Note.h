@@ -54,6 +54,7 @@ namespace H2Core
 {
 
 class XMLNode;
+class XMLStreamReader;
 class ADSR;
 class Instrument;
 class InstrumentList;
@@ -118,6 +119,16 @@ class Note : public H2Core::Object<Note>
 		 * \return a new Note instance
 		 */
 	static Note* load_from( XMLNode* node, InstrumentList* instruments, bool bSilent = false );
+		/**
+		 * load a note from the current 'note' element of an
+		 * XMLStreamReader
+		 * \param pReader the reader positioned at the 'note' element
+		 * \param instruments the current instrument list to search instrument into
+		 * \param bSilent Whether infos, warnings, and errors should
+		 * be logged.
+		 * \return a new Note instance
+		 */
+	static Note* load_from( XMLStreamReader* pReader, InstrumentList* instruments, bool bSilent = false );
 
 		/**
 		 * find the corresponding instrument and point to it, or an empty instrument
@@ -30,6 +30,7 @@
 #include <core/Hydrogen.h>
 
 #include <core/Helpers/Filesystem.h>
+#include <core/Helpers/LibraryIndex.h>
 #include <core/Helpers/Legacy.h>
 
 namespace H2Core
@@ -107,15 +108,30 @@ Pattern* Pattern::load_file( const QString& sPatternPath, InstrumentList* pInstr
 {
 	INFOLOG( QString( "Load pattern %1" ).arg( sPatternPath ) );
 
-	XMLDoc doc;
-	if ( ! loadDoc( sPatternPath, pInstrumentList, &doc, false ) ) {
-		// Try former pattern version
-		return Legacy::load_drumkit_pattern( sPatternPath, pInstrumentList );
+	// Patterns not complying with the current schema are handled by
+	// the legacy code.
+	XMLStreamReader reader;
+	if ( Filesystem::file_readable( sPatternPath, false ) &&
+		 reader.read( sPatternPath, Filesystem::pattern_xsd_path() ) &&
+		 reader.readNextStartElement() &&
+		 reader.name() == QLatin1String( "drumkit_pattern" ) ) {
+		while ( reader.readNextStartElement() ) {
+			if ( reader.name() == QLatin1String( "pattern" ) ) {
+				Pattern* pPattern = load_from( &reader, pInstrumentList );
+				if ( ! reader.hasError() ) {
+					return pPattern;
+				}
+				delete pPattern;
+				break;
+			}
+			reader.skipCurrentElement();
+		}
+		ERRORLOG( QString( "'pattern' node not found in [%1]" )
+				  .arg( sPatternPath ) );
 	}
 
-	XMLNode root = doc.firstChildElement( "drumkit_pattern" );
-	XMLNode pattern_node = root.firstChildElement( "pattern" );
-	return load_from( &pattern_node, pInstrumentList );
+	// Try former pattern version
+	return Legacy::load_drumkit_pattern( sPatternPath, pInstrumentList );
 }
 
 Pattern* Pattern::load_from( XMLNode* node, InstrumentList* pInstrumentList, bool bSilent )
@@ -149,6 +165,52 @@ Pattern* Pattern::load_from( XMLNode* node, InstrumentList* pInstrumentList, boo
 	return pPattern;
 }
 
+Pattern* Pattern::load_from( XMLStreamReader* pReader, InstrumentList* pInstrumentList, bool bSilent )
+{
+	QString sName, sInfo;
+	QString sCategory = "unknown";
+	int nSize = -1;
+	int nDenominator = 4;
+	std::vector<Note*> notes;
+
+	if ( pInstrumentList == nullptr ) {
+		ERRORLOG( "Invalid instrument list provided" );
+	}
+
+	while ( pReader->readNextStartElement() ) {
+		const auto sElement = pReader->name();
+		if ( sElement == QLatin1String( "name" ) ) {
+			sName = pReader->read_string();
+		} else if ( sElement == QLatin1String( "info" ) ) {
+			sInfo = pReader->read_string();
+		} else if ( sElement == QLatin1String( "category" ) ) {
+			sCategory = pReader->read_string( sCategory );
+		} else if ( sElement == QLatin1String( "size" ) ) {
+			nSize = pReader->read_int( nSize );
+		} else if ( sElement == QLatin1String( "denominator" ) ) {
+			nDenominator = pReader->read_int( nDenominator );
+		} else if ( sElement == QLatin1String( "noteList" ) &&
+					pInstrumentList != nullptr ) {
+			while ( pReader->readNextStartElement() ) {
+				if ( pReader->name() == QLatin1String( "note" ) ) {
+					notes.push_back( Note::load_from( pReader, pInstrumentList, bSilent ) );
+				} else {
+					pReader->skipCurrentElement();
+				}
+			}
+		} else {
+			pReader->skipCurrentElement();
+		}
+	}
+
+	Pattern* pPattern = new Pattern( sName, sInfo, sCategory, nSize, nDenominator );
+	for ( const auto& pNote : notes ) {
+		pPattern->insert_note( pNote );
+	}
+
+	return pPattern;
+}
+
 bool Pattern::save_file( const QString& drumkit_name, const QString& author, const License& license, const QString& pattern_path, bool overwrite ) const
 {
 	INFOLOG( QString( "Saving pattern into %1" ).arg( pattern_path ) );
@@ -191,6 +253,13 @@ void Pattern::save_to( XMLNode* node, const std::shared_ptr<Instrument> pInstrum
 
 QString Pattern::loadDrumkitNameFrom( const QString& sPatternPath ) {
 
+	QString sDrumkitName;
+	auto pIndex = LibraryIndex::get_instance();
+	if ( pIndex != nullptr &&
+		 pIndex->findPatternDrumkitName( sPatternPath, &sDrumkitName ) ) {
+		return sDrumkitName;
+	}
+
 	XMLDoc doc;
 	// We don't check the return value in here since even if the
 	// validation against the pattern XSD schema fails the document
@@ -201,14 +270,16 @@ QString Pattern::loadDrumkitNameFrom( const QString& sPatternPath ) {
 	XMLNode rootNode = doc.firstChildElement( "drumkit_pattern" );
 	if ( ! rootNode.isNull() ) {
 
-		QString sDrumkitName = rootNode.read_string( "drumkit_name", "", false, false );
+		sDrumkitName = rootNode.read_string( "drumkit_name", "", false, false );
 		if ( sDrumkitName.isEmpty() ) {
 			sDrumkitName = rootNode.read_string( "pattern_for_drumkit", "" );
 		}
 
-		return sDrumkitName;
+		if ( pIndex != nullptr ) {
+			pIndex->addPattern( sPatternPath, sDrumkitName );
+		}
 	}
-	return QString();
+	return sDrumkitName;
 }
 
 Note* Pattern::find_note( int idx_a, int idx_b, std::shared_ptr<Instrument> instrument, Note::Key key, Note::Octave octave, bool strict ) const
@@ -34,6 +34,7 @@ namespace H2Core
 {
 
 class XMLNode;
+class XMLStreamReader;
 class Instrument;
 class InstrumentList;
 class PatternList;
@@ -88,6 +89,17 @@ class Pattern : public H2Core::Object<Pattern>
 		 * \return a new Pattern instance
 		 */
 	static Pattern* load_from( XMLNode* node, InstrumentList* instruments, bool bSilent = false );
+		/**
+		 * load a pattern from the current 'pattern' element of an
+		 * XMLStreamReader
+		 * \param pReader the reader positioned at the 'pattern' element
+		 * \param instruments the current instrument list to search
+		 * instrument into
+		 * \param bSilent Whether infos, warnings, and errors should
+		 * be logged.
+		 * \return a new Pattern instance
+		 */
+	static Pattern* load_from( XMLStreamReader* pReader, InstrumentList* instruments, bool bSilent = false );
 		/**
 		 * save a pattern into an xml file
 		 * \param drumkit_name the name of the drumkit it is supposed to play with
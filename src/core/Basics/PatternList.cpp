@@ -84,6 +84,25 @@ PatternList* PatternList::load_from( XMLNode* pNode, InstrumentList* pInstrument
 	return pPatternList;
 }
 
+PatternList* PatternList::load_from( XMLStreamReader* pReader, InstrumentList* pInstrumentList, bool bSilent ) {
+	PatternList* pPatternList = new PatternList();
+	int nPatternCount = 0;
+
+	while ( pReader->readNextStartElement() ) {
+		if ( pReader->name() == QLatin1String( "pattern" ) ) {
+			nPatternCount++;
+			pPatternList->add( Pattern::load_from( pReader, pInstrumentList, bSilent ) );
+		} else {
+			pReader->skipCurrentElement();
+		}
+	}
+	if ( nPatternCount == 0 && ! bSilent ) {
+		WARNINGLOG( "0 patterns?" );
+	}
+
+	return pPatternList;
+}
+
 void PatternList::save_to( XMLNode* pNode, const std::shared_ptr<Instrument> pInstrumentOnly ) const {
 	XMLNode patternListNode = pNode->createNode( "patternList" );
 	
@@ -34,6 +34,7 @@ class Pattern;
 class AudioEngineLocking;
 class InstrumentList;
 class XMLNode;
+class XMLStreamReader;
 
 /**
  * PatternList is a collection of patterns
@@ -62,6 +63,16 @@ class XMLNode;
 		 * \return a new Pattern instance
 		 */
 	static PatternList* load_from( XMLNode* pNode, InstrumentList* pInstrumentList, bool bSilent = false );
+		/**
+		 * load a #PatternList from the current 'patternList' element
+		 * of an XMLStreamReader
+		 * \param pReader the reader positioned at the 'patternList' element
+		 * \param pInstrumentList the current instrument list to search instrument into
+		 * \param bSilent Whether infos, warnings, and errors should
+		 * be logged.
+		 * \return a new PatternList instance
+		 */
+	static PatternList* load_from( XMLStreamReader* pReader, InstrumentList* pInstrumentList, bool bSilent = false );
 	void save_to( XMLNode* pNode, const std::shared_ptr<Instrument> pInstrumentOnly = nullptr ) const;
 
 		/** returns the numbers of patterns */
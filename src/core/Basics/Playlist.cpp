@@ -64,8 +64,8 @@ void Playlist::clear()
 
 Playlist* Playlist::load_file( const QString& pl_path, bool useRelativePaths )
 {
-	XMLDoc doc;
-	if ( !doc.read( pl_path, Filesystem::playlist_xsd_path() ) ) {
+	XMLStreamReader reader;
+	if ( !reader.read( pl_path, Filesystem::playlist_xsd_path() ) ) {
 		Playlist* pl = new Playlist();
 		Playlist* ret = Legacy::load_playlist( pl, pl_path );
 		if ( ret == nullptr ) {
@@ -76,13 +76,20 @@ Playlist* Playlist::load_file( const QString& pl_path, bool useRelativePaths )
 		pl->save_file( pl_path, pl->getFilename(), true, useRelativePaths );
 		return pl;
 	}
-	XMLNode root = doc.firstChildElement( "playlist" );
-	if ( root.isNull() ) {
+	if ( ! reader.readNextStartElement() ||
+		 reader.name() != QLatin1String( "playlist" ) ) {
 		ERRORLOG( "playlist node not found" );
 		return nullptr;
 	}
 	QFileInfo fileInfo = QFileInfo( pl_path );
-	return Playlist::load_from( &root, fileInfo, useRelativePaths );
+	Playlist* pPlaylist = Playlist::load_from( &reader, fileInfo, useRelativePaths );
+	if ( reader.hasError() ) {
+		ERRORLOG( QString( "Unable to read playlist [%1]: %2" )
+				  .arg( pl_path ).arg( reader.errorString() ) );
+		delete pPlaylist;
+		return nullptr;
+	}
+	return pPlaylist;
 }
 
 Playlist* Playlist::load_from( XMLNode* node, QFileInfo& fileInfo, bool useRelativePaths )
@@ -120,6 +127,67 @@ Playlist* Playlist::load_from( XMLNode* node, QFileInfo& fileInfo, bool useRelat
 	return pPlaylist;
 }
 
+Playlist* Playlist::load_from( XMLStreamReader* pReader, QFileInfo& fileInfo, bool useRelativePaths )
+{
+	Playlist* pPlaylist = new Playlist();
+	pPlaylist->setFilename( fileInfo.absoluteFilePath() );
+
+	QString sName;
+	bool bSongsFound = false;
+	while ( pReader->readNextStartElement() ) {
+		if ( pReader->name() == QLatin1String( "name" ) ) {
+			sName = pReader->read_string();
+		}
+		else if ( pReader->name() == QLatin1String( "songs" ) ) {
+			bSongsFound = true;
+			while ( pReader->readNextStartElement() ) {
+				if ( pReader->name() != QLatin1String( "song" ) ) {
+					pReader->skipCurrentElement();
+					continue;
+				}
+
+				QString sSongPath, sScriptPath;
+				bool bScriptEnabled = false;
+				while ( pReader->readNextStartElement() ) {
+					if ( pReader->name() == QLatin1String( "path" ) ) {
+						sSongPath = pReader->read_string();
+					} else if ( pReader->name() == QLatin1String( "scriptPath" ) ) {
+						sScriptPath = pReader->read_string();
+					} else if ( pReader->name() == QLatin1String( "scriptEnabled" ) ) {
+						bScriptEnabled = pReader->read_bool( false );
+					} else {
+						pReader->skipCurrentElement();
+					}
+				}
+
+				if ( !sSongPath.isEmpty() ) {
+					Playlist::Entry* pEntry = new Playlist::Entry();
+					QFileInfo songPathInfo( fileInfo.absoluteDir(), sSongPath );
+					pEntry->filePath = songPathInfo.absoluteFilePath();
+					pEntry->fileExists = songPathInfo.isReadable();
+					pEntry->scriptPath = sScriptPath;
+					pEntry->scriptEnabled = bScriptEnabled;
+					pPlaylist->add( pEntry );
+				}
+			}
+		}
+		else {
+			pReader->skipCurrentElement();
+		}
+	}
+
+	if ( sName.isEmpty() ) {
+		ERRORLOG( "Playlist has no name, abort" );
+		delete pPlaylist;
+		return nullptr;
+	}
+	if ( ! bSongsFound ) {
+		WARNINGLOG( "songs node not found" );
+	}
+
+	return pPlaylist;
+}
+
 bool Playlist::save_file( const QString& pl_path, const QString& name, bool overwrite, bool useRelativePaths )
 {
 	INFOLOG( QString( "Saving palylist to %1" ).arg( pl_path ) );
@@ -28,6 +28,8 @@
 namespace H2Core
 {
 
+class XMLStreamReader;
+
 /**
  * Drumkit info
 */
@@ -118,6 +120,7 @@ class Playlist : public H2Core::Object<Playlist>
 
 		void save_to( XMLNode* node, bool useRelativePaths );
 		static Playlist* load_from( XMLNode* root, QFileInfo& fileInfo, bool useRelativePaths );
+		static Playlist* load_from( XMLStreamReader* pReader, QFileInfo& fileInfo, bool useRelativePaths );
 };
 
 inline int Playlist::size() const
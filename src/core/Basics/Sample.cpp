@@ -30,6 +30,7 @@
 #include <core/Helpers/Filesystem.h>
 #include <core/Basics/Sample.h>
 #include <core/Basics/Note.h>
+#include <core/Basics/WaveformPeaks.h>
 
 #if defined(H2CORE_HAVE_RUBBERBAND) || _DOXYGEN_
 #include <rubberband/RubberBandStretcher.h>
@@ -106,6 +107,10 @@ Sample::Sample( std::shared_ptr<Sample> pOther ): Object( *pOther ),
 	for( int i=0; i<pVelocity->size(); i++ ) {
 		__velocity_envelope.push_back( pVelocity->at(i) );
 	}
+
+	// The audio data is identical. So are the peaks.
+	std::lock_guard<std::mutex> lock( pOther->m_waveformPeaksMutex );
+	m_pWaveformPeaks = pOther->m_pWaveformPeaks;
 }
 
 Sample::~Sample()
@@ -118,6 +123,16 @@ Sample::~Sample()
 	}
 }
 
+std::shared_ptr<const WaveformPeaks> Sample::getWaveformPeaks()
+{
+	std::lock_guard<std::mutex> lock( m_waveformPeaksMutex );
+	if ( m_pWaveformPeaks == nullptr && ! is_empty() ) {
+		m_pWaveformPeaks = std::make_shared<const WaveformPeaks>( __data_l, __data_r,
+																  __frames );
+	}
+	return m_pWaveformPeaks;
+}
+
 void Sample::set_filename( const QString& filename )
 {
 	QFileInfo Filename = QFileInfo( filename );
@@ -189,9 +204,13 @@ bool Sample::load( float fBpm )
 		WARNINGLOG( QString( "Unable to close sample file %1" ).arg( __filepath ) );
 	}
 	
+	// The audio data is altered in several steps. Widgets requesting
+	// the waveform peaks in the meantime have to wait.
+	std::unique_lock<std::mutex> lock( m_waveformPeaksMutex );
+
 	// Flush the current content of the left and right channel and
 	// the current metadata.
-	unload();
+	unloadData();
 	
 	// Save the metadata of the loaded file into private members
 	// of the Sample class.
@@ -227,6 +246,11 @@ bool Sample::load( float fBpm )
 		WARNINGLOG( "Unable to apply rubberband" );
 	}
 #endif
+	lock.unlock();
+
+	// Summarize the new content for the waveform displays without
+	// blocking the caller.
+	WaveformPeaks::schedule( weak_from_this() );
 
 	return true;
 }
@@ -642,12 +666,18 @@ bool Sample::exec_rubberband_cli( float fBpm )
 
 	QFile( rubberResultPath ).remove();
 
+	// The temporary sample was already handed to the waveform peaks
+	// worker by load(). Take its buffers under its own lock so the
+	// worker either finishes reading them first or finds the sample
+	// empty afterwards.
+	std::lock_guard<std::mutex> rubberbandedLock( p_Rubberbanded->m_waveformPeaksMutex );
 	__frames = p_Rubberbanded->get_frames();
 
 	__data_l = p_Rubberbanded->get_data_l();
 	__data_r = p_Rubberbanded->get_data_r();
 	p_Rubberbanded->__data_l = nullptr;
 	p_Rubberbanded->__data_r = nullptr;
+	p_Rubberbanded->__frames = 0;
 
 	__is_modified = true;
 	
@@ -24,6 +24,7 @@
 #define H2C_SAMPLE_H
 
 #include <memory>
+#include <mutex>
 #include <vector>
 #include <sndfile.h>
 
@@ -33,6 +34,8 @@
 namespace H2Core
 {
 
+class WaveformPeaks;
+
 /**
  * A container for a sample, being able to apply modifications on it
  */
@@ -64,7 +67,8 @@ class EnvelopePoint : public H2Core::Object<EnvelopePoint>
 		EnvelopePoint( const EnvelopePoint& other );
 };
 
-class Sample : public H2Core::Object<Sample>
+class Sample : public H2Core::Object<Sample>,
+			   public std::enable_shared_from_this<Sample>
 {
 		H2_OBJECT(Sample)
 	public:
@@ -204,6 +208,18 @@ class Sample : public H2Core::Object<Sample>
 		 */
 		void unload();
 
+		/**
+		 * Peaks of the current audio data used to draw the
+		 * waveform.
+		 *
+		 * They are created in a background thread after each
+		 * load(). In case this did not happen yet, they are
+		 * created by the calling thread instead.
+		 *
+		 * \return nullptr in case the sample is empty.
+		 */
+		std::shared_ptr<const WaveformPeaks> getWaveformPeaks();
+
 		/** \return true if both data channels are null pointers */
 		bool is_empty() const;
 		/** \return #__filepath */
@@ -299,6 +315,8 @@ class Sample : public H2Core::Object<Sample>
 		 * \param fBpm tempo the Rubberband transformation will target
 		 */
 		bool exec_rubberband_cli( float fBpm );
+		/** unload() without locking #m_waveformPeaksMutex.*/
+		void unloadData();
 	
 		QString				__filepath;          ///< filepath of the sample
 		int					__frames;            ///< number of frames in this sample
@@ -326,11 +344,24 @@ class Sample : public H2Core::Object<Sample>
 	 * the Pattern Editor, it does not have to be specified.
 	 */
 	License m_license;
+
+	/** Created on demand from #__data_l and #__data_r and reset
+	 * each time they change.*/
+	std::shared_ptr<const WaveformPeaks> m_pWaveformPeaks;
+	/** Guards #m_pWaveformPeaks and the audio data against load()
+	 * while the peaks are created.*/
+	std::mutex m_waveformPeaksMutex;
 };
 
 // DEFINITIONS
 
 inline void Sample::unload()
+{
+	std::lock_guard<std::mutex> lock( m_waveformPeaksMutex );
+	unloadData();
+}
+
+inline void Sample::unloadData()
 {
 	if ( __data_l != nullptr ) {
 		delete [] __data_l;
@@ -344,6 +375,7 @@ inline void Sample::unload()
 	    velocity, loop and rubberband are kept unchanged */
 
 	__data_l = __data_r = nullptr;
+	m_pWaveformPeaks = nullptr;
 }
 
 inline bool Sample::is_empty() const
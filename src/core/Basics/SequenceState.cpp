@@ -0,0 +1,308 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#include <core/Basics/SequenceState.h>
+
+#include <core/Basics/Pattern.h>
+#include <core/Basics/PatternList.h>
+#include <core/Basics/Song.h>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+
+namespace H2Core
+{
+
+static std::atomic<size_t> s_nTotalBytes( 0 );
+static std::atomic<size_t> s_nMemoryBudget( SequenceState::nDefaultMemoryBudget );
+
+/** All states created so far in order of their creation. Used to
+ * share storage with the most recent state and to expire the oldest
+ * ones.*/
+static std::mutex s_statesMutex;
+static std::vector<std::weak_ptr<SequenceState>> s_states;
+
+/** Approximate size of the control block std::make_shared()
+ * allocates alongside each object (vtable pointer and two reference
+ * counts).*/
+static constexpr size_t nControlBlockBytes = sizeof( void* ) + 2 * sizeof( long );
+
+/** Numbers of the patterns contained in a single column.*/
+struct SequenceState::Column {
+	explicit Column( std::vector<int>&& patterns )
+		: patterns( std::move( patterns ) ) {
+		s_nTotalBytes += getBytes();
+	}
+	~Column() {
+		s_nTotalBytes -= getBytes();
+	}
+	size_t getBytes() const {
+		return nControlBlockBytes + sizeof( Column ) +
+			patterns.capacity() * sizeof( int );
+	}
+
+	const std::vector<int> patterns;
+};
+
+/** Numbers of the virtual patterns of each pattern in the pattern
+ * list.*/
+struct SequenceState::VirtualPatterns {
+	explicit VirtualPatterns( std::vector<std::vector<int>>&& patterns )
+		: patterns( std::move( patterns ) ) {
+		s_nTotalBytes += getBytes();
+	}
+	~VirtualPatterns() {
+		s_nTotalBytes -= getBytes();
+	}
+	size_t getBytes() const {
+		size_t nBytes = nControlBlockBytes + sizeof( VirtualPatterns ) +
+			patterns.capacity() * sizeof( std::vector<int> );
+		for ( const auto& virtualPatterns : patterns ) {
+			nBytes += virtualPatterns.capacity() * sizeof( int );
+		}
+		return nBytes;
+	}
+
+	const std::vector<std::vector<int>> patterns;
+};
+
+/** Allows to look up shared columns by their content.*/
+struct ColumnLess {
+	typedef void is_transparent;
+	template<typename T>
+	static const std::vector<int>& get( const T& column ) {
+		return column->patterns;
+	}
+	static const std::vector<int>& get( const std::vector<int>& patterns ) {
+		return patterns;
+	}
+	template<typename A, typename B>
+	bool operator()( const A& a, const B& b ) const {
+		return get( a ) < get( b );
+	}
+};
+
+SequenceState::SequenceState()
+	: m_nPatterns( 0 )
+	, m_bExpired( false )
+	, m_nBytes( 0 )
+{
+}
+
+SequenceState::~SequenceState()
+{
+	s_nTotalBytes -= m_nBytes;
+}
+
+std::shared_ptr<SequenceState> SequenceState::create( std::shared_ptr<Song> pSong )
+{
+	if ( pSong == nullptr ) {
+		___ERRORLOG( "Invalid song" );
+		return nullptr;
+	}
+
+	auto pPatternList = pSong->getPatternList();
+	auto pColumns = pSong->getPatternGroupVector();
+
+	std::unordered_map<const Pattern*, int> patternNumbers;
+	patternNumbers.reserve( pPatternList->size() );
+	for ( int ii = 0; ii < pPatternList->size(); ++ii ) {
+		patternNumbers[ pPatternList->get( ii ) ] = ii;
+	}
+
+	std::shared_ptr<SequenceState> pPrevious;
+	{
+		std::lock_guard<std::mutex> lock( s_statesMutex );
+		s_states.erase( std::remove_if( s_states.begin(), s_states.end(),
+										[]( const std::weak_ptr<SequenceState>& pState ) {
+											return pState.expired(); } ),
+						s_states.end() );
+		if ( ! s_states.empty() ) {
+			pPrevious = s_states.back().lock();
+		}
+	}
+
+	// Columns are shared with identical ones of the previous state
+	// and of this one.
+	std::set<std::shared_ptr<const Column>, ColumnLess> columnPool;
+	if ( pPrevious != nullptr ) {
+		for ( const auto& pColumn : pPrevious->m_columns ) {
+			columnPool.insert( pColumn );
+		}
+	}
+
+	std::shared_ptr<SequenceState> pState( new SequenceState() );
+	pState->m_nPatterns = pPatternList->size();
+	pState->m_columns.reserve( pColumns->size() );
+
+	for ( const auto& pColumn : *pColumns ) {
+		std::vector<int> patterns;
+		patterns.reserve( pColumn->size() );
+		for ( const auto& pPattern : *pColumn ) {
+			auto it = patternNumbers.find( pPattern );
+			if ( it != patternNumbers.end() ) {
+				patterns.push_back( it->second );
+			} else {
+				___ERRORLOG( "Pattern in sequence not found in pattern list" );
+			}
+		}
+
+		auto it = columnPool.find( patterns );
+		if ( it != columnPool.end() ) {
+			pState->m_columns.push_back( *it );
+		} else {
+			auto pNewColumn = std::make_shared<const Column>( std::move( patterns ) );
+			columnPool.insert( pNewColumn );
+			pState->m_columns.push_back( pNewColumn );
+		}
+	}
+
+	std::vector<std::vector<int>> virtualPatterns( pPatternList->size() );
+	for ( int ii = 0; ii < pPatternList->size(); ++ii ) {
+		for ( const auto& pVirtualPattern :
+				  *( pPatternList->get( ii )->get_virtual_patterns() ) ) {
+			auto it = patternNumbers.find( pVirtualPattern );
+			if ( it != patternNumbers.end() ) {
+				virtualPatterns[ ii ].push_back( it->second );
+			}
+		}
+		std::sort( virtualPatterns[ ii ].begin(), virtualPatterns[ ii ].end() );
+	}
+	if ( pPrevious != nullptr && pPrevious->m_pVirtualPatterns != nullptr &&
+		 pPrevious->m_pVirtualPatterns->patterns == virtualPatterns ) {
+		pState->m_pVirtualPatterns = pPrevious->m_pVirtualPatterns;
+	} else {
+		pState->m_pVirtualPatterns =
+			std::make_shared<const VirtualPatterns>( std::move( virtualPatterns ) );
+	}
+
+	// The references to the shared columns are owned by the state
+	// itself.
+	pState->m_nBytes = nControlBlockBytes + sizeof( SequenceState ) +
+		pState->m_columns.capacity() * sizeof( std::shared_ptr<const Column> );
+	s_nTotalBytes += pState->m_nBytes;
+
+	{
+		std::lock_guard<std::mutex> lock( s_statesMutex );
+		s_states.push_back( pState );
+	}
+	enforceMemoryBudget();
+
+	return pState;
+}
+
+bool SequenceState::restore( std::shared_ptr<Song> pSong ) const
+{
+	if ( m_bExpired ) {
+		ERRORLOG( "State was expired due to the memory budget of the undo history" );
+		return false;
+	}
+	if ( pSong == nullptr ) {
+		ERRORLOG( "Invalid song" );
+		return false;
+	}
+
+	auto pPatternList = pSong->getPatternList();
+	if ( pPatternList->size() != m_nPatterns ) {
+		ERRORLOG( QString( "Pattern list does not match. Expected [%1] patterns, found [%2]" )
+				  .arg( m_nPatterns ).arg( pPatternList->size() ) );
+		return false;
+	}
+
+	// Virtual patterns have to be present before the columns are
+	// filled in order to omit patterns already contained as virtual
+	// ones.
+	const auto& virtualPatterns = m_pVirtualPatterns->patterns;
+	for ( int ii = 0; ii < pPatternList->size(); ++ii ) {
+		auto pPattern = pPatternList->get( ii );
+		pPattern->virtual_patterns_clear();
+		for ( const int nVirtualPattern : virtualPatterns[ ii ] ) {
+			pPattern->virtual_patterns_add( pPatternList->get( nVirtualPattern ) );
+		}
+	}
+	pPatternList->flattened_virtual_patterns_compute();
+
+	auto pColumns = pSong->getPatternGroupVector();
+	for ( auto& pColumn : *pColumns ) {
+		pColumn->clear();
+		delete pColumn;
+	}
+	pColumns->clear();
+	pColumns->reserve( m_columns.size() );
+
+	for ( const auto& pColumn : m_columns ) {
+		auto pNewColumn = new PatternList();
+		for ( const int nPattern : pColumn->patterns ) {
+			pNewColumn->add( pPatternList->get( nPattern ) );
+		}
+		pColumns->push_back( pNewColumn );
+	}
+
+	return true;
+}
+
+void SequenceState::expire()
+{
+	m_columns.clear();
+	m_columns.shrink_to_fit();
+	m_pVirtualPatterns = nullptr;
+	m_bExpired = true;
+
+	// The expired state itself is kept by the undo stack.
+	s_nTotalBytes -= m_nBytes;
+	m_nBytes = nControlBlockBytes + sizeof( SequenceState );
+	s_nTotalBytes += m_nBytes;
+}
+
+size_t SequenceState::getTotalMemoryUsage()
+{
+	return s_nTotalBytes;
+}
+
+size_t SequenceState::getMemoryBudget()
+{
+	return s_nMemoryBudget;
+}
+
+void SequenceState::setMemoryBudget( size_t nBytes )
+{
+	s_nMemoryBudget = nBytes;
+	enforceMemoryBudget();
+}
+
+void SequenceState::enforceMemoryBudget()
+{
+	std::lock_guard<std::mutex> lock( s_statesMutex );
+
+	while ( s_nTotalBytes > s_nMemoryBudget && s_states.size() > 1 ) {
+		auto pState = s_states.front().lock();
+		s_states.erase( s_states.begin() );
+		if ( pState != nullptr ) {
+			___WARNINGLOG( "Memory budget of the undo history exceeded. Dropping oldest sequence state." );
+			pState->expire();
+		}
+	}
+}
+
+};
@@ -0,0 +1,126 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#ifndef H2C_SEQUENCE_STATE_H
+#define H2C_SEQUENCE_STATE_H
+
+#include <core/Object.h>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace H2Core
+{
+
+class Song;
+
+/**
+ * In-memory record of the pattern sequence (the columns of the
+ * SongEditor) and the virtual patterns of a song used by the undo
+ * history.
+ *
+ * Patterns are referenced by their position in the pattern list of
+ * the song. A state can thus only be restored as long as the pattern
+ * list has the same layout as at the time of creation - which is
+ * ensured by the undo stack.
+ *
+ * The columns are immutable and shared. Identical columns within a
+ * state as well as columns not altered since the most recent state
+ * still alive reference the same storage. This way subsequent
+ * states of a large song differing in a couple of columns only
+ * require memory for the altered ones.
+ *
+ * The overall memory of all states is bounded by
+ * getMemoryBudget(). Once it is exceeded the oldest states are
+ * expired and can not be restored anymore.
+ *
+ * States have to be created and restored from a single thread
+ * only (the GUI one).
+ */
+/** \ingroup docCore*/
+class SequenceState : public H2Core::Object<SequenceState>
+{
+	H2_OBJECT(SequenceState)
+public:
+	~SequenceState();
+
+	/** \return State of the pattern sequence and virtual patterns
+	 * of @a pSong or nullptr in case @a pSong is not valid.*/
+	static std::shared_ptr<SequenceState> create( std::shared_ptr<Song> pSong );
+
+	/**
+	 * Replaces the pattern sequence and virtual patterns of @a pSong
+	 * by the ones stored in this state.
+	 *
+	 * The audio engine has to be locked by the caller.
+	 *
+	 * \return true on success. Restoring fails in case the state was
+	 *   expired or the pattern list of @a pSong does not match the
+	 *   one the state was created from.
+	 */
+	bool restore( std::shared_ptr<Song> pSong ) const;
+
+	int getColumnCount() const {
+		return static_cast<int>( m_columns.size() );
+	}
+	bool isExpired() const {
+		return m_bExpired;
+	}
+
+	/** \return Number of bytes currently held by all states,
+	 * including the references of each state to its columns.
+	 * Storage shared between several states is only counted once.*/
+	static size_t getTotalMemoryUsage();
+	static size_t getMemoryBudget();
+	/** Sets the budget and expires the oldest states in case it is
+	 * exceeded. The most recent state is never expired.*/
+	static void setMemoryBudget( size_t nBytes );
+
+	/** Default value of getMemoryBudget().*/
+	static constexpr size_t nDefaultMemoryBudget = 32 * 1024 * 1024;
+
+private:
+	struct Column;
+	struct VirtualPatterns;
+
+	SequenceState();
+
+	/** Drops all data held by the state.*/
+	void expire();
+
+	/** Expires the oldest states till the budget is met. */
+	static void enforceMemoryBudget();
+
+	std::vector<std::shared_ptr<const Column>> m_columns;
+	std::shared_ptr<const VirtualPatterns> m_pVirtualPatterns;
+	/** Size of the pattern list the state was created from.*/
+	int m_nPatterns;
+	bool m_bExpired;
+	/** Memory held by the state itself, i.e. excluding the shared
+	 * columns and virtual patterns. Part of
+	 * getTotalMemoryUsage().*/
+	size_t m_nBytes;
+};
+
+};
+
+#endif
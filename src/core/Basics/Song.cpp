@@ -31,6 +31,7 @@
 #include <core/Globals.h>
 #include <core/Timeline.h>
 #include <core/Basics/Song.h>
+#include <core/Basics/SongSnapshot.h>
 #include <core/Basics/DrumkitComponent.h>
 #include <core/Basics/Sample.h>
 #include <core/Basics/Instrument.h>
@@ -80,6 +81,7 @@ Song::Song( const QString& sName, const QString& sAuthor, float fBpm, float fVol
 	, m_fHumanizeVelocityValue( 0.0 )
 	, m_fSwingFactor( 0.0 )
 	, m_bIsModified( false )
+	, m_nRevision( 0 )
 	, m_mode( Mode::Pattern )
 	, m_sPlaybackTrackFilename( "" )
 	, m_bPlaybackTrackEnabled( false )
@@ -192,42 +194,107 @@ std::shared_ptr<Song> Song::load( const QString& sFilename, bool bSilent )
 		return nullptr;
 	}
 
+	const bool bSnapshots = Preferences::get_instance()->getSaveSongSnapshots();
+	if ( bSnapshots ) {
+		auto pSong = SongSnapshot::load( sPath, bSilent );
+		if ( pSong != nullptr ) {
+			pSong->setFilename( sFilename );
+			return pSong;
+		}
+	}
+
 	if ( ! bSilent ) {
 		INFOLOG( "Reading " + sPath );
 	}
 
-	XMLDoc doc;
-	if ( ! doc.read( sFilename ) && ! bSilent ) {
+	XMLStreamReader reader;
+	if ( ! reader.read( sFilename ) && ! bSilent ) {
 		ERRORLOG( QString( "Something went wrong while loading song [%1]" )
 				  .arg( sFilename ) );
 	}
-				  
-	XMLNode songNode = doc.firstChildElement( "song" );
 
-	if ( songNode.isNull() ) {
+	if ( ! reader.readNextStartElement() ||
+		 reader.name() != QLatin1String( "song" ) ) {
 		ERRORLOG( "Error reading song: 'song' node not found" );
 		return nullptr;
 	}
 
-	if ( ! bSilent ) {
-		QString sSongVersion = songNode.read_string( "version", "Unknown version", false, false );
-		if ( sSongVersion != QString( get_version().c_str() ) ) {
-			INFOLOG( QString( "Trying to load a song [%1] created with a different version [%2] of hydrogen. Current version: %3" )
-					 .arg( sFilename )
-					 .arg( sSongVersion )
-					 .arg( get_version().c_str() ) );
+	// Instruments and patterns - the bulk of a song - are created
+	// while parsing. All remaining nodes are collected into a small
+	// DOM handled by loadFrom(). Patterns can only be streamed in
+	// case the instruments were already read (which is the order
+	// they are written in).
+	XMLDoc doc;
+	XMLNode songNode = doc.createElement( "song" );
+	doc.appendChild( songNode );
+	InstrumentList* pInstrumentList = nullptr;
+	PatternList* pPatternList = nullptr;
+	while ( reader.readNextStartElement() ) {
+		if ( reader.name() == QLatin1String( "instrumentList" ) &&
+			 pInstrumentList == nullptr ) {
+			pInstrumentList = InstrumentList::load_from( &reader,
+														 "", // sDrumkitPath
+														 "", // sDrumkitName
+														 License(), // per-instrument licenses
+														 bSilent );
+		}
+		else if ( reader.name() == QLatin1String( "patternList" ) &&
+				  pInstrumentList != nullptr && pPatternList == nullptr ) {
+			pPatternList = PatternList::load_from( &reader, pInstrumentList, bSilent );
 		}
+		else {
+			songNode.appendChild( reader.read_node( &doc ) );
+		}
+	}
+
+	if ( reader.hasError() ) {
+		ERRORLOG( QString( "Error reading song [%1] at line %2: %3" )
+				  .arg( sFilename ).arg( reader.lineNumber() )
+				  .arg( reader.errorString() ) );
+		delete pInstrumentList;
+		delete pPatternList;
+		return nullptr;
+	}
+
+	checkVersion( &songNode, sFilename, bSilent );
+
+	auto pSong = Song::loadFrom( &songNode, bSilent, pInstrumentList, pPatternList );
+	if ( pSong == nullptr ) {
+		return nullptr;
 	}
+	pSong->setFilename( sFilename );
 
-	auto pSong = Song::loadFrom( &songNode, bSilent );
-	if ( pSong != nullptr ) {
-		pSong->setFilename( sFilename );
+	// The snapshot is created from the song as it was just loaded
+	// from XML - including all compatibility handling done while
+	// parsing - and not from the one written by save(). The streamed
+	// instrument list is not part of the skeleton yet.
+	if ( bSnapshots &&
+		 Filesystem::dir_writable( QFileInfo( sPath ).absolutePath(), true ) ) {
+		pSong->getInstrumentList()->save_to( &songNode, -1, true, true );
+		SongSnapshot::save( pSong.get(), doc, sPath );
 	}
 
 	return pSong;
 }
 
-std::shared_ptr<Song> Song::loadFrom( XMLNode* pRootNode, bool bSilent )
+void Song::checkVersion( XMLNode* pNode, const QString& sFilename, bool bSilent )
+{
+	if ( bSilent ) {
+		return;
+	}
+
+	QString sSongVersion = pNode->read_string( "version", "Unknown version", false, false );
+	if ( sSongVersion != QString( get_version().c_str() ) ) {
+		INFOLOG( QString( "Trying to load a song [%1] created with a different version [%2] of hydrogen. Current version: %3" )
+				 .arg( sFilename )
+				 .arg( sSongVersion )
+				 .arg( get_version().c_str() ) );
+	}
+}
+
+std::shared_ptr<Song> Song::loadFrom( XMLNode* pRootNode, bool bSilent,
+									  InstrumentList* pInstrumentList,
+									  PatternList* pPatternList )
 {
 	auto pPreferences = Preferences::get_instance();
 	
@@ -383,12 +450,15 @@ std::shared_ptr<Song> Song::loadFrom( XMLNode* pRootNode, bool bSilent )
 	// By supplying no drumkit path and name the individual
 	// drumkit meta infos stored in the 'instrument' nodes will be
 	// used.
-	auto pInstrumentList = InstrumentList::load_from( pRootNode,
-													  "", // sDrumkitPath
-													  "", // sDrumkitName
-													  License(), // per-instrument licenses
-													  bSilent );
 	if ( pInstrumentList == nullptr ) {
+		pInstrumentList = InstrumentList::load_from( pRootNode,
+													 "", // sDrumkitPath
+													 "", // sDrumkitName
+													 License(), // per-instrument licenses
+													 bSilent );
+	}
+	if ( pInstrumentList == nullptr ) {
+		delete pPatternList;
 		return nullptr;
 	}
 
@@ -400,9 +470,12 @@ std::shared_ptr<Song> Song::loadFrom( XMLNode* pRootNode, bool bSilent )
 	pSong->setCurrentDrumkitLookup( pSong->getInstrumentList()->get( 0 )->get_drumkit_lookup() );
 
 	// Pattern list
-	pSong->setPatternList( PatternList::load_from( pRootNode,
-												   pSong->getInstrumentList(),
-												   bSilent ) );
+	if ( pPatternList == nullptr ) {
+		pPatternList = PatternList::load_from( pRootNode,
+											   pSong->getInstrumentList(),
+											   bSilent );
+	}
+	pSong->setPatternList( pPatternList );
 
 	// Virtual Patterns
 	pSong->loadVirtualPatternsFrom( pRootNode, bSilent );
@@ -531,15 +604,7 @@ bool Song::save( const QString& sFilename, bool bSilent )
 	}
 
 	XMLDoc doc;
-	XMLNode rootNode = doc.set_root( "song" );
-	
-	// In order to comply with the GPL license we have to add a
-	// license notice to the file.
-	if ( getLicense().getType() == License::GPL ) {
-		doc.appendChild( doc.createComment( License::getGPLLicenseNotice( getAuthor() ) ) );
-	}
-
-	writeTo( &rootNode, bSilent );
+	saveTo( &doc, bSilent );
 	
 	setFilename( sFilename );
 	setIsModified( false );
@@ -549,6 +614,11 @@ bool Song::save( const QString& sFilename, bool bSilent )
 		return false;
 	}
 
+	// A snapshot left over from a previous save is outdated in any
+	// case and will be ignored. Removing it avoids clutter. A new one
+	// is created the next time the file is loaded.
+	SongSnapshot::remove( sFilename );
+
 	if ( ! bSilent ) {
 		INFOLOG("Save was successful.");
 	}
@@ -556,6 +626,19 @@ bool Song::save( const QString& sFilename, bool bSilent )
 	return true;
 }
 
+void Song::saveTo( XMLDoc* pDoc, bool bSilent )
+{
+	XMLNode rootNode = pDoc->set_root( "song" );
+	
+	// In order to comply with the GPL license we have to add a
+	// license notice to the file.
+	if ( getLicense().getType() == License::GPL ) {
+		pDoc->appendChild( pDoc->createComment( License::getGPLLicenseNotice( getAuthor() ) ) );
+	}
+
+	writeTo( &rootNode, bSilent );
+}
+
 void Song::loadVirtualPatternsFrom( XMLNode* pNode, bool bSilent ) {
 
 	XMLNode virtualPatternListNode = pNode->firstChildElement( "virtualPatternList" );
@@ -945,6 +1028,10 @@ void Song::setSwingFactor( float factor )
 
 void Song::setIsModified( bool bIsModified )
 {
+	if ( bIsModified ) {
+		++m_nRevision;
+	}
+
 	bool Notify = false;
 
 	if( m_bIsModified != bIsModified ) {
@@ -1146,41 +1233,67 @@ void Song::setPanLawKNorm( float fKNorm ) {
 	}
 }
 
-void Song::loadDrumkit( Drumkit *pDrumkit, bool bConditional ) {
+Song::PreparedDrumkit::~PreparedDrumkit() {
+	for ( auto& pComponent : components ) {
+		delete pComponent;
+	}
+}
+
+std::shared_ptr<Song::PreparedDrumkit> Song::prepareDrumkit( Drumkit* pDrumkit ) {
 	assert ( pDrumkit );
 	if ( pDrumkit == nullptr ) {
 		ERRORLOG( "Invalid drumkit supplied" );
-		return;
+		return nullptr;
 	}
-	
-	auto pAudioEngine = Hydrogen::get_instance()->getAudioEngine();
 
-	m_sCurrentDrumkitName = pDrumkit->get_name();
+	auto pPrepared = std::make_shared<PreparedDrumkit>();
+	pPrepared->sName = pDrumkit->get_name();
 	if ( pDrumkit->isUserDrumkit() ) {
-		m_currentDrumkitLookup = Filesystem::Lookup::user;
+		pPrepared->lookup = Filesystem::Lookup::user;
 	} else {
-		m_currentDrumkitLookup = Filesystem::Lookup::system;
+		pPrepared->lookup = Filesystem::Lookup::system;
 	}
 
+	for ( const auto& pSrcComponent : *pDrumkit->get_components() ) {
+		DrumkitComponent* pNewComponent =
+			new DrumkitComponent( pSrcComponent->get_id(), pSrcComponent->get_name() );
+		pNewComponent->load_from( pSrcComponent );
+		pPrepared->components.push_back( pNewComponent );
+	}
 
-	// Load DrumkitComponents 
-	std::vector<DrumkitComponent*>* pDrumkitCompoList = pDrumkit->get_components();
-	
-	for( auto &pComponent : *m_pComponents ){
-		delete pComponent;
+	InstrumentList *pDrumkitInstrList = pDrumkit->get_instruments();
+	pPrepared->instruments.reserve( pDrumkitInstrList->size() );
+	for ( int nnInstr = 0; nnInstr < pDrumkitInstrList->size(); ++nnInstr ) {
+		auto pNewInstr = pDrumkitInstrList->get( nnInstr );
+		assert( pNewInstr );
+		INFOLOG( QString( "Loading instrument (%1 of %2) [%3]" )
+				 .arg( nnInstr + 1 )
+				 .arg( pDrumkitInstrList->size() )
+				 .arg( pNewInstr->get_name() ) );
+
+		auto pInstr = std::make_shared<Instrument>();
+		pInstr->load_from( pDrumkit, pNewInstr );
+		pPrepared->instruments.push_back( pInstr );
 	}
-	m_pComponents->clear();
-	
-	for (std::vector<DrumkitComponent*>::iterator it = pDrumkitCompoList->begin() ; it != pDrumkitCompoList->end(); ++it) {
-		DrumkitComponent* pSrcComponent = *it;
-		DrumkitComponent* pNewComponent = new DrumkitComponent( pSrcComponent->get_id(), pSrcComponent->get_name() );
-		pNewComponent->load_from( pSrcComponent );
 
-		m_pComponents->push_back( pNewComponent );
+	return pPrepared;
+}
+
+void Song::commitDrumkit( std::shared_ptr<PreparedDrumkit> pPrepared, bool bConditional ) {
+	if ( pPrepared == nullptr ) {
+		ERRORLOG( "Invalid drumkit supplied" );
+		return;
 	}
 
+	m_sCurrentDrumkitName = pPrepared->sName;
+	m_currentDrumkitLookup = pPrepared->lookup;
+
+	// Swap DrumkitComponents. The old ones will be deleted along
+	// with pPrepared.
+	m_pComponents->swap( pPrepared->components );
+
 	//////
-	// Load InstrumentList
+	// Swap InstrumentList
 	/*
 	 * If the old drumkit is bigger then the new drumkit,
 	 * delete all instruments with a bigger pos then
@@ -1189,40 +1302,37 @@ void Song::loadDrumkit( Drumkit *pDrumkit, bool bConditional ) {
 	 * pos > pDrumkitInstrList->size() stay in the
 	 * new instrumentlist
 	 */
-	InstrumentList *pDrumkitInstrList = pDrumkit->get_instruments();
-	
-	int nInstrumentDiff = m_pInstrumentList->size() - pDrumkitInstrList->size();
+	const int nNewInstruments = pPrepared->instruments.size();
+	int nInstrumentDiff = m_pInstrumentList->size() - nNewInstruments;
 	int nMaxID = -1;
-	
-	std::shared_ptr<Instrument> pInstr, pNewInstr;
-	for ( int nnInstr = 0; nnInstr < pDrumkitInstrList->size(); ++nnInstr ) {
-		if ( nnInstr < m_pInstrumentList->size() ) {
-			// Instrument exists already
-			pInstr = m_pInstrumentList->get( nnInstr );
-			assert( pInstr );
-		} else {
-			pInstr = std::make_shared<Instrument>();
-			m_pInstrumentList->add( pInstr );
-		}
 
-		pNewInstr = pDrumkitInstrList->get( nnInstr );
-		assert( pNewInstr );
-		INFOLOG( QString( "Loading instrument (%1 of %2) [%3]" )
-				 .arg( nnInstr + 1 )
-				 .arg( pDrumkitInstrList->size() )
-				 .arg( pNewInstr->get_name() ) );
+	for ( int nnInstr = 0; nnInstr < nNewInstruments; ++nnInstr ) {
+		auto pNewInstr = pPrepared->instruments[ nnInstr ];
 
 		// Preserve instrument IDs. Where the new drumkit has more
 		// instruments than the song does, new instruments need new
 		// ids.
-		int nID = pInstr->get_id();
-		if ( nID == EMPTY_INSTR_ID ) {
-			nID = nMaxID + 1;
-		}
-		nMaxID = std::max( nID, nMaxID );
+		if ( nnInstr < m_pInstrumentList->size() ) {
+			// Instrument exists already and is referenced by the
+			// notes of the song. Only its content is swapped.
+			auto pInstr = m_pInstrumentList->get( nnInstr );
+			assert( pInstr );
 
-		pInstr->load_from( pDrumkit, pNewInstr );
-		pInstr->set_id( nID );
+			int nID = pInstr->get_id();
+			if ( nID == EMPTY_INSTR_ID ) {
+				nID = nMaxID + 1;
+			}
+			nMaxID = std::max( nID, nMaxID );
+
+			pInstr->swap_from( pNewInstr );
+			pInstr->set_id( nID );
+		}
+		else {
+			int nID = nMaxID + 1;
+			nMaxID = nID;
+			pNewInstr->set_id( nID );
+			m_pInstrumentList->add( pNewInstr );
+		}
 	}
 
 	// Discard redundant instruments (in case the last drumkit had
@@ -1235,6 +1345,11 @@ void Song::loadDrumkit( Drumkit *pDrumkit, bool bConditional ) {
 	}
 }
 
+void Song::loadDrumkit( Drumkit *pDrumkit, bool bConditional ) {
+	auto pPrepared = prepareDrumkit( pDrumkit );
+	commitDrumkit( pPrepared, bConditional );
+}
+
 void Song::removeInstrument( int nInstrumentNumber, bool bConditional ) {
 	auto pHydrogen = Hydrogen::get_instance();
 	auto pInstr = m_pInstrumentList->get( nInstrumentNumber );
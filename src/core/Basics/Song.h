@@ -131,6 +131,10 @@ class Song : public H2Core::Object<Song>, public std::enable_shared_from_this<So
 
 	static std::shared_ptr<Song> 	load( const QString& sFilename, bool bSilent = false );
 	bool 			save( const QString& sFilename, bool bSilent = false );
+	/** Serializes the song into @a pDoc without accessing the
+	 * disk. In contrast to save() neither the filename nor the
+	 * modification state of the song are altered.*/
+	void			saveTo( XMLDoc* pDoc, bool bSilent = false );
 
 	bool getIsTimelineActivated() const;
 	void setIsTimelineActivated( bool bIsTimelineActivated );
@@ -213,6 +217,10 @@ class Song : public H2Core::Object<Song>, public std::enable_shared_from_this<So
 							
 		bool			getIsModified() const;
 		void			setIsModified( bool bIsModified);
+		/** Incremented every time the song is marked as modified,
+		 * even if #m_bIsModified was already set. Allows to detect
+		 * changes since a particular point in time.*/
+		long			getRevision() const;
 
 	std::vector<DrumkitComponent*>* getComponents() const;
 
@@ -265,6 +273,47 @@ class Song : public H2Core::Object<Song>, public std::enable_shared_from_this<So
 
 	std::shared_ptr<Timeline> getTimeline() const;
 
+	/**
+	 * Components and instruments of a drumkit including all their
+	 * samples, ready to be swapped into a song using
+	 * commitDrumkit().
+	 *
+	 * After the commit it holds the replaced components and
+	 * instrument data of the song instead and frees them on
+	 * destruction.
+	 */
+	class PreparedDrumkit {
+	public:
+		~PreparedDrumkit();
+
+		QString sName;
+		Filesystem::Lookup lookup;
+		std::vector<DrumkitComponent*> components;
+		std::vector<std::shared_ptr<Instrument>> instruments;
+	};
+
+	/**
+	 * Creates all components and instruments of @a pDrumkit and
+	 * loads their samples from disk.
+	 *
+	 * The song is not altered. Therefore, this can be done without
+	 * holding the AudioEngine lock.
+	 */
+	static std::shared_ptr<PreparedDrumkit> prepareDrumkit( Drumkit* pDrumkit );
+	/**
+	 * Replaces the current drumkit by @a pPrepared.
+	 *
+	 * Only pointers are swapped, so this is cheap enough to be
+	 * called with the AudioEngine locked. The previous kit is handed
+	 * back in @a pPrepared and should be released after unlocking.
+	 *
+	 * \param pPrepared Obtained via prepareDrumkit().
+	 * \param bConditional Whether instruments not contained in the
+	 *   new kit are kept in case they are used in a pattern.
+	 */
+	void commitDrumkit( std::shared_ptr<PreparedDrumkit> pPrepared, bool bConditional );
+	/** Convenience function calling prepareDrumkit() and
+	 * commitDrumkit().*/
 	void loadDrumkit( Drumkit* pDrumkit, bool bConditional );
 	void removeInstrument( int nInstrumentNumber, bool bConditional );
 
@@ -298,8 +347,27 @@ class Song : public H2Core::Object<Song>, public std::enable_shared_from_this<So
 		QString toQString( const QString& sPrefix, bool bShort = true ) const override;
 	
 private:
+	/** Reuses loadFrom() for the parts not stored in binary form and
+	 * checkVersion().*/
+	friend class SongSnapshot;
 
-	static std::shared_ptr<Song> loadFrom( XMLNode* pNode, bool bSilent = false );
+	/**
+	 * \param pNode 'song' node to read from.
+	 * \param bSilent Whether infos, warnings, and errors should
+	 *   be logged.
+	 * \param pInstrumentList Already loaded instrument list. If
+	 *   nullptr, it will be read from @a pNode. The song takes
+	 *   ownership.
+	 * \param pPatternList Already loaded pattern list. If nullptr,
+	 *   it will be read from @a pNode. The song takes ownership.
+	 */
+	static std::shared_ptr<Song> loadFrom( XMLNode* pNode, bool bSilent = false,
+										   InstrumentList* pInstrumentList = nullptr,
+										   PatternList* pPatternList = nullptr );
+	/** Logs a message in case the song stored in @a pNode was
+	 * created by a different version of Hydrogen.*/
+	static void checkVersion( XMLNode* pNode, const QString& sFilename,
+							  bool bSilent = false );
 	void writeTo( XMLNode* pNode, bool bSilent = false );
 
 	void loadVirtualPatternsFrom( XMLNode* pNode, bool bSilent = false );
@@ -354,6 +422,7 @@ private:
 		float			m_fHumanizeVelocityValue;
 		float			m_fSwingFactor;
 		bool			m_bIsModified;
+		long			m_nRevision;
 		std::map< float, int> 	m_latestRoundRobins;
 		Mode			m_mode;
 		
@@ -493,6 +562,11 @@ inline bool Song::getIsModified() const
 	return m_bIsModified;
 }
 
+inline long Song::getRevision() const
+{
+	return m_nRevision;
+}
+
 inline InstrumentList* Song::getInstrumentList() const
 {
 	return m_pInstrumentList;
@@ -0,0 +1,348 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#include <core/Basics/SongSnapshot.h>
+
+#include <core/Basics/InstrumentList.h>
+#include <core/Basics/Note.h>
+#include <core/Basics/Pattern.h>
+#include <core/Basics/PatternList.h>
+#include <core/Basics/Song.h>
+#include <core/Helpers/Xml.h>
+#include <core/Version.h>
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+#include <map>
+#include <vector>
+
+namespace H2Core
+{
+
+/** "H2SS" */
+static constexpr quint32 nMagic = 0x48325353;
+
+/** Nodes of the .h2song file stored in binary form.*/
+static const QStringList binaryNodes{ "patternList", "virtualPatternList",
+									  "patternSequence" };
+
+QString SongSnapshot::pathFor( const QString& sSongPath ) {
+	return sSongPath + ".snapshot";
+}
+
+void SongSnapshot::remove( const QString& sSongPath ) {
+	const QString sPath = pathFor( sSongPath );
+	if ( QFile::exists( sPath ) && ! QFile::remove( sPath ) ) {
+		ERRORLOG( QString( "Unable to remove outdated snapshot [%1]" ).arg( sPath ) );
+	}
+}
+
+bool SongSnapshot::save( const Song* pSong, const XMLDoc& doc,
+						 const QString& sSongPath ) {
+	QFileInfo songInfo( sSongPath );
+	if ( pSong == nullptr || ! songInfo.exists() ) {
+		ERRORLOG( QString( "Unable to create snapshot for [%1]" ).arg( sSongPath ) );
+		return false;
+	}
+
+	// All nodes handled in binary form are replaced by empty ones.
+	QDomDocument skeleton = doc.cloneNode( true ).toDocument();
+	QDomElement songElement = skeleton.firstChildElement( "song" );
+	for ( const auto& sNode : binaryNodes ) {
+		QDomElement element = songElement.firstChildElement( sNode );
+		if ( ! element.isNull() ) {
+			songElement.replaceChild( skeleton.createElement( sNode ), element );
+		} else {
+			songElement.appendChild( skeleton.createElement( sNode ) );
+		}
+	}
+
+	const QString sPath = pathFor( sSongPath );
+	QSaveFile file( sPath );
+	if ( ! file.open( QIODevice::WriteOnly ) ) {
+		ERRORLOG( QString( "Unable to open [%1] for writing" ).arg( sPath ) );
+		return false;
+	}
+
+	QDataStream stream( &file );
+	stream.setVersion( QDataStream::Qt_5_0 );
+	stream.setFloatingPointPrecision( QDataStream::SinglePrecision );
+
+	stream << nMagic << nVersion
+		   << static_cast<qint64>( songInfo.size() )
+		   << static_cast<qint64>( songInfo.lastModified().toMSecsSinceEpoch() )
+		   << QString( get_version().c_str() )
+		   << skeleton.toByteArray( 0 );
+
+	PatternList* pPatternList = pSong->getPatternList();
+	std::map<const Pattern*, quint32> indices;
+	stream << static_cast<quint32>( pPatternList->size() );
+	for ( const auto& pPattern : *pPatternList ) {
+		const quint32 nIndex = static_cast<quint32>( indices.size() );
+		indices[ pPattern ] = nIndex;
+
+		const auto pNotes = pPattern->get_notes();
+		stream << pPattern->get_name() << pPattern->get_info()
+			   << pPattern->get_category()
+			   << static_cast<qint32>( pPattern->get_length() )
+			   << static_cast<qint32>( pPattern->get_denominator() )
+			   << static_cast<quint32>( pNotes->size() );
+
+		for ( const auto& it : *pNotes ) {
+			Note* pNote = it.second;
+			const int nInstrumentId = pNote->get_instrument() != nullptr ?
+				pNote->get_instrument()->get_id() : pNote->get_instrument_id();
+			stream << static_cast<qint32>( pNote->get_position() )
+				   << static_cast<qint32>( pNote->get_length() )
+				   << static_cast<qint32>( nInstrumentId )
+				   << pNote->get_velocity() << pNote->getPan()
+				   << pNote->get_pitch() << pNote->get_lead_lag()
+				   << pNote->get_probability()
+				   << static_cast<qint8>( pNote->get_key() )
+				   << static_cast<qint8>( pNote->get_octave() )
+				   << static_cast<quint8>( pNote->get_note_off() );
+		}
+	}
+
+	// Patterns not contained in the pattern list are dropped, just
+	// as the XML loader does.
+	auto writeIndices = [&]( auto& patterns ) {
+		std::vector<quint32> patternIndices;
+		for ( const auto& pPattern : patterns ) {
+			const auto it = indices.find( pPattern );
+			if ( it != indices.end() ) {
+				patternIndices.push_back( it->second );
+			}
+		}
+		stream << static_cast<quint32>( patternIndices.size() );
+		for ( const auto nIndex : patternIndices ) {
+			stream << nIndex;
+		}
+	};
+
+	for ( const auto& pPattern : *pPatternList ) {
+		writeIndices( *pPattern->get_virtual_patterns() );
+	}
+
+	const auto pColumns = pSong->getPatternGroupVector();
+	stream << static_cast<quint32>( pColumns->size() );
+	for ( const auto& pColumn : *pColumns ) {
+		writeIndices( *pColumn );
+	}
+
+	if ( stream.status() != QDataStream::Ok || ! file.commit() ) {
+		ERRORLOG( QString( "Unable to write snapshot [%1]" ).arg( sPath ) );
+		return false;
+	}
+
+	return true;
+}
+
+std::shared_ptr<Song> SongSnapshot::load( const QString& sSongPath, bool bSilent ) {
+	const QString sPath = pathFor( sSongPath );
+	QFileInfo songInfo( sSongPath );
+	if ( ! songInfo.exists() || ! QFile::exists( sPath ) ) {
+		return nullptr;
+	}
+
+	QFile file( sPath );
+	if ( ! file.open( QIODevice::ReadOnly ) ) {
+		ERRORLOG( QString( "Unable to open snapshot [%1]" ).arg( sPath ) );
+		return nullptr;
+	}
+
+	// Reading from the mapped file avoids copying its content into
+	// a separate buffer first.
+	QByteArray data;
+	const uchar* pData = file.map( 0, file.size() );
+	if ( pData != nullptr ) {
+		data = QByteArray::fromRawData( reinterpret_cast<const char*>( pData ),
+										 static_cast<int>( file.size() ) );
+	} else {
+		data = file.readAll();
+	}
+
+	QDataStream stream( data );
+	stream.setVersion( QDataStream::Qt_5_0 );
+	stream.setFloatingPointPrecision( QDataStream::SinglePrecision );
+
+	quint32 nFileMagic, nFileVersion;
+	qint64 nSongSize, nSongModified;
+	stream >> nFileMagic >> nFileVersion >> nSongSize >> nSongModified;
+	if ( stream.status() != QDataStream::Ok || nFileMagic != nMagic ||
+		 nFileVersion != nVersion ) {
+		WARNINGLOG( QString( "Ignoring snapshot [%1] of unsupported format" )
+					.arg( sPath ) );
+		return nullptr;
+	}
+	if ( nSongSize != songInfo.size() ||
+		 nSongModified != songInfo.lastModified().toMSecsSinceEpoch() ) {
+		if ( ! bSilent ) {
+			INFOLOG( QString( "Snapshot [%1] is outdated" ).arg( sPath ) );
+		}
+		return nullptr;
+	}
+
+	// The snapshot holds the result of loading the .h2song file. A
+	// different version of Hydrogen might have handled it differently.
+	QString sSnapshotVersion;
+	stream >> sSnapshotVersion;
+	if ( stream.status() != QDataStream::Ok ||
+		 sSnapshotVersion != QString( get_version().c_str() ) ) {
+		if ( ! bSilent ) {
+			INFOLOG( QString( "Snapshot [%1] was created by a different version [%2] of hydrogen" )
+					 .arg( sPath ).arg( sSnapshotVersion ) );
+		}
+		return nullptr;
+	}
+
+	QByteArray skeletonData;
+	stream >> skeletonData;
+	XMLDoc doc;
+	if ( stream.status() != QDataStream::Ok || ! doc.setContent( skeletonData ) ) {
+		ERRORLOG( QString( "Corrupted snapshot [%1]" ).arg( sPath ) );
+		return nullptr;
+	}
+
+	XMLNode songNode = doc.firstChildElement( "song" );
+	if ( songNode.isNull() ) {
+		ERRORLOG( QString( "Corrupted snapshot [%1]" ).arg( sPath ) );
+		return nullptr;
+	}
+
+	Song::checkVersion( &songNode, sSongPath, bSilent );
+
+	auto pSong = Song::loadFrom( &songNode, bSilent );
+	if ( pSong == nullptr || pSong->getPatternGroupVector() == nullptr ) {
+		return nullptr;
+	}
+	InstrumentList* pInstrumentList = pSong->getInstrumentList();
+
+	bool bCorrupted = false;
+	PatternList* pPatternList = new PatternList();
+	std::vector<Pattern*> patterns;
+
+	quint32 nPatterns;
+	stream >> nPatterns;
+	for ( quint32 ii = 0; ii < nPatterns &&
+			  stream.status() == QDataStream::Ok; ++ii ) {
+		QString sName, sInfo, sCategory;
+		qint32 nLength, nDenominator;
+		quint32 nNotes;
+		stream >> sName >> sInfo >> sCategory >> nLength >> nDenominator >> nNotes;
+
+		Pattern* pPattern = new Pattern( sName, sInfo, sCategory,
+										 nLength, nDenominator );
+		pPatternList->add( pPattern );
+		patterns.push_back( pPattern );
+
+		for ( quint32 nn = 0; nn < nNotes &&
+				  stream.status() == QDataStream::Ok; ++nn ) {
+			qint32 nPosition, nNoteLength, nInstrumentId;
+			float fVelocity, fPan, fPitch, fLeadLag, fProbability;
+			qint8 nKey, nOctave;
+			quint8 nNoteOff;
+			stream >> nPosition >> nNoteLength >> nInstrumentId
+				   >> fVelocity >> fPan >> fPitch >> fLeadLag >> fProbability
+				   >> nKey >> nOctave >> nNoteOff;
+
+			Note* pNote = new Note( nullptr, nPosition, fVelocity, fPan,
+									nNoteLength, fPitch );
+			pNote->set_lead_lag( fLeadLag );
+			pNote->set_key_octave( static_cast<Note::Key>( nKey ),
+								   static_cast<Note::Octave>( nOctave ) );
+			pNote->set_note_off( nNoteOff != 0 );
+			pNote->set_instrument_id( nInstrumentId );
+			pNote->map_instrument( pInstrumentList );
+			pNote->set_probability( fProbability );
+			pPattern->insert_note( pNote );
+		}
+	}
+
+	auto readPattern = [&]() -> Pattern* {
+		quint32 nIndex;
+		stream >> nIndex;
+		if ( stream.status() != QDataStream::Ok || nIndex >= patterns.size() ) {
+			bCorrupted = true;
+			return nullptr;
+		}
+		return patterns[ nIndex ];
+	};
+
+	for ( auto& pPattern : patterns ) {
+		quint32 nVirtualPatterns;
+		stream >> nVirtualPatterns;
+		for ( quint32 ii = 0; ii < nVirtualPatterns && ! bCorrupted; ++ii ) {
+			Pattern* pVirtualPattern = readPattern();
+			if ( pVirtualPattern != nullptr ) {
+				pPattern->virtual_patterns_add( pVirtualPattern );
+			}
+		}
+	}
+	pPatternList->flattened_virtual_patterns_compute();
+
+	std::vector<PatternList*> columns;
+	quint32 nColumns;
+	stream >> nColumns;
+	for ( quint32 ii = 0; ii < nColumns && ! bCorrupted &&
+			  stream.status() == QDataStream::Ok; ++ii ) {
+		PatternList* pColumn = new PatternList();
+		columns.push_back( pColumn );
+
+		quint32 nColumnPatterns;
+		stream >> nColumnPatterns;
+		for ( quint32 nn = 0; nn < nColumnPatterns && ! bCorrupted; ++nn ) {
+			Pattern* pPattern = readPattern();
+			if ( pPattern != nullptr ) {
+				pColumn->add( pPattern );
+			}
+		}
+	}
+
+	if ( bCorrupted || stream.status() != QDataStream::Ok ) {
+		ERRORLOG( QString( "Corrupted snapshot [%1]" ).arg( sPath ) );
+		for ( auto& pColumn : columns ) {
+			// Patterns are owned by pPatternList.
+			pColumn->clear();
+			delete pColumn;
+		}
+		delete pPatternList;
+		return nullptr;
+	}
+
+	delete pSong->getPatternList();
+	pSong->setPatternList( pPatternList );
+	for ( auto& pColumn : columns ) {
+		pSong->getPatternGroupVector()->push_back( pColumn );
+	}
+
+	if ( ! bSilent ) {
+		INFOLOG( QString( "Song loaded from snapshot [%1]" ).arg( sPath ) );
+	}
+
+	return pSong;
+}
+
+};
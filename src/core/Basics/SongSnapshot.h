@@ -0,0 +1,96 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#ifndef H2C_SONG_SNAPSHOT_H
+#define H2C_SONG_SNAPSHOT_H
+
+#include <core/Object.h>
+
+#include <memory>
+
+namespace H2Core
+{
+
+class Song;
+class XMLDoc;
+
+/**
+ * Compact binary cache of a .h2song file stored next to it (with
+ * the suffix ".snapshot").
+ *
+ * The snapshot is written by Song::load() right after the .h2song
+ * file was loaded from XML. It thus holds the very song the XML
+ * loading code produced. Song::save() removes it.
+ *
+ * Patterns, virtual patterns, and the pattern sequence - by far the
+ * largest and most expensive parts to parse in a regular song - are
+ * stored as plain binary records. All remaining parts of the song
+ * are kept as a small XML skeleton and read using the regular
+ * Song::loadFrom() code. This way all backward compatibility and
+ * fallback handling of the XML loading code is retained.
+ *
+ * A snapshot is only used in case the size and the modification
+ * time of the .h2song file it was created for did not change and
+ * it was written by the same version of Hydrogen. Otherwise (or in
+ * case the snapshot is corrupted) Song::load() falls back to the XML
+ * file and replaces the snapshot.
+ */
+/** \ingroup docCore*/
+class SongSnapshot : public H2Core::Object<SongSnapshot>
+{
+	H2_OBJECT(SongSnapshot)
+public:
+	/** \return Path of the snapshot belonging to @a sSongPath.*/
+	static QString pathFor( const QString& sSongPath );
+
+	/**
+	 * Writes a snapshot of @a pSong.
+	 *
+	 * \param pSong Song just loaded from @a sSongPath.
+	 * \param doc XML document holding all nodes of @a sSongPath
+	 *   @a pSong was created from. Nodes stored in binary form may
+	 *   be missing. Its content is not altered.
+	 * \param sSongPath Path of the corresponding .h2song file.
+	 *
+	 * \return true on success.
+	 */
+	static bool save( const Song* pSong, const XMLDoc& doc,
+					  const QString& sSongPath );
+
+	/**
+	 * \return The song stored in the snapshot of @a sSongPath or
+	 * nullptr in case there is no up-to-date snapshot.
+	 */
+	static std::shared_ptr<Song> load( const QString& sSongPath,
+									   bool bSilent = false );
+
+	/** Removes the snapshot belonging to @a sSongPath (if present).*/
+	static void remove( const QString& sSongPath );
+
+	/** Version of the binary format. Snapshots of a different
+	 * version, or ones created by a different version of Hydrogen,
+	 * are ignored.*/
+	static constexpr quint32 nVersion = 2;
+};
+
+};
+
+#endif
@@ -0,0 +1,243 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+#include <core/Basics/WaveformPeaks.h>
+#include <core/Basics/Sample.h>
+
+#include <condition_variable>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <thread>
+
+namespace H2Core
+{
+
+namespace {
+
+/** Single thread creating the peaks of all scheduled samples. It is
+ * started on first use and joined at exit.*/
+class PeakWorker {
+public:
+	PeakWorker() : m_bShutdown( false ), m_bBusy( false ) {
+		m_thread = std::thread( &PeakWorker::run, this );
+	}
+	~PeakWorker() {
+		{
+			std::lock_guard<std::mutex> lock( m_mutex );
+			m_bShutdown = true;
+			m_queue.clear();
+		}
+		m_condition.notify_all();
+		m_thread.join();
+	}
+
+	void push( std::weak_ptr<Sample> pSample ) {
+		{
+			std::lock_guard<std::mutex> lock( m_mutex );
+			m_queue.push_back( pSample );
+		}
+		m_condition.notify_all();
+	}
+
+	void wait() {
+		std::unique_lock<std::mutex> lock( m_mutex );
+		m_finishedCondition.wait( lock, [&]{
+			return ( m_queue.empty() && ! m_bBusy ) || m_bShutdown; } );
+	}
+
+private:
+	void run() {
+		std::unique_lock<std::mutex> lock( m_mutex );
+		while ( true ) {
+			m_condition.wait( lock, [&]{
+				return ! m_queue.empty() || m_bShutdown; } );
+			if ( m_bShutdown ) {
+				break;
+			}
+
+			auto pSample = m_queue.front().lock();
+			m_queue.pop_front();
+			m_bBusy = true;
+			lock.unlock();
+
+			if ( pSample != nullptr ) {
+				pSample->getWaveformPeaks();
+			}
+			// Release the sample outside of the lock. It might have
+			// been the last reference.
+			pSample = nullptr;
+
+			lock.lock();
+			m_bBusy = false;
+			m_finishedCondition.notify_all();
+		}
+		m_finishedCondition.notify_all();
+	}
+
+	std::thread m_thread;
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+	std::condition_variable m_finishedCondition;
+	std::deque<std::weak_ptr<Sample>> m_queue;
+	bool m_bShutdown;
+	bool m_bBusy;
+};
+
+PeakWorker& peakWorker() {
+	static PeakWorker worker;
+	return worker;
+}
+
+};
+
+WaveformPeaks::WaveformPeaks( const float* pData_L, const float* pData_R, int nFrames )
+	: m_nFrames( std::max( nFrames, 0 ) )
+{
+	const float* data[ 2 ] = { pData_L, pData_R };
+
+	for ( int nChannel = 0; nChannel < 2; ++nChannel ) {
+		const float* pData = data[ nChannel ];
+		if ( pData == nullptr || m_nFrames == 0 ) {
+			continue;
+		}
+
+		// First level from the raw data. The last block might be
+		// incomplete.
+		std::vector<Peak> level( ( m_nFrames + nBlockSize - 1 ) / nBlockSize );
+		for ( int nBlock = 0; nBlock < level.size(); ++nBlock ) {
+			const int nStart = nBlock * nBlockSize;
+			const int nEnd = std::min( nStart + nBlockSize, m_nFrames );
+			float fMin = pData[ nStart ];
+			float fMax = pData[ nStart ];
+			for ( int ii = nStart + 1; ii < nEnd; ++ii ) {
+				fMin = std::min( fMin, pData[ ii ] );
+				fMax = std::max( fMax, pData[ ii ] );
+			}
+			level[ nBlock ] = { fMin, fMax };
+		}
+		m_levels[ nChannel ].push_back( std::move( level ) );
+
+		// Coarser levels are built until a single block covers the
+		// whole sample.
+		while ( m_levels[ nChannel ].back().size() > 1 ) {
+			const auto& finer = m_levels[ nChannel ].back();
+			std::vector<Peak> coarser( ( finer.size() + nLevelFactor - 1 ) / nLevelFactor );
+			for ( int nBlock = 0; nBlock < coarser.size(); ++nBlock ) {
+				const int nStart = nBlock * nLevelFactor;
+				const int nEnd = std::min( nStart + nLevelFactor,
+										   static_cast<int>( finer.size() ) );
+				Peak peak = finer[ nStart ];
+				for ( int ii = nStart + 1; ii < nEnd; ++ii ) {
+					peak.fMin = std::min( peak.fMin, finer[ ii ].fMin );
+					peak.fMax = std::max( peak.fMax, finer[ ii ].fMax );
+				}
+				coarser[ nBlock ] = peak;
+			}
+			m_levels[ nChannel ].push_back( std::move( coarser ) );
+		}
+	}
+}
+
+void WaveformPeaks::mergeRaw( Peak& peak, const float* pData, int nStart, int nEnd ) const
+{
+	if ( pData == nullptr ) {
+		return;
+	}
+	for ( int ii = nStart; ii < nEnd; ++ii ) {
+		peak.fMin = std::min( peak.fMin, pData[ ii ] );
+		peak.fMax = std::max( peak.fMax, pData[ ii ] );
+	}
+}
+
+WaveformPeaks::Peak WaveformPeaks::getPeak( int nChannel, const float* pData,
+											int nStart, int nEnd ) const
+{
+	nStart = std::max( nStart, 0 );
+	nEnd = std::min( nEnd, m_nFrames );
+	if ( nChannel < 0 || nChannel > 1 || nStart >= nEnd ||
+		 m_levels[ nChannel ].empty() ) {
+		return { 0, 0 };
+	}
+
+	const auto& levels = m_levels[ nChannel ];
+	Peak peak = { std::numeric_limits<float>::max(),
+				  std::numeric_limits<float>::lowest() };
+
+	int nPos = nStart;
+	while ( nPos < nEnd ) {
+		if ( nPos % nBlockSize != 0 || nPos + nBlockSize > nEnd ) {
+			// Unaligned head or tail. Read the raw frames up to the
+			// next block boundary.
+			const int nNext = std::min( ( nPos / nBlockSize + 1 ) * nBlockSize, nEnd );
+			mergeRaw( peak, pData, nPos, nNext );
+			nPos = nNext;
+			continue;
+		}
+
+		// Climb up to the coarsest block starting at nPos and still
+		// fitting into the range.
+		int nLevel = 0;
+		int nSize = nBlockSize;
+		while ( nLevel + 1 < levels.size() &&
+				nPos % ( nSize * nLevelFactor ) == 0 &&
+				nPos + nSize * nLevelFactor <= nEnd ) {
+			++nLevel;
+			nSize *= nLevelFactor;
+		}
+
+		const Peak& block = levels[ nLevel ][ nPos / nSize ];
+		peak.fMin = std::min( peak.fMin, block.fMin );
+		peak.fMax = std::max( peak.fMax, block.fMax );
+		nPos += nSize;
+	}
+
+	if ( peak.fMin > peak.fMax ) {
+		// No raw data provided for a range not covered by a block.
+		return { 0, 0 };
+	}
+
+	return peak;
+}
+
+size_t WaveformPeaks::getMemoryUsage() const
+{
+	size_t nBytes = 0;
+	for ( const auto& levels : m_levels ) {
+		for ( const auto& level : levels ) {
+			nBytes += level.size() * sizeof( Peak );
+		}
+	}
+	return nBytes;
+}
+
+void WaveformPeaks::schedule( std::weak_ptr<Sample> pSample )
+{
+	peakWorker().push( pSample );
+}
+
+void WaveformPeaks::waitForScheduled()
+{
+	peakWorker().wait();
+}
+
+};
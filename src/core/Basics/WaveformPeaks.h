@@ -0,0 +1,135 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+#ifndef H2C_WAVEFORM_PEAKS_H
+#define H2C_WAVEFORM_PEAKS_H
+
+#include <core/Object.h>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace H2Core
+{
+
+class Sample;
+
+/**
+ * Multi-resolution min/max summary of the audio data of a #Sample
+ * used to draw waveforms.
+ *
+ * The first level holds the minimum and maximum of consecutive
+ * blocks of #nBlockSize frames. Each following level combines
+ * #nLevelFactor blocks of the previous one. getPeak() covers an
+ * arbitrary range of frames by combining the coarsest blocks fitting
+ * into it and only reads the raw data at the unaligned edges. This
+ * way the cost of drawing a column does not depend on the number of
+ * frames it covers.
+ *
+ * Instances are immutable and shared between the #Sample they were
+ * created for and all widgets displaying it. They are usually
+ * obtained via Sample::getWaveformPeaks().
+ */
+/** \ingroup docCore*/
+class WaveformPeaks : public H2Core::Object<WaveformPeaks>
+{
+	H2_OBJECT(WaveformPeaks)
+public:
+	struct Peak {
+		float fMin;
+		float fMax;
+
+		/** \return The larger one of the absolute values of
+		 * #fMin and #fMax.*/
+		float getMagnitude() const;
+		/** \return Either #fMin or #fMax, whichever has the larger
+		 * absolute value.*/
+		float getExtremum() const;
+	};
+
+	/** Number of frames summarized by a single entry of the first
+	 * level.*/
+	static constexpr int nBlockSize = 256;
+	/** Number of entries of a level combined into a single entry
+	 * of the next one.*/
+	static constexpr int nLevelFactor = 4;
+
+	WaveformPeaks( const float* pData_L, const float* pData_R, int nFrames );
+
+	/**
+	 * Minimum and maximum value of a channel within the frames
+	 * [@a nStart, @a nEnd).
+	 *
+	 * \param nChannel 0 for the left and 1 for the right channel.
+	 * \param pData Raw data of @a nChannel the peaks were created
+	 *   from. It is used for the frames not covered by a complete
+	 *   block.
+	 * \param nStart First frame (inclusive).
+	 * \param nEnd Last frame (exclusive).
+	 *
+	 * \return Peak of the range. In case it is empty or does not
+	 * overlap with the sample, both values are 0.
+	 */
+	Peak getPeak( int nChannel, const float* pData, int nStart, int nEnd ) const;
+
+	int getFrames() const;
+	int getLevelCount() const;
+	/** \return Number of bytes occupied by all levels.*/
+	size_t getMemoryUsage() const;
+
+	/**
+	 * Creates the peaks of @a pSample in a background thread.
+	 *
+	 * Widgets calling Sample::getWaveformPeaks() before the worker
+	 * got to the sample compute them on their own. Samples already
+	 * destroyed once the worker picks them up are skipped.
+	 */
+	static void schedule( std::weak_ptr<Sample> pSample );
+	/** Blocks until all samples passed to schedule() are
+	 * processed.*/
+	static void waitForScheduled();
+
+private:
+	void mergeRaw( Peak& peak, const float* pData, int nStart, int nEnd ) const;
+
+	int m_nFrames;
+	/** Levels of both channels. Index 0 is the finest one.*/
+	std::vector<std::vector<Peak>> m_levels[ 2 ];
+};
+
+inline float WaveformPeaks::Peak::getMagnitude() const {
+	return std::max( -fMin, fMax );
+}
+inline float WaveformPeaks::Peak::getExtremum() const {
+	return -fMin > fMax ? fMin : fMax;
+}
+inline int WaveformPeaks::getFrames() const {
+	return m_nFrames;
+}
+inline int WaveformPeaks::getLevelCount() const {
+	return static_cast<int>( m_levels[ 0 ].size() );
+}
+
+};
+
+#endif
@@ -471,6 +471,12 @@ bool CoreActionController::initExternalControlInterfaces()
 	 * Push the current state of Hydrogen to the attached control interfaces (e.g. OSC clients)
 	 */
 	
+	// Control interfaces are attached to the engine of the default
+	// context only.
+	if ( ! EngineContext::current()->isDefault() ) {
+		return true;
+	}
+
 	//MASTER_VOLUME_ABSOLUTE
 	auto pHydrogen = Hydrogen::get_instance();
 	auto pSong = pHydrogen->getSong();
@@ -711,15 +717,9 @@ bool CoreActionController::savePreferences() {
 }
 bool CoreActionController::quit() {
 
-	if ( Hydrogen::get_instance()->getGUIState() != Hydrogen::GUIState::unavailable ) {
-		EventQueue::get_instance()->push_event( EVENT_QUIT, 0 );
-	} else {
-		// TODO: Close Hydrogen with no GUI present.
-		
-		ERRORLOG( QString( "Error: Closing the application via the core part is not supported yet!" ) );
-		return false;
-		
-	}
+	// Both the GUI and the event loop of h2cli (including its daemon
+	// mode) shut down on this event.
+	EventQueue::get_instance()->push_event( EVENT_QUIT, 0 );
 	
 	return true;
 }
@@ -0,0 +1,86 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#include <core/EngineContext.h>
+
+#include <core/EventQueue.h>
+#include <core/Hydrogen.h>
+#include <core/MidiMap.h>
+#include <core/FX/Effects.h>
+#include <core/Preferences/Preferences.h>
+
+#include <cassert>
+
+namespace H2Core
+{
+
+thread_local EngineContext* EngineContext::m_pCurrent = nullptr;
+
+EngineContext::EngineContext()
+	: m_pHydrogen( nullptr )
+	, m_pPreferences( nullptr )
+	, m_pEventQueue( nullptr )
+	, m_pEffects( nullptr )
+	, m_pMidiMap( nullptr )
+{
+}
+
+EngineContext::~EngineContext()
+{
+	assert( ! isDefault() );
+
+	// The destructors access the remaining instances using their
+	// get_instance() functions.
+	Scope scope( this );
+
+	// The engine has to go first. The Effects are owned by its
+	// AudioEngine.
+	delete m_pHydrogen;
+	delete m_pEventQueue;
+	delete m_pMidiMap;
+	delete m_pPreferences;
+
+	m_pHydrogen = nullptr;
+	m_pEventQueue = nullptr;
+	m_pMidiMap = nullptr;
+	m_pPreferences = nullptr;
+}
+
+EngineContext* EngineContext::getDefault()
+{
+	// Never destroyed. The instances of the default context are
+	// deleted explicitly on shutdown.
+	static EngineContext* pDefault = new EngineContext;
+	return pDefault;
+}
+
+EngineContext::Scope::Scope( EngineContext* pContext )
+	: m_pPrevious( EngineContext::m_pCurrent )
+{
+	EngineContext::m_pCurrent = pContext;
+}
+
+EngineContext::Scope::~Scope()
+{
+	EngineContext::m_pCurrent = m_pPrevious;
+}
+
+};
@@ -0,0 +1,136 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#ifndef H2C_ENGINE_CONTEXT_H
+#define H2C_ENGINE_CONTEXT_H
+
+namespace H2Core
+{
+
+class Hydrogen;
+class Preferences;
+class EventQueue;
+class Effects;
+class MidiMap;
+
+/**
+ * Holds all instances required to run a single engine.
+ *
+ * The get_instance() functions of Hydrogen, Preferences, EventQueue,
+ * Effects, and MidiMap do not return a process-wide singleton but the
+ * instance stored in the context current for the calling thread. By
+ * default this is the context returned by getDefault(), so code not
+ * aware of contexts behaves as before.
+ *
+ * In order to run another engine in the same process, create a new
+ * context, make it current using a Scope, and call
+ * Hydrogen::create_instance(). All threads working on behalf of this
+ * engine (e.g. the DriverThread) have to make the context current as
+ * well.
+ *
+ * The Logger, the MIDI action handling, the OSC server, the NSM
+ * client, the Playlist, and the maximum number of instrument layers
+ * (InstrumentComponent::getMaxLayers()) are still shared by all
+ * contexts and only set up in the default one. Secondary contexts are therefore intended for offline
+ * rendering using the DiskWriterDriver, FakeDriver, or NullDriver.
+ */
+/** \ingroup docCore */
+class EngineContext
+{
+public:
+	EngineContext();
+	/** Deletes all instances owned by the context. Not allowed for
+	 * the default context, whose instances are destroyed explicitly
+	 * during shutdown.*/
+	~EngineContext();
+
+	EngineContext( const EngineContext& ) = delete;
+	EngineContext& operator=( const EngineContext& ) = delete;
+
+	/** Context wrapping the instances previously known as
+	 * singletons.*/
+	static EngineContext* getDefault();
+	/** Context of the calling thread.*/
+	static EngineContext* current() {
+		return m_pCurrent != nullptr ? m_pCurrent : getDefault();
+	}
+	bool isDefault() const {
+		return this == getDefault();
+	}
+
+	/** Makes a context current for the calling thread till the
+	 * scope is left.*/
+	class Scope
+	{
+	public:
+		explicit Scope( EngineContext* pContext );
+		~Scope();
+
+		Scope( const Scope& ) = delete;
+		Scope& operator=( const Scope& ) = delete;
+	private:
+		EngineContext* m_pPrevious;
+	};
+
+	Hydrogen* getHydrogen() const {
+		return m_pHydrogen;
+	}
+	void setHydrogen( Hydrogen* pHydrogen ) {
+		m_pHydrogen = pHydrogen;
+	}
+	Preferences* getPreferences() const {
+		return m_pPreferences;
+	}
+	void setPreferences( Preferences* pPreferences ) {
+		m_pPreferences = pPreferences;
+	}
+	EventQueue* getEventQueue() const {
+		return m_pEventQueue;
+	}
+	void setEventQueue( EventQueue* pEventQueue ) {
+		m_pEventQueue = pEventQueue;
+	}
+	Effects* getEffects() const {
+		return m_pEffects;
+	}
+	void setEffects( Effects* pEffects ) {
+		m_pEffects = pEffects;
+	}
+	MidiMap* getMidiMap() const {
+		return m_pMidiMap;
+	}
+	void setMidiMap( MidiMap* pMidiMap ) {
+		m_pMidiMap = pMidiMap;
+	}
+
+private:
+	static thread_local EngineContext* m_pCurrent;
+
+	Hydrogen* m_pHydrogen;
+	Preferences* m_pPreferences;
+	EventQueue* m_pEventQueue;
+	Effects* m_pEffects;
+	MidiMap* m_pMidiMap;
+};
+
+};
+
+#endif
@@ -25,12 +25,10 @@
 namespace H2Core
 {
 
-EventQueue* EventQueue::__instance = nullptr;
-
 void EventQueue::create_instance()
 {
-	if ( __instance == nullptr ) {
-		__instance = new EventQueue;
+	if ( EngineContext::current()->getEventQueue() == nullptr ) {
+		new EventQueue;
 	}
 }
 
@@ -40,7 +38,7 @@ EventQueue::EventQueue()
 		, __write_index( 0 )
 		, m_bSilent( false )
 {
-	__instance = this;
+	EngineContext::current()->setEventQueue( this );
 
 	for ( int i = 0; i < MAX_EVENTS; ++i ) {
 		__events_buffer[ i ].type = EVENT_NONE;
@@ -52,6 +50,9 @@ EventQueue::EventQueue()
 EventQueue::~EventQueue()
 {
 //	infoLog( "DESTROY" );
+	if ( EngineContext::current()->getEventQueue() == this ) {
+		EngineContext::current()->setEventQueue( nullptr );
+	}
 }
 
 
@@ -24,6 +24,7 @@
 #define EVENT_QUEUE_H
 
 #include <core/Object.h>
+#include <core/EngineContext.h>
 #include <core/Basics/Note.h>
 #include <cassert>
 #include <mutex>
@@ -171,7 +172,14 @@ enum EventType {
 	EVENT_RELOCATION,
 	EVENT_SONG_SIZE_CHANGED,
 	EVENT_DRIVER_CHANGED,
-	EVENT_PLAYBACK_TRACK_CHANGED
+	EVENT_PLAYBACK_TRACK_CHANGED,
+	/** The SamplePreview finished decoding a sample. The value is 1
+	 * on success and 0 otherwise.*/
+	EVENT_PREVIEW_LOADED,
+	/** Progress (in percent) of installing or exporting drumkits.
+	 * Kept apart from #EVENT_PROGRESS, which value 100 signals the
+	 * end of a song export.*/
+	EVENT_DRUMKIT_PROGRESS
 };
 
 /** Basic building block for the communication between the core of
@@ -207,17 +215,17 @@ class EventQueue : public H2Core::Object<EventQueue>
 {
 	H2_OBJECT(EventQueue)
 public:/**
-	* If #__instance equals 0, a new EventQueue singleton will be
-	 * created and stored in it.
+	* If the current EngineContext does not hold an EventQueue
+	 * yet, a new one will be created and stored in it.
 	 *
 	 * It is called in Hydrogen::create_instance().
 	 */
 	static void create_instance();
 	/**
-	 * Returns a pointer to the current EventQueue singleton
-	 * stored in #__instance.
+	 * Returns a pointer to the EventQueue of the current
+	 * EngineContext.
 	 */
-	static EventQueue* get_instance() { assert(__instance); return __instance; }
+	static EventQueue* get_instance() { assert( EngineContext::current()->getEventQueue() ); return EngineContext::current()->getEventQueue(); }
 	~EventQueue();
 
 	/**
@@ -277,16 +285,10 @@ private:
 	 * Constructor of the EventQueue class.
 	 *
 	 * It fills all #MAX_EVENTS slots of the #__events_buffer with
-	 * #H2Core::EVENT_NONE and assigns itself to #__instance. Called by
-	 * create_instance().
+	 * #H2Core::EVENT_NONE and assigns itself to the current
+	 * EngineContext. Called by create_instance().
 	 */
 	EventQueue();
-	/**
-	 * Object holding the current EventQueue singleton. It is
-	 * initialized with nullptr, set in EventQueue(), and
-	 * accessed via get_instance().
-	 */
-	static EventQueue *__instance;
 
 	/**
 	 * Continuously growing number indexing the event, which has
@@ -42,14 +42,11 @@
 namespace H2Core
 {
 
-// static data
-Effects* Effects::__instance = nullptr;
-
 Effects::Effects()
 		: m_pRootGroup( nullptr )
 		, m_pRecentGroup( nullptr )
 {
-	__instance = this;
+	EngineContext::current()->setEffects( this );
 
 	for ( int nFX = 0; nFX < MAX_FX; ++nFX ) {
 		m_FXList[ nFX ] = nullptr;
@@ -62,8 +59,8 @@ Effects::Effects()
 
 void Effects::create_instance()
 {
-	if ( __instance == nullptr ) {
-		__instance = new Effects;
+	if ( EngineContext::current()->getEffects() == nullptr ) {
+		new Effects;
 	}
 }
 
@@ -84,6 +81,10 @@ Effects::~Effects()
 	for ( int nFX = 0; nFX < MAX_FX; ++nFX ) {
 		delete m_FXList[ nFX ];
 	}
+
+	if ( EngineContext::current()->getEffects() == this ) {
+		EngineContext::current()->setEffects( nullptr );
+	}
 }
 
 
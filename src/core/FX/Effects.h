@@ -28,6 +28,7 @@
 
 #include <core/Globals.h>
 #include <core/Object.h>
+#include <core/EngineContext.h>
 #include <core/FX/LadspaFX.h>
 
 #include <vector>
@@ -41,17 +42,17 @@ class Effects : public H2Core::Object<Effects>
 	H2_OBJECT(Effects)
 public:
 	/**
-	 * If #__instance equals 0, a new Effects
-	 * singleton will be created and stored in it.
+	 * If the current EngineContext does not hold an Effects
+	 * instance yet, a new one will be created and stored in it.
 	 *
 	 * It is called in Hydrogen::audioEngine_init().
 	 */
 	static void create_instance();
 	/**
-	 * Returns a pointer to the current Effects singleton
-	 * stored in #__instance.
+	 * Returns a pointer to the Effects of the current
+	 * EngineContext.
 	 */
-	static Effects* get_instance() { assert(__instance); return __instance; }
+	static Effects* get_instance() { assert( EngineContext::current()->getEffects() ); return EngineContext::current()->getEffects(); }
 	~Effects();
 
 	LadspaFX* getLadspaFX( int nFX ) const;
@@ -62,12 +63,6 @@ public:
 
 
 private:
-	/**
-	 * Object holding the current Effects singleton. It is
-	 * initialized with NULL, set with create_instance(), and
-	 * accessed with get_instance().
-	 */
-	static Effects* __instance;
 	std::vector<LadspaFXInfo*> m_pluginList;
 	LadspaFXGroup* m_pRootGroup;
 	LadspaFXGroup* m_pRecentGroup;
@@ -0,0 +1,50 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#include <core/FX/FXActivity.h>
+
+namespace H2Core
+{
+
+FXActivity::FXActivity()
+	: m_bInputActive( false )
+	, m_nSilentFrames( 0 )
+	, m_bIdle( false )
+{
+}
+
+bool FXActivity::process( unsigned nFrames, long long nTailFrames )
+{
+	if ( m_bInputActive ) {
+		m_nSilentFrames = 0;
+		m_bInputActive = false;
+	}
+	else if ( m_nSilentFrames <= nTailFrames ) {
+		m_nSilentFrames += nFrames;
+	}
+
+	const bool bIdle = nTailFrames >= 0 && m_nSilentFrames > nTailFrames;
+	m_bIdle = bIdle;
+
+	return ! bIdle;
+}
+
+};
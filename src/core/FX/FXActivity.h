@@ -0,0 +1,79 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#ifndef FX_ACTIVITY_H
+#define FX_ACTIVITY_H
+
+#include <core/Object.h>
+
+#include <atomic>
+
+namespace H2Core
+{
+
+/**
+ * Keeps track of whether an effect received input recently enough
+ * to still be processed.
+ *
+ * Everyone writing into the input of the effect calls
+ * markInputActive() and the audio engine calls process() once per
+ * cycle after all input was written. As soon as the input was silent
+ * for longer than the tail time, the effect is bypassed until input
+ * arrives again.
+ *
+ * All methods but isIdle() must be called by the audio thread.
+ */
+/** \ingroup docCore */
+class FXActivity : public H2Core::Object<FXActivity>
+{
+	H2_OBJECT(FXActivity)
+public:
+	FXActivity();
+
+	void markInputActive() {
+		m_bInputActive = true;
+	}
+	/**
+	 * \param nFrames Size of the current cycle.
+	 * \param nTailFrames Number of frames the effect is still
+	 *   processed after its input became silent. Negative values
+	 *   disable the bypass.
+	 *
+	 * \return false in case the input was silent for longer than
+	 *   @a nTailFrames.
+	 */
+	bool process( unsigned nFrames, long long nTailFrames );
+	/** Whether the effect was bypassed in the last cycle.*/
+	bool isIdle() const {
+		return m_bIdle;
+	}
+
+private:
+	/** Whether input was written in the current cycle.*/
+	bool m_bInputActive;
+	/** Number of frames since the input was active the last time.*/
+	long long m_nSilentFrames;
+	std::atomic<bool> m_bIdle;
+};
+
+};
+
+#endif
@@ -29,8 +29,10 @@
 
 #include <vector>
 #include <list>
+#include <atomic>
 #include "ladspa.h"
 #include <core/Object.h>
+#include <core/FX/FXActivity.h>
 
 namespace H2Core
 {
@@ -138,6 +140,40 @@ public:
 	void deactivate();
 	void processFX( unsigned nFrames );
 
+	/** Has to be called by everyone writing into #m_pBuffer_L and
+	 * #m_pBuffer_R within the current cycle.*/
+	void markInputActive() {
+		m_activity.markInputActive();
+		m_bBuffersDirty = true;
+	}
+	/** Clears the first @a nFrames of the buffers in case they were
+	 * written to since the last call.*/
+	void clearBuffers( unsigned nFrames );
+	/**
+	 * Decides whether the effect has to be processed in the current
+	 * cycle. To be called once per cycle after all input was
+	 * written.
+	 *
+	 * \param nFrames Size of the current cycle.
+	 * \param nTailFrames Number of frames the effect is still
+	 *   processed after its input became silent. Negative values
+	 *   disable the automatic bypass.
+	 *
+	 * \return false in case the input was silent for longer than
+	 *   @a nTailFrames. Both the input and the output of the
+	 *   effect are silent then.
+	 */
+	bool checkActivity( unsigned nFrames, long long nTailFrames );
+	/** Whether the effect was bypassed in the last cycle because of
+	 * a silent input.*/
+	bool isIdle() const {
+		return m_activity.isIdle();
+	}
+	/** Time in ms the last call to processFX() took.*/
+	float getProcessTime() const {
+		return m_fProcessTime;
+	}
+
 
 	const QString& getPluginLabel() const {
 		return m_sLabel;
@@ -173,6 +209,10 @@ private:
 	bool m_pluginType;
 	bool m_bEnabled;
 	bool m_bActivated;	// Guard against plugins that can't be deactivated before being activated (
+	FXActivity m_activity;
+	/** Whether the buffers contain non-silent data.*/
+	bool m_bBuffersDirty;
+	std::atomic<float> m_fProcessTime;
 	QString m_sLabel;
 	QString m_sName;
 	QString m_sLibraryPath;
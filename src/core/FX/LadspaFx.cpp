@@ -28,6 +28,8 @@
 #include <core/Basics/Song.h>
 
 #include <QDir>
+#include <chrono>
+#include <cstring>
 
 #define LADSPA_IS_CONTROL_INPUT(x) (LADSPA_IS_PORT_INPUT(x) && LADSPA_IS_PORT_CONTROL(x))
 #define LADSPA_IS_AUDIO_INPUT(x) (LADSPA_IS_PORT_INPUT(x) && LADSPA_IS_PORT_AUDIO(x))
@@ -126,6 +128,8 @@ LadspaFX::LadspaFX( const QString& sLibraryPath, const QString& sPluginLabel )
 		, m_pluginType( UNDEFINED )
 		, m_bEnabled( false )
 		, m_bActivated( false )
+		, m_bBuffersDirty( false )
+		, m_fProcessTime( 0.0f )
 		, m_sLabel( sPluginLabel )
 		, m_sLibraryPath( sLibraryPath )
 		, m_pLibrary( nullptr )
@@ -438,10 +442,35 @@ void LadspaFX::processFX( unsigned nFrames )
 {
 //	infoLog( "[LadspaFX::applyFX()]" );
 	if( m_bActivated ) {
+		const auto start = std::chrono::steady_clock::now();
 		m_d->run( m_handle, nFrames );
+		m_bBuffersDirty = true;
+		m_fProcessTime = std::chrono::duration<float, std::milli>(
+			std::chrono::steady_clock::now() - start ).count();
 	}
 }
 
+void LadspaFX::clearBuffers( unsigned nFrames )
+{
+	if ( m_bBuffersDirty ) {
+		memset( m_pBuffer_L, 0, nFrames * sizeof( float ) );
+		memset( m_pBuffer_R, 0, nFrames * sizeof( float ) );
+		m_bBuffersDirty = false;
+	}
+}
+
+bool LadspaFX::checkActivity( unsigned nFrames, long long nTailFrames )
+{
+	// Called on the audio thread. Transitions are not logged. The GUI
+	// polls isIdle() instead.
+	const bool bActive = m_activity.process( nFrames, nTailFrames );
+	if ( ! bActive ) {
+		m_fProcessTime = 0.0f;
+	}
+
+	return bActive;
+}
+
 void LadspaFX::activate()
 {
 	if ( m_d->activate ) {
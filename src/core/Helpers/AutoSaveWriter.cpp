@@ -0,0 +1,157 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#include <core/Helpers/AutoSaveWriter.h>
+
+#include <core/Basics/Song.h>
+#include <core/Helpers/Xml.h>
+
+#include <QCryptographicHash>
+#include <QFile>
+#include <QSaveFile>
+
+namespace H2Core
+{
+
+AutoSaveWriter::AutoSaveWriter()
+	: m_bShutdown( false )
+	, m_bWriting( false )
+	, m_pPendingDoc( nullptr )
+	, m_nLastRevision( -1 )
+	, m_nWriteCount( 0 )
+{
+	m_thread = std::thread( &AutoSaveWriter::run, this );
+}
+
+AutoSaveWriter::~AutoSaveWriter()
+{
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+		m_bShutdown = true;
+	}
+	m_condition.notify_all();
+	m_thread.join();
+}
+
+bool AutoSaveWriter::save( std::shared_ptr<Song> pSong, const QString& sPath )
+{
+	if ( pSong == nullptr ) {
+		return false;
+	}
+
+	if ( m_pLastSong.lock() == pSong && m_nLastRevision == pSong->getRevision() &&
+		 m_sLastPath == sPath ) {
+		return false;
+	}
+
+	// Serializing into the DOM only touches memory. Everything else
+	// is left to the worker.
+	auto pDoc = std::make_unique<XMLDoc>();
+	pSong->saveTo( pDoc.get(), true );
+
+	m_pLastSong = pSong;
+	m_nLastRevision = pSong->getRevision();
+	m_sLastPath = sPath;
+
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+		m_pPendingDoc = std::move( pDoc );
+		m_sPendingPath = sPath;
+	}
+	m_condition.notify_all();
+
+	return true;
+}
+
+void AutoSaveWriter::waitForFinished()
+{
+	std::unique_lock<std::mutex> lock( m_mutex );
+	m_finishedCondition.wait( lock, [&]{
+		return m_pPendingDoc == nullptr && ! m_bWriting; } );
+}
+
+int AutoSaveWriter::getWriteCount() const
+{
+	std::lock_guard<std::mutex> lock( m_mutex );
+	return m_nWriteCount;
+}
+
+void AutoSaveWriter::run()
+{
+	std::unique_lock<std::mutex> lock( m_mutex );
+	while ( true ) {
+		m_condition.wait( lock, [&]{
+			return m_pPendingDoc != nullptr || m_bShutdown; } );
+
+		if ( m_pPendingDoc != nullptr ) {
+			auto pDoc = std::move( m_pPendingDoc );
+			const QString sPath = m_sPendingPath;
+			m_bWriting = true;
+			lock.unlock();
+
+			const bool bWritten = write( *pDoc, sPath );
+			pDoc.reset();
+
+			lock.lock();
+			if ( bWritten ) {
+				++m_nWriteCount;
+			}
+			m_bWriting = false;
+			m_finishedCondition.notify_all();
+		}
+		else if ( m_bShutdown ) {
+			break;
+		}
+	}
+}
+
+bool AutoSaveWriter::write( const XMLDoc& doc, const QString& sPath )
+{
+	const QByteArray content = doc.toString().toUtf8();
+	const QByteArray hash = QCryptographicHash::hash( content, QCryptographicHash::Sha1 );
+	if ( hash == m_lastHash && sPath == m_sLastWrittenPath &&
+		 QFile::exists( sPath ) ) {
+		return false;
+	}
+
+	// QSaveFile writes into a temporary file which is synced to
+	// disk and renamed to sPath on commit(). A crash during writing
+	// never leaves a truncated autosave file behind.
+	QSaveFile file( sPath );
+	if ( ! file.open( QIODevice::WriteOnly | QIODevice::Text ) ) {
+		ERRORLOG( QString( "Unable to open autosave file [%1] for writing" )
+				  .arg( sPath ) );
+		return false;
+	}
+	if ( file.write( content ) != content.size() || ! file.commit() ) {
+		ERRORLOG( QString( "Unable to write autosave file [%1]: %2" )
+				  .arg( sPath ).arg( file.errorString() ) );
+		return false;
+	}
+
+	m_lastHash = hash;
+	m_sLastWrittenPath = sPath;
+	INFOLOG( QString( "Autosave written to [%1]" ).arg( sPath ) );
+
+	return true;
+}
+
+};
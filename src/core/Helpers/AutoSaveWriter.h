@@ -0,0 +1,108 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#ifndef H2C_AUTO_SAVE_WRITER_H
+#define H2C_AUTO_SAVE_WRITER_H
+
+#include <core/Object.h>
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <QByteArray>
+#include <QString>
+
+namespace H2Core
+{
+
+class Song;
+class XMLDoc;
+
+/**
+ * Writes autosave files of a #Song in a background thread.
+ *
+ * The calling thread only serializes the song into an in-memory
+ * XMLDoc. Converting it to text, writing, syncing it to disk, and
+ * atomically replacing the previous file is done by the worker
+ * thread. In case a new snapshot is requested while the previous
+ * one was not written yet, the latter is dropped.
+ *
+ * Snapshots are skipped altogether in case the song was not
+ * modified (see Song::getRevision()) since the last one or in case
+ * the resulting file would be identical to the one written before.
+ */
+/** \ingroup docCore*/
+class AutoSaveWriter : public H2Core::Object<AutoSaveWriter>
+{
+	H2_OBJECT(AutoSaveWriter)
+public:
+	AutoSaveWriter();
+	/** Writes the pending snapshot (if any) and stops the worker
+	 * thread.*/
+	~AutoSaveWriter();
+
+	/**
+	 * Takes a snapshot of @a pSong and schedules it for writing to
+	 * @a sPath.
+	 *
+	 * \return false in case @a pSong did not change since the last
+	 * snapshot to @a sPath and nothing was scheduled.
+	 */
+	bool save( std::shared_ptr<Song> pSong, const QString& sPath );
+
+	/** Blocks until the pending snapshot was written.*/
+	void waitForFinished();
+
+	/** \return Number of files actually written to disk.*/
+	int getWriteCount() const;
+
+private:
+	void run();
+	bool write( const XMLDoc& doc, const QString& sPath );
+
+	std::thread m_thread;
+	mutable std::mutex m_mutex;
+	std::condition_variable m_condition;
+	std::condition_variable m_finishedCondition;
+	bool m_bShutdown;
+	bool m_bWriting;
+
+	std::unique_ptr<XMLDoc> m_pPendingDoc;
+	QString m_sPendingPath;
+
+	/** Identifies the last snapshot taken (accessed by the calling
+	 * thread only).*/
+	std::weak_ptr<Song> m_pLastSong;
+	long m_nLastRevision;
+	QString m_sLastPath;
+
+	/** Hash and path of the last file written (accessed by the
+	 * worker thread only).*/
+	QByteArray m_lastHash;
+	QString m_sLastWrittenPath;
+	int m_nWriteCount;
+};
+
+};
+
+#endif
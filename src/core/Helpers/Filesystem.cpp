@@ -24,6 +24,7 @@
 #include <core/config.h>
 #include <core/EventQueue.h>
 #include <core/Helpers/Filesystem.h>
+#include <core/Helpers/LibraryIndex.h>
 #include <core/Hydrogen.h>
 
 #include <QtCore/QDir>
@@ -798,16 +799,27 @@ QString Filesystem::drumkit_path_search( const QString& dk_name, Lookup lookup,
 	}
 			
 #endif
+
+	// Kits known to the library index only have to be checked for
+	// being still present instead of listing and validating all
+	// installed ones.
+	auto pIndex = LibraryIndex::get_instance();
 	
 	if ( lookup == Lookup::stacked || lookup == Lookup::user ) {
-		if ( usr_drumkit_list().contains( dk_name ) ){
-			return usr_drumkits_dir() + dk_name;
+		const QString sPath = usr_drumkits_dir() + dk_name;
+		if ( ( pIndex != nullptr && pIndex->containsDrumkitPath( sPath ) &&
+			   drumkit_valid( sPath ) ) ||
+			 usr_drumkit_list().contains( dk_name ) ){
+			return sPath;
 		}
 	}
 
 	if ( lookup == Lookup::stacked || lookup == Lookup::system ) {
-		if( sys_drumkit_list().contains( dk_name ) ){
-			return sys_drumkits_dir() + dk_name;
+		const QString sPath = sys_drumkits_dir() + dk_name;
+		if ( ( pIndex != nullptr && pIndex->containsDrumkitPath( sPath ) &&
+			   drumkit_valid( sPath ) ) ||
+			 sys_drumkit_list().contains( dk_name ) ){
+			return sPath;
 		}
 	}
 
@@ -822,13 +834,21 @@ QString Filesystem::drumkit_path_search( const QString& dk_name, Lookup lookup,
 	
 QString Filesystem::drumkit_dir_search( const QString& dk_name, Lookup lookup )
 {
+	auto pIndex = LibraryIndex::get_instance();
+	
 	if ( lookup == Lookup::user || lookup == Lookup::stacked ) {
-		if ( usr_drumkit_list().contains( dk_name ) ) {
+		if ( ( pIndex != nullptr &&
+			   pIndex->containsDrumkitPath( usr_drumkits_dir() + dk_name ) &&
+			   drumkit_valid( usr_drumkits_dir() + dk_name ) ) ||
+			 usr_drumkit_list().contains( dk_name ) ) {
 			return usr_drumkits_dir();
 		}
 	}
 	if ( lookup == Lookup::system || lookup == Lookup::stacked ) {
-		if( sys_drumkit_list().contains( dk_name ) ) {
+		if ( ( pIndex != nullptr &&
+			   pIndex->containsDrumkitPath( sys_drumkits_dir() + dk_name ) &&
+			   drumkit_valid( sys_drumkits_dir() + dk_name ) ) ||
+			 sys_drumkit_list().contains( dk_name ) ) {
 			return sys_drumkits_dir();
 		}
 	}
@@ -0,0 +1,373 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#include <core/Helpers/LibraryIndex.h>
+
+#include <core/Basics/Drumkit.h>
+#include <core/Basics/DrumkitComponent.h>
+#include <core/Basics/Instrument.h>
+#include <core/Basics/InstrumentList.h>
+#include <core/Helpers/Xml.h>
+
+#include <QDateTime>
+#include <QFileInfo>
+#include <algorithm>
+
+namespace H2Core
+{
+
+LibraryIndex* LibraryIndex::__instance = nullptr;
+
+LibraryIndex::LibraryIndex()
+	: m_bModified( false )
+{
+	load();
+}
+
+LibraryIndex::~LibraryIndex()
+{
+	std::lock_guard<std::mutex> lock( m_mutex );
+	if ( m_bModified ) {
+		save();
+	}
+	__instance = nullptr;
+}
+
+void LibraryIndex::create_instance()
+{
+	if ( __instance == nullptr ) {
+		__instance = new LibraryIndex;
+	}
+}
+
+QString LibraryIndex::getIndexPath()
+{
+	return Filesystem::cache_dir() + "/library_index.xml";
+}
+
+qint64 LibraryIndex::modificationTime( const QString& sPath )
+{
+	QFileInfo info( sPath );
+	if ( ! info.exists() ) {
+		return -1;
+	}
+	return info.lastModified().toMSecsSinceEpoch();
+}
+
+void LibraryIndex::update()
+{
+	// Parsing the drumkits is done without holding the mutex since
+	// loading a drumkit might query the index itself.
+	std::vector<DrumkitEntry> oldDrumkits;
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+		oldDrumkits = m_drumkits;
+	}
+
+	std::vector<DrumkitEntry> drumkits;
+	bool bChanged = false;
+	int nParsed = 0;
+
+	for ( const auto& lookup : { Filesystem::Lookup::user,
+								 Filesystem::Lookup::system } ) {
+		QString sDir;
+		QStringList folders;
+		if ( lookup == Filesystem::Lookup::user ) {
+			sDir = Filesystem::usr_drumkits_dir();
+			folders = Filesystem::usr_drumkit_list();
+		} else {
+			sDir = Filesystem::sys_drumkits_dir();
+			folders = Filesystem::sys_drumkit_list();
+		}
+
+		for ( const auto& sFolder : folders ) {
+			const QString sPath = sDir + sFolder;
+			const qint64 nModified =
+				modificationTime( Filesystem::drumkit_file( sPath ) );
+
+			auto it = std::find_if( oldDrumkits.begin(), oldDrumkits.end(),
+									[&]( const DrumkitEntry& entry ) {
+										return entry.sPath == sPath; } );
+			if ( it != oldDrumkits.end() && it->nModified == nModified ) {
+				drumkits.push_back( *it );
+				continue;
+			}
+
+			Drumkit* pDrumkit = Drumkit::load( sPath, false, true, true );
+			if ( pDrumkit == nullptr ) {
+				ERRORLOG( QString( "Unable to index drumkit [%1]" ).arg( sPath ) );
+				continue;
+			}
+			++nParsed;
+
+			DrumkitEntry entry;
+			entry.sName = pDrumkit->get_name();
+			entry.sPath = sPath;
+			// Loading might have upgraded the drumkit.xml.
+			entry.nModified = modificationTime( Filesystem::drumkit_file( sPath ) );
+			entry.lookup = lookup;
+			entry.sAuthor = pDrumkit->get_author();
+			entry.sLicense = pDrumkit->get_license().getLicenseString();
+			auto pInstrumentList = pDrumkit->get_instruments();
+			for ( int ii = 0; ii < pInstrumentList->size(); ++ii ) {
+				entry.instruments << pInstrumentList->get( ii )->get_name();
+			}
+			for ( const auto& pComponent : *pDrumkit->get_components() ) {
+				entry.components << pComponent->get_name();
+			}
+			delete pDrumkit;
+
+			drumkits.push_back( entry );
+			bChanged = true;
+		}
+	}
+
+	if ( drumkits.size() != oldDrumkits.size() ) {
+		// Drumkits were removed.
+		bChanged = true;
+	}
+
+	INFOLOG( QString( "[%1] drumkits indexed, [%2] of them parsed" )
+			 .arg( drumkits.size() ).arg( nParsed ) );
+
+	std::lock_guard<std::mutex> lock( m_mutex );
+	m_drumkits = std::move( drumkits );
+
+	// Drop patterns which do not exist anymore.
+	for ( auto it = m_patterns.begin(); it != m_patterns.end(); ) {
+		if ( ! QFileInfo::exists( it->first ) ) {
+			it = m_patterns.erase( it );
+			bChanged = true;
+		} else {
+			++it;
+		}
+	}
+
+	if ( bChanged || m_bModified ) {
+		m_bModified = ! save();
+	}
+}
+
+std::vector<LibraryIndex::DrumkitEntry> LibraryIndex::getDrumkits( Filesystem::Lookup lookup ) const
+{
+	std::lock_guard<std::mutex> lock( m_mutex );
+	if ( lookup == Filesystem::Lookup::stacked ) {
+		return m_drumkits;
+	}
+
+	std::vector<DrumkitEntry> drumkits;
+	for ( const auto& entry : m_drumkits ) {
+		if ( entry.lookup == lookup ) {
+			drumkits.push_back( entry );
+		}
+	}
+	return drumkits;
+}
+
+bool LibraryIndex::findDrumkit( const QString& sName, Filesystem::Lookup lookup,
+								DrumkitEntry* pEntry ) const
+{
+	std::lock_guard<std::mutex> lock( m_mutex );
+
+	// User drumkits are stored first.
+	for ( const auto& entry : m_drumkits ) {
+		if ( lookup != Filesystem::Lookup::stacked && entry.lookup != lookup ) {
+			continue;
+		}
+		if ( entry.sName == sName ) {
+			if ( pEntry != nullptr ) {
+				*pEntry = entry;
+			}
+			return true;
+		}
+	}
+	return false;
+}
+
+bool LibraryIndex::containsDrumkitPath( const QString& sPath ) const
+{
+	std::lock_guard<std::mutex> lock( m_mutex );
+	return std::any_of( m_drumkits.begin(), m_drumkits.end(),
+						[&]( const DrumkitEntry& entry ) {
+							return entry.sPath == sPath; } );
+}
+
+bool LibraryIndex::findPatternDrumkitName( const QString& sPatternPath,
+										   QString* pDrumkitName ) const
+{
+	const qint64 nModified = modificationTime( sPatternPath );
+
+	std::lock_guard<std::mutex> lock( m_mutex );
+	auto it = m_patterns.find( sPatternPath );
+	if ( it == m_patterns.end() || it->second.nModified != nModified ) {
+		return false;
+	}
+	if ( pDrumkitName != nullptr ) {
+		*pDrumkitName = it->second.sDrumkitName;
+	}
+	return true;
+}
+
+void LibraryIndex::addPattern( const QString& sPatternPath, const QString& sDrumkitName )
+{
+	const qint64 nModified = modificationTime( sPatternPath );
+	if ( nModified == -1 ) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock( m_mutex );
+	m_patterns[ sPatternPath ] = { nModified, sDrumkitName };
+	m_bModified = true;
+}
+
+bool LibraryIndex::load()
+{
+	const QString sPath = getIndexPath();
+	if ( ! QFileInfo::exists( sPath ) ) {
+		return false;
+	}
+
+	XMLDoc doc;
+	if ( ! doc.read( sPath, nullptr, true ) ) {
+		WARNINGLOG( QString( "Unable to read library index [%1]" ).arg( sPath ) );
+		return false;
+	}
+
+	XMLNode root = doc.firstChildElement( "library_index" );
+	if ( root.isNull() ||
+		 root.read_int( "formatVersion", 0, false, false, true ) != nFormatVersion ) {
+		INFOLOG( QString( "Discarding outdated library index [%1]" ).arg( sPath ) );
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock( m_mutex );
+	m_drumkits.clear();
+	m_patterns.clear();
+
+	XMLNode drumkitNode = root.firstChildElement( "drumkit" );
+	while ( ! drumkitNode.isNull() ) {
+		DrumkitEntry entry;
+		entry.sName = drumkitNode.read_string( "name", "", false, false, true );
+		entry.sPath = drumkitNode.read_string( "path", "", false, false, true );
+		entry.nModified = drumkitNode.read_string( "modified", "-1", false, false, true )
+			.toLongLong();
+		entry.lookup = static_cast<Filesystem::Lookup>(
+			drumkitNode.read_int( "lookup", static_cast<int>(Filesystem::Lookup::user),
+								  false, false, true ) );
+		entry.sAuthor = drumkitNode.read_string( "author", "", false, true, true );
+		entry.sLicense = drumkitNode.read_string( "license", "", false, true, true );
+
+		XMLNode instrumentNode = drumkitNode.firstChildElement( "instrument" );
+		while ( ! instrumentNode.isNull() ) {
+			entry.instruments << instrumentNode.read_text( true, true );
+			instrumentNode = instrumentNode.nextSiblingElement( "instrument" );
+		}
+		XMLNode componentNode = drumkitNode.firstChildElement( "component" );
+		while ( ! componentNode.isNull() ) {
+			entry.components << componentNode.read_text( true, true );
+			componentNode = componentNode.nextSiblingElement( "component" );
+		}
+
+		if ( ! entry.sPath.isEmpty() ) {
+			m_drumkits.push_back( entry );
+		}
+		drumkitNode = drumkitNode.nextSiblingElement( "drumkit" );
+	}
+
+	XMLNode patternNode = root.firstChildElement( "pattern" );
+	while ( ! patternNode.isNull() ) {
+		const QString sPatternPath = patternNode.read_string( "path", "", false, false, true );
+		if ( ! sPatternPath.isEmpty() ) {
+			m_patterns[ sPatternPath ] = {
+				patternNode.read_string( "modified", "-1", false, false, true ).toLongLong(),
+				patternNode.read_string( "drumkit", "", false, true, true ) };
+		}
+		patternNode = patternNode.nextSiblingElement( "pattern" );
+	}
+
+	INFOLOG( QString( "Library index loaded: [%1] drumkits, [%2] patterns" )
+			 .arg( m_drumkits.size() ).arg( m_patterns.size() ) );
+
+	return true;
+}
+
+bool LibraryIndex::save()
+{
+	// Called with m_mutex being locked.
+	XMLDoc doc;
+	XMLNode root = doc.set_root( "library_index" );
+	root.write_int( "formatVersion", nFormatVersion );
+
+	for ( const auto& entry : m_drumkits ) {
+		XMLNode drumkitNode = root.createNode( "drumkit" );
+		drumkitNode.write_string( "name", entry.sName );
+		drumkitNode.write_string( "path", entry.sPath );
+		drumkitNode.write_string( "modified", QString::number( entry.nModified ) );
+		drumkitNode.write_int( "lookup", static_cast<int>(entry.lookup) );
+		drumkitNode.write_string( "author", entry.sAuthor );
+		drumkitNode.write_string( "license", entry.sLicense );
+		for ( const auto& sInstrument : entry.instruments ) {
+			drumkitNode.write_string( "instrument", sInstrument );
+		}
+		for ( const auto& sComponent : entry.components ) {
+			drumkitNode.write_string( "component", sComponent );
+		}
+	}
+
+	for ( const auto& [ sPath, entry ] : m_patterns ) {
+		XMLNode patternNode = root.createNode( "pattern" );
+		patternNode.write_string( "path", sPath );
+		patternNode.write_string( "modified", QString::number( entry.nModified ) );
+		patternNode.write_string( "drumkit", entry.sDrumkitName );
+	}
+
+	if ( ! doc.write( getIndexPath() ) ) {
+		ERRORLOG( QString( "Unable to write library index [%1]" ).arg( getIndexPath() ) );
+		return false;
+	}
+	return true;
+}
+
+QString LibraryIndex::toQString( const QString& sPrefix, bool bShort ) const
+{
+	std::lock_guard<std::mutex> lock( m_mutex );
+	QString s = Base::sPrintIndention;
+	QString sOutput;
+	if ( ! bShort ) {
+		sOutput = QString( "%1[LibraryIndex]\n" ).arg( sPrefix )
+			.append( QString( "%1%2m_drumkits: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_drumkits.size() ) )
+			.append( QString( "%1%2m_patterns: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_patterns.size() ) )
+			.append( QString( "%1%2m_bModified: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_bModified ) );
+	}
+	else {
+		sOutput = QString( "[LibraryIndex]" )
+			.append( QString( " m_drumkits: %1" ).arg( m_drumkits.size() ) )
+			.append( QString( ", m_patterns: %1" ).arg( m_patterns.size() ) )
+			.append( QString( ", m_bModified: %1" ).arg( m_bModified ) );
+	}
+
+	return sOutput;
+}
+
+};
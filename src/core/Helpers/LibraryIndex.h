@@ -0,0 +1,160 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#ifndef H2C_LIBRARY_INDEX_H
+#define H2C_LIBRARY_INDEX_H
+
+#include <core/Object.h>
+#include <core/Helpers/Filesystem.h>
+
+#include <QString>
+#include <QStringList>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace H2Core
+{
+
+/**
+ * Persistent index of the metadata of all installed drumkits and
+ * of the drumkits patterns were created for.
+ *
+ * Reading the metadata of a drumkit requires to parse and validate
+ * its drumkit.xml. Doing so for every kit on startup or whenever
+ * the sound library is refreshed does not scale with the number of
+ * installed kits. Instead, the metadata is stored in
+ * Filesystem::cache_dir() and only kits whose drumkit.xml has a
+ * different modification time than the indexed one are parsed
+ * again.
+ *
+ * All queries are answered from memory and are thread-safe. The
+ * index is written to disk in update() and on destruction in case
+ * it has changed.
+ */
+/** \ingroup docCore*/
+class LibraryIndex : public H2Core::Object<LibraryIndex>
+{
+	H2_OBJECT(LibraryIndex)
+public:
+	struct DrumkitEntry {
+		/** Name as stated in the drumkit.xml.*/
+		QString sName;
+		/** Absolute path of the drumkit folder.*/
+		QString sPath;
+		/** Modification time of the drumkit.xml in ms since
+		 * epoch.*/
+		qint64 nModified;
+		/** Either Filesystem::Lookup::user or
+		 * Filesystem::Lookup::system.*/
+		Filesystem::Lookup lookup;
+		QString sAuthor;
+		QString sLicense;
+		QStringList instruments;
+		QStringList components;
+	};
+
+	/**
+	 * Creates the singleton and reads the index stored on disk
+	 * (if present). It is called in Hydrogen::create_instance().
+	 */
+	static void create_instance();
+	/** \return Singleton or nullptr in case create_instance() was
+	 * not called yet.*/
+	static LibraryIndex* get_instance() { return __instance; }
+	~LibraryIndex();
+
+	/**
+	 * Synchronizes the index with the user and system drumkit
+	 * folders. Only kits which were added or altered since the
+	 * last update are parsed.
+	 */
+	void update();
+
+	/** \return Copy of all indexed drumkits installed at @a
+	 * lookup. Filesystem::Lookup::stacked returns both user and
+	 * system kits.*/
+	std::vector<DrumkitEntry> getDrumkits( Filesystem::Lookup lookup ) const;
+
+	/**
+	 * \param sName Name of the drumkit as stated in its drumkit.xml.
+	 * \param lookup Where to search for the kit.
+	 * \param pEntry If not nullptr, the found entry will be copied
+	 *   into it.
+	 *
+	 * \return Whether an indexed drumkit was found. User kits are
+	 *   preferred over system ones in case of
+	 *   Filesystem::Lookup::stacked.
+	 */
+	bool findDrumkit( const QString& sName, Filesystem::Lookup lookup,
+					  DrumkitEntry* pEntry = nullptr ) const;
+	/** \return Whether a drumkit located in folder @a sPath is
+	 * indexed.*/
+	bool containsDrumkitPath( const QString& sPath ) const;
+
+	/**
+	 * Looks up the drumkit the pattern at @a sPatternPath was
+	 * created for.
+	 *
+	 * \return Whether an entry with matching modification time was
+	 *   found.
+	 */
+	bool findPatternDrumkitName( const QString& sPatternPath,
+								 QString* pDrumkitName ) const;
+	/** Stores @a sDrumkitName for the pattern at @a sPatternPath
+	 * using its current modification time.*/
+	void addPattern( const QString& sPatternPath, const QString& sDrumkitName );
+
+	/** Path of the index file within Filesystem::cache_dir().*/
+	static QString getIndexPath();
+
+	/** Modification time of @a sPath in ms since epoch or -1 in
+	 * case it does not exist.*/
+	static qint64 modificationTime( const QString& sPath );
+
+	QString toQString( const QString& sPrefix = "", bool bShort = true ) const override;
+
+private:
+	LibraryIndex();
+	static LibraryIndex* __instance;
+
+	/** Format version of the index file. Bumping it discards all
+	 * indices written by previous versions.*/
+	static constexpr int nFormatVersion = 1;
+
+	bool load();
+	bool save();
+
+	struct PatternEntry {
+		qint64 nModified;
+		QString sDrumkitName;
+	};
+
+	mutable std::mutex m_mutex;
+	std::vector<DrumkitEntry> m_drumkits;
+	std::map<QString, PatternEntry> m_patterns;
+	/** Whether the content differs from the one on disk.*/
+	bool m_bModified;
+};
+
+};
+
+#endif  // H2C_LIBRARY_INDEX_H
@@ -24,13 +24,20 @@
 #include <core/Helpers/Legacy.h>
 
 #include <QtCore/QFile>
+#include <QtCore/QFileInfo>
 #include <QtCore/QLocale>
+#include <QtCore/QSaveFile>
 #include <QtCore/QString>
 #include <QtCore/QTextStream>
 #include <QtXmlPatterns/QXmlSchema>
 #include <QtXmlPatterns/QXmlSchemaValidator>
 #include <QAbstractMessageHandler>
 
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+
 #define XMLNS_BASE "http://www.hydrogen-music.org/"
 #define XMLNS_XSI "http://www.w3.org/2001/XMLSchema-instance"
 
@@ -55,7 +62,112 @@ protected:
 
 };
 
+/** Schema compiled once and reused for all subsequent documents.*/
+struct CompiledSchema {
+	SilentMessageHandler handler;
+	QXmlSchema schema;
+	/** Hash of the content of the .xsd file.*/
+	QByteArray digest;
+	/** QXmlSchema is reentrant but not thread-safe.*/
+	std::mutex mutex;
+};
+
+static std::mutex validationCacheMutex;
+static std::atomic<bool> bValidationCacheEnabled( true );
+static std::map<QString, std::shared_ptr<CompiledSchema>> compiledSchemas;
+/** Absolute path of each document validated successfully mapped to
+ * the hash of the combination of its content and the schema content
+ * it was validated against. Only the latest hash of each document is
+ * kept, so the cache grows with the number of documents and not with
+ * the number of times they changed.*/
+static std::map<QString, QByteArray> validatedHashes;
+static bool bValidatedHashesLoaded = false;
+static bool bValidatedHashesModified = false;
+
+static QString validationCachePath() {
+	const QString sCacheDir = Filesystem::cache_dir();
+	if ( sCacheDir.isEmpty() ) {
+		return QString();
+	}
+	return sCacheDir + "/xml_validation_cache";
+}
+
+/** Has to be called with #validationCacheMutex locked.*/
+static void loadValidatedHashes() {
+	if ( bValidatedHashesLoaded ) {
+		return;
+	}
+	bValidatedHashesLoaded = true;
+
+	QFile file( validationCachePath() );
+	if ( ! file.open( QIODevice::ReadOnly | QIODevice::Text ) ) {
+		return;
+	}
+	// Each line holds the hex encoded hash followed by a single space
+	// and the path of the document. Later lines take precedence.
+	while ( ! file.atEnd() ) {
+		const QByteArray line = file.readLine().trimmed();
+		const int nSeparator = line.indexOf( ' ' );
+		if ( nSeparator > 0 ) {
+			validatedHashes[ QString::fromUtf8( line.mid( nSeparator + 1 ) ) ] =
+				QByteArray::fromHex( line.left( nSeparator ) );
+		}
+	}
+}
+
+/** Has to be called with #validationCacheMutex locked.*/
+static bool isValidated( const QString& sFilePath, const QByteArray& hash ) {
+	loadValidatedHashes();
+	const auto it = validatedHashes.find( sFilePath );
+	return it != validatedHashes.end() && it->second == hash;
+}
+
+/** Has to be called with #validationCacheMutex locked.*/
+static void addValidatedHash( const QString& sFilePath, const QByteArray& hash ) {
+	validatedHashes[ sFilePath ] = hash;
+	// Written to disk in a single batch by
+	// XMLDoc::saveValidationCache().
+	bValidatedHashesModified = true;
+}
+
+static std::shared_ptr<CompiledSchema> compileSchema( const QString& sSchemaPath ) {
+	QFile file( sSchemaPath );
+	if ( !file.open( QIODevice::ReadOnly ) ) {
+		___ERRORLOG( QString( "Unable to open XML schema [%1] for reading." )
+					 .arg( sSchemaPath ) );
+		return nullptr;
+	}
+
+	auto pCompiled = std::make_shared<CompiledSchema>();
+	const QByteArray content = file.readAll();
+	file.close();
+	pCompiled->digest = QCryptographicHash::hash( content, QCryptographicHash::Sha1 );
+	pCompiled->schema.setMessageHandler( &pCompiled->handler );
+	pCompiled->schema.load( content, QUrl::fromLocalFile( file.fileName() ) );
+	if ( ! pCompiled->schema.isValid() ) {
+		return nullptr;
+	}
+
+	return pCompiled;
+}
+
+static std::shared_ptr<CompiledSchema> getCompiledSchema( const QString& sSchemaPath ) {
+	if ( ! bValidationCacheEnabled ) {
+		return compileSchema( sSchemaPath );
+	}
+
+	std::lock_guard<std::mutex> lock( validationCacheMutex );
+	auto it = compiledSchemas.find( sSchemaPath );
+	if ( it != compiledSchemas.end() ) {
+		return it->second;
+	}
 
+	auto pCompiled = compileSchema( sSchemaPath );
+	if ( pCompiled != nullptr ) {
+		compiledSchemas[ sSchemaPath ] = pCompiled;
+	}
+	return pCompiled;
+}
 
 XMLNode::XMLNode() { }
 XMLNode::XMLNode( QDomNode node ) : QDomNode( node ) { }
@@ -295,75 +407,158 @@ XMLDoc::XMLDoc( ) { }
 
 bool XMLDoc::read( const QString& sFilePath, const QString& sSchemaPath, bool bSilent )
 {
-	
+	QByteArray content;
+	if ( ! readContent( sFilePath, sSchemaPath, &content, bSilent ) ) {
+		return false;
+	}
+
+	if ( ! setContent( content ) ) {
+		ERRORLOG( QString( "Unable to read XML document [%1]" )
+				  .arg( sFilePath ) );
+		return false;
+	}
+
+	return true;
+}
+
+bool XMLDoc::readContent( const QString& sFilePath, const QString& sSchemaPath,
+						  QByteArray* pContent, bool bSilent )
+{
 	QFile file( sFilePath );
 	if ( !file.open( QIODevice::ReadOnly ) ) {
 		ERRORLOG( QString( "Unable to open [%1] for reading" )
 				  .arg( sFilePath ) );
 		return false;
 	}
+
+	// The document is read only once and the same buffer is used
+	// for both validation and parsing.
+	QByteArray content = file.readAll();
 	
-	SilentMessageHandler handler;
-	QXmlSchema schema;
-	schema.setMessageHandler( &handler );
-	
-	bool bSchemaUsable = false;
-	
+	std::shared_ptr<CompiledSchema> pSchema = nullptr;
 	if ( ! sSchemaPath.isEmpty() ) {
-		QFile file( sSchemaPath );
-		if ( !file.open( QIODevice::ReadOnly ) ) {
-			ERRORLOG( QString( "Unable to open XML schema [%1] for reading." )
-					  .arg( sSchemaPath ) );
-		} else {
-			schema.load( &file, QUrl::fromLocalFile( file.fileName() ) );
-			file.close();
-			if ( schema.isValid() ) {
-				bSchemaUsable = true;
-			} else {
-				ERRORLOG( QString( "XML schema [%1] is not valid. File [%2] will not be validated" )
-						  .arg( sSchemaPath ).arg( sFilePath ) );
-			}
+		pSchema = getCompiledSchema( sSchemaPath );
+		if ( pSchema == nullptr ) {
+			ERRORLOG( QString( "XML schema [%1] is not valid. File [%2] will not be validated" )
+					  .arg( sSchemaPath ).arg( sFilePath ) );
 		}
 	}
 	
-	if ( bSchemaUsable ) {
-		QXmlSchemaValidator validator( schema );
-		if ( !validator.validate( &file, QUrl::fromLocalFile( file.fileName() ) ) ) {
-			if ( ! bSilent ) {
-				WARNINGLOG( QString( "XML document [%1] is not valid with respect to schema [%2], loading may fail" )
-							.arg( sFilePath ).arg( sSchemaPath ) );
+	if ( pSchema != nullptr ) {
+		// Documents already validated against the very same schema
+		// do not have to be validated again.
+		const QString sAbsoluteFilePath = QFileInfo( sFilePath ).absoluteFilePath();
+		QByteArray hash;
+		bool bValidated = false;
+		if ( bValidationCacheEnabled ) {
+			QCryptographicHash hasher( QCryptographicHash::Sha1 );
+			hasher.addData( pSchema->digest );
+			hasher.addData( content );
+			hash = hasher.result();
+
+			std::lock_guard<std::mutex> lock( validationCacheMutex );
+			bValidated = isValidated( sAbsoluteFilePath, hash );
+		}
+
+		if ( ! bValidated ) {
+			bool bValid;
+			{
+				std::lock_guard<std::mutex> lock( pSchema->mutex );
+				QXmlSchemaValidator validator( pSchema->schema );
+				bValid = validator.validate( content, QUrl::fromLocalFile( file.fileName() ) );
+			}
+			if ( ! bValid ) {
+				if ( ! bSilent ) {
+					WARNINGLOG( QString( "XML document [%1] is not valid with respect to schema [%2], loading may fail" )
+								.arg( sFilePath ).arg( sSchemaPath ) );
+				}
+				file.close();
+				return false;
+			}
+			else if ( ! bSilent ) {
+				INFOLOG( QString( "XML document [%1] is valid with respect to schema [%2]" )
+						 .arg( sFilePath ).arg( sSchemaPath ) );
+			}
+
+			if ( bValidationCacheEnabled ) {
+				std::lock_guard<std::mutex> lock( validationCacheMutex );
+				addValidatedHash( sAbsoluteFilePath, hash );
 			}
-			file.close();
-			return false;
 		}
 		else if ( ! bSilent ) {
-			INFOLOG( QString( "XML document [%1] is valid with respect to schema [%2]" )
+			INFOLOG( QString( "XML document [%1] was already validated against schema [%2]" )
 					 .arg( sFilePath ).arg( sSchemaPath ) );
 		}
-		file.seek( 0 );
 	}
 
 	if ( Legacy::checkTinyXMLCompatMode( &file ) ) {
 		// Document was created using TinyXML and not using QtXML. We
 		// need to convert it first.
-		if ( ! setContent( Legacy::convertFromTinyXML( &file ) ) ) {
-			ERRORLOG( QString( "Unable to read conversion result document [%1]" )
-					  .arg( sFilePath ) );
-			file.close();
-			return false;
-		}
+		content = Legacy::convertFromTinyXML( &file );
+	}
+	file.close();
+
+	*pContent = content;
+	return true;
+}
+
+void XMLDoc::setValidationCacheEnabled( bool bEnabled )
+{
+	bValidationCacheEnabled = bEnabled;
+}
+
+bool XMLDoc::isValidationCacheEnabled()
+{
+	return bValidationCacheEnabled;
+}
+
+void XMLDoc::clearValidationCache()
+{
+	std::lock_guard<std::mutex> lock( validationCacheMutex );
+	compiledSchemas.clear();
+	validatedHashes.clear();
+	// Nothing to load anymore.
+	bValidatedHashesLoaded = true;
+	bValidatedHashesModified = false;
+
+	const QString sPath = validationCachePath();
+	if ( ! sPath.isEmpty() && QFile::exists( sPath ) ) {
+		QFile::remove( sPath );
+	}
+}
+
+bool XMLDoc::saveValidationCache()
+{
+	std::lock_guard<std::mutex> lock( validationCacheMutex );
+	if ( ! bValidatedHashesModified ) {
+		return true;
+	}
+
+	const QString sPath = validationCachePath();
+	if ( sPath.isEmpty() ) {
+		return false;
 	}
-	else  {
-		// File was written using current format.
-		if ( ! setContent( &file ) ) {
-			ERRORLOG( QString( "Unable to read XML document [%1]" )
-					  .arg( sFilePath ) );
-			file.close();
-			return false;
+
+	// Documents removed in the meantime are dropped.
+	QByteArray content;
+	for ( auto it = validatedHashes.begin(); it != validatedHashes.end(); ) {
+		if ( ! QFile::exists( it->first ) ) {
+			it = validatedHashes.erase( it );
+			continue;
 		}
+		content.append( it->second.toHex() + ' ' + it->first.toUtf8() + '\n' );
+		++it;
 	}
-	file.close();
-	
+
+	QSaveFile file( sPath );
+	if ( ! file.open( QIODevice::WriteOnly | QIODevice::Text ) ||
+		 file.write( content ) != content.size() || ! file.commit() ) {
+		___WARNINGLOG( QString( "Unable to write XML validation cache [%1]: %2" )
+					   .arg( sPath ).arg( file.errorString() ) );
+		return false;
+	}
+
+	bValidatedHashesModified = false;
 	return true;
 }
 
@@ -402,4 +597,109 @@ XMLNode XMLDoc::set_root( const QString& node_name, const QString& xmlns )
 	return root;
 }
 
+XMLStreamReader::XMLStreamReader() {
+	// Consistent with the default of QDomDocument::setContent().
+	setNamespaceProcessing( false );
+}
+
+bool XMLStreamReader::read( const QString& sFilePath, const QString& sSchemaPath, bool bSilent )
+{
+	QByteArray content;
+	if ( ! XMLDoc::readContent( sFilePath, sSchemaPath, &content, bSilent ) ) {
+		return false;
+	}
+
+	m_buffer.close();
+	m_buffer.setData( content );
+	m_buffer.open( QIODevice::ReadOnly );
+	setDevice( &m_buffer );
+
+	return true;
+}
+
+QString XMLStreamReader::read_string( const QString& sDefaultValue )
+{
+	// Whitespace-only text nodes are dropped by QDomDocument too.
+	const QString sText = readElementText( QXmlStreamReader::SkipChildElements );
+	if ( sText.trimmed().isEmpty() ) {
+		return sDefaultValue;
+	}
+	return sText;
+}
+
+float XMLStreamReader::read_float( float fDefaultValue )
+{
+	const QString sText = read_string();
+	if ( sText.isEmpty() ) {
+		return fDefaultValue;
+	}
+	return QLocale::c().toFloat( sText );
+}
+
+int XMLStreamReader::read_int( int nDefaultValue )
+{
+	const QString sText = read_string();
+	if ( sText.isEmpty() ) {
+		return nDefaultValue;
+	}
+	return QLocale::c().toInt( sText );
+}
+
+bool XMLStreamReader::read_bool( bool bDefaultValue )
+{
+	const QString sText = read_string();
+	if ( sText.isEmpty() ) {
+		return bDefaultValue;
+	}
+	return sText == "true";
+}
+
+XMLNode XMLStreamReader::read_node( XMLDoc* pDoc )
+{
+	auto createElement = [&]() {
+		QDomElement element = pDoc->createElement( qualifiedName().toString() );
+		for ( const auto& attribute : attributes() ) {
+			element.setAttribute( attribute.qualifiedName().toString(),
+								  attribute.value().toString() );
+		}
+		return element;
+	};
+
+	QDomElement rootElement = createElement();
+	QDomElement currentElement = rootElement;
+	int nDepth = 1;
+	while ( nDepth > 0 && ! atEnd() ) {
+		switch ( readNext() ) {
+		case QXmlStreamReader::StartElement: {
+			QDomElement element = createElement();
+			currentElement.appendChild( element );
+			currentElement = element;
+			++nDepth;
+			break;
+		}
+		case QXmlStreamReader::EndElement:
+			--nDepth;
+			if ( nDepth > 0 ) {
+				currentElement = currentElement.parentNode().toElement();
+			}
+			break;
+		case QXmlStreamReader::Characters:
+			if ( isCDATA() ) {
+				currentElement.appendChild(
+					pDoc->createCDATASection( text().toString() ) );
+			}
+			else if ( ! isWhitespace() ) {
+				currentElement.appendChild(
+					pDoc->createTextNode( text().toString() ) );
+			}
+			break;
+		default:
+			break;
+		}
+	}
+
+	return XMLNode( rootElement );
+}
+
 };
+
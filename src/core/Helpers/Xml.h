@@ -26,6 +26,8 @@
 #include <core/Object.h>
 #include <QtCore/QString>
 #include <QColor>
+#include <QtCore/QBuffer>
+#include <QtCore/QXmlStreamReader>
 #include <QtXml/QDomDocument>
 
 namespace H2Core
@@ -203,6 +205,90 @@ class XMLDoc : public H2Core::Object<XMLDoc>, public QDomDocument
 		 * \param xmlns the xml namespace prefix to add after XMLNS_BASE
 		 */
 		XMLNode set_root( const QString& node_name, const QString& xmlns = nullptr );
+
+		/**
+		 * read the content of an xml file without parsing it. Files
+		 * written using TinyXML are converted.
+		 * \param filepath the path to the file to read from
+		 * \param schemapath the path to the XML Schema file. If
+		 * set, the content is validated against it.
+		 * \param pContent receives the content of the file
+		 * \param bSilent Whether debug and info messages should be logged
+		 */
+		static bool readContent( const QString& filepath, const QString& schemapath,
+								 QByteArray* pContent, bool bSilent = false );
+
+		/**
+		 * Whether compiled XML schemas are reused for the lifetime of
+		 * the process and whether the validation of documents is
+		 * skipped in case their content was already validated
+		 * successfully against the same schema. The hashes of
+		 * validated documents are stored in Filesystem::cache_dir().
+		 *
+		 * Enabled by default.
+		 */
+		static void setValidationCacheEnabled( bool bEnabled );
+		static bool isValidationCacheEnabled();
+		/** Discards all compiled schemas and all validation results
+		 * (including the ones stored on disk).*/
+		static void clearValidationCache();
+		/** Writes all validation results added since the last call
+		 * to Filesystem::cache_dir(). Entries of documents which do
+		 * not exist anymore are dropped.
+		 *
+		 * Called once on shutdown of the engine of the default
+		 * context.
+		 *
+		 * \return false if the cache file could not be written.*/
+		static bool saveValidationCache();
+};
+
+/**
+ * XMLStreamReader is a subclass of QXmlStreamReader used to create
+ * objects directly while parsing a file instead of building the DOM
+ * of the whole document first.
+ *
+ * The read_*() methods read the text of the current element and
+ * move past its end. Subtrees without a streaming loader can be
+ * converted into a DOM node using read_node() and handed over to
+ * the regular XMLNode-based loaders.
+ */
+/** \ingroup docCore*/
+class XMLStreamReader : public H2Core::Object<XMLStreamReader>, public QXmlStreamReader
+{
+		H2_OBJECT(XMLStreamReader)
+	public:
+		/** basic constructor */
+		XMLStreamReader();
+		/**
+		 * read the content of an xml file and prepare it for parsing
+		 * \param filepath the path to the file to read from
+		 * \param schemapath the path to the XML Schema file
+		 * \param bSilent Whether debug and info messages should be logged
+		 * \return true on success. Errors occurring while parsing
+		 * are reported via hasError().
+		 */
+		bool read( const QString& filepath, const QString& schemapath=nullptr, bool bSilent = false );
+
+		/**
+		 * reads the text of the current element
+		 * \param default_value the value returned if the element is empty
+		 */
+		QString read_string( const QString& default_value = "" );
+		float read_float( float default_value );
+		int read_int( int default_value );
+		bool read_bool( bool default_value );
+
+		/**
+		 * convert the current element including all its children
+		 * into a node of @a pDoc
+		 * \return the newly created node. It is not appended to
+		 * any parent.
+		 */
+		XMLNode read_node( XMLDoc* pDoc );
+
+	private:
+		QBuffer m_buffer;
 };
 
 };
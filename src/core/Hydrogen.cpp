@@ -62,10 +62,13 @@
 #include <core/Basics/PatternList.h>
 #include <core/Basics/Note.h>
 #include <core/Helpers/Filesystem.h>
+#include <core/Helpers/LibraryIndex.h>
+#include <core/Helpers/Xml.h>
 #include <core/FX/LadspaFX.h>
 #include <core/FX/Effects.h>
 
 #include <core/Preferences/Preferences.h>
+#include <core/Sampler/SamplePreview.h>
 #include <core/Sampler/Sampler.h>
 #include "MidiMap.h"
 
@@ -99,8 +102,6 @@ namespace H2Core
 //
 //----------------------------------------------------------------------------
 
-Hydrogen* Hydrogen::__instance = nullptr;
-
 Hydrogen::Hydrogen() : m_nSelectedInstrumentNumber( 0 )
 					 , m_nSelectedPatternNumber( 0 )
 					 , m_bExportSessionIsActive( false )
@@ -111,7 +112,7 @@ Hydrogen::Hydrogen() : m_nSelectedInstrumentNumber( 0 )
 					 , m_bOldLoopEnabled( false )
 					 , m_nLastRecordedMIDINoteTick( 0 )
 {
-	if ( __instance ) {
+	if ( EngineContext::current()->getHydrogen() != nullptr ) {
 		ERRORLOG( "Hydrogen audio engine is already running" );
 		throw H2Exception( "Hydrogen audio engine is already running" );
 	}
@@ -124,15 +125,24 @@ Hydrogen::Hydrogen() : m_nSelectedInstrumentNumber( 0 )
 	m_pCoreActionController = new CoreActionController();
 
 	initBeatcounter();
-	InstrumentComponent::setMaxLayers( Preferences::get_instance()->getMaxLayers() );
+
+	// The maximum number of layers and the Playlist are shared by
+	// all contexts. Only the default one, which holds the
+	// Preferences written by the user, sets them up.
+	if ( EngineContext::current()->isDefault() ) {
+		InstrumentComponent::setMaxLayers( Preferences::get_instance()->getMaxLayers() );
+	}
 	
 	m_pAudioEngine = new AudioEngine();
-	Playlist::create_instance();
+	m_pSamplePreview = new SamplePreview( m_pAudioEngine->getSampler() );
+	if ( EngineContext::current()->isDefault() ) {
+		Playlist::create_instance();
+	}
 
 	EventQueue::get_instance()->push_event( EVENT_STATE, static_cast<int>(AudioEngine::State::Initialized) );
 
 	// Prevent double creation caused by calls from MIDI thread
-	__instance = this;
+	EngineContext::current()->setHydrogen( this );
 
 	m_pAudioEngine->startAudioDrivers();
 	
@@ -140,7 +150,8 @@ Hydrogen::Hydrogen() : m_nSelectedInstrumentNumber( 0 )
 		m_nInstrumentLookupTable[i] = i;
 	}
 
-	if ( Preferences::get_instance()->getOscServerEnabled() ) {
+	if ( Preferences::get_instance()->getOscServerEnabled() &&
+		 EngineContext::current()->isDefault() ) {
 		toggleOscServer( true );
 	}
 }
@@ -149,13 +160,17 @@ Hydrogen::~Hydrogen()
 {
 	INFOLOG( "[~Hydrogen]" );
 
+	// The process-wide instances are only handled by the engine of
+	// the default context.
+	const bool bDefaultContext = EngineContext::current()->isDefault();
+
 #ifdef H2CORE_HAVE_OSC
-	NsmClient* pNsmClient = NsmClient::get_instance();
+	NsmClient* pNsmClient = bDefaultContext ? NsmClient::get_instance() : nullptr;
 	if( pNsmClient ) {
 		pNsmClient->shutdown();
 		delete pNsmClient;
 	}
-	OscServer* pOscServer = OscServer::get_instance();
+	OscServer* pOscServer = bDefaultContext ? OscServer::get_instance() : nullptr;
 	if( pOscServer ) {
 		delete pOscServer;
 	}
@@ -166,9 +181,17 @@ Hydrogen::~Hydrogen()
 	__kill_instruments();
 
 	delete m_pCoreActionController;
+	delete m_pSamplePreview;
 	delete m_pAudioEngine;
 
-	__instance = nullptr;
+	// Writes pending changes of the index and the XML validation
+	// cache to disk.
+	if ( bDefaultContext ) {
+		delete LibraryIndex::get_instance();
+		XMLDoc::saveValidationCache();
+	}
+
+	EngineContext::current()->setHydrogen( nullptr );
 }
 
 void Hydrogen::create_instance()
@@ -179,15 +202,21 @@ void Hydrogen::create_instance()
 	MidiMap::create_instance();
 	Preferences::create_instance();
 	EventQueue::create_instance();
-	MidiActionManager::create_instance();
+
+	// Shared by all contexts.
+	if ( EngineContext::current()->isDefault() ) {
+		MidiActionManager::create_instance();
+		LibraryIndex::create_instance();
 
 #ifdef H2CORE_HAVE_OSC
-	NsmClient::create_instance();
-	OscServer::create_instance( Preferences::get_instance() );
+		NsmClient::create_instance();
+		OscServer::create_instance( Preferences::get_instance() );
 #endif
+	}
 
-	if ( __instance == nullptr ) {
-		__instance = new Hydrogen;
+	if ( EngineContext::current()->getHydrogen() == nullptr ) {
+		// Registers itself in the current context.
+		new Hydrogen;
 	}
 
 	// See audioEngine_init() for:
@@ -686,6 +715,11 @@ bool Hydrogen::startExportSession( int nSampleRate, int nSampleDepth )
 
 /// Export a song to a wav file
 void Hydrogen::startExportSong( const QString& filename)
+{
+	startExportSong( QStringList() << filename );
+}
+
+void Hydrogen::startExportSong( const QStringList& filenames )
 {
 	AudioEngine* pAudioEngine = m_pAudioEngine;
 	getCoreActionController()->locateToTick( 0 );
@@ -693,7 +727,7 @@ void Hydrogen::startExportSong( const QString& filename)
 	pAudioEngine->getSampler()->stopPlayingNotes();
 
 	DiskWriterDriver* pDiskWriterDriver = static_cast<DiskWriterDriver*>(pAudioEngine->getAudioDriver());
-	pDiskWriterDriver->setFileName( filename );
+	pDiskWriterDriver->setFileNames( filenames );
 	pDiskWriterDriver->write();
 }
 
@@ -751,9 +785,18 @@ int Hydrogen::loadDrumkit( Drumkit *pDrumkitInfo, bool bConditional )
 
 		INFOLOG( pDrumkitInfo->get_name() );
 
+		// Decoding the samples is done before locking the audio
+		// engine. This way playback continues while loading the
+		// kit and the actual switch only takes a single cycle.
+		auto pPrepared = Song::prepareDrumkit( pDrumkitInfo );
+		if ( pPrepared == nullptr ) {
+			ERRORLOG( "Unable to prepare drumkit" );
+			return -1;
+		}
+
 		m_pAudioEngine->lock( RIGHT_HERE );
 		
-		pSong->loadDrumkit( pDrumkitInfo, bConditional );
+		pSong->commitDrumkit( pPrepared, bConditional );
 		if ( m_nSelectedInstrumentNumber >=
 			 pSong->getInstrumentList()->size() ) {
 			setSelectedInstrumentNumber( std::max( 0, pSong->getInstrumentList()->size() -1 ) );
@@ -761,6 +804,9 @@ int Hydrogen::loadDrumkit( Drumkit *pDrumkitInfo, bool bConditional )
 
 		renameJackPorts( getSong() );
 		m_pAudioEngine->unlock();
+
+		// Release the previous kit outside of the lock.
+		pPrepared = nullptr;
 	
 		m_pCoreActionController->initExternalControlInterfaces();
 
@@ -1257,6 +1303,9 @@ JackAudioDriver::Timebase Hydrogen::getJackTimebaseState() const {
 
 bool Hydrogen::isUnderSessionManagement() const {
 #ifdef H2CORE_HAVE_OSC
+	if ( ! EngineContext::current()->isDefault() ) {
+		return false;
+	}
 	if ( NsmClient::get_instance() != nullptr ) {
 		if ( NsmClient::get_instance()->getUnderSessionManagement() ) {
 			return true;
@@ -1394,6 +1443,12 @@ void Hydrogen::toggleOscServer( bool bEnable ) {
 
 void Hydrogen::recreateOscServer() {
 #ifdef H2CORE_HAVE_OSC
+	// The OSC server is a process-wide instance owned by the engine
+	// of the default context.
+	if ( ! EngineContext::current()->isDefault() ) {
+		return;
+	}
+
 	OscServer* pOscServer = OscServer::get_instance();
 	if( pOscServer ) {
 		delete pOscServer;
@@ -1475,7 +1530,9 @@ void Hydrogen::recalculateRubberband( float fBpm ) {
 
 void Hydrogen::setIsModified( bool bIsModified ) {
 	if ( getSong() != nullptr ) {
-		if ( getSong()->getIsModified() != bIsModified ) {
+		// Marking an already modified song as modified again still
+		// bumps its revision.
+		if ( getSong()->getIsModified() != bIsModified || bIsModified ) {
 			getSong()->setIsModified( bIsModified );
 		}
 	}
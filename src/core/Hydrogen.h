@@ -26,6 +26,7 @@
 #include <core/Basics/Song.h>
 #include <core/Basics/Sample.h>
 #include <core/Object.h>
+#include <core/EngineContext.h>
 #include <core/Timeline.h>
 #include <core/IO/AudioOutput.h>
 #include <core/IO/MidiInput.h>
@@ -44,6 +45,7 @@ inline int randomValue( int max );
 namespace H2Core
 {
 	class CoreActionController;
+	class SamplePreview;
 	class AudioEngine;
 ///
 /// Hydrogen Audio Engine.
@@ -73,13 +75,15 @@ public:
 	};
 	/**
 	 * Creates all the instances used within Hydrogen in the right
-	 * order.
+	 * order and stores them in the EngineContext of the calling
+	 * thread.
 	 */
 	static void		create_instance();
 	/**
-	 * Returns the current Hydrogen instance #__instance.
+	 * Returns the Hydrogen instance of the EngineContext of the
+	 * calling thread.
 	 */
-	static Hydrogen*	get_instance(){ assert(__instance); return __instance; };
+	static Hydrogen*	get_instance(){ assert( EngineContext::current()->getHydrogen() ); return EngineContext::current()->getHydrogen(); };
 
 	/*
 	 * return central instance of the audio engine
@@ -312,7 +316,13 @@ void			previewSample( Sample *pSample );
 		 * port number. 
 		 */
 		OSC_CANNOT_CONNECT_TO_PORT,
-		PLAYBACK_TRACK_INVALID
+		PLAYBACK_TRACK_INVALID,
+		/**
+		 * One of the files of an audio export could not be
+		 * opened for writing. It is skipped by the
+		 * DiskWriterDriver.
+		 */
+		ERROR_EXPORTING_FILE
 	};
 
 	void			onTapTempoAccelEvent();
@@ -381,9 +391,14 @@ void			previewSample( Sample *pSample );
 	bool			startExportSession( int rate, int depth );
 	void			stopExportSession();
 	void			startExportSong( const QString& filename );
+	/** Renders the song once and writes it into all @a filenames
+	 * (e.g. a .wav and a .flac file).*/
+	void			startExportSong( const QStringList& filenames );
 	void			stopExportSong();
 	
 	CoreActionController* 	getCoreActionController() const;
+	/** Previews of the file browsers and the sound library.*/
+	SamplePreview*			getSamplePreview() const;
 
 	/************************************************************/
 	/********************** Playback track **********************/
@@ -492,15 +507,6 @@ void			previewSample( Sample *pSample );
 	QString toQString( const QString& sPrefix, bool bShort = true ) const override;
 
 private:
-	/**
-	 * Static reference to the Hydrogen singleton. 
-	 *
-	 * It is created using the Hydrogen::Hydrogen() constructor,
-	 * initialized with NULL and assigned a new Hydrogen instance
-	 * if still 0 in create_instance().
-	 */
-	static Hydrogen* 	__instance;
-
 	/**
 	 * Pointer to the current song. It is initialized with NULL in
 	 * the Hydrogen() constructor, set via setSong(), and accessed
@@ -586,6 +592,9 @@ private:
 	 * Central instance of the audio engine. 
 	 */
 	AudioEngine*	m_pAudioEngine;
+	/** Feeds the Sampler of #m_pAudioEngine. It is destroyed
+	 * before the latter.*/
+	SamplePreview*	m_pSamplePreview;
 
 	/**
 	 * Map associating drumkit paths with the license found in the
@@ -604,9 +613,9 @@ private:
 	 * bunch of Qt5 stuff and creating an instance of the Logger
 	 * and Preferences.
 	 *
-	 * Only one Hydrogen object is allowed to exist. If the
-	 * #__instance object is present, the constructor will throw
-	 * an error.
+	 * Only one Hydrogen object is allowed to exist per
+	 * EngineContext. If the current context already holds one, the
+	 * constructor will throw an error.
 	 */
 	Hydrogen();
 
@@ -641,6 +650,10 @@ inline AudioEngine* Hydrogen::getAudioEngine() const {
 	return m_pAudioEngine;
 }
 
+inline SamplePreview* Hydrogen::getSamplePreview() const {
+	return m_pSamplePreview;
+}
+
 inline Hydrogen::GUIState Hydrogen::getGUIState() const {
 	return m_GUIState;
 }
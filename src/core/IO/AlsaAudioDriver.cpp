@@ -24,7 +24,7 @@
 
 #if defined(H2CORE_HAVE_ALSA) || _DOXYGEN_
 
-#include <pthread.h>
+#include <algorithm>
 #include <iostream>
 #include <core/Preferences/Preferences.h>
 #include <core/EventQueue.h>
@@ -32,8 +32,6 @@
 namespace H2Core
 {
 
-pthread_t alsaAudioDriverThread;
-
 static int alsa_xrun_recovery( snd_pcm_t *handle, int err )
 {
 	if ( err == -EPIPE ) {  /* under-run */
@@ -53,98 +51,235 @@ static int alsa_xrun_recovery( snd_pcm_t *handle, int err )
 	return err;
 }
 
-void* alsaAudioDriver_processCaller( void* param )
+/** Clips the sample into [-1,1]. Written branch-free to allow the
+ * compiler to vectorize the conversion loops below.*/
+inline static float clip( float fVal )
+{
+	return std::min( std::max( fVal, -1.0f ), 1.0f );
+}
+
+template <typename T>
+inline static void convertInterleavedInteger( const float* __restrict__ pIn_L,
+											  const float* __restrict__ pIn_R,
+											  T* __restrict__ pOut,
+											  int nFrames, float fScale )
 {
-	Base *__object = (Base*)param;
-	AlsaAudioDriver *pDriver = ( AlsaAudioDriver* )param;
-
-	// stolen from amSynth
-	struct sched_param sched;
-	sched.sched_priority = 50;
-	int res = sched_setscheduler( 0, SCHED_FIFO, &sched );
-	sched_getparam( 0, &sched );
-	if ( res ) {
-		__ERRORLOG( "Can't set realtime scheduling for ALSA Driver" );
+	for ( int i = 0; i < nFrames; ++i ) {
+		pOut[ 2 * i ] = static_cast<T>( clip( pIn_L[ i ] ) * fScale );
+		pOut[ 2 * i + 1 ] = static_cast<T>( clip( pIn_R[ i ] ) * fScale );
+	}
+}
+
+const std::vector<snd_pcm_format_t> AlsaAudioDriver::m_formatsPreferred = {
+	SND_PCM_FORMAT_FLOAT, SND_PCM_FORMAT_S32, SND_PCM_FORMAT_S24_3LE,
+	SND_PCM_FORMAT_S16 };
+
+bool AlsaAudioDriver::convertInterleaved( snd_pcm_format_t format, const float* pIn_L,
+										  const float* pIn_R, void* pDest, int nFrames )
+{
+	switch ( format ) {
+	case SND_PCM_FORMAT_FLOAT: {
+		float* __restrict__ pOut = static_cast<float*>( pDest );
+		for ( int i = 0; i < nFrames; ++i ) {
+			pOut[ 2 * i ] = clip( pIn_L[ i ] );
+			pOut[ 2 * i + 1 ] = clip( pIn_R[ i ] );
+		}
+		break;
 	}
-	__INFOLOG( QString( "Scheduling priority = %1" ).arg( sched.sched_priority ) );
+	case SND_PCM_FORMAT_S32:
+		// The largest float below 2^31 ensures the positive full
+		// scale does not overflow.
+		convertInterleavedInteger<int32_t>( pIn_L, pIn_R,
+											static_cast<int32_t*>( pDest ),
+											nFrames, 2147483520.0f );
+		break;
+	case SND_PCM_FORMAT_S24_3LE: {
+		uint8_t* pOut = static_cast<uint8_t*>( pDest );
+		for ( int i = 0; i < nFrames; ++i ) {
+			const int32_t nLeft = static_cast<int32_t>( clip( pIn_L[ i ] ) * 8388607.0f );
+			const int32_t nRight = static_cast<int32_t>( clip( pIn_R[ i ] ) * 8388607.0f );
+			pOut[ 0 ] = nLeft & 0xff;
+			pOut[ 1 ] = ( nLeft >> 8 ) & 0xff;
+			pOut[ 2 ] = ( nLeft >> 16 ) & 0xff;
+			pOut[ 3 ] = nRight & 0xff;
+			pOut[ 4 ] = ( nRight >> 8 ) & 0xff;
+			pOut[ 5 ] = ( nRight >> 16 ) & 0xff;
+			pOut += 6;
+		}
+		break;
+	}
+	case SND_PCM_FORMAT_S16:
+		convertInterleavedInteger<int16_t>( pIn_L, pIn_R,
+											static_cast<int16_t*>( pDest ),
+											nFrames, 32767.0f );
+		break;
+	default:
+		return false;
+	}
+	return true;
+}
 
-	sleep( 1 );
+static void alsa_report_xrun( AlsaAudioDriver* pDriver )
+{
+	pDriver->m_pDriverThread->reportXRun();
+}
 
+/** Writes a single period of already converted audio using
+ * snd_pcm_writei().*/
+static void alsa_write_rw( AlsaAudioDriver* pDriver, const char* pBuffer, int nFrames )
+{
+	Base *__object = (Base*)pDriver;
 	int err;
-	if ( ( err = snd_pcm_prepare( pDriver->m_pPlayback_handle ) ) < 0 ) {
-		__ERRORLOG( QString( "Cannot prepare audio interface for use: %1" )
-					.arg( snd_strerror ( err ) ) );
+
+	if ( ( err = snd_pcm_writei( pDriver->m_pPlayback_handle,
+								 pBuffer, nFrames ) ) < 0 ) {
+		___ERRORLOG( QString( "Error while writing playback stream: %1" )
+					 .arg( snd_strerror( err ) ) );
+
+		// Try to bring the playback device in a nice state
+		// again and retry writing the output buffer.
+		if ( ( err = snd_pcm_recover( pDriver->m_pPlayback_handle, err, 0 ) ) == 0 ) {
+			___INFOLOG( "Successfully recovered from error. Attempt to write buffer again." );
+			if ( ( err = snd_pcm_writei( pDriver->m_pPlayback_handle,
+										 pBuffer, nFrames ) ) < 0 ) {
+				___ERRORLOG( QString( "Unable to write playback stream again: %1" )
+							 .arg( snd_strerror( err ) ) );
+				alsa_report_xrun( pDriver );
+				if ( ( err = snd_pcm_recover( pDriver->m_pPlayback_handle, err, 0 ) ) < 0 ) {
+					__ERRORLOG( QString( "Can't recover from XRUN: %1" )
+								.arg( snd_strerror( err ) ) );
+				}
+			}
+		} else {
+			__ERRORLOG( QString( "Can't recover from XRUN: %1" )
+						.arg( snd_strerror( err ) ) );
+			alsa_report_xrun( pDriver );
+		}
 	}
+}
 
-	int nFrames = pDriver->m_nBufferSize;
-	__INFOLOG( QString( "nFrames: %1" ).arg( nFrames ) );
-	short pBuffer[ nFrames * 2 ];
+/** Converts a single period straight into the DMA ring buffer of the
+ * device. Since the mapped area might wrap around at the end of the
+ * ring, a period can require more than one snd_pcm_mmap_begin() /
+ * snd_pcm_mmap_commit() cycle.*/
+static void alsa_write_mmap( AlsaAudioDriver* pDriver, int nFrames )
+{
+	Base *__object = (Base*)pDriver;
+	snd_pcm_t* pHandle = pDriver->m_pPlayback_handle;
+	int nWritten = 0;
+	int err;
 
-	float *pOut_L = pDriver->m_pOut_L;
-	float *pOut_R = pDriver->m_pOut_R;
+	while ( nWritten < nFrames ) {
+		snd_pcm_sframes_t nAvail = snd_pcm_avail_update( pHandle );
+		if ( nAvail < 0 ) {
+			___ERRORLOG( QString( "Error while querying available frames: %1" )
+						 .arg( snd_strerror( nAvail ) ) );
+			alsa_report_xrun( pDriver );
+			if ( ( err = snd_pcm_recover( pHandle, nAvail, 0 ) ) < 0 ) {
+				__ERRORLOG( QString( "Can't recover from XRUN: %1" )
+							.arg( snd_strerror( err ) ) );
+				return;
+			}
+			continue;
+		}
 
-	int nTimeoutInMilliseconds = 100;
+		if ( nAvail == 0 ) {
+			// The ring buffer is full. Should only happen if the
+			// stream was not started yet.
+			if ( snd_pcm_state( pHandle ) == SND_PCM_STATE_PREPARED ) {
+				snd_pcm_start( pHandle );
+			}
+			if ( ( err = snd_pcm_wait( pHandle, 100 ) ) < 1 ) {
+				return;
+			}
+			continue;
+		}
 
-	while ( pDriver->m_bIsRunning ) {
-		// prepare the audio data
-		pDriver->m_processCallback( nFrames, nullptr );
+		const snd_pcm_channel_area_t* pAreas;
+		snd_pcm_uframes_t nOffset;
+		snd_pcm_uframes_t nChunk = nFrames - nWritten;
+		if ( ( err = snd_pcm_mmap_begin( pHandle, &pAreas, &nOffset, &nChunk ) ) < 0 ) {
+			___ERRORLOG( QString( "Error in snd_pcm_mmap_begin: %1" )
+						 .arg( snd_strerror( err ) ) );
+			alsa_report_xrun( pDriver );
+			snd_pcm_recover( pHandle, err, 0 );
+			return;
+		}
 
-		for ( int i = 0; i < nFrames; ++i ) {
-			pBuffer[ i * 2 ] = ( short )( pOut_L[ i ] * 32768.0 );
-			pBuffer[ i * 2 + 1 ] = ( short )( pOut_R[ i ] * 32768.0 );
+		// With interleaved access both channels share the area of
+		// the first one.
+		char* pDest = static_cast<char*>( pAreas[ 0 ].addr ) +
+			( pAreas[ 0 ].first + nOffset * pAreas[ 0 ].step ) / 8;
+		AlsaAudioDriver::convertInterleaved( pDriver->m_format,
+											 pDriver->m_pOut_L + nWritten,
+											 pDriver->m_pOut_R + nWritten,
+											 pDest, nChunk );
+
+		snd_pcm_sframes_t nCommitted = snd_pcm_mmap_commit( pHandle, nOffset, nChunk );
+		if ( nCommitted < 0 ||
+			 static_cast<snd_pcm_uframes_t>( nCommitted ) != nChunk ) {
+			___ERRORLOG( QString( "Error in snd_pcm_mmap_commit: %1" )
+						 .arg( snd_strerror( nCommitted < 0 ? nCommitted : -EPIPE ) ) );
+			alsa_report_xrun( pDriver );
+			snd_pcm_recover( pHandle, nCommitted < 0 ? nCommitted : -EPIPE, 0 );
+			return;
 		}
+		nWritten += nChunk;
 
-		// Check whether the playback stream is ready to process
-		// input.
-		if ( ( err = snd_pcm_wait( pDriver->m_pPlayback_handle,
-								   nTimeoutInMilliseconds ) ) < 1 ) {
-			// Playback stream is not ready. Since we opened the stream
-			// in blocking mode, the call to snd_pcm_writei() may take
-			// forever and cause the audio engine to stop working
-			// entirely. In addition, this also prevents the audio
-			// driver to be stopped and thus prevents the user from
-			// selecting a different/working version.
-			if ( err == 0 ) {
-				___ERRORLOG( QString( "timeout after [%1] milliseconds" )
-							 .arg( nTimeoutInMilliseconds ) );
-			} else {
-				___ERRORLOG( QString( "Error while waiting for playback stream: %1" )
+		if ( snd_pcm_state( pHandle ) == SND_PCM_STATE_PREPARED ) {
+			if ( ( err = snd_pcm_start( pHandle ) ) < 0 ) {
+				___ERRORLOG( QString( "Unable to start playback stream: %1" )
 							 .arg( snd_strerror( err ) ) );
 			}
-			pDriver->m_nXRuns++;
-			EventQueue::get_instance()->push_event( EVENT_XRUN, 0 );
-		} else {
+		}
+	}
+}
 
-			// Playback stream is ready, let's write out the audio
-			// buffer.
-			if ( ( err = snd_pcm_writei( pDriver->m_pPlayback_handle, pBuffer, nFrames ) ) < 0 ) {
-				___ERRORLOG( QString( "Error while writing playback stream: %1" )
-							 .arg( snd_strerror( err ) ) );
+int AlsaAudioDriver::renderPeriod( int nSlot )
+{
+	// prepare the audio data
+	m_processCallback( m_nBufferSize, nullptr );
 
-				// Try to bring the playback device in a nice state
-				// again and retry writing the output buffer.
-				if ( ( err = snd_pcm_recover( pDriver->m_pPlayback_handle, err, 0 ) ) == 0 ) {
-					___INFOLOG( "Successfully recovered from error. Attempt to write buffer again." );
-					if ( ( err = snd_pcm_writei( pDriver->m_pPlayback_handle, pBuffer, nFrames ) ) < 0 ) {
-						___ERRORLOG( QString( "Unable to write playback stream again: %1" )
-									 .arg( snd_strerror( err ) ) );
-						pDriver->m_nXRuns++;
-						EventQueue::get_instance()->push_event( EVENT_XRUN, 0 );
-						if ( ( err = snd_pcm_recover( pDriver->m_pPlayback_handle, err, 0 ) ) < 0 ) {
-							__ERRORLOG( QString( "Can't recover from XRUN: %1" )
-										.arg( snd_strerror( err ) ) );
-						}
-					}
-				} else {
-					__ERRORLOG( QString( "Can't recover from XRUN: %1" )
-								.arg( snd_strerror( err ) ) );
-					pDriver->m_nXRuns++;
-					EventQueue::get_instance()->push_event( EVENT_XRUN, 0 );
-				}
-			}
+	if ( ! m_bUseMmap ) {
+		convertInterleaved( m_format, m_pOut_L, m_pOut_R,
+							m_pConversionBuffer + nSlot * m_nConversionBufferSize,
+							m_nBufferSize );
+	}
+
+	return 0;
+}
+
+void AlsaAudioDriver::writePeriod( int nSlot )
+{
+	const int nTimeoutInMilliseconds = 100;
+	int err;
+
+	// Check whether the playback stream is ready to process
+	// input.
+	if ( ( err = snd_pcm_wait( m_pPlayback_handle,
+							   nTimeoutInMilliseconds ) ) < 1 ) {
+		// Playback stream is not ready. Since we opened the stream
+		// in blocking mode, the call to snd_pcm_writei() may take
+		// forever and cause the audio engine to stop working
+		// entirely. In addition, this also prevents the audio
+		// driver to be stopped and thus prevents the user from
+		// selecting a different/working version.
+		if ( err == 0 ) {
+			ERRORLOG( QString( "timeout after [%1] milliseconds" )
+					  .arg( nTimeoutInMilliseconds ) );
+		} else {
+			ERRORLOG( QString( "Error while waiting for playback stream: %1" )
+					  .arg( snd_strerror( err ) ) );
 		}
+		alsa_report_xrun( this );
+	} else if ( m_bUseMmap ) {
+		alsa_write_mmap( this, m_nBufferSize );
+	} else {
+		// Playback stream is ready, let's write out the audio
+		// buffer.
+		alsa_write_rw( this, m_pConversionBuffer + nSlot * m_nConversionBufferSize,
+					   m_nBufferSize );
 	}
-	return nullptr;
 }
 
 
@@ -185,22 +320,55 @@ AlsaAudioDriver::AlsaAudioDriver( audioProcessCallback processCallback )
 		, m_bIsRunning( false )
 		, m_pOut_L( nullptr )
 		, m_pOut_R( nullptr )
-		, m_nXRuns( 0 )
 		, m_nBufferSize( 0 )
 		, m_pPlayback_handle( nullptr )
 		, m_processCallback( processCallback )
+		, m_format( SND_PCM_FORMAT_S16 )
+		, m_pConversionBuffer( nullptr )
+		, m_nConversionBufferSize( 0 )
+		, m_pDriverThread( nullptr )
 {
 	m_nSampleRate = Preferences::get_instance()->m_nSampleRate;
 	m_sAlsaAudioDevice = Preferences::get_instance()->m_sAlsaAudioDevice;
+	m_bUseMmap = Preferences::get_instance()->m_bAlsaUseMmap;
 }
 
 AlsaAudioDriver::~AlsaAudioDriver()
 {
-	if ( m_nXRuns > 0 ) {
-		WARNINGLOG( QString( "%1 xruns" ).arg( m_nXRuns ) );
+	if ( getXRuns() > 0 ) {
+		WARNINGLOG( QString( "%1 xruns" ).arg( getXRuns() ) );
 	}
+	delete m_pDriverThread;
 }
 
+int AlsaAudioDriver::getXRuns() const
+{
+	if ( m_pDriverThread == nullptr ) {
+		return 0;
+	}
+	return m_pDriverThread->getXRuns();
+}
+
+
+int AlsaAudioDriver::negotiateFormat( snd_pcm_hw_params_t* hw_params )
+{
+	for ( const auto& format : m_formatsPreferred ) {
+		if ( snd_pcm_hw_params_test_format( m_pPlayback_handle,
+											hw_params, format ) == 0 ) {
+			int err = snd_pcm_hw_params_set_format( m_pPlayback_handle,
+													hw_params, format );
+			if ( err == 0 ) {
+				m_format = format;
+				INFOLOG( QString( "Using sample format [%1]" )
+						 .arg( snd_pcm_format_name( format ) ) );
+				return 0;
+			}
+		}
+	}
+
+	ERRORLOG( "None of the supported sample formats is accepted by the device" );
+	return -EINVAL;
+}
 
 int AlsaAudioDriver::init( unsigned nBufferSize )
 {
@@ -268,21 +436,28 @@ int AlsaAudioDriver::connect()
 				  .arg( QString::fromLocal8Bit(snd_strerror(err)) ) );
 		return 1;
 	}
-//	snd_pcm_hw_params_set_access( m_pPlayback_handle, hw_params, SND_PCM_ACCESS_MMAP_INTERLEAVED  );
 
-	if ( ( err = snd_pcm_hw_params_set_access( m_pPlayback_handle,
-											   hw_params,
-											   SND_PCM_ACCESS_RW_INTERLEAVED ) ) < 0 ) {
-		ERRORLOG( QString( "error in snd_pcm_hw_params_set_access: %1" )
-				  .arg( QString::fromLocal8Bit(snd_strerror(err)) ) );
-		return 1;
+	if ( m_bUseMmap ) {
+		if ( ( err = snd_pcm_hw_params_set_access( m_pPlayback_handle,
+												   hw_params,
+												   SND_PCM_ACCESS_MMAP_INTERLEAVED ) ) < 0 ) {
+			WARNINGLOG( QString( "Device does not support mmap access, falling back to read/write access: %1" )
+						.arg( QString::fromLocal8Bit(snd_strerror(err)) ) );
+			m_bUseMmap = false;
+		}
 	}
 
-	if ( ( err = snd_pcm_hw_params_set_format( m_pPlayback_handle,
-											   hw_params,
-											   SND_PCM_FORMAT_S16_LE ) ) < 0 ) {
-		ERRORLOG( QString( "error in snd_pcm_hw_params_set_format: %1" )
-				  .arg( QString::fromLocal8Bit(snd_strerror(err)) ) );
+	if ( ! m_bUseMmap ) {
+		if ( ( err = snd_pcm_hw_params_set_access( m_pPlayback_handle,
+												   hw_params,
+												   SND_PCM_ACCESS_RW_INTERLEAVED ) ) < 0 ) {
+			ERRORLOG( QString( "error in snd_pcm_hw_params_set_access: %1" )
+					  .arg( QString::fromLocal8Bit(snd_strerror(err)) ) );
+			return 1;
+		}
+	}
+
+	if ( ( err = negotiateFormat( hw_params ) ) < 0 ) {
 		return 1;
 	}
 
@@ -348,12 +523,38 @@ int AlsaAudioDriver::connect()
 	memset( m_pOut_L, 0, m_nBufferSize * sizeof( float ) );
 	memset( m_pOut_R, 0, m_nBufferSize * sizeof( float ) );
 
+	auto threadSettings = DriverThread::settingsFromPreferences();
+	if ( ! m_bUseMmap ) {
+		m_nConversionBufferSize = m_nBufferSize * nChannels *
+			snd_pcm_format_physical_width( m_format ) / 8;
+		m_pConversionBuffer =
+			new char[ DriverThread::nSlots * m_nConversionBufferSize ];
+	} else if ( threadSettings.bDoubleBuffering ) {
+		// In mmap mode the audio is converted straight from the
+		// output buffers of the engine into the ring buffer of the
+		// device. There is nothing to overlap.
+		INFOLOG( "Double buffering is not used in mmap mode" );
+		threadSettings.bDoubleBuffering = false;
+	}
+
+	if ( ( err = snd_pcm_prepare( m_pPlayback_handle ) ) < 0 ) {
+		ERRORLOG( QString( "Cannot prepare audio interface for use: %1" )
+				  .arg( snd_strerror ( err ) ) );
+	}
+
 	m_bIsRunning = true;
 
 	// start the main thread
-	pthread_attr_t attr;
-	pthread_attr_init( &attr );
-	pthread_create( &alsaAudioDriverThread, &attr, alsaAudioDriver_processCaller, this );
+	delete m_pDriverThread;
+	m_pDriverThread = new DriverThread(
+		"ALSA",
+		[this]( int nSlot ) { return renderPeriod( nSlot ); },
+		[this]( int nSlot ) { writePeriod( nSlot ); },
+		threadSettings );
+	if ( m_pDriverThread->start() != 0 ) {
+		m_bIsRunning = false;
+		return 1;
+	}
 
 	return 0;	// OK
 }
@@ -367,7 +568,9 @@ void AlsaAudioDriver::disconnect()
 	
 	m_bIsRunning = false;
 
-	pthread_join( alsaAudioDriverThread, nullptr );
+	if ( m_pDriverThread != nullptr ) {
+		m_pDriverThread->stop();
+	}
 
 	snd_pcm_close( m_pPlayback_handle );
 
@@ -376,6 +579,9 @@ void AlsaAudioDriver::disconnect()
 
 	delete[] m_pOut_R;
 	m_pOut_R = nullptr;
+
+	delete[] m_pConversionBuffer;
+	m_pConversionBuffer = nullptr;
 }
 
 unsigned AlsaAudioDriver::getBufferSize()
@@ -24,10 +24,12 @@
 
 #include <core/IO/AudioOutput.h>
 #include <core/IO/NullDriver.h>
+#include <core/IO/DriverThread.h>
 
 #if defined(H2CORE_HAVE_ALSA) || _DOXYGEN_
 
 #include <inttypes.h>
+#include <vector>
 #include <alsa/asoundlib.h>
 
 namespace H2Core
@@ -45,7 +47,20 @@ public:
 	float* m_pOut_R;
 	QString m_sAlsaAudioDevice;
 	audioProcessCallback m_processCallback;
-	int m_nXRuns;
+	/** Sample format negotiated with the device in connect(). The
+	 * formats are tried in the order of #m_formatsPreferred.*/
+	snd_pcm_format_t m_format;
+	/** Whether the audio is written directly into the DMA ring
+	 * buffer of the device (#SND_PCM_ACCESS_MMAP_INTERLEAVED)
+	 * instead of being copied using snd_pcm_writei().*/
+	bool m_bUseMmap;
+	/** Interleaved, already converted output used in read/write
+	 * access mode. It holds one period for each slot of
+	 * #m_pDriverThread. Allocated in connect().*/
+	char* m_pConversionBuffer;
+	/** Size of a single slot in #m_pConversionBuffer in bytes.*/
+	int m_nConversionBufferSize;
+	DriverThread* m_pDriverThread;
 
 	AlsaAudioDriver( audioProcessCallback processCallback );
 	~AlsaAudioDriver();
@@ -59,10 +74,32 @@ public:
 	virtual float* getOut_R() override;
 	static QStringList getDevices();
 
-	virtual int getXRuns() const override { return m_nXRuns; }
+	virtual int getXRuns() const override;
+
+	/** Converts @a nFrames of the float output buffers into
+	 * interleaved samples of format @a format written to @a pDest.
+	 *
+	 * Values are clipped to [-1,1] prior to the conversion.
+	 *
+	 * \return Whether @a format is supported.*/
+	static bool convertInterleaved( snd_pcm_format_t format, const float* pIn_L,
+									const float* pIn_R, void* pDest, int nFrames );
 	
 private:
 
+	/** Runs the audio engine and - in read/write access mode -
+	 * converts the result into the @a nSlot part of
+	 * #m_pConversionBuffer.*/
+	int renderPeriod( int nSlot );
+	void writePeriod( int nSlot );
+
+	/** Tries to find a sample format supported by both the device and
+	 * convertInterleaved(). Higher resolutions are preferred to
+	 * spare the driver thread the conversion to 16 bit.*/
+	int negotiateFormat( snd_pcm_hw_params_t* hw_params );
+
+	static const std::vector<snd_pcm_format_t> m_formatsPreferred;
+
 	unsigned int m_nSampleRate;
 };
 
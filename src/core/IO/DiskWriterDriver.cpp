@@ -26,13 +26,21 @@
 #include <core/AudioEngine/AudioEngine.h>
 #include <core/EventQueue.h>
 #include <core/CoreActionController.h>
+#include <core/EngineContext.h>
 #include <core/Hydrogen.h>
 #include <core/Basics/Pattern.h>
 #include <core/Basics/PatternList.h>
 #include <core/IO/DiskWriterDriver.h>
 
-#include <pthread.h>
+#include <atomic>
 #include <cassert>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #if defined(WIN32) || _DOXYGEN_
 #include <windows.h>
@@ -49,58 +57,132 @@
 namespace H2Core
 {
 
-pthread_t diskWriterDriverThread;
+namespace {
 
-void* diskWriterDriver_thread( void* param )
-{
-	Base * __object = ( Base * )param;
-	DiskWriterDriver *pDriver = ( DiskWriterDriver* )param;
+/**
+ * Encodes interleaved stereo frames into a single file.
+ *
+ * The frames are handed over by the render thread via push() and
+ * written in a separate thread. This way the (possibly expensive)
+ * compression of formats like FLAC or OGG/Vorbis does not add to the
+ * render time. The queue between both is bounded to keep the memory
+ * consumption constant. In case the encoder falls behind, the render
+ * thread blocks.
+ */
+class EncoderStage {
+public:
+	typedef std::shared_ptr<const std::vector<float>> Chunk;
+
+	EncoderStage( SNDFILE* pFile, const QString& sFilename, size_t nCapacity )
+		: m_pFile( pFile )
+		, m_sFilename( sFilename )
+		, m_nCapacity( nCapacity )
+		, m_bFinished( false )
+		, m_bError( false ) {
+		m_thread = std::thread( &EncoderStage::run, this );
+	}
+	~EncoderStage() {
+		finish();
+	}
 
-	EventQueue::get_instance()->push_event( EVENT_PROGRESS, 0 );
+	void push( Chunk pChunk ) {
+		std::unique_lock<std::mutex> lock( m_mutex );
+		m_notFull.wait( lock, [&]{ return m_queue.size() < m_nCapacity; } );
+		m_queue.push_back( pChunk );
+		lock.unlock();
+		m_notEmpty.notify_one();
+	}
 
-	auto pAudioEngine = Hydrogen::get_instance()->getAudioEngine();
-	
-	__INFOLOG( "DiskWriterDriver thread start" );
+	/** Writes all pending frames and closes the file.
+	 *
+	 * \return false in case not all frames could be written.*/
+	bool finish() {
+		if ( m_thread.joinable() ) {
+			{
+				std::lock_guard<std::mutex> lock( m_mutex );
+				m_bFinished = true;
+			}
+			m_notEmpty.notify_one();
+			m_thread.join();
+			sf_close( m_pFile );
+		}
+		return ! m_bError;
+	}
 
-	// always rolling, no user interaction
-	pAudioEngine->play();
-	SF_INFO soundInfo;
-	soundInfo.samplerate = pDriver->m_nSampleRate;
-//	soundInfo.frames = -1;//getNFrames();		///\todo: da terminare
-	soundInfo.channels = 2;
+private:
+	void run() {
+		while ( true ) {
+			Chunk pChunk;
+			{
+				std::unique_lock<std::mutex> lock( m_mutex );
+				m_notEmpty.wait( lock, [&]{
+					return ! m_queue.empty() || m_bFinished; } );
+				if ( m_queue.empty() ) {
+					return;
+				}
+				pChunk = m_queue.front();
+				m_queue.pop_front();
+			}
+			m_notFull.notify_one();
+
+			const sf_count_t nFrames = pChunk->size() / 2;
+			if ( sf_writef_float( m_pFile, pChunk->data(), nFrames ) != nFrames ) {
+				___ERRORLOG( QString( "Error during sf_write_float [%1]: %2" )
+							 .arg( m_sFilename ).arg( sf_strerror( m_pFile ) ) );
+				m_bError = true;
+			}
+		}
+	}
+
+	SNDFILE* m_pFile;
+	QString m_sFilename;
+	size_t m_nCapacity;
+	std::thread m_thread;
+	std::mutex m_mutex;
+	std::condition_variable m_notEmpty;
+	std::condition_variable m_notFull;
+	std::deque<Chunk> m_queue;
+	bool m_bFinished;
+	std::atomic<bool> m_bError;
+};
+
+};
+
+int DiskWriterDriver::formatFromFilename( const QString& sFilename, int nSampleDepth )
+{
 	//default format
 	int sfformat = 0x010000; //wav format (default)
 	int bits = 0x0002; //16 bit PCM (default)
 	//sf_format switch
-	if( pDriver->m_sFilename.endsWith(".aiff") || pDriver->m_sFilename.endsWith(".AIFF") ){
+	if( sFilename.endsWith(".aiff") || sFilename.endsWith(".AIFF") ){
 		sfformat =  0x020000; //Apple/SGI AIFF format (big endian)
 	}
-	if( pDriver->m_sFilename.endsWith(".flac") || pDriver->m_sFilename.endsWith(".FLAC") ){
+	if( sFilename.endsWith(".flac") || sFilename.endsWith(".FLAC") ){
 		sfformat =  0x170000; //FLAC lossless file format
 	}
-	if( ( pDriver->m_nSampleDepth == 8 ) && ( pDriver->m_sFilename.endsWith(".aiff") || pDriver->m_sFilename.endsWith(".AIFF") ) ){
+	if( ( nSampleDepth == 8 ) && ( sFilename.endsWith(".aiff") || sFilename.endsWith(".AIFF") ) ){
 		bits = 0x0001; //Signed 8 bit data works with aiff
 	}
-	if( ( pDriver->m_nSampleDepth == 8 ) && ( pDriver->m_sFilename.endsWith(".wav") || pDriver->m_sFilename.endsWith(".WAV") ) ){
+	if( ( nSampleDepth == 8 ) && ( sFilename.endsWith(".wav") || sFilename.endsWith(".WAV") ) ){
 		bits = 0x0005; //Unsigned 8 bit data needed for Microsoft WAV format
 	}
-	if( pDriver->m_nSampleDepth == 16 ){
+	if( nSampleDepth == 16 ){
 		bits = 0x0002; //Signed 16 bit data
 	}
-	if( pDriver->m_nSampleDepth == 24 ){
+	if( nSampleDepth == 24 ){
 		bits = 0x0003; //Signed 24 bit data
 	}
-	if( pDriver->m_nSampleDepth == 32 ){
+	if( nSampleDepth == 32 ){
 		bits = 0x0004; ////Signed 32 bit data
 	}
 
-	soundInfo.format =  sfformat|bits;
+	int nFormat = sfformat|bits;
 
 //	#ifdef HAVE_OGGVORBIS
 
 	//ogg vorbis option
-	if( pDriver->m_sFilename.endsWith( ".ogg" ) | pDriver->m_sFilename.endsWith( ".OGG" ) ) {
-		soundInfo.format = SF_FORMAT_OGG | SF_FORMAT_VORBIS;
+	if( sFilename.endsWith( ".ogg" ) | sFilename.endsWith( ".OGG" ) ) {
+		nFormat = SF_FORMAT_OGG | SF_FORMAT_VORBIS;
 	}
 //	#endif
 
@@ -136,15 +218,63 @@ void* diskWriterDriver_thread( void* param )
 ///used for ogg
 //          SF_FORMAT_VORBIS
 
-	if ( !sf_format_check( &soundInfo ) ) {
-		__ERRORLOG( "Error in soundInfo" );
-		return nullptr;
-	}
+	return nFormat;
+}
+
+void* diskWriterDriver_thread( void* param )
+{
+	Base * __object = ( Base * )param;
+	DiskWriterDriver *pDriver = ( DiskWriterDriver* )param;
+
+	EventQueue::get_instance()->push_event( EVENT_PROGRESS, 0 );
+
+	auto pAudioEngine = Hydrogen::get_instance()->getAudioEngine();
+	
+	__INFOLOG( "DiskWriterDriver thread start" );
 
+	// One encoder per file. All of them are fed with the same
+	// rendered frames. Files which can not be written are skipped
+	// and reported to the user.
+	std::vector<std::unique_ptr<EncoderStage>> encoders;
+	for ( const auto& ssFilename : pDriver->m_filenames ) {
+		SF_INFO soundInfo;
+		memset( &soundInfo, 0, sizeof( soundInfo ) );
+		soundInfo.samplerate = pDriver->m_nSampleRate;
+		soundInfo.channels = 2;
+		soundInfo.format = DiskWriterDriver::formatFromFilename(
+			ssFilename, pDriver->m_nSampleDepth );
+
+		if ( !sf_format_check( &soundInfo ) ) {
+			__ERRORLOG( QString( "Error in soundInfo of [%1]" ).arg( ssFilename ) );
+			EventQueue::get_instance()->push_event( EVENT_ERROR,
+													Hydrogen::ERROR_EXPORTING_FILE );
+			continue;
+		}
 
-	SNDFILE* m_file = sf_open( pDriver->m_sFilename.toLocal8Bit(), SFM_WRITE, &soundInfo );
+		SNDFILE* pFile = sf_open( ssFilename.toLocal8Bit(), SFM_WRITE, &soundInfo );
+		if ( pFile == nullptr ) {
+			__ERRORLOG( QString( "Unable to open [%1]: %2" )
+						.arg( ssFilename ).arg( sf_strerror( nullptr ) ) );
+			EventQueue::get_instance()->push_event( EVENT_ERROR,
+													Hydrogen::ERROR_EXPORTING_FILE );
+			continue;
+		}
 
-	float *pData = new float[ pDriver->m_nBufferSize * 2 ];	// always stereo
+		encoders.push_back( std::make_unique<EncoderStage>(
+								pFile, ssFilename,
+								DiskWriterDriver::nEncoderQueueSize ) );
+	}
+
+	if ( encoders.empty() ) {
+		__ERRORLOG( "No file to export to" );
+		// Neither the GUI nor h2cli must wait for an export which
+		// will never happen.
+		EventQueue::get_instance()->push_event( EVENT_PROGRESS, 100 );
+		return nullptr;
+	}
+
+	// always rolling, no user interaction
+	pAudioEngine->play();
 
 	float *pData_L = pDriver->m_pOut_L;
 	float *pData_R = pDriver->m_pOut_R;
@@ -246,7 +376,10 @@ void* diskWriterDriver_thread( void* param )
 			}
 			
 			nFrameNumber += nBufferWriteLength;
-			
+
+			// The chunk is owned by the encoders once handed over.
+			auto pChunk = std::make_shared<std::vector<float>>( nBufferWriteLength * 2 ); // always stereo
+			float* pData = pChunk->data();
 			for ( unsigned ii = 0; ii < nBufferWriteLength; ii++ ) {
 				if( pData_L[ ii ] > 1 ) {
 					pData[ ii * 2 ] = 1;
@@ -264,10 +397,9 @@ void* diskWriterDriver_thread( void* param )
 					pData[ ii * 2 + 1 ] = pData_R[ ii ];
 				}
 			}
-			
-			int res = sf_writef_float( m_file, pData, nBufferWriteLength );
-			if ( res != ( int )nBufferWriteLength ) {
-				__ERRORLOG( "Error during sf_write_float" );
+
+			for ( auto& pEncoder : encoders ) {
+				pEncoder->push( pChunk );
 			}
 
 			// Sampler is still rendering notes put we seem to have
@@ -277,19 +409,25 @@ void* diskWriterDriver_thread( void* param )
 				break;
 			}
 		}
-		
-		// this progress bar method is not exact but ok enough to give users a usable visible progress feedback
-		float fPercent = ( float )(patternPosition +1) / ( float )nColumns * 100.0;
-		EventQueue::get_instance()->push_event( EVENT_PROGRESS, ( int )fPercent );
+
+		// The last progress event is pushed only after all files are
+		// written.
+		if ( patternPosition < nColumns - 1 ) {
+			// this progress bar method is not exact but ok enough to give users a usable visible progress feedback
+			float fPercent = ( float )(patternPosition +1) / ( float )nColumns * 100.0;
+			EventQueue::get_instance()->push_event( EVENT_PROGRESS, ( int )fPercent );
+		}
 	}
-	delete[] pData;
-	pData = nullptr;
 
-	sf_close( m_file );
+	for ( auto& pEncoder : encoders ) {
+		if ( ! pEncoder->finish() ) {
+			__ERRORLOG( "Not all frames could be written" );
+		}
+	}
+	EventQueue::get_instance()->push_event( EVENT_PROGRESS, 100 );
 
 	__INFOLOG( "DiskWriterDriver thread end" );
 
-	pthread_exit( nullptr );
 	return nullptr;
 }
 
@@ -308,6 +446,16 @@ DiskWriterDriver::DiskWriterDriver( audioProcessCallback processCallback )
 
 
 DiskWriterDriver::~DiskWriterDriver() {
+	join();
+}
+
+
+
+void DiskWriterDriver::join()
+{
+	if ( m_thread.joinable() ) {
+		m_thread.join();
+	}
 }
 
 
@@ -332,11 +480,15 @@ int DiskWriterDriver::connect()
 void DiskWriterDriver::write()
 {
 	INFOLOG( "" );
-	
-	pthread_attr_t attr;
-	pthread_attr_init( &attr );
 
-	pthread_create( &diskWriterDriverThread, &attr, diskWriterDriver_thread, this );
+	// Join a previous export, if any.
+	join();
+
+	EngineContext* pContext = EngineContext::current();
+	m_thread = std::thread( [this, pContext]() {
+		EngineContext::Scope scope( pContext );
+		diskWriterDriver_thread( this );
+	} );
 }
 
 /// disconnect
@@ -344,7 +496,7 @@ void DiskWriterDriver::disconnect()
 {
 	INFOLOG( "" );
 
-	pthread_join( diskWriterDriverThread, NULL );
+	join();
 
 	delete[] m_pOut_L;
 	m_pOut_L = nullptr;
@@ -30,6 +30,10 @@
 #include <core/IO/AudioOutput.h>
 #include <core/Object.h>
 
+#include <QStringList>
+
+#include <thread>
+
 namespace H2Core
 {
 
@@ -37,6 +41,13 @@ namespace H2Core
 ///
 /// Driver for export audio to disk
 ///
+/// The song is rendered offline, as fast as possible, in a single
+/// pass by a thread of its own started in write(). Contrary to the
+/// other pulling drivers it does not use the DriverThread since
+/// neither realtime scheduling nor double buffering apply to an
+/// export. Encoding the rendered audio is already decoupled from
+/// rendering by one encoder thread per file.
+///
 /** \ingroup docCore docAudioDriver */
 class DiskWriterDriver : public Object<DiskWriterDriver>, public AudioOutput
 {
@@ -44,7 +55,9 @@ class DiskWriterDriver : public Object<DiskWriterDriver>, public AudioOutput
 	public:
 
 		unsigned				m_nSampleRate;
-		QString					m_sFilename;
+		/** All files are written from the same rendered audio. Their
+		 * format is determined by their suffix.*/
+		QStringList				m_filenames;
 		unsigned				m_nBufferSize;
 		int						m_nSampleDepth;
 		audioProcessCallback	m_processCallback;
@@ -81,11 +94,25 @@ class DiskWriterDriver : public Object<DiskWriterDriver>, public AudioOutput
 		}
 		
 		void  setFileName( const QString& sFilename ){
-			m_sFilename = sFilename;
+			m_filenames = QStringList() << sFilename;
 		}
+		void  setFileNames( const QStringList& filenames ){
+			m_filenames = filenames;
+		}
+
+		/** \return libsndfile format corresponding to the suffix of
+		 * @a sFilename.*/
+		static int formatFromFilename( const QString& sFilename, int nSampleDepth );
+
+		/** Number of rendered buffers which can be queued for each
+		 * encoder before rendering blocks.*/
+		static constexpr size_t nEncoderQueueSize = 32;
 
 	private:
+		/** Joins #m_thread in case an export was started.*/
+		void join();
 
+		std::thread m_thread;
 
 };
 
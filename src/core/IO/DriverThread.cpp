@@ -0,0 +1,304 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#include <core/IO/DriverThread.h>
+#include <core/EventQueue.h>
+#include <core/Preferences/Preferences.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sched.h>
+
+#ifndef WIN32
+#include <sys/mman.h>
+#endif
+
+namespace H2Core
+{
+
+DriverThread::DriverThread( const QString& sName,
+							std::function<int(int)> render,
+							std::function<void(int)> write,
+							const Settings& settings )
+	: m_sName( sName )
+	, m_render( render )
+	, m_write( write )
+	, m_settings( settings )
+	, m_bIsRunning( false )
+	, m_nXRuns( 0 )
+	, m_bJoinable( false )
+	, m_pContext( nullptr )
+{
+	for ( int ii = 0; ii < nSlots; ++ii ) {
+		m_slotFull[ ii ] = false;
+	}
+}
+
+DriverThread::~DriverThread()
+{
+	stop();
+}
+
+DriverThread::Settings DriverThread::settingsFromPreferences( bool bRealtime )
+{
+	auto pPref = Preferences::get_instance();
+
+	Settings settings;
+	settings.nPriority = bRealtime ? pPref->m_nDriverThreadPriority : 0;
+	settings.nCpu = bRealtime ? pPref->m_nDriverThreadCpu : -1;
+	settings.bLockMemory = bRealtime && pPref->m_bDriverThreadLockMemory;
+	settings.bDoubleBuffering = pPref->m_bDriverThreadDoubleBuffering;
+
+	return settings;
+}
+
+void DriverThread::applySettings( const QString& sName, const Settings& settings )
+{
+	if ( settings.nPriority > 0 ) {
+		const int nMin = sched_get_priority_min( SCHED_FIFO );
+		const int nMax = sched_get_priority_max( SCHED_FIFO );
+		int nPriority = settings.nPriority;
+		if ( nMin != -1 && nMax != -1 &&
+			 ( nPriority < nMin || nPriority > nMax ) ) {
+			nPriority = std::clamp( nPriority, nMin, nMax );
+			___WARNINGLOG( QString( "[%1] Priority [%2] out of range [%3,%4]. Using [%5] instead" )
+						   .arg( sName ).arg( settings.nPriority )
+						   .arg( nMin ).arg( nMax ).arg( nPriority ) );
+		}
+
+		struct sched_param sched;
+		sched.sched_priority = nPriority;
+		int nRes = pthread_setschedparam( pthread_self(), SCHED_FIFO, &sched );
+		if ( nRes != 0 ) {
+			___ERRORLOG( QString( "[%1] Can't set realtime scheduling with priority [%2]: %3" )
+						 .arg( sName ).arg( settings.nPriority )
+						 .arg( strerror( nRes ) ) );
+		} else {
+			___INFOLOG( QString( "[%1] Scheduling priority = %2" )
+						.arg( sName ).arg( settings.nPriority ) );
+		}
+	}
+
+	if ( settings.nCpu >= 0 ) {
+#ifdef __linux__
+		cpu_set_t cpuSet;
+		CPU_ZERO( &cpuSet );
+		CPU_SET( settings.nCpu, &cpuSet );
+		int nRes = pthread_setaffinity_np( pthread_self(), sizeof( cpu_set_t ), &cpuSet );
+		if ( nRes != 0 ) {
+			___ERRORLOG( QString( "[%1] Unable to pin thread to CPU [%2]: %3" )
+						 .arg( sName ).arg( settings.nCpu )
+						 .arg( strerror( nRes ) ) );
+		} else {
+			___INFOLOG( QString( "[%1] Pinned to CPU %2" )
+						.arg( sName ).arg( settings.nCpu ) );
+		}
+#else
+		___WARNINGLOG( QString( "[%1] CPU pinning is not supported on this platform" )
+					   .arg( sName ) );
+#endif
+	}
+
+	if ( settings.bLockMemory ) {
+#ifndef WIN32
+		// Locking is done for the whole process. Doing it once is
+		// sufficient.
+		static std::atomic<bool> bMemoryLocked( false );
+		if ( ! bMemoryLocked.exchange( true ) ) {
+			if ( mlockall( MCL_CURRENT | MCL_FUTURE ) != 0 ) {
+				___ERRORLOG( QString( "[%1] Unable to lock memory: %2" )
+							 .arg( sName ).arg( strerror( errno ) ) );
+				bMemoryLocked = false;
+			} else {
+				___INFOLOG( QString( "[%1] Memory locked" ).arg( sName ) );
+			}
+		}
+#else
+		___WARNINGLOG( QString( "[%1] Memory locking is not supported on this platform" )
+					   .arg( sName ) );
+#endif
+	}
+}
+
+int DriverThread::start()
+{
+	if ( m_bIsRunning ) {
+		ERRORLOG( QString( "[%1] thread is already running" ).arg( m_sName ) );
+		return 1;
+	}
+	// Previous run stopped by the render function itself.
+	stop();
+
+	for ( int ii = 0; ii < nSlots; ++ii ) {
+		m_slotFull[ ii ] = false;
+	}
+	m_bIsRunning = true;
+	m_pContext = EngineContext::current();
+
+	pthread_attr_t attr;
+	pthread_attr_init( &attr );
+
+	if ( isDoubleBuffered() ) {
+		INFOLOG( QString( "[%1] Starting double buffered driver thread" ).arg( m_sName ) );
+		if ( pthread_create( &m_writeThread, &attr, writeCaller, this ) != 0 ) {
+			ERRORLOG( QString( "[%1] Unable to create write thread" ).arg( m_sName ) );
+			m_bIsRunning = false;
+			pthread_attr_destroy( &attr );
+			return 1;
+		}
+		if ( pthread_create( &m_renderThread, &attr, renderCaller, this ) != 0 ) {
+			ERRORLOG( QString( "[%1] Unable to create render thread" ).arg( m_sName ) );
+			m_bIsRunning = false;
+			m_slotCondition.notify_all();
+			pthread_join( m_writeThread, nullptr );
+			pthread_attr_destroy( &attr );
+			return 1;
+		}
+	} else {
+		if ( pthread_create( &m_renderThread, &attr, processCaller, this ) != 0 ) {
+			ERRORLOG( QString( "[%1] Unable to create driver thread" ).arg( m_sName ) );
+			m_bIsRunning = false;
+			pthread_attr_destroy( &attr );
+			return 1;
+		}
+	}
+
+	pthread_attr_destroy( &attr );
+	m_bJoinable = true;
+	return 0;
+}
+
+void DriverThread::stop()
+{
+	// The threads might have stopped themselves (a render function
+	// returning non-zero). They still have to be joined.
+	{
+		std::lock_guard<std::mutex> lock( m_slotMutex );
+		m_bIsRunning = false;
+	}
+	m_slotCondition.notify_all();
+
+	if ( ! m_bJoinable ) {
+		return;
+	}
+
+	pthread_join( m_renderThread, nullptr );
+	if ( isDoubleBuffered() ) {
+		pthread_join( m_writeThread, nullptr );
+	}
+	m_bJoinable = false;
+}
+
+void DriverThread::reportXRun()
+{
+	++m_nXRuns;
+	EventQueue::get_instance()->push_event( EVENT_XRUN, 0 );
+}
+
+bool DriverThread::waitForSlot( int nSlot, bool bFull )
+{
+	std::unique_lock<std::mutex> lock( m_slotMutex );
+	m_slotCondition.wait( lock, [&]{
+		return m_slotFull[ nSlot ] == bFull || ! m_bIsRunning; } );
+	return m_slotFull[ nSlot ] == bFull;
+}
+
+void DriverThread::setSlot( int nSlot, bool bFull )
+{
+	std::unique_lock<std::mutex> lock( m_slotMutex );
+	m_slotFull[ nSlot ] = bFull;
+	lock.unlock();
+	m_slotCondition.notify_all();
+}
+
+void* DriverThread::processCaller( void* param )
+{
+	DriverThread* pThread = static_cast<DriverThread*>( param );
+	EngineContext::Scope scope( pThread->m_pContext );
+	applySettings( pThread->m_sName, pThread->m_settings );
+
+	while ( pThread->m_bIsRunning ) {
+		if ( pThread->m_render( 0 ) != 0 ) {
+			pThread->m_bIsRunning = false;
+			break;
+		}
+		if ( pThread->m_write != nullptr ) {
+			pThread->m_write( 0 );
+		}
+	}
+
+	return nullptr;
+}
+
+void* DriverThread::renderCaller( void* param )
+{
+	DriverThread* pThread = static_cast<DriverThread*>( param );
+	EngineContext::Scope scope( pThread->m_pContext );
+	applySettings( pThread->m_sName, pThread->m_settings );
+
+	int nSlot = 0;
+	while ( pThread->m_bIsRunning ) {
+		pThread->waitForSlot( nSlot, false );
+		if ( ! pThread->m_bIsRunning ) {
+			break;
+		}
+
+		if ( pThread->m_render( nSlot ) != 0 ) {
+			std::unique_lock<std::mutex> lock( pThread->m_slotMutex );
+			pThread->m_bIsRunning = false;
+			lock.unlock();
+			pThread->m_slotCondition.notify_all();
+			break;
+		}
+
+		pThread->setSlot( nSlot, true );
+		nSlot = ( nSlot + 1 ) % nSlots;
+	}
+
+	return nullptr;
+}
+
+void* DriverThread::writeCaller( void* param )
+{
+	DriverThread* pThread = static_cast<DriverThread*>( param );
+	EngineContext::Scope scope( pThread->m_pContext );
+	applySettings( pThread->m_sName + " (write)", pThread->m_settings );
+
+	// Slots rendered before the thread was stopped are still
+	// written. Else, the end of an export would be lost in case the
+	// render function stopped the thread itself.
+	int nSlot = 0;
+	while ( true ) {
+		if ( ! pThread->waitForSlot( nSlot, true ) ) {
+			break;
+		}
+
+		pThread->m_write( nSlot );
+
+		pThread->setSlot( nSlot, false );
+		nSlot = ( nSlot + 1 ) % nSlots;
+	}
+
+	return nullptr;
+}
+
+};
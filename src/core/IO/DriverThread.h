@@ -0,0 +1,167 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#ifndef DRIVER_THREAD_H
+#define DRIVER_THREAD_H
+
+#include <core/Object.h>
+#include <core/EngineContext.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <pthread.h>
+
+namespace H2Core
+{
+
+/**
+ * Thread driving the audio engine for all audio drivers pulling
+ * their audio data themselves (as opposed to the callback-based
+ * ones, like JACK or PortAudio, where the thread is provided by the
+ * audio system).
+ *
+ * A period is processed in two steps. The \e render function calls
+ * the audio engine and moves the result into a slot owned by the
+ * driver and the \e write function hands the content of a slot over
+ * to the device. In case double buffering is enabled, both steps are
+ * done in separate threads using two slots. This way the next period
+ * is rendered while the current one is still being written (at the
+ * cost of one additional period of latency).
+ *
+ * Scheduling priority, CPU affinity, and memory locking are set
+ * according to the Settings provided in the constructor, which are
+ * usually obtained from the Preferences using
+ * settingsFromPreferences(). The priority is clamped to the range
+ * supported by SCHED_FIFO.
+ *
+ * When the thread is stopped, either by stop() or by the render
+ * function returning a value other than 0, all slots already
+ * rendered are still written.
+ */
+/** \ingroup docCore docAudioDriver */
+class DriverThread : public Object<DriverThread>
+{
+	H2_OBJECT(DriverThread)
+public:
+
+	struct Settings {
+		/** SCHED_FIFO priority of the thread(s). A value of 0
+		 * keeps the default scheduling policy.*/
+		int nPriority;
+		/** CPU the thread(s) will be pinned to. A negative value
+		 * disables pinning.*/
+		int nCpu;
+		/** Whether to lock all current and future memory pages of
+		 * the process into RAM using mlockall().*/
+		bool bLockMemory;
+		/** Whether to overlap rendering of the next period and
+		 * writing of the current one.*/
+		bool bDoubleBuffering;
+	};
+
+	/** Number of slots a driver has to provide in case of double
+	 * buffering.*/
+	static constexpr int nSlots = 2;
+
+	/**
+	 * \param sName Name used in log messages.
+	 * \param render Renders a period into the provided slot. If it
+	 *   returns a value other than 0, the thread will be stopped.
+	 * \param write Writes the content of the provided slot to the
+	 *   device. If @a write is nullptr, only @a render will be called.
+	 * \param settings Scheduling settings of the thread.
+	 */
+	DriverThread( const QString& sName,
+				  std::function<int(int)> render,
+				  std::function<void(int)> write,
+				  const Settings& settings );
+	~DriverThread();
+
+	/** Builds the settings using the driver_thread options in the
+	 * Preferences.
+	 *
+	 * \param bRealtime If set to false, the scheduling priority,
+	 *   CPU pinning, and memory locking will be ignored. Useful for
+	 *   offline rendering, like with the DiskWriterDriver.*/
+	static Settings settingsFromPreferences( bool bRealtime = true );
+
+	/** \return 0 on success.*/
+	int start();
+	/** Stops and joins the thread(s). Subsequent calls have no
+	 * effect.*/
+	void stop();
+
+	bool isRunning() const {
+		return m_bIsRunning;
+	}
+	bool isDoubleBuffered() const {
+		return m_settings.bDoubleBuffering && m_write != nullptr;
+	}
+
+	/** Increments the number of xruns and notifies the GUI about
+	 * it. Can be called from within both @a render and @a write.*/
+	void reportXRun();
+	int getXRuns() const {
+		return m_nXRuns;
+	}
+
+	/** Applies the scheduling, affinity, and memory locking
+	 * settings to the calling thread.*/
+	static void applySettings( const QString& sName, const Settings& settings );
+
+private:
+	static void* processCaller( void* param );
+	static void* renderCaller( void* param );
+	static void* writeCaller( void* param );
+
+	/** Blocks till @a nSlot is full (@a bFull) or empty or till the
+	 * thread was stopped.
+	 *
+	 * \return Whether @a nSlot is in the requested state.*/
+	bool waitForSlot( int nSlot, bool bFull );
+	void setSlot( int nSlot, bool bFull );
+
+	QString m_sName;
+	std::function<int(int)> m_render;
+	std::function<void(int)> m_write;
+	Settings m_settings;
+
+	pthread_t m_renderThread;
+	pthread_t m_writeThread;
+	std::atomic<bool> m_bIsRunning;
+	std::atomic<int> m_nXRuns;
+	/** Whether start() created threads which were not joined yet.*/
+	bool m_bJoinable;
+	/** Context of the thread calling start(). It is made current
+	 * in the driver thread(s).*/
+	EngineContext* m_pContext;
+
+	std::mutex m_slotMutex;
+	std::condition_variable m_slotCondition;
+	/** Whether a slot contains rendered audio not written yet.*/
+	bool m_slotFull[ nSlots ];
+};
+
+};
+
+#endif
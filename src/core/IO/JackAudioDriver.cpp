@@ -119,6 +119,8 @@ JackAudioDriver::JackAudioDriver( JackProcessCallback m_processCallback )
 	
 	memset( m_pTrackOutputPortsL, 0, sizeof(m_pTrackOutputPortsL) );
 	memset( m_pTrackOutputPortsR, 0, sizeof(m_pTrackOutputPortsR) );
+	memset( m_pTrackOutBuffersL, 0, sizeof(m_pTrackOutBuffersL) );
+	memset( m_pTrackOutBuffersR, 0, sizeof(m_pTrackOutBuffersR) );
 
 	m_JackTransportState  = JackTransportStopped;
 }
@@ -258,14 +260,25 @@ void JackAudioDriver::clearPerTrackAudioBuffers( uint32_t nFrames )
 		float* pBuffer;
 		
 		for ( int ii = 0; ii < m_nTrackPortCount; ++ii ) {
-			pBuffer = getTrackOut_L( ii );
-			if ( pBuffer != nullptr ) {
-				memset( pBuffer, 0, nFrames * sizeof( float ) );
+			pBuffer = nullptr;
+			if ( m_pTrackOutputPortsL[ ii ] != nullptr ) {
+				pBuffer = static_cast<float*>(
+					jack_port_get_buffer( m_pTrackOutputPortsL[ ii ], nFrames ) );
+				if ( pBuffer != nullptr ) {
+					memset( pBuffer, 0, nFrames * sizeof( float ) );
+				}
 			}
-			pBuffer = getTrackOut_R( ii );
-			if ( pBuffer != nullptr ) {
-				memset( pBuffer, 0, nFrames * sizeof( float ) );
+			m_pTrackOutBuffersL[ ii ] = pBuffer;
+			
+			pBuffer = nullptr;
+			if ( m_pTrackOutputPortsR[ ii ] != nullptr ) {
+				pBuffer = static_cast<float*>(
+					jack_port_get_buffer( m_pTrackOutputPortsR[ ii ], nFrames ) );
+				if ( pBuffer != nullptr ) {
+					memset( pBuffer, 0, nFrames * sizeof( float ) );
+				}
 			}
+			m_pTrackOutBuffersR[ ii ] = pBuffer;
 		}
 	}
 }
@@ -617,42 +630,22 @@ float* JackAudioDriver::getOut_R()
 	return out;
 }
 
-float* JackAudioDriver::getTrackOut_L( unsigned nTrack )
+float* JackAudioDriver::getTrackOut_L( std::shared_ptr<Instrument> instr, std::shared_ptr<InstrumentComponent> pCompo)
 {
-	if ( nTrack > static_cast<unsigned>(m_nTrackPortCount) ) {
+	int nTrack = getTrackNumber( instr->get_id(), pCompo->get_drumkit_componentID() );
+	if ( nTrack < 0 ) {
 		return nullptr;
 	}
-	
-	jack_port_t* pPort = m_pTrackOutputPortsL[nTrack];
-	jack_default_audio_sample_t* out = nullptr;
-	if( pPort ) {
-		out = static_cast<jack_default_audio_sample_t*>(jack_port_get_buffer( pPort, JackAudioDriver::jackServerBufferSize));
-	}
-	return out;
+	return getTrackOut_L( static_cast<unsigned>(nTrack) );
 }
 
-float* JackAudioDriver::getTrackOut_R( unsigned nTrack )
+float* JackAudioDriver::getTrackOut_R( std::shared_ptr<Instrument> instr, std::shared_ptr<InstrumentComponent> pCompo)
 {
-	if( nTrack > static_cast<unsigned>(m_nTrackPortCount) ) {
+	int nTrack = getTrackNumber( instr->get_id(), pCompo->get_drumkit_componentID() );
+	if ( nTrack < 0 ) {
 		return nullptr;
 	}
-	
-	jack_port_t* pPort = m_pTrackOutputPortsR[nTrack];
-	jack_default_audio_sample_t* out = nullptr;
-	if( pPort ) {
-		out = static_cast<jack_default_audio_sample_t*>(jack_port_get_buffer( pPort, JackAudioDriver::jackServerBufferSize));
-	}
-	return out;
-}
-
-float* JackAudioDriver::getTrackOut_L( std::shared_ptr<Instrument> instr, std::shared_ptr<InstrumentComponent> pCompo)
-{
-	return getTrackOut_L(m_trackMap[instr->get_id()][pCompo->get_drumkit_componentID()]);
-}
-
-float* JackAudioDriver::getTrackOut_R( std::shared_ptr<Instrument> instr, std::shared_ptr<InstrumentComponent> pCompo)
-{
-	return getTrackOut_R(m_trackMap[instr->get_id()][pCompo->get_drumkit_componentID()]);
+	return getTrackOut_R( static_cast<unsigned>(nTrack) );
 }
 
 
@@ -905,8 +898,10 @@ void JackAudioDriver::makeTrackOutputs( std::shared_ptr<Song> pSong )
 		pPortL = m_pTrackOutputPortsL[n];
 		pPortR = m_pTrackOutputPortsR[n];
 		m_pTrackOutputPortsL[n] = nullptr;
+		m_pTrackOutBuffersL[n] = nullptr;
 		jack_port_unregister( m_pClient, pPortL );
 		m_pTrackOutputPortsR[n] = nullptr;
+		m_pTrackOutBuffersR[n] = nullptr;
 		jack_port_unregister( m_pClient, pPortR );
 	}
 
@@ -159,8 +159,14 @@ public:
 
 	virtual int getXRuns() const override;
 
-	/** Resets the buffers contained in #m_pTrackOutputPortsL and
-	 * #m_pTrackOutputPortsR.
+	/** Resolves the buffers of all ports in #m_pTrackOutputPortsL
+	 * and #m_pTrackOutputPortsR into #m_pTrackOutBuffersL and
+	 * #m_pTrackOutBuffersR and resets them.
+	 *
+	 * This has to be done once at the beginning of each cycle of the
+	 * audio process callback. All getTrackOut_L() and
+	 * getTrackOut_R() calls within the same cycle do just return the
+	 * cached pointers.
 	 * 
 	 * @param nFrames Size of the buffers used in the audio process
 	 * callback function.
@@ -198,23 +204,53 @@ public:
 	/**
 	 * Get content of left output port of a specific track.
 	 *
-	 * \param nTrack Track number. Must not be bigger than
+	 * The buffer was resolved by clearPerTrackAudioBuffers() at the
+	 * beginning of the current cycle and is only valid within the
+	 * audio process callback.
+	 *
+	 * \param nTrack Track number. Must be smaller than
 	 * #m_nTrackPortCount.
 	 *
 	 * \return Pointer to buffer content of type
 	 * _jack_default_audio_sample_t*_ (jack/types.h)
 	 */
-	float* getTrackOut_L( unsigned nTrack );
+	float* getTrackOut_L( unsigned nTrack ) const {
+		return nTrack < static_cast<unsigned>(m_nTrackPortCount) ?
+			m_pTrackOutBuffersL[ nTrack ] : nullptr;
+	}
 	/**
 	 * Get content of right output port of a specific track.
 	 *
-	 * \param nTrack Track number. Must not be bigger than
+	 * The buffer was resolved by clearPerTrackAudioBuffers() at the
+	 * beginning of the current cycle and is only valid within the
+	 * audio process callback.
+	 *
+	 * \param nTrack Track number. Must be smaller than
 	 * #m_nTrackPortCount.
 	 *
 	 * \return Pointer to buffer content of type
 	 * _jack_default_audio_sample_t*_ (jack/types.h)
 	 */
-	float* getTrackOut_R( unsigned nTrack );
+	float* getTrackOut_R( unsigned nTrack ) const {
+		return nTrack < static_cast<unsigned>(m_nTrackPortCount) ?
+			m_pTrackOutBuffersR[ nTrack ] : nullptr;
+	}
+	/**
+	 * Looks up the track number of a component of an instrument in
+	 * #m_trackMap.
+	 *
+	 * \param nInstrumentId Instrument::__id
+	 * \param nComponentId InstrumentComponent::__related_drumkit_componentID
+	 *
+	 * \return Track number or -1 if there is none.
+	 */
+	int getTrackNumber( int nInstrumentId, int nComponentId ) const {
+		if ( nInstrumentId < 0 || nInstrumentId >= MAX_INSTRUMENTS ||
+			 nComponentId < 0 || nComponentId >= MAX_COMPONENTS ) {
+			return -1;
+		}
+		return m_trackMap[ nInstrumentId ][ nComponentId ];
+	}
 	/** 
 	 * Convenience function looking up the track number of a component
 	 * of an instrument using in #m_trackMap using their IDs
@@ -488,6 +524,18 @@ private:
 	 * local JACK client.
 	 */
 	jack_port_t*		 	m_pTrackOutputPortsR[MAX_INSTRUMENTS];
+	/**
+	 * Buffers of the ports in #m_pTrackOutputPortsL resolved by
+	 * clearPerTrackAudioBuffers(). This way _jack_port_get_buffer()_
+	 * (jack/jack.h) is called only once per port and cycle instead
+	 * of once per rendered note.
+	 */
+	float*				m_pTrackOutBuffersL[MAX_INSTRUMENTS];
+	/**
+	 * Buffers of the ports in #m_pTrackOutputPortsR resolved by
+	 * clearPerTrackAudioBuffers().
+	 */
+	float*				m_pTrackOutBuffersR[MAX_INSTRUMENTS];
 
 	/**
 	 * Current transport state returned by
@@ -0,0 +1,262 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#include <core/IO/LoopbackDriver.h>
+#include <core/IO/MidiInput.h>
+#include <core/Hydrogen.h>
+#include <core/Preferences/Preferences.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+namespace H2Core
+{
+
+LoopbackDriver::LoopbackDriver( audioProcessCallback processCallback )
+		: AudioOutput()
+		, m_processCallback( processCallback )
+		, m_nBufferSize( 0 )
+		, m_nSampleRate( 44100 )
+		, m_pOut_L( nullptr )
+		, m_pOut_R( nullptr )
+		, m_nFrame( 0 ) {
+}
+
+LoopbackDriver::~LoopbackDriver() {
+	delete[] m_pOut_L;
+	delete[] m_pOut_R;
+}
+
+int LoopbackDriver::init( unsigned nBufferSize )
+{
+	INFOLOG( QString( "Init, %1 samples" ).arg( nBufferSize ) );
+
+	m_nBufferSize = nBufferSize;
+	m_nSampleRate = Preferences::get_instance()->m_nSampleRate;
+
+	delete[] m_pOut_L;
+	delete[] m_pOut_R;
+	m_pOut_L = new float[ nBufferSize ];
+	m_pOut_R = new float[ nBufferSize ];
+	memset( m_pOut_L, 0, nBufferSize * sizeof( float ) );
+	memset( m_pOut_R, 0, nBufferSize * sizeof( float ) );
+
+	return 0;
+}
+
+int LoopbackDriver::connect()
+{
+	INFOLOG( "connect" );
+	m_nFrame = 0;
+	return 0;
+}
+
+void LoopbackDriver::disconnect()
+{
+	INFOLOG( "disconnect" );
+}
+
+unsigned LoopbackDriver::getSampleRate()
+{
+	return m_nSampleRate;
+}
+
+float* LoopbackDriver::getOut_L()
+{
+	return m_pOut_L;
+}
+
+float* LoopbackDriver::getOut_R()
+{
+	return m_pOut_R;
+}
+
+void LoopbackDriver::scheduleMidiMessage( long long nFrame, const MidiMessage& msg )
+{
+	m_scheduledMidi.push_back( { nFrame, msg } );
+}
+
+void LoopbackDriver::scheduleAction( long long nFrame, std::function<void()> action )
+{
+	m_scheduledActions.push_back( { nFrame, action } );
+}
+
+void LoopbackDriver::captureMidiMessage( const MidiMessage& msg )
+{
+	m_capturedMidiOutput.push_back( { m_nFrame, msg } );
+}
+
+void LoopbackDriver::clearCapture()
+{
+	m_capturedOut_L.clear();
+	m_capturedOut_R.clear();
+	m_capturedMidiInput.clear();
+	m_capturedMidiOutput.clear();
+	m_cycleTimes.clear();
+}
+
+void LoopbackDriver::dispatchScheduled( long long nCycleEnd )
+{
+	// Handlers are allowed to schedule further events. Due ones are
+	// therefore moved out first.
+	std::vector<MidiEvent> dueMidi;
+	auto midiIt = std::stable_partition(
+		m_scheduledMidi.begin(), m_scheduledMidi.end(),
+		[=]( const MidiEvent& ev ) { return ev.nFrame >= nCycleEnd; } );
+	dueMidi.assign( midiIt, m_scheduledMidi.end() );
+	m_scheduledMidi.erase( midiIt, m_scheduledMidi.end() );
+
+	std::vector<ScheduledAction> dueActions;
+	auto actionIt = std::stable_partition(
+		m_scheduledActions.begin(), m_scheduledActions.end(),
+		[=]( const ScheduledAction& ac ) { return ac.nFrame >= nCycleEnd; } );
+	dueActions.assign( actionIt, m_scheduledActions.end() );
+	m_scheduledActions.erase( actionIt, m_scheduledActions.end() );
+
+	std::stable_sort( dueMidi.begin(), dueMidi.end(),
+					  []( const MidiEvent& a, const MidiEvent& b ) {
+						  return a.nFrame < b.nFrame; } );
+	std::stable_sort( dueActions.begin(), dueActions.end(),
+					  []( const ScheduledAction& a, const ScheduledAction& b ) {
+						  return a.nFrame < b.nFrame; } );
+
+	for ( const auto& action : dueActions ) {
+		action.action();
+	}
+
+	MidiInput* pMidiInput = Hydrogen::get_instance()->getMidiInput();
+	for ( const auto& ev : dueMidi ) {
+		if ( pMidiInput == nullptr ) {
+			ERRORLOG( "No MIDI input available. Scheduled message dropped." );
+			continue;
+		}
+		pMidiInput->handleMidiMessage( ev.message );
+		m_capturedMidiInput.push_back( { m_nFrame, ev.message } );
+	}
+}
+
+int LoopbackDriver::processCycles( int nCycles )
+{
+	if ( m_pOut_L == nullptr || m_pOut_R == nullptr ) {
+		ERRORLOG( "Driver not initialized" );
+		return 0;
+	}
+
+	int nProcessed = 0;
+	for ( ; nProcessed < nCycles; ++nProcessed ) {
+		dispatchScheduled( m_nFrame + m_nBufferSize );
+
+		auto start = std::chrono::steady_clock::now();
+		int nRes = m_processCallback( m_nBufferSize, nullptr );
+		auto end = std::chrono::steady_clock::now();
+
+		m_cycleTimes.push_back(
+			std::chrono::duration<double, std::milli>( end - start ).count() );
+		m_capturedOut_L.insert( m_capturedOut_L.end(), m_pOut_L,
+								m_pOut_L + m_nBufferSize );
+		m_capturedOut_R.insert( m_capturedOut_R.end(), m_pOut_R,
+								m_pOut_R + m_nBufferSize );
+
+		m_nFrame += m_nBufferSize;
+
+		if ( nRes != 0 ) {
+			++nProcessed;
+			break;
+		}
+	}
+
+	return nProcessed;
+}
+
+int LoopbackDriver::processCyclesThreaded( int nCycles,
+										   const DriverThread::Settings& settings )
+{
+	if ( m_pOut_L == nullptr || m_pOut_R == nullptr ) {
+		ERRORLOG( "Driver not initialized" );
+		return 0;
+	}
+
+	std::vector<float> slots_L[ DriverThread::nSlots ];
+	std::vector<float> slots_R[ DriverThread::nSlots ];
+	int nRendered = 0;
+	int nCaptured = 0;
+	bool bStopRequested = false;
+
+	auto render = [&]( int nSlot ) {
+		if ( nRendered == nCycles || bStopRequested ) {
+			return 1;
+		}
+
+		dispatchScheduled( m_nFrame + m_nBufferSize );
+
+		auto start = std::chrono::steady_clock::now();
+		// Like processCycles() the cycle in which the audio engine
+		// requested to stop is still captured.
+		bStopRequested = m_processCallback( m_nBufferSize, nullptr ) != 0;
+		auto end = std::chrono::steady_clock::now();
+
+		m_cycleTimes.push_back(
+			std::chrono::duration<double, std::milli>( end - start ).count() );
+		slots_L[ nSlot ].assign( m_pOut_L, m_pOut_L + m_nBufferSize );
+		slots_R[ nSlot ].assign( m_pOut_R, m_pOut_R + m_nBufferSize );
+
+		m_nFrame += m_nBufferSize;
+		++nRendered;
+		return 0;
+	};
+
+	auto write = [&]( int nSlot ) {
+		m_capturedOut_L.insert( m_capturedOut_L.end(), slots_L[ nSlot ].begin(),
+								slots_L[ nSlot ].end() );
+		m_capturedOut_R.insert( m_capturedOut_R.end(), slots_R[ nSlot ].begin(),
+								slots_R[ nSlot ].end() );
+		++nCaptured;
+	};
+
+	DriverThread thread( "Loopback", render, write, settings );
+	if ( thread.start() != 0 ) {
+		return 0;
+	}
+	while ( thread.isRunning() ) {
+		std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+	}
+	// Joins the thread(s).
+	thread.stop();
+
+	return nCaptured;
+}
+
+long long LoopbackDriver::findOnset( const std::vector<float>& buffer,
+									 long long nStart, float fThreshold )
+{
+	for ( long long ii = std::max( nStart, 0LL );
+		  ii < static_cast<long long>(buffer.size()); ++ii ) {
+		if ( std::fabs( buffer[ ii ] ) > fThreshold ) {
+			return ii;
+		}
+	}
+	return -1;
+}
+
+};
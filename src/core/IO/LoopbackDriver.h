@@ -0,0 +1,175 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#ifndef LOOPBACK_DRIVER_H
+#define LOOPBACK_DRIVER_H
+
+#include <core/IO/AudioOutput.h>
+#include <core/IO/DriverThread.h>
+#include <core/IO/MidiCommon.h>
+
+#include <functional>
+#include <inttypes.h>
+#include <vector>
+
+namespace H2Core
+{
+
+/**
+ * Audio driver running on a simulated clock. Intended for
+ * deterministic end-to-end tests of the realtime path (MIDI input
+ * -> audio engine -> audio and MIDI output) without any audio
+ * hardware.
+ *
+ * No thread is started. Instead, time is advanced in steps of
+ * exactly one buffer each time processCycles() is invoked. Prior to
+ * each cycle all MIDI messages and actions scheduled using
+ * scheduleMidiMessage() and scheduleAction() for a frame within the
+ * upcoming cycle are dispatched. The rendered audio, all MIDI
+ * messages sent by the LoopbackMidiDriver, and the processing time
+ * of each cycle are captured in memory.
+ *
+ * Events are dispatched at the beginning of the cycle their frame
+ * falls into. This mimics the behavior of a real driver delivering
+ * incoming events with a granularity of one period.
+ */
+/** \ingroup docCore docAudioDriver */
+class LoopbackDriver : public Object<LoopbackDriver>, public AudioOutput
+{
+	H2_OBJECT(LoopbackDriver)
+public:
+	/** MIDI message annotated with the frame it was sent or
+	 * received at.*/
+	struct MidiEvent {
+		long long nFrame;
+		MidiMessage message;
+	};
+
+	LoopbackDriver( audioProcessCallback processCallback );
+	~LoopbackDriver();
+
+	virtual int init( unsigned nBufferSize ) override;
+	virtual int connect() override;
+	virtual void disconnect() override;
+	virtual unsigned getBufferSize() override {
+		return m_nBufferSize;
+	}
+	virtual unsigned getSampleRate() override;
+
+	virtual float* getOut_L() override;
+	virtual float* getOut_R() override;
+
+	/**
+	 * Processes @a nCycles buffers.
+	 *
+	 * \return Number of cycles processed. Smaller than @a nCycles in
+	 *   case the audio engine requested to stop the driver.
+	 */
+	int processCycles( int nCycles );
+	/**
+	 * Processes @a nCycles buffers like processCycles() but within a
+	 * DriverThread using @a settings. Rendering is done in its
+	 * render function while audio is captured in its write function.
+	 * This way the hand over between both, e.g. in case of double
+	 * buffering, can be checked.
+	 *
+	 * Blocks till the thread stopped.
+	 *
+	 * \return Number of cycles captured.
+	 */
+	int processCyclesThreaded( int nCycles, const DriverThread::Settings& settings );
+
+	/** Passes @a msg to the current MIDI input as soon as the cycle
+	 * containing @a nFrame is processed. */
+	void scheduleMidiMessage( long long nFrame, const MidiMessage& msg );
+	/** Calls @a action as soon as the cycle containing @a nFrame is
+	 * processed. Intended for scripting commands usually triggered
+	 * via OSC (which themselves call the CoreActionController). */
+	void scheduleAction( long long nFrame, std::function<void()> action );
+
+	/** Stores @a msg sent at the current frame.
+	 *
+	 * Used by the LoopbackMidiDriver.*/
+	void captureMidiMessage( const MidiMessage& msg );
+	/** Discards all captured audio, MIDI, and timing data. */
+	void clearCapture();
+
+	/** \return Frame the next cycle will start at.*/
+	long long getFrame() const {
+		return m_nFrame;
+	}
+	const std::vector<float>& getCapturedOut_L() const {
+		return m_capturedOut_L;
+	}
+	const std::vector<float>& getCapturedOut_R() const {
+		return m_capturedOut_R;
+	}
+	const std::vector<MidiEvent>& getCapturedMidiInput() const {
+		return m_capturedMidiInput;
+	}
+	const std::vector<MidiEvent>& getCapturedMidiOutput() const {
+		return m_capturedMidiOutput;
+	}
+	/** Wall clock time in milliseconds spent in the process
+	 * callback for each of the cycles processed. */
+	const std::vector<double>& getCycleTimes() const {
+		return m_cycleTimes;
+	}
+
+	/**
+	 * \return Index of the first frame of @a buffer starting from @a
+	 *   nStart whose absolute value exceeds @a fThreshold or -1 if
+	 *   there is none.
+	 */
+	static long long findOnset( const std::vector<float>& buffer,
+								long long nStart = 0,
+								float fThreshold = 0 );
+
+private:
+	struct ScheduledAction {
+		long long nFrame;
+		std::function<void()> action;
+	};
+
+	void dispatchScheduled( long long nCycleEnd );
+
+	audioProcessCallback m_processCallback;
+	unsigned m_nBufferSize;
+	unsigned m_nSampleRate;
+	float* m_pOut_L;
+	float* m_pOut_R;
+
+	/** Simulated clock. First frame of the next cycle.*/
+	long long m_nFrame;
+
+	std::vector<MidiEvent> m_scheduledMidi;
+	std::vector<ScheduledAction> m_scheduledActions;
+
+	std::vector<float> m_capturedOut_L;
+	std::vector<float> m_capturedOut_R;
+	std::vector<MidiEvent> m_capturedMidiInput;
+	std::vector<MidiEvent> m_capturedMidiOutput;
+	std::vector<double> m_cycleTimes;
+};
+
+};
+
+#endif
@@ -0,0 +1,131 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#include <core/IO/LoopbackMidiDriver.h>
+#include <core/IO/LoopbackDriver.h>
+
+#include <core/Basics/Instrument.h>
+#include <core/Basics/InstrumentList.h>
+#include <core/Basics/Note.h>
+#include <core/Basics/Song.h>
+#include <core/Hydrogen.h>
+
+namespace H2Core
+{
+
+LoopbackMidiDriver::LoopbackMidiDriver()
+	: MidiInput(), MidiOutput(), Object<LoopbackMidiDriver>()
+{
+}
+
+LoopbackMidiDriver::~LoopbackMidiDriver()
+{
+}
+
+void LoopbackMidiDriver::open()
+{
+	INFOLOG( "open" );
+}
+
+void LoopbackMidiDriver::close()
+{
+	INFOLOG( "close" );
+}
+
+std::vector<QString> LoopbackMidiDriver::getInputPortList()
+{
+	return std::vector<QString>();
+}
+
+std::vector<QString> LoopbackMidiDriver::getOutputPortList()
+{
+	return std::vector<QString>();
+}
+
+void LoopbackMidiDriver::send( const MidiMessage& msg )
+{
+	auto pDriver = dynamic_cast<LoopbackDriver*>(
+		Hydrogen::get_instance()->getAudioOutput() );
+	if ( pDriver == nullptr ) {
+		return;
+	}
+	pDriver->captureMidiMessage( msg );
+}
+
+void LoopbackMidiDriver::handleQueueNote( Note* pNote )
+{
+	int nChannel = pNote->get_instrument()->get_midi_out_channel();
+	if ( nChannel < 0 ) {
+		return;
+	}
+
+	// Same order as in the other MIDI drivers: note off first.
+	handleQueueNoteOff( nChannel, pNote->get_midi_key(),
+						pNote->get_midi_velocity() );
+
+	MidiMessage msg;
+	msg.m_type = MidiMessage::NOTE_ON;
+	msg.m_nChannel = nChannel;
+	msg.m_nData1 = pNote->get_midi_key();
+	msg.m_nData2 = pNote->get_midi_velocity();
+	send( msg );
+}
+
+void LoopbackMidiDriver::handleQueueNoteOff( int channel, int key, int velocity )
+{
+	if ( channel < 0 ) {
+		return;
+	}
+
+	MidiMessage msg;
+	msg.m_type = MidiMessage::NOTE_OFF;
+	msg.m_nChannel = channel;
+	msg.m_nData1 = key;
+	msg.m_nData2 = velocity;
+	send( msg );
+}
+
+void LoopbackMidiDriver::handleQueueAllNoteOff()
+{
+	auto pSong = Hydrogen::get_instance()->getSong();
+	if ( pSong == nullptr ) {
+		return;
+	}
+
+	InstrumentList* pInstrList = pSong->getInstrumentList();
+	for ( int ii = 0; ii < pInstrList->size(); ++ii ) {
+		auto pInstr = pInstrList->get( ii );
+		handleQueueNoteOff( pInstr->get_midi_out_channel(),
+							pInstr->get_midi_out_note(), 0 );
+	}
+}
+
+void LoopbackMidiDriver::handleOutgoingControlChange( int param, int value, int channel )
+{
+	MidiMessage msg;
+	msg.m_type = MidiMessage::CONTROL_CHANGE;
+	msg.m_nChannel = channel;
+	msg.m_nData1 = param;
+	msg.m_nData2 = value;
+	send( msg );
+}
+
+};
@@ -0,0 +1,66 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#ifndef LOOPBACK_MIDI_DRIVER_H
+#define LOOPBACK_MIDI_DRIVER_H
+
+#include <core/IO/MidiInput.h>
+#include <core/IO/MidiOutput.h>
+
+#include <vector>
+
+namespace H2Core
+{
+
+/**
+ * MIDI driver without any connection to the outside world used in
+ * combination with the LoopbackDriver.
+ *
+ * Incoming messages are injected by the LoopbackDriver using
+ * MidiInput::handleMidiMessage(). Outgoing messages are passed to
+ * the LoopbackDriver (if it is the current audio driver) which
+ * stores them along with the frame they were sent at.
+ */
+/** \ingroup docCore docMIDI */
+class LoopbackMidiDriver : public Object<LoopbackMidiDriver>, public virtual MidiInput, public virtual MidiOutput
+{
+	H2_OBJECT(LoopbackMidiDriver)
+public:
+	LoopbackMidiDriver();
+	virtual ~LoopbackMidiDriver();
+
+	virtual void open() override;
+	virtual void close() override;
+	virtual std::vector<QString> getInputPortList() override;
+	virtual std::vector<QString> getOutputPortList() override;
+
+	virtual void handleQueueNote(Note* pNote) override;
+	virtual void handleQueueNoteOff( int channel, int key, int velocity ) override;
+	virtual void handleQueueAllNoteOff() override;
+	virtual void handleOutgoingControlChange( int param, int value, int channel ) override;
+
+private:
+	void send( const MidiMessage& msg );
+};
+
+};
+
+#endif
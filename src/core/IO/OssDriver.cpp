@@ -27,54 +27,23 @@
 
 #include <core/Preferences/Preferences.h>
 
-#include <pthread.h>
+#include <algorithm>
 
 namespace H2Core
 {
 
-audioProcessCallback ossDriver_audioProcessCallback;
-bool ossDriver_running;
-pthread_t ossDriverThread;
 int oss_driver_bufferSize = -1;
-OssDriver *m_pOssDriverInstance = NULL;
-
-unsigned nNextFrames = 0;
-
-void* ossDriver_processCaller( void* param )
-{
-	Base * __object = ( Base * )param;
-	// stolen from amSynth
-	struct sched_param sched;
-	sched.sched_priority = 50;
-	int res = sched_setscheduler( 0, SCHED_FIFO, &sched );
-	sched_getparam( 0, &sched );
-	if ( res ) {
-		__WARNINGLOG( "Can't set realtime scheduling for OSS Driver" );
-	}
-	__INFOLOG( QString( "Scheduling priority = %1" ).arg( sched.sched_priority ) );
-
-	OssDriver *ossDriver = ( OssDriver* )param;
-
-	sleep( 1 );
-
-	while ( ossDriver_running ) {
-		ossDriver_audioProcessCallback( oss_driver_bufferSize, NULL );
-		ossDriver->write();
-	}
-
-	pthread_exit( NULL );
-	return NULL;
-}
-
 
 OssDriver::OssDriver( audioProcessCallback processCallback )
 		: AudioOutput()
 {
 	audioBuffer = NULL;
-	ossDriver_running = false;
 	this->processCallback = processCallback;
-	ossDriver_audioProcessCallback = processCallback;
-	m_pOssDriverInstance = this;
+	m_pDriverThread = new DriverThread(
+		"OSS",
+		[this]( int nSlot ) { return render( nSlot ); },
+		[this]( int nSlot ) { write( nSlot ); },
+		DriverThread::settingsFromPreferences() );
 }
 
 
@@ -83,6 +52,7 @@ OssDriver::OssDriver( audioProcessCallback processCallback )
 
 
 OssDriver::~OssDriver() {
+	delete m_pDriverThread;
 }
 
 
@@ -94,7 +64,7 @@ int OssDriver::init( unsigned nBufferSize )
 	delete[] audioBuffer;
 	audioBuffer = NULL;
 
-	audioBuffer = new short[nBufferSize * 2];
+	audioBuffer = new short[nBufferSize * 2 * DriverThread::nSlots];
 
 	out_L = new float[nBufferSize];
 	out_R = new float[nBufferSize];
@@ -191,11 +161,10 @@ int OssDriver::connect()
 	}
 
 	// start main thread
-	ossDriver_running = true;
-	pthread_attr_t attr;
-	pthread_attr_init( &attr );
-
-	pthread_create( &ossDriverThread, &attr, ossDriver_processCaller, this );
+	if ( m_pDriverThread->start() != 0 ) {
+		close( fd );
+		return 1;
+	}
 
 	return 0;
 }
@@ -207,10 +176,7 @@ void OssDriver::disconnect()
 {
 	INFOLOG( "disconnect" );
 
-	ossDriver_running = false;
-
-	// join ossDriverThread
-	pthread_join( ossDriverThread, NULL );
+	m_pDriverThread->stop();
 
 	if ( fd != -1 ) {
 		if ( close( fd ) ) {
@@ -231,26 +197,41 @@ void OssDriver::disconnect()
 
 
 
-/// Write the audio data
-void OssDriver::write()
+int OssDriver::render( int nSlot )
 {
-//	infoLog("write");
-	unsigned size = oss_driver_bufferSize * 2;
+	processCallback( oss_driver_bufferSize, NULL );
 
 	// prepare the 2-channel array of short
+	short* pBuffer = audioBuffer + nSlot * oss_driver_bufferSize * 2;
 	for ( unsigned i = 0; i < ( unsigned )oss_driver_bufferSize; ++i ) {
-		audioBuffer[i * 2] = ( short )( out_L[i] * 32768.0 );
-		audioBuffer[i * 2 + 1] = ( short )( out_R[i] * 32768.0 );
+		pBuffer[i * 2] = ( short )( std::min( std::max( out_L[i], -1.0f ), 1.0f ) * 32767.0 );
+		pBuffer[i * 2 + 1] = ( short )( std::min( std::max( out_R[i], -1.0f ), 1.0f ) * 32767.0 );
 	}
 
-	unsigned long written = ::write( fd, audioBuffer, size * 2 );
+	return 0;
+}
+
+/// Write the audio data
+void OssDriver::write( int nSlot )
+{
+//	infoLog("write");
+	unsigned size = oss_driver_bufferSize * 2;
+	short* pBuffer = audioBuffer + nSlot * size;
+
+	unsigned long written = ::write( fd, pBuffer, size * 2 );
 
 	if ( written != ( size * 2 ) ) {
 		ERRORLOG( "OssDriver: Error writing samples to audio device." );
+		m_pDriverThread->reportXRun();
 //		std::cerr << "written = " << written << " of " << (size*2) << endl;
 	}
 }
 
+int OssDriver::getXRuns() const
+{
+	return m_pDriverThread->getXRuns();
+}
+
 
 
 
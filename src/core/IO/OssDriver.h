@@ -45,6 +45,7 @@
 #include <inttypes.h>
 
 #include <core/Globals.h>
+#include <core/IO/DriverThread.h>
 
 /*
 #ifdef __NetBSD__
@@ -72,22 +73,30 @@ public:
 	int connect();
 	void disconnect();
 
-	void write();
+	/** Writes the @a nSlot part of #audioBuffer to the device.*/
+	void write( int nSlot );
 	unsigned getBufferSize();
 	unsigned getSampleRate();
 	float* getOut_L();
 	float* getOut_R();
+	virtual int getXRuns() const override;
 
 private:
 	/** file descriptor, for writing to /dev/dsp */
 	int fd;
 
+	/** Interleaved 16 bit output. Holds one period for each slot
+	 * of #m_pDriverThread.*/
 	short* audioBuffer;
 	float* out_L;
 	float* out_R;
 
 	audioProcessCallback processCallback;
+	DriverThread* m_pDriverThread;
 	int log2( int n );
+	/** Runs the audio engine and converts its output into the @a
+	 * nSlot part of #audioBuffer.*/
+	int render( int nSlot );
 
 };
 
@@ -41,11 +41,9 @@
 *
 */
 
-MidiMap * MidiMap::__instance = nullptr;
-
 MidiMap::MidiMap()
 {
-	__instance = this;
+	EngineContext::current()->setMidiMap( this );
 	QMutexLocker mx(&__mutex);
 
 	// Constructor
@@ -57,20 +55,22 @@ MidiMap::~MidiMap()
 {
 	QMutexLocker mx(&__mutex);
 
-	__instance = nullptr;
+	if ( EngineContext::current()->getMidiMap() == this ) {
+		EngineContext::current()->setMidiMap( nullptr );
+	}
 }
 
 void MidiMap::create_instance()
 {
-	if( __instance == nullptr ) {
-		__instance = new MidiMap;
+	if( EngineContext::current()->getMidiMap() == nullptr ) {
+		new MidiMap;
 	}
 }
 
 void MidiMap::reset_instance()
 {
 	create_instance();
-	__instance->reset();
+	get_instance()->reset();
 }
 
 
@@ -27,6 +27,7 @@
 #include <map>
 #include <cassert>
 #include <core/Object.h>
+#include <core/EngineContext.h>
 
 #include <QtCore/QMutex>
 
@@ -37,31 +38,25 @@ class MidiMap : public H2Core::Object<MidiMap>
 {
 	H2_OBJECT(MidiMap)
 public:
-	/**
-	 * Object holding the current MidiMap singleton. It is
-	 * initialized with NULL, set with create_instance(),
-	 * and accessed with get_instance().
-	 */
-	static MidiMap* __instance;
 	~MidiMap();
 		
 	/**
-	 * If #__instance equals 0, a new MidiMap singleton will
-	 * be created and stored in it.
+	 * If the current EngineContext does not hold a MidiMap yet, a
+	 * new one will be created and stored in it.
 	 *
 	 * It is called in Hydrogen::create_instance().
 	 */
 	static void create_instance();
 	/**
-	 * Convenience function calling reset() on the current
-	 * MidiMap #__instance.
+	 * Convenience function calling reset() on the MidiMap of the
+	 * current EngineContext.
 	 */
 	static void reset_instance();
 	/**
-	 * Returns a pointer to the current MidiMap singleton
-	 * stored in #__instance.
+	 * Returns a pointer to the MidiMap of the current
+	 * EngineContext.
 	 */
-	static MidiMap* get_instance() { assert(__instance); return __instance; }
+	static MidiMap* get_instance() { assert( EngineContext::current()->getMidiMap() ); return EngineContext::current()->getMidiMap(); }
 
 	void reset();  ///< Reinitializes the object.
 
@@ -39,6 +39,7 @@
 #include "core/EventQueue.h"
 #include "core/Hydrogen.h"
 #include "core/AudioEngine/AudioEngine.h"
+#include "core/IO/AudioOutput.h"
 #include "core/Basics/Song.h"
 #include "core/MidiAction.h"
 
@@ -820,6 +821,24 @@ void OscServer::QUIT_Handler(lo_arg **argv, int argc) {
 	pController->quit();
 }
 
+void OscServer::HEALTH_Handler( lo_message msg ) {
+	INFOLOG( "processing message" );
+	auto pHydrogen = H2Core::Hydrogen::get_instance();
+	auto pAudioOutput = pHydrogen->getAudioOutput();
+
+	lo_message reply = lo_message_new();
+	lo_message_add_int32( reply, static_cast<int32_t>( getpid() ) );
+	lo_message_add_int32( reply, static_cast<int32_t>(
+							  pHydrogen->getAudioEngine()->getState() ) );
+	lo_message_add_int32( reply, pAudioOutput != nullptr ?
+						  pAudioOutput->getXRuns() : 0 );
+	lo_message_add_string( reply, pAudioOutput != nullptr ?
+						   pAudioOutput->class_name() : "" );
+
+	lo_send_message( lo_message_get_source( msg ), "/Hydrogen/HEALTH", reply );
+	lo_message_free( reply );
+}
+
 // -------------------------------------------------------------------
 
 void OscServer::TIMELINE_ACTIVATION_Handler(lo_arg **argv, int argc) {
@@ -1308,10 +1327,14 @@ bool OscServer::init()
 	m_pServerThread->add_method("/Hydrogen/SAVE_SONG", "", SAVE_SONG_Handler);
 	m_pServerThread->add_method("/Hydrogen/SAVE_SONG", "f", SAVE_SONG_Handler);
 	m_pServerThread->add_method("/Hydrogen/SAVE_SONG_AS", "s", SAVE_SONG_AS_Handler);
-	m_pServerThread->add_method("/Hydrogen/SAVE_PREFERENCES", "", SAVE_SONG_Handler);
-	m_pServerThread->add_method("/Hydrogen/SAVE_PREFERENCES", "f", SAVE_SONG_Handler);
+	m_pServerThread->add_method("/Hydrogen/SAVE_PREFERENCES", "", SAVE_PREFERENCES_Handler);
+	m_pServerThread->add_method("/Hydrogen/SAVE_PREFERENCES", "f", SAVE_PREFERENCES_Handler);
 	m_pServerThread->add_method("/Hydrogen/QUIT", "", QUIT_Handler);
 	m_pServerThread->add_method("/Hydrogen/QUIT", "f", QUIT_Handler);
+	m_pServerThread->add_method("/Hydrogen/HEALTH", "", [&](lo_message msg){
+		HEALTH_Handler( msg );
+		return 0;
+	});
 
 	m_pServerThread->add_method("/Hydrogen/TIMELINE_ACTIVATION", "f", TIMELINE_ACTIVATION_Handler);
 	m_pServerThread->add_method("/Hydrogen/TIMELINE_ADD_MARKER", "ff", TIMELINE_ADD_MARKER_Handler);
@@ -628,6 +628,18 @@ class OscServer : public H2Core::Object<OscServer>
 		 * \param argc Unused number of arguments passed by the OSC
 		 * message.*/
 		static void QUIT_Handler(lo_arg **argv, int argc);
+		/**
+		 * Replies to the sender of the message with a \e
+		 * /Hydrogen/HEALTH message containing the process ID, the
+		 * state of the audio engine (as H2Core::AudioEngine::State),
+		 * the number of xruns, and the class name of the current
+		 * audio driver.
+		 *
+		 * Intended to be polled by process supervisors when running
+		 * Hydrogen headless using `h2cli --daemon`.
+		 *
+		 * \param msg Incoming message. Used to determine its sender.*/
+		static void HEALTH_Handler( lo_message msg );
 		/**
 		 * Triggers CoreActionController::activateTimeline().
 		 *
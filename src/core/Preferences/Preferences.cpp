@@ -49,18 +49,16 @@
 namespace H2Core
 {
 
-Preferences* Preferences::__instance = nullptr;
-
 void Preferences::create_instance()
 {
-	if ( __instance == nullptr ) {
-		__instance = new Preferences;
+	if ( EngineContext::current()->getPreferences() == nullptr ) {
+		new Preferences;
 	}
 }
 
 Preferences::Preferences()
 {
-	__instance = this;
+	EngineContext::current()->setPreferences( this );
 	m_pTheme = std::make_shared<Theme>();
 
 	// switch to enable / disable lash, only on h2 startup
@@ -144,12 +142,21 @@ Preferences::Preferences()
 	m_bUseMetronome = false;
 	m_fMetronomeVolume = 0.5;
 	m_nMaxNotes = 256;
+	m_bFXAutoBypass = true;
+	m_fFXTailTime = 10.0;
+	m_nFXWorkerThreads = -1;
 	m_nBufferSize = 1024;
 	m_nSampleRate = 44100;
 
 	//___ oss driver properties ___
 	m_sOSSDevice = QString("/dev/dsp");
 
+	//___ driver thread properties ___
+	m_nDriverThreadPriority = 50;
+	m_nDriverThreadCpu = -1;
+	m_bDriverThreadLockMemory = false;
+	m_bDriverThreadDoubleBuffering = false;
+
 	//___ MIDI Driver properties
 #if defined(H2CORE_HAVE_ALSA)
 	m_sMidiDriver = QString("ALSA");
@@ -202,6 +209,7 @@ Preferences::Preferences()
 #else
 	m_sAlsaAudioDevice = "hw:0";
 #endif
+	m_bAlsaUseMmap = false;
 
 	//___  jack driver properties ___
 	m_sJackPortName1 = QString("alsa_pcm:playback_1");
@@ -233,6 +241,7 @@ Preferences::Preferences()
 	quantizeEvents = true;
 	recordEvents = false;
 	m_bUseRelativeFilenamesForPlaylists = false;
+	m_bSaveSongSnapshots = false;
 	m_bHideKeyboardCursor = false;
 
 	//___ GUI properties ___
@@ -272,7 +281,9 @@ Preferences::Preferences()
 Preferences::~Preferences()
 {
 	INFOLOG( "DESTROY" );
-	__instance = nullptr;
+	if ( EngineContext::current()->getPreferences() == this ) {
+		EngineContext::current()->setPreferences( nullptr );
+	}
 }
 
 
@@ -349,6 +360,7 @@ void Preferences::loadPreferences( bool bGlobal )
 								   static_cast<int>(InterfaceTheme::ScalingPolicy::Smaller), false, false )) );
 			m_nLastOpenTab = rootNode.read_int( "lastOpenTab", 0, false, false );
 			m_bUseRelativeFilenamesForPlaylists = rootNode.read_bool( "useRelativeFilenamesForPlaylists", false, false, false );
+			m_bSaveSongSnapshots = rootNode.read_bool( "saveSongSnapshots", m_bSaveSongSnapshots, true, false );
 			m_bHideKeyboardCursor = rootNode.read_bool( "hideKeyboardCursorWhenUnused", false, false, false );
 
 			//restore the right m_bsetlash value
@@ -439,6 +451,9 @@ void Preferences::loadPreferences( bool bGlobal )
 				m_bUseMetronome = audioEngineNode.read_bool( "use_metronome", m_bUseMetronome, false, false );
 				m_fMetronomeVolume = audioEngineNode.read_float( "metronome_volume", 0.5f, false, false );
 				m_nMaxNotes = audioEngineNode.read_int( "maxNotes", m_nMaxNotes, false, false );
+				m_bFXAutoBypass = audioEngineNode.read_bool( "fx_auto_bypass", m_bFXAutoBypass, true, false );
+				m_fFXTailTime = audioEngineNode.read_float( "fx_tail_time", m_fFXTailTime, true, false );
+				m_nFXWorkerThreads = audioEngineNode.read_int( "fx_worker_threads", m_nFXWorkerThreads, true, false );
 				m_nBufferSize = audioEngineNode.read_int( "buffer_size", m_nBufferSize, false, false );
 				m_nSampleRate = audioEngineNode.read_int( "samplerate", m_nSampleRate, false, false );
 
@@ -451,6 +466,15 @@ void Preferences::loadPreferences( bool bGlobal )
 					m_sOSSDevice = ossDriverNode.read_string( "ossDevice", m_sOSSDevice, false, false );
 				}
 
+				//// DRIVER THREAD ////
+				XMLNode driverThreadNode = audioEngineNode.firstChildElement( "driver_thread" );
+				if ( ! driverThreadNode.isNull() ) {
+					m_nDriverThreadPriority = driverThreadNode.read_int( "priority", m_nDriverThreadPriority, true, false );
+					m_nDriverThreadCpu = driverThreadNode.read_int( "cpu", m_nDriverThreadCpu, true, false );
+					m_bDriverThreadLockMemory = driverThreadNode.read_bool( "lock_memory", m_bDriverThreadLockMemory, true, false );
+					m_bDriverThreadDoubleBuffering = driverThreadNode.read_bool( "double_buffering", m_bDriverThreadDoubleBuffering, true, false );
+				}
+
 				//// PORTAUDIO DRIVER ////
 				XMLNode portAudioDriverNode = audioEngineNode.firstChildElement( "portaudio_driver" );
 				if ( portAudioDriverNode.isNull()  ) {
@@ -533,6 +557,7 @@ void Preferences::loadPreferences( bool bGlobal )
 					bRecreate = true;
 				} else {
 					m_sAlsaAudioDevice = alsaAudioDriverNode.read_string( "alsa_audio_device", m_sAlsaAudioDevice, false, false );
+					m_bAlsaUseMmap = alsaAudioDriverNode.read_bool( "alsa_use_mmap", m_bAlsaUseMmap, true, false );
 				}
 
 				/// MIDI DRIVER ///
@@ -853,6 +878,7 @@ bool Preferences::savePreferences()
 	rootNode.write_bool( "useTheRubberbandBpmChangeEvent", m_useTheRubberbandBpmChangeEvent );
 
 	rootNode.write_bool( "useRelativeFilenamesForPlaylists", m_bUseRelativeFilenamesForPlaylists );
+	rootNode.write_bool( "saveSongSnapshots", m_bSaveSongSnapshots );
 	rootNode.write_bool( "hideKeyboardCursorWhenUnused", m_bHideKeyboardCursor );
 	
 	// instrument input mode
@@ -924,6 +950,9 @@ bool Preferences::savePreferences()
 		audioEngineNode.write_bool( "use_metronome", m_bUseMetronome );
 		audioEngineNode.write_float( "metronome_volume", m_fMetronomeVolume );
 		audioEngineNode.write_int( "maxNotes", m_nMaxNotes );
+		audioEngineNode.write_bool( "fx_auto_bypass", m_bFXAutoBypass );
+		audioEngineNode.write_float( "fx_tail_time", m_fFXTailTime );
+		audioEngineNode.write_int( "fx_worker_threads", m_nFXWorkerThreads );
 		audioEngineNode.write_int( "buffer_size", m_nBufferSize );
 		audioEngineNode.write_int( "samplerate", m_nSampleRate );
 
@@ -933,6 +962,15 @@ bool Preferences::savePreferences()
 			ossDriverNode.write_string( "ossDevice", m_sOSSDevice );
 		}
 
+		//// DRIVER THREAD ////
+		XMLNode driverThreadNode = audioEngineNode.createNode( "driver_thread" );
+		{
+			driverThreadNode.write_int( "priority", m_nDriverThreadPriority );
+			driverThreadNode.write_int( "cpu", m_nDriverThreadCpu );
+			driverThreadNode.write_bool( "lock_memory", m_bDriverThreadLockMemory );
+			driverThreadNode.write_bool( "double_buffering", m_bDriverThreadDoubleBuffering );
+		}
+
 		//// PORTAUDIO DRIVER ////
 		XMLNode portAudioDriverNode = audioEngineNode.createNode( "portaudio_driver" );
 		{
@@ -1001,6 +1039,7 @@ bool Preferences::savePreferences()
 		XMLNode alsaAudioDriverNode = audioEngineNode.createNode( "alsa_audio_driver" );
 		{
 			alsaAudioDriverNode.write_string( "alsa_audio_device", m_sAlsaAudioDevice );
+			alsaAudioDriverNode.write_bool( "alsa_use_mmap", m_bAlsaUseMmap );
 		}
 
 		/// MIDI DRIVER ///
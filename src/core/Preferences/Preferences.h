@@ -32,6 +32,7 @@
 #include <core/MidiAction.h>
 #include <core/Globals.h>
 #include <core/Object.h>
+#include <core/EngineContext.h>
 
 #include <QStringList>
 #include <QDomDocument>
@@ -187,6 +188,17 @@ public:
 	float				m_fMetronomeVolume;
 	/// max notes
 	unsigned			m_nMaxNotes;
+	/** Whether LADSPA effects are skipped once their input was
+	 * silent for longer than #m_fFXTailTime.*/
+	bool				m_bFXAutoBypass;
+	/** Time in seconds an effect keeps being processed after its
+	 * input became silent in order to render its tail (e.g. reverb
+	 * or delay).*/
+	float				m_fFXTailTime;
+	/** Number of threads processing LADSPA effects in parallel to
+	 * the audio thread. 0 processes all of them in the audio thread
+	 * and -1 picks a value based on the number of CPU cores.*/
+	int					m_nFXWorkerThreads;
 	/** 
 	 * Buffer size of the audio.
 	 *
@@ -205,6 +217,20 @@ public:
 	//	OSS driver properties ___
 	QString				m_sOSSDevice;		///< Device used for output
 
+	//	driver thread properties ___
+	// Used by all audio drivers running their own thread (see
+	// DriverThread).
+	/** SCHED_FIFO priority of the driver thread. 0 disables realtime
+	 * scheduling.*/
+	int					m_nDriverThreadPriority;
+	/** CPU the driver thread is pinned to. -1 disables pinning.*/
+	int					m_nDriverThreadCpu;
+	/** Whether to lock the memory of Hydrogen using mlockall().*/
+	bool				m_bDriverThreadLockMemory;
+	/** Whether to render the next period while the current one is
+	 * written to the device.*/
+	bool				m_bDriverThreadDoubleBuffering;
+
 	//	MIDI Driver properties
 	/**
 	 * MIDI driver
@@ -273,6 +299,10 @@ public:
 
 	//	alsa audio driver properties ___
 	QString				m_sAlsaAudioDevice;
+	/** Whether the AlsaAudioDriver writes directly into the
+	 * memory-mapped ring buffer of the device. Falls back to
+	 * read/write access if the device does not support it.*/
+	bool				m_bAlsaUseMmap;
 
 	// PortAudio properties
 	QString				m_sPortAudioDevice;
@@ -373,17 +403,17 @@ public:
 	QString				m_rubberBandCLIexecutable;
 
 	/**
-	 * If #__instance equals 0, a new Preferences singleton will
-	 * be created and stored in it.
+	 * If the current EngineContext does not hold a Preferences
+	 * instance yet, a new one will be created and stored in it.
 	 *
 	 * It is called in Hydrogen::create_instance().
 	 */
 	static void				create_instance();
 	/**
-	 * Returns a pointer to the current Preferences singleton
-	 * stored in #__instance.
+	 * Returns a pointer to the Preferences of the current
+	 * EngineContext.
 	 */
-	static Preferences* 	get_instance(){ assert(__instance); return __instance; }
+	static Preferences* 	get_instance(){ assert( EngineContext::current()->getPreferences() ); return EngineContext::current()->getPreferences(); }
 
 	~Preferences();
 
@@ -413,6 +443,10 @@ public:
 	void			setRestoreLastSongEnabled( bool restore );
 	void			setRestoreLastPlaylistEnabled( bool restore );
 	void			setUseRelativeFilenamesForPlaylists( bool value );
+	/** Whether a binary SongSnapshot is written next to each
+	 * .h2song file loaded and used for loading it again.*/
+	bool			getSaveSongSnapshots() const;
+	void			setSaveSongSnapshots( bool bValue );
 
 	void			setShowDevelWarning( bool value );
 	bool			getShowDevelWarning();
@@ -653,13 +687,6 @@ public:
 	void setTheme( const std::shared_ptr<Theme> pTheme );
 	
 private:
-	/**
-	 * Object holding the current Preferences singleton. It is
-	 * initialized with NULL, set with create_instance(), and
-	 * accessed with get_instance().
-	 */
-	static Preferences *		__instance;
-
 	std::shared_ptr<Theme>		m_pTheme;
 	
 	//___ General properties ___
@@ -734,6 +761,7 @@ private:
 	bool					m_bIsFXTabVisible;
 	bool					m_bShowAutomationArea;
 	bool					m_bUseRelativeFilenamesForPlaylists;
+	bool					m_bSaveSongSnapshots;
 	unsigned				m_nPatternEditorGridHeight;
 	unsigned				m_nPatternEditorGridWidth;
 	unsigned				m_nSongEditorGridHeight;
@@ -1015,6 +1043,13 @@ inline void Preferences::setUseRelativeFilenamesForPlaylists( bool value ) {
 	m_bUseRelativeFilenamesForPlaylists= value;
 }
 
+inline bool Preferences::getSaveSongSnapshots() const {
+	return m_bSaveSongSnapshots;
+}
+inline void Preferences::setSaveSongSnapshots( bool bValue ) {
+	m_bSaveSongSnapshots = bValue;
+}
+
 inline void Preferences::setShowDevelWarning( bool value ) {
 	m_bShowDevelWarning = value;
 }
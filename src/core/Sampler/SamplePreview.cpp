@@ -0,0 +1,356 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+#include <core/Sampler/SamplePreview.h>
+
+#include <core/Basics/Drumkit.h>
+#include <core/Basics/Instrument.h>
+#include <core/Basics/InstrumentComponent.h>
+#include <core/Basics/InstrumentLayer.h>
+#include <core/Basics/InstrumentList.h>
+#include <core/Basics/Sample.h>
+#include <core/EngineContext.h>
+#include <core/EventQueue.h>
+#include <core/Sampler/Sampler.h>
+
+#include <algorithm>
+
+#include <QFileInfo>
+
+namespace H2Core
+{
+
+SamplePreview::SamplePreview( Sampler* pSampler )
+	: m_pSampler( pSampler )
+	, m_pContext( EngineContext::current() )
+	, m_bShutdown( false )
+	, m_pPendingRequest( nullptr )
+	, m_bBusy( false )
+	, m_nGeneration( 0 )
+	, m_nCacheSize( nDefaultCacheSize )
+	, m_nCacheUsage( 0 )
+{
+	m_thread = std::thread( &SamplePreview::run, this );
+}
+
+SamplePreview::~SamplePreview()
+{
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+		m_bShutdown = true;
+		m_pPendingRequest = nullptr;
+	}
+	m_condition.notify_all();
+	m_thread.join();
+}
+
+void SamplePreview::previewSample( const QString& sPath, int nLength )
+{
+	std::unique_lock<std::mutex> lock( m_mutex );
+	auto pSample = lookup( sPath );
+	if ( pSample != nullptr ) {
+		++m_nGeneration;
+		m_pPendingRequest = nullptr;
+		queue( pSample, nLength );
+		return;
+	}
+	lock.unlock();
+
+	auto pRequest = std::make_unique<Request>();
+	pRequest->sPath = sPath;
+	pRequest->bPlay = true;
+	pRequest->nLength = nLength;
+	schedule( std::move( pRequest ) );
+}
+
+void SamplePreview::previewInstrument( const QString& sDrumkitName,
+									   const QString& sInstrumentName,
+									   Filesystem::Lookup lookup )
+{
+	auto pRequest = std::make_unique<Request>();
+	pRequest->sDrumkitName = sDrumkitName;
+	pRequest->sInstrumentName = sInstrumentName;
+	pRequest->lookup = lookup;
+	pRequest->bPlay = true;
+	pRequest->nLength = MAX_NOTES;
+	schedule( std::move( pRequest ) );
+}
+
+void SamplePreview::stop()
+{
+	std::lock_guard<std::mutex> lock( m_mutex );
+	++m_nGeneration;
+	m_pPendingRequest = nullptr;
+	m_pSampler->queuePreviewInstrument( nullptr );
+}
+
+std::shared_ptr<Sample> SamplePreview::loadSample( const QString& sPath )
+{
+	std::unique_lock<std::mutex> lock( m_mutex );
+	auto pSample = lookup( sPath );
+	if ( pSample != nullptr ) {
+		return pSample;
+	}
+	lock.unlock();
+
+	auto pRequest = std::make_unique<Request>();
+	pRequest->sPath = sPath;
+	pRequest->bPlay = false;
+	pRequest->nLength = -1;
+	schedule( std::move( pRequest ) );
+
+	return nullptr;
+}
+
+std::shared_ptr<Sample> SamplePreview::getCachedSample( const QString& sPath )
+{
+	std::lock_guard<std::mutex> lock( m_mutex );
+	return lookup( sPath );
+}
+
+bool SamplePreview::isLoading( const QString& sPath ) const
+{
+	std::lock_guard<std::mutex> lock( m_mutex );
+	return m_sLoadingPath == sPath ||
+		( m_pPendingRequest != nullptr && m_pPendingRequest->sPath == sPath );
+}
+
+void SamplePreview::waitForFinished()
+{
+	std::unique_lock<std::mutex> lock( m_mutex );
+	m_finishedCondition.wait( lock, [&]{
+		return m_pPendingRequest == nullptr && ! m_bBusy; } );
+}
+
+size_t SamplePreview::getCacheSize() const
+{
+	std::lock_guard<std::mutex> lock( m_mutex );
+	return m_nCacheSize;
+}
+
+void SamplePreview::setCacheSize( size_t nBytes )
+{
+	std::lock_guard<std::mutex> lock( m_mutex );
+	m_nCacheSize = nBytes;
+	evict();
+}
+
+size_t SamplePreview::getCacheUsage() const
+{
+	std::lock_guard<std::mutex> lock( m_mutex );
+	return m_nCacheUsage;
+}
+
+void SamplePreview::clearCache()
+{
+	std::lock_guard<std::mutex> lock( m_mutex );
+	m_cache.clear();
+	m_cacheIndex.clear();
+	m_nCacheUsage = 0;
+}
+
+void SamplePreview::schedule( std::unique_ptr<Request> pRequest )
+{
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+		pRequest->nGeneration = ++m_nGeneration;
+		// A request not picked up by the worker yet is dropped.
+		m_pPendingRequest = std::move( pRequest );
+	}
+	m_condition.notify_all();
+}
+
+std::shared_ptr<Sample> SamplePreview::lookup( const QString& sPath )
+{
+	auto it = m_cacheIndex.find( sPath );
+	if ( it == m_cacheIndex.end() ) {
+		return nullptr;
+	}
+
+	auto entry = it->second;
+	if ( entry->lastModified != QFileInfo( sPath ).lastModified() ) {
+		// The file was changed on disk.
+		m_nCacheUsage -= entry->nBytes;
+		m_cache.erase( entry );
+		m_cacheIndex.erase( it );
+		return nullptr;
+	}
+
+	// Mark as most recently used.
+	m_cache.splice( m_cache.begin(), m_cache, entry );
+	return entry->pSample;
+}
+
+void SamplePreview::evict()
+{
+	// The most recently used sample is kept even if it exceeds the
+	// size of the cache on its own. Else, it could not be played.
+	while ( m_nCacheUsage > m_nCacheSize && m_cache.size() > 1 ) {
+		const auto& entry = m_cache.back();
+		m_nCacheUsage -= entry.nBytes;
+		m_cacheIndex.erase( entry.sPath );
+		m_cache.pop_back();
+	}
+}
+
+std::shared_ptr<Sample> SamplePreview::obtainSample( const QString& sPath )
+{
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+		auto pSample = lookup( sPath );
+		if ( pSample != nullptr ) {
+			return pSample;
+		}
+	}
+
+	const QDateTime lastModified = QFileInfo( sPath ).lastModified();
+	auto pSample = Sample::load( sPath );
+	if ( pSample == nullptr ) {
+		return nullptr;
+	}
+
+	std::lock_guard<std::mutex> lock( m_mutex );
+	if ( m_cacheIndex.find( sPath ) == m_cacheIndex.end() ) {
+		CacheEntry entry;
+		entry.sPath = sPath;
+		entry.lastModified = lastModified;
+		entry.pSample = pSample;
+		entry.nBytes = static_cast<size_t>( pSample->get_frames() ) * 2 * sizeof( float );
+		m_cache.push_front( entry );
+		m_cacheIndex[ sPath ] = m_cache.begin();
+		m_nCacheUsage += entry.nBytes;
+		evict();
+	}
+
+	return pSample;
+}
+
+std::shared_ptr<Instrument> SamplePreview::createInstrument( const Request& request )
+{
+	// The drumkit is loaded without samples. They are taken from the
+	// cache instead.
+	Drumkit* pDrumkit = Drumkit::load_by_name( request.sDrumkitName, false,
+											   request.lookup );
+	if ( pDrumkit == nullptr ) {
+		ERRORLOG( QString( "Unable to preview instrument [%1]: drumkit [%2] could not be loaded" )
+				  .arg( request.sInstrumentName ).arg( request.sDrumkitName ) );
+		return nullptr;
+	}
+
+	auto pSource = pDrumkit->get_instruments()->find( request.sInstrumentName );
+	if ( pSource == nullptr ) {
+		ERRORLOG( QString( "Unable to preview instrument: [%1] could not be found in drumkit [%2]" )
+				  .arg( request.sInstrumentName ).arg( request.sDrumkitName ) );
+		delete pDrumkit;
+		return nullptr;
+	}
+
+	auto pInstrument = std::make_shared<Instrument>( pSource );
+	for ( const auto& pComponent : *pInstrument->get_components() ) {
+		for ( int ii = 0; ii < InstrumentComponent::getMaxLayers(); ++ii ) {
+			auto pLayer = pComponent->get_layer( ii );
+			if ( pLayer == nullptr || pLayer->get_sample() == nullptr ) {
+				continue;
+			}
+
+			auto pSample = obtainSample( pDrumkit->get_path() + "/" +
+										 pLayer->get_sample()->get_filename() );
+			if ( pSample == nullptr ) {
+				pComponent->set_layer( nullptr, ii );
+			} else {
+				pLayer->set_sample( pSample );
+			}
+		}
+	}
+	pInstrument->set_muted( false );
+
+	delete pDrumkit;
+	return pInstrument;
+}
+
+void SamplePreview::queue( std::shared_ptr<Sample> pSample, int nLength )
+{
+	if ( nLength < 0 ) {
+		nLength = ( pSample->get_frames() /
+					std::max( pSample->get_sample_rate(), 1 ) + 1 ) * 100;
+	}
+	m_pSampler->queuePreviewSample( pSample, nLength );
+}
+
+void SamplePreview::run()
+{
+	EngineContext::Scope scope( m_pContext );
+
+	std::unique_lock<std::mutex> lock( m_mutex );
+	while ( true ) {
+		m_condition.wait( lock, [&]{
+			return m_pPendingRequest != nullptr || m_bShutdown; } );
+		if ( m_bShutdown ) {
+			break;
+		}
+
+		auto pRequest = std::move( m_pPendingRequest );
+		m_sLoadingPath = pRequest->sPath;
+		m_bBusy = true;
+		lock.unlock();
+
+		std::shared_ptr<Sample> pSample;
+		std::shared_ptr<Instrument> pInstrument;
+		if ( ! pRequest->sPath.isEmpty() ) {
+			pSample = obtainSample( pRequest->sPath );
+			if ( pSample == nullptr ) {
+				ERRORLOG( QString( "Unable to load sample [%1]" ).arg( pRequest->sPath ) );
+			}
+		} else {
+			pInstrument = createInstrument( *pRequest );
+		}
+
+		lock.lock();
+		m_sLoadingPath = "";
+		// The Sampler is only fed while holding the lock. This way
+		// a request superseded in the meantime can not overwrite the
+		// newer one.
+		if ( pRequest->bPlay && pRequest->nGeneration == m_nGeneration ) {
+			if ( pSample != nullptr ) {
+				queue( pSample, pRequest->nLength );
+			} else if ( pInstrument != nullptr ) {
+				m_pSampler->queuePreviewInstrument( pInstrument, pRequest->nLength );
+			}
+		}
+		lock.unlock();
+
+		if ( ! pRequest->sPath.isEmpty() ) {
+			EventQueue::get_instance()->push_event( EVENT_PREVIEW_LOADED,
+													pSample != nullptr ? 1 : 0 );
+		}
+		// Release the objects outside of the lock.
+		pSample = nullptr;
+		pInstrument = nullptr;
+
+		lock.lock();
+		m_bBusy = false;
+		m_finishedCondition.notify_all();
+	}
+	m_finishedCondition.notify_all();
+}
+
+};
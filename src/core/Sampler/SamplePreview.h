@@ -0,0 +1,175 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+#ifndef H2C_SAMPLE_PREVIEW_H
+#define H2C_SAMPLE_PREVIEW_H
+
+#include <core/Object.h>
+#include <core/Helpers/Filesystem.h>
+
+#include <condition_variable>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <QDateTime>
+#include <QString>
+
+namespace H2Core
+{
+
+class EngineContext;
+class Instrument;
+class Sample;
+class Sampler;
+
+/**
+ * Previews samples and instruments of the file browsers without
+ * blocking the calling thread.
+ *
+ * Audio files are decoded by a worker thread and kept in a cache of
+ * limited size. The least recently used samples are evicted first.
+ * Once a sample is ready, it is handed over to the Sampler using
+ * Sampler::queuePreviewSample(), which does not lock the
+ * AudioEngine. Previews of cached samples start right away.
+ *
+ * Requests supersede each other. In case the user scrolls through a
+ * folder, only the sample selected last is decoded and played.
+ *
+ * Each time the worker finished decoding a sample,
+ * #EVENT_PREVIEW_LOADED is pushed with a value of 1 on success and 0
+ * otherwise.
+ */
+/** \ingroup docCore docAudioEngine*/
+class SamplePreview : public H2Core::Object<SamplePreview>
+{
+	H2_OBJECT(SamplePreview)
+public:
+	static constexpr size_t nDefaultCacheSize = 64 * 1024 * 1024;
+
+	SamplePreview( Sampler* pSampler );
+	/** Discards all pending requests and stops the worker thread.*/
+	~SamplePreview();
+
+	/**
+	 * Plays the audio file @a sPath.
+	 *
+	 * \param sPath Absolute path of the audio file.
+	 * \param nLength Length of the preview note in ticks. If
+	 *   negative, it is derived from the length of the sample.
+	 */
+	void previewSample( const QString& sPath, int nLength = -1 );
+	/**
+	 * Loads and plays an instrument of an installed drumkit. Its
+	 * samples are taken from the cache as well.
+	 */
+	void previewInstrument( const QString& sDrumkitName,
+							const QString& sInstrumentName,
+							Filesystem::Lookup lookup = Filesystem::Lookup::stacked );
+	/** Stops the current preview and discards pending requests.*/
+	void stop();
+
+	/**
+	 * Retrieves the sample stored in @a sPath without playing it.
+	 *
+	 * \return The cached sample. If it was not cached yet, nullptr
+	 *   is returned and the sample is decoded in the background.
+	 */
+	std::shared_ptr<Sample> loadSample( const QString& sPath );
+	/** \return The cached sample or nullptr. Does never decode.*/
+	std::shared_ptr<Sample> getCachedSample( const QString& sPath );
+	/** \return Whether @a sPath is waiting to be or currently
+	 * decoded.*/
+	bool isLoading( const QString& sPath ) const;
+
+	/** Blocks until all pending requests are handled.*/
+	void waitForFinished();
+
+	size_t getCacheSize() const;
+	/** Evicts samples in case the cache is larger than @a nBytes.*/
+	void setCacheSize( size_t nBytes );
+	/** \return Number of bytes occupied by the cached samples.*/
+	size_t getCacheUsage() const;
+	void clearCache();
+
+private:
+	struct Request {
+		/** Audio file. Empty for instrument requests.*/
+		QString sPath;
+		QString sDrumkitName;
+		QString sInstrumentName;
+		Filesystem::Lookup lookup = Filesystem::Lookup::stacked;
+		bool bPlay = false;
+		int nLength = -1;
+		/** Requests are only played in case they were not
+		 * superseded in the meantime.*/
+		long nGeneration = 0;
+	};
+
+	struct CacheEntry {
+		QString sPath;
+		/** Modification time of the file when it was decoded.*/
+		QDateTime lastModified;
+		std::shared_ptr<Sample> pSample;
+		size_t nBytes;
+	};
+
+	void run();
+	void schedule( std::unique_ptr<Request> pRequest );
+	/** Decodes @a sPath unless it is cached already.*/
+	std::shared_ptr<Sample> obtainSample( const QString& sPath );
+	std::shared_ptr<Instrument> createInstrument( const Request& request );
+	/** Requires #m_mutex to be locked.*/
+	std::shared_ptr<Sample> lookup( const QString& sPath );
+	/** Requires #m_mutex to be locked.*/
+	void evict();
+	void queue( std::shared_ptr<Sample> pSample, int nLength );
+
+	Sampler* m_pSampler;
+	/** Context of the thread creating the object. It is made current
+	 * in the worker thread.*/
+	EngineContext* m_pContext;
+
+	std::thread m_thread;
+	mutable std::mutex m_mutex;
+	std::condition_variable m_condition;
+	std::condition_variable m_finishedCondition;
+	bool m_bShutdown;
+
+	std::unique_ptr<Request> m_pPendingRequest;
+	/** Path of the sample decoded by the worker right now.*/
+	QString m_sLoadingPath;
+	bool m_bBusy;
+	long m_nGeneration;
+
+	/** Most recently used sample first.*/
+	std::list<CacheEntry> m_cache;
+	std::map<QString, std::list<CacheEntry>::iterator> m_cacheIndex;
+	size_t m_nCacheSize;
+	size_t m_nCacheUsage;
+};
+
+};
+
+#endif
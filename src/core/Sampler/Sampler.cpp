@@ -69,7 +69,12 @@ static std::shared_ptr<Instrument> createInstrument(int id, const QString& filep
 Sampler::Sampler()
 		: m_pMainOut_L( nullptr )
 		, m_pMainOut_R( nullptr )
+		, m_bMainOutActive( true )
 		, m_pPreviewInstrument( nullptr )
+		, m_pPendingPreview( nullptr )
+		, m_pRetiredPreview( nullptr )
+		, m_pHandledPreview( nullptr )
+		, m_pTrackOutDriver( nullptr )
 		, m_interpolateMode( Interpolation::InterpolateMode::Linear )
 {
 	
@@ -98,6 +103,10 @@ Sampler::~Sampler()
 	delete[] m_pMainOut_L;
 	delete[] m_pMainOut_R;
 
+	delete m_pPendingPreview.exchange( nullptr );
+	delete m_pRetiredPreview.exchange( nullptr );
+	delete m_pHandledPreview;
+
 	m_pPreviewInstrument = nullptr;
 	m_pPlaybackTrackInstrument = nullptr;
 }
@@ -112,12 +121,19 @@ void Sampler::process( uint32_t nFrames, std::shared_ptr<Song> pSong )
 	AudioOutput* pAudioOutpout = Hydrogen::get_instance()->getAudioOutput();
 	assert( pAudioOutpout );
 
-	memset( m_pMainOut_L, 0, nFrames * sizeof( float ) );
-	memset( m_pMainOut_R, 0, nFrames * sizeof( float ) );
+	// Buffers nothing was written to in the last cycle are still
+	// silent.
+	if ( m_bMainOutActive ) {
+		memset( m_pMainOut_L, 0, nFrames * sizeof( float ) );
+		memset( m_pMainOut_R, 0, nFrames * sizeof( float ) );
+		m_bMainOutActive = false;
+	}
 
 	// Track output queues are zeroed by
 	// audioEngine_process_clearAudioBuffers()
 
+	processPreviewRequest();
+
 	// Max notes limit
 	int m_nMaxNotes = Preferences::get_instance()->m_nMaxNotes;
 	while ( ( int )m_playingNotesQueue.size() > m_nMaxNotes ) {
@@ -131,6 +147,19 @@ void Sampler::process( uint32_t nFrames, std::shared_ptr<Song> pSong )
 		pComponent->reset_outs(nFrames);
 	}
 
+#ifdef H2CORE_HAVE_JACK
+	// Resolve the driver only once per cycle instead of once per
+	// rendered note.
+	m_pTrackOutDriver = nullptr;
+	if ( Preferences::get_instance()->m_bJackTrackOuts ) {
+		m_pTrackOutDriver = dynamic_cast<JackAudioDriver*>( pAudioOutpout );
+	}
+#endif
+
+	if ( ! m_playingNotesQueue.empty() ) {
+		m_bMainOutActive = true;
+	}
+
 	// eseguo tutte le note nella lista di note in esecuzione
 	unsigned i = 0;
 	Note* pNote;
@@ -535,6 +564,14 @@ bool Sampler::renderNote( Note* pNote, unsigned nBufferSize, std::shared_ptr<Son
 	int nReturnValueIndex = 0;
 	int nAlreadySelectedLayer = -1;
 
+	// Looked up once per note instead of once per component and
+	// channel. Both are resolved through the EngineContext of the
+	// rendering thread.
+	const auto jackTrackOutputMode = Preferences::get_instance()->m_JackTrackOutputMode;
+	MidiOutput* pMidiOutput = pHydrogen->getMidiOutput();
+	const bool bIsExportSessionActive = pHydrogen->getIsExportSessionActive();
+	const bool bIsAnyInstrumentSoloed = isAnyInstrumentSoloed();
+
 	for ( const auto& pCompo : *components ) {
 		nReturnValues[nReturnValueIndex] = false;
 		DrumkitComponent* pMainCompo = nullptr;
@@ -599,8 +636,8 @@ bool Sampler::renderNote( Note* pNote, unsigned nBufferSize, std::shared_ptr<Son
 		float cost_track_L = 1.0f;
 		float cost_track_R = 1.0f;
 		
-		bool isMutedForExport = (pHydrogen->getIsExportSessionActive() && !pInstr->is_currently_exported());
-		bool isMutedBecauseOfSolo = (isAnyInstrumentSoloed() && !pInstr->is_soloed());
+		bool isMutedForExport = (bIsExportSessionActive && !pInstr->is_currently_exported());
+		bool isMutedBecauseOfSolo = (bIsAnyInstrumentSoloed && !pInstr->is_soloed());
 		
 		/*
 		 *  Is instrument muted?
@@ -614,7 +651,7 @@ bool Sampler::renderNote( Note* pNote, unsigned nBufferSize, std::shared_ptr<Son
 		if ( isMutedForExport || pInstr->is_muted() || pSong->getIsMuted() || pMainCompo->is_muted() || isMutedBecauseOfSolo) {	
 			cost_L = 0.0;
 			cost_R = 0.0;
-			if ( Preferences::get_instance()->m_JackTrackOutputMode == Preferences::JackTrackOutputMode::postFader ) {
+			if ( jackTrackOutputMode == Preferences::JackTrackOutputMode::postFader ) {
 				cost_track_L = 0.0;
 				cost_track_R = 0.0;
 			}
@@ -634,7 +671,7 @@ bool Sampler::renderNote( Note* pNote, unsigned nBufferSize, std::shared_ptr<Son
 			cost_L = cost_L * pMainCompo->get_volume(); // Component volument
 
 			cost_L = cost_L * pInstr->get_volume();		// instrument volume
-			if ( Preferences::get_instance()->m_JackTrackOutputMode == Preferences::JackTrackOutputMode::postFader ) {
+			if ( jackTrackOutputMode == Preferences::JackTrackOutputMode::postFader ) {
 				cost_track_L = cost_L * 2;
 			}
 			cost_L = cost_L * pSong->getVolume();	// song volume
@@ -647,14 +684,14 @@ bool Sampler::renderNote( Note* pNote, unsigned nBufferSize, std::shared_ptr<Son
 			cost_R = cost_R * pMainCompo->get_volume(); // Component volument
 
 			cost_R = cost_R * pInstr->get_volume();		// instrument volume
-			if ( Preferences::get_instance()->m_JackTrackOutputMode == Preferences::JackTrackOutputMode::postFader ) {
+			if ( jackTrackOutputMode == Preferences::JackTrackOutputMode::postFader ) {
 				cost_track_R = cost_R * 2;
 			}
 			cost_R = cost_R * pSong->getVolume();	// song pan
 		}
 
 		// direct track outputs only use velocity
-		if ( Preferences::get_instance()->m_JackTrackOutputMode == Preferences::JackTrackOutputMode::preFader ) {
+		if ( jackTrackOutputMode == Preferences::JackTrackOutputMode::preFader ) {
 			cost_track_L = cost_track_L * pNote->get_velocity();
 			cost_track_L = cost_track_L * fLayerGain;
 			cost_track_R = cost_track_L;
@@ -669,8 +706,8 @@ bool Sampler::renderNote( Note* pNote, unsigned nBufferSize, std::shared_ptr<Son
 
 		//_INFOLOG( "total pitch: " + to_string( fTotalPitch ) );
 		if ( (int) pSelectedLayer->SamplePosition == 0  && !pInstr->is_muted() ) {
-			if ( Hydrogen::get_instance()->getMidiOutput() != nullptr ){
-				Hydrogen::get_instance()->getMidiOutput()->handleQueueNote( pNote );
+			if ( pMidiOutput != nullptr ){
+				pMidiOutput->handleQueueNote( pNote );
 			}
 		}
 
@@ -723,14 +760,15 @@ bool Sampler::processPlaybackTrack(int nBufferSize)
 		return true;
 	}
 
+	m_bMainOutActive = true;
+
 	float fVal_L;
 	float fVal_R;
 
 	auto pSample_data_L = pSample->get_data_l();
 	auto pSample_data_R = pSample->get_data_r();
 	
-	float fInstrPeak_L = m_pPlaybackTrackInstrument->get_peak_l(); // this value will be reset to 0 by the mixer..
-	float fInstrPeak_R = m_pPlaybackTrackInstrument->get_peak_r(); // this value will be reset to 0 by the mixer..
+	Meter::Accumulator meter;
 
 	int nAvail_bytes = 0;
 	int	nInitialBufferPos = 0;
@@ -765,14 +803,9 @@ bool Sampler::processPlaybackTrack(int nBufferSize)
 	
 			//pDrumCompo->set_outs( nBufferPos, fVal_L, fVal_R );
 	
+			meter.process( fVal_L, fVal_R );
+
 			// to main mix
-			if ( fVal_L > fInstrPeak_L ) {
-				fInstrPeak_L = fVal_L;
-			}
-			if ( fVal_R > fInstrPeak_R ) {
-				fInstrPeak_R = fVal_R;
-			}
-			
 			m_pMainOut_L[nBufferPos] += fVal_L;
 			m_pMainOut_R[nBufferPos] += fVal_R;
 			
@@ -846,12 +879,7 @@ bool Sampler::processPlaybackTrack(int nBufferSize)
 					}
 			}
 			
-			if ( fVal_L > fInstrPeak_L ) {
-				fInstrPeak_L = fVal_L;
-			}
-			if ( fVal_R > fInstrPeak_R ) {
-				fInstrPeak_R = fVal_R;
-			}
+			meter.process( fVal_L, fVal_R );
 
 			m_pMainOut_L[nBufferPos] += fVal_L;
 			m_pMainOut_R[nBufferPos] += fVal_R;
@@ -861,12 +889,43 @@ bool Sampler::processPlaybackTrack(int nBufferSize)
 		} //for
 	}
 	
-	m_pPlaybackTrackInstrument->set_peak_l( fInstrPeak_L );
-	m_pPlaybackTrackInstrument->set_peak_r( fInstrPeak_R );
+	m_pPlaybackTrackInstrument->get_meter().add( meter );
 
 	return true;
 }
 
+int Sampler::prepareFXSends( std::shared_ptr<Instrument> pInstrument,
+							 std::shared_ptr<Song> pSong,
+							 FXSend* sends ) const
+{
+	int nSends = 0;
+#ifdef H2CORE_HAVE_LADSPA
+	if ( pInstrument->is_muted() || pSong->getIsMuted() ) {
+		return 0;
+	}
+
+	float fMasterVol = pSong->getVolume();
+	Effects* pEffects = Effects::get_instance();
+	for ( int nFX = 0; nFX < MAX_FX; ++nFX ) {
+		float fLevel = pInstrument->get_fx_level( nFX );
+		if ( fLevel == 0.0 ) {
+			continue;
+		}
+		LadspaFX *pFX = pEffects->getLadspaFX( nFX );
+		if ( pFX == nullptr ) {
+			continue;
+		}
+
+		pFX->markInputActive();
+		sends[ nSends ].pBuffer_L = pFX->m_pBuffer_L;
+		sends[ nSends ].pBuffer_R = pFX->m_pBuffer_R;
+		sends[ nSends ].fGain = fLevel * pFX->getVolume() * fMasterVol;
+		++nSends;
+	}
+#endif
+	return nSends;
+}
+
 bool Sampler::renderNoteNoResample(
 	std::shared_ptr<Sample> pSample,
 	Note *pNote,
@@ -922,24 +981,28 @@ bool Sampler::renderNoteNoResample(
 	auto pSample_data_L = pSample->get_data_l();
 	auto pSample_data_R = pSample->get_data_r();
 
-	float fInstrPeak_L = pInstrument->get_peak_l(); // this value will be reset to 0 by the mixer..
-	float fInstrPeak_R = pInstrument->get_peak_r(); // this value will be reset to 0 by the mixer..
+	// Instrument and component meters are fed by the same voice.
+	Meter::Accumulator meter;
 
 	auto pADSR = pNote->get_adsr();
 	float fADSRValue;
 	float fVal_L;
 	float fVal_R;
 
+	// Effect sends are fed by the same loop as the main outputs.
+	FXSend sends[ MAX_FX ];
+	const int nSends = prepareFXSends( pInstrument, pSong, sends );
+
 #ifdef H2CORE_HAVE_JACK
 	float *		pTrackOutL = nullptr;
 	float *		pTrackOutR = nullptr;
 
-	if ( Preferences::get_instance()->m_bJackTrackOuts ) {
-		auto pJackAudioDriver = dynamic_cast<JackAudioDriver*>( pAudioDriver );
-		if( pJackAudioDriver ) {
-			pTrackOutL = pJackAudioDriver->getTrackOut_L( pInstrument, pCompo );
-			pTrackOutR = pJackAudioDriver->getTrackOut_R( pInstrument, pCompo );
-		}
+	// The port buffers were already resolved at the beginning of the
+	// cycle. Tracks the note would not contribute to are not touched.
+	if ( m_pTrackOutDriver != nullptr &&
+		 ( cost_track_L != 0 || cost_track_R != 0 ) ) {
+		pTrackOutL = m_pTrackOutDriver->getTrackOut_L( pInstrument, pCompo );
+		pTrackOutR = m_pTrackOutDriver->getTrackOut_R( pInstrument, pCompo );
 	}
 #endif
 
@@ -1000,16 +1063,16 @@ bool Sampler::renderNoteNoResample(
 		}
 #endif
 
+		// Sends are taken after ADSR and filter but ahead of gain and pan.
+		for ( int nSend = 0; nSend < nSends; ++nSend ) {
+			sends[ nSend ].pBuffer_L[ nBufferPos ] += fVal_L * sends[ nSend ].fGain;
+			sends[ nSend ].pBuffer_R[ nBufferPos ] += fVal_R * sends[ nSend ].fGain;
+		}
+
 		fVal_L = fVal_L * cost_L;
 		fVal_R = fVal_R * cost_R;
 
-		// update instr peak
-		if ( fVal_L > fInstrPeak_L ) {
-			fInstrPeak_L = fVal_L;
-		}
-		if ( fVal_R > fInstrPeak_R ) {
-			fInstrPeak_R = fVal_R;
-		}
+		meter.process( fVal_L, fVal_R );
 
 		pDrumCompo->set_outs( nBufferPos, fVal_L, fVal_R );
 
@@ -1018,46 +1081,16 @@ bool Sampler::renderNoteNoResample(
 		m_pMainOut_R[nBufferPos] += fVal_R;
 
 	}
+	pDrumCompo->mark_outs( nTimes );
 	if ( pInstrument->is_filter_active() && pNote->filter_sustain() ) {
 		// Note is still ringing, do not end.
 		retValue = false;
 	}
 
 	pSelectedLayerInfo->SamplePosition += nAvail_bytes;
-	pInstrument->set_peak_l( fInstrPeak_L );
-	pInstrument->set_peak_r( fInstrPeak_R );
-
-
-#ifdef H2CORE_HAVE_LADSPA
-	// LADSPA
-	// change the below return logic if you add code after that ifdef
-	if (pInstrument->is_muted() || pSong->getIsMuted() ) return retValue;
-	float masterVol =  pSong->getVolume();
-	for ( unsigned nFX = 0; nFX < MAX_FX; ++nFX ) {
-		LadspaFX *pFX = Effects::get_instance()->getLadspaFX( nFX );
+	pInstrument->get_meter().add( meter );
+	pDrumCompo->get_meter().add( meter );
 
-		float fLevel = pInstrument->get_fx_level( nFX );
-
-		if ( ( pFX ) && ( fLevel != 0.0 ) ) {
-			fLevel = fLevel * pFX->getVolume();
-			float *pBuf_L = pFX->m_pBuffer_L;
-			float *pBuf_R = pFX->m_pBuffer_R;
-
-			float fFXCost_L = fLevel * masterVol;
-			float fFXCost_R = fLevel * masterVol;
-
-			int nBufferPos = nInitialBufferPos;
-			int nSamplePos = nInitialSamplePos;
-			for ( int i = 0; i < nAvail_bytes; ++i ) {
-				pBuf_L[ nBufferPos ] += pSample_data_L[ nSamplePos ] * fFXCost_L;
-				pBuf_R[ nBufferPos ] += pSample_data_R[ nSamplePos ] * fFXCost_R;
-				++nSamplePos;
-				++nBufferPos;
-			}
-		}
-	}
-	// ~LADSPA
-#endif
 
 	return retValue;
 }
@@ -1132,8 +1165,8 @@ bool Sampler::renderNoteResample(
 	auto pSample_data_L = pSample->get_data_l();
 	auto pSample_data_R = pSample->get_data_r();
 
-	float fInstrPeak_L = pInstrument->get_peak_l(); // this value will be reset to 0 by the mixer..
-	float fInstrPeak_R = pInstrument->get_peak_r(); // this value will be reset to 0 by the mixer..
+	// Instrument and component meters are fed by the same voice.
+	Meter::Accumulator meter;
 
 	auto pADSR = pNote->get_adsr();
 	float fADSRValue = 1.0;
@@ -1149,16 +1182,20 @@ bool Sampler::renderNoteResample(
 	}
 
 
+	// Effect sends are fed by the same loop as the main outputs.
+	FXSend sends[ MAX_FX ];
+	const int nSends = prepareFXSends( pInstrument, pSong, sends );
+
 #ifdef H2CORE_HAVE_JACK
 	float *		pTrackOutL = nullptr;
 	float *		pTrackOutR = nullptr;
 
-	if ( Preferences::get_instance()->m_bJackTrackOuts ) {
-		auto pJackAudioDriver = dynamic_cast<JackAudioDriver*>( pAudioDriver );
-		if( pJackAudioDriver ) {
-			pTrackOutL = pJackAudioDriver->getTrackOut_L( pInstrument, pCompo );
-			pTrackOutR = pJackAudioDriver->getTrackOut_R( pInstrument, pCompo );
-		}
+	// The port buffers were already resolved at the beginning of the
+	// cycle. Tracks the note would not contribute to are not touched.
+	if ( m_pTrackOutDriver != nullptr &&
+		 ( cost_track_L != 0 || cost_track_R != 0 ) ) {
+		pTrackOutL = m_pTrackOutDriver->getTrackOut_L( pInstrument, pCompo );
+		pTrackOutR = m_pTrackOutDriver->getTrackOut_R( pInstrument, pCompo );
 	}
 #endif
 
@@ -1271,16 +1308,16 @@ bool Sampler::renderNoteResample(
 		}
 #endif
 
+		// Sends are taken after ADSR and filter but ahead of gain and pan.
+		for ( int nSend = 0; nSend < nSends; ++nSend ) {
+			sends[ nSend ].pBuffer_L[ nBufferPos ] += fVal_L * sends[ nSend ].fGain;
+			sends[ nSend ].pBuffer_R[ nBufferPos ] += fVal_R * sends[ nSend ].fGain;
+		}
+
 		fVal_L = fVal_L * cost_L;
 		fVal_R = fVal_R * cost_R;
 
-		// update instr peak
-		if ( fVal_L > fInstrPeak_L ) {
-			fInstrPeak_L = fVal_L;
-		}
-		if ( fVal_R > fInstrPeak_R ) {
-			fInstrPeak_R = fVal_R;
-		}
+		meter.process( fVal_L, fVal_R );
 
 		pDrumCompo->set_outs( nBufferPos, fVal_L, fVal_R );
 
@@ -1289,6 +1326,7 @@ bool Sampler::renderNoteResample(
 		m_pMainOut_R[nBufferPos] += fVal_R;
 
 	}
+	pDrumCompo->mark_outs( nTimes );
 
 	if ( pInstrument->is_filter_active() && pNote->filter_sustain() ) {
 		// Note is still ringing, do not end.
@@ -1296,42 +1334,10 @@ bool Sampler::renderNoteResample(
 	}
 	
 	pSelectedLayerInfo->SamplePosition += nAvail_bytes * fStep;
-	pInstrument->set_peak_l( fInstrPeak_L );
-	pInstrument->set_peak_r( fInstrPeak_R );
-
-
-#ifdef H2CORE_HAVE_LADSPA
-	// LADSPA
-	// change the below return logic if you add code after that ifdef
-	if ( pInstrument->is_muted() || pSong->getIsMuted() ) {
-		return retValue;
-	}
-	float masterVol = pSong->getVolume();
-	for ( unsigned nFX = 0; nFX < MAX_FX; ++nFX ) {
-		LadspaFX *pFX = Effects::get_instance()->getLadspaFX( nFX );
-		float fLevel = pInstrument->get_fx_level( nFX );
-		if ( ( pFX ) && ( fLevel != 0.0 ) ) {
-			fLevel = fLevel * pFX->getVolume();
-
-			float *pBuf_L = pFX->m_pBuffer_L;
-			float *pBuf_R = pFX->m_pBuffer_R;
-
-			float fFXCost_L = fLevel * masterVol;
-			float fFXCost_R = fLevel * masterVol;
+	pInstrument->get_meter().add( meter );
+	pDrumCompo->get_meter().add( meter );
 
-			int nBufferPos = nInitialBufferPos;
-			for ( int i = 0; i < nAvail_bytes; ++i ) {
 
-				fVal_L = buffer_L[ nBufferPos ];
-				fVal_R = buffer_R[ nBufferPos ];
-
-				pBuf_L[ nBufferPos ] += fVal_L * fFXCost_L;
-				pBuf_R[ nBufferPos ] += fVal_R * fFXCost_R;
-				++nBufferPos;
-			}
-		}
-	}
-#endif
 	return retValue;
 }
 
@@ -1401,6 +1407,72 @@ void Sampler::preview_instrument( std::shared_ptr<Instrument> pInstr )
 	Hydrogen::get_instance()->getAudioEngine()->unlock();
 }
 
+Sampler::PreviewRequest::~PreviewRequest()
+{
+	delete pNote;
+}
+
+void Sampler::queuePreviewInstrument( std::shared_ptr<Instrument> pInstr, int nLength )
+{
+	// Release the request handled last (and the instrument it
+	// replaced) outside of the audio thread.
+	delete m_pRetiredPreview.exchange( nullptr );
+
+	auto pRequest = new PreviewRequest;
+	pRequest->pInstrument = pInstr;
+	pRequest->pNote = nullptr;
+	if ( pInstr != nullptr ) {
+		pInstr->set_is_preview_instrument( true );
+		pRequest->pNote = new Note( pInstr, 0, 1.0, 0.f, nLength, 0 );
+	}
+
+	// A request not picked up yet is superseded.
+	delete m_pPendingPreview.exchange( pRequest );
+}
+
+void Sampler::queuePreviewSample( std::shared_ptr<Sample> pSample, int nLength )
+{
+	auto pInstrument = std::make_shared<Instrument>( EMPTY_INSTR_ID, "preview" );
+	pInstrument->set_volume( 0.8 );
+	auto pComponent = std::make_shared<InstrumentComponent>( 0 );
+	pComponent->set_layer( std::make_shared<InstrumentLayer>( pSample ), 0 );
+	pInstrument->get_components()->push_back( pComponent );
+
+	queuePreviewInstrument( pInstrument, nLength );
+}
+
+void Sampler::processPreviewRequest()
+{
+	// A handled request is only retired once the previous one was
+	// released. Until then no new request is picked up.
+	if ( m_pHandledPreview != nullptr ) {
+		PreviewRequest* pEmpty = nullptr;
+		if ( ! m_pRetiredPreview.compare_exchange_strong( pEmpty, m_pHandledPreview ) ) {
+			return;
+		}
+		m_pHandledPreview = nullptr;
+	}
+
+	PreviewRequest* pRequest = m_pPendingPreview.exchange( nullptr );
+	if ( pRequest == nullptr ) {
+		return;
+	}
+
+	stopPlayingNotes( m_pPreviewInstrument );
+	if ( pRequest->pInstrument != nullptr ) {
+		// The former preview instrument is handed back along with
+		// the request.
+		std::swap( m_pPreviewInstrument, pRequest->pInstrument );
+		noteOn( pRequest->pNote );
+		pRequest->pNote = nullptr;
+	}
+
+	PreviewRequest* pEmpty = nullptr;
+	if ( ! m_pRetiredPreview.compare_exchange_strong( pEmpty, pRequest ) ) {
+		m_pHandledPreview = pRequest;
+	}
+}
+
 bool Sampler::isAnyInstrumentSoloed() const
 {
 	Hydrogen*		pHydrogen = Hydrogen::get_instance();
@@ -28,6 +28,7 @@
 #include <core/Globals.h>
 #include <core/Sampler/Interpolation.h>
 
+#include <atomic>
 #include <inttypes.h>
 #include <vector>
 #include <memory>
@@ -43,6 +44,7 @@ class Instrument;
 struct SelectedLayerInfo;
 class InstrumentComponent;
 class AudioOutput;
+class JackAudioDriver;
 
 ///
 /// Waveform based sampler.
@@ -179,6 +181,12 @@ public:
 	 * @return True, if the #Sampler is still processing notes.
 	 */
 	bool isRenderingNotes() const;
+	/** Whether #m_pMainOut_L and #m_pMainOut_R were written to in
+	 * the last call to process(). If not, they contain silence only
+	 * and do not have to be mixed.*/
+	bool isMainOutActive() const {
+		return m_bMainOutActive;
+	}
 	
 	/// Start playing a note
 	void noteOn( Note * pNote );
@@ -196,6 +204,30 @@ public:
 	void preview_sample( std::shared_ptr<Sample> pSample, int length );
 	void preview_instrument( std::shared_ptr<Instrument> pInstr );
 
+	/**
+	 * Lock-free counterpart of preview_instrument().
+	 *
+	 * @a pInstr replaces the preview instrument at the beginning of
+	 * the next process() cycle without locking the AudioEngine. Only
+	 * the most recent request is kept. A request not picked up by
+	 * the audio thread yet is dropped.
+	 *
+	 * Requests handled by the audio thread, including the
+	 * instrument they replaced, are released by the next call to
+	 * this function. This way no memory is freed within the audio
+	 * thread.
+	 *
+	 * \param pInstr Instrument to play. It must not be accessed by
+	 *   anyone else afterwards. If nullptr, the current preview is
+	 *   stopped.
+	 * \param nLength Length of the preview note in ticks.
+	 */
+	void queuePreviewInstrument( std::shared_ptr<Instrument> pInstr,
+								 int nLength = MAX_NOTES );
+	/** Wraps @a pSample in a new preview instrument and passes it
+	 * to queuePreviewInstrument().*/
+	void queuePreviewSample( std::shared_ptr<Sample> pSample, int nLength );
+
 	bool isInstrumentPlaying( std::shared_ptr<Instrument> pInstr );
 
 	void setInterpolateMode( Interpolation::InterpolateMode mode ){
@@ -241,12 +273,43 @@ private:
 	std::vector<Note*> m_playingNotesQueue;
 	std::vector<Note*> m_queuedNoteOffs;
 	
+	/** Whether the main outputs were written to since the last
+	 * time they were cleared.*/
+	bool m_bMainOutActive;
+
 	/// Instrument used for the playback track feature.
 	std::shared_ptr<Instrument> m_pPlaybackTrackInstrument;
 
 	/// Instrument used for the preview feature.
 	std::shared_ptr<Instrument> m_pPreviewInstrument;
 
+	/** Preview passed to the audio thread by
+	 * queuePreviewInstrument().*/
+	struct PreviewRequest {
+		std::shared_ptr<Instrument> pInstrument;
+		/** Note created by the calling thread. Ownership is passed
+		 * to the Sampler once it is played.*/
+		Note* pNote;
+		~PreviewRequest();
+	};
+	/** Picks up the pending preview request. Called at the
+	 * beginning of each process() cycle.*/
+	void processPreviewRequest();
+	/** Request not handled by the audio thread yet.*/
+	std::atomic<PreviewRequest*> m_pPendingPreview;
+	/** Request handled by the audio thread and waiting to be
+	 * released by queuePreviewInstrument().*/
+	std::atomic<PreviewRequest*> m_pRetiredPreview;
+	/** Handled request which could not be retired yet because
+	 * #m_pRetiredPreview was still occupied. Only accessed by the
+	 * audio thread.*/
+	PreviewRequest* m_pHandledPreview;
+
+	/** JACK driver providing the per track outputs. Resolved once
+	 * per cycle in process() and nullptr in case they are not
+	 * used.*/
+	JackAudioDriver* m_pTrackOutDriver;
+
 	/** Maximum number of layers to be used in the Instrument
 	    editor. It will be inferred from
 	    InstrumentComponent::m_nMaxLayers, which itself is
@@ -300,6 +363,26 @@ private:
 		float fLayerPitch,
 		std::shared_ptr<Song> pSong
 	);
+
+	/** Input buffers of a LADSPA effect a voice is sent to along with
+	 * the resulting gain.*/
+	struct FXSend {
+		float* pBuffer_L;
+		float* pBuffer_R;
+		float fGain;
+	};
+
+	/** Resolves all effects @a pInstrument is sending to once per
+	 * voice so the send buffers can be filled within the same loop
+	 * writing the main and track outputs.
+	 *
+	 * \param sends Array of at least #MAX_FX elements.
+	 * \return Number of valid entries in @a sends. 0 in case the
+	 *   instrument or the song is muted or Hydrogen was built without
+	 *   LADSPA support.*/
+	int prepareFXSends( std::shared_ptr<Instrument> pInstrument,
+						std::shared_ptr<Song> pSong,
+						FXSend* sends ) const;
 };
 
 inline const std::vector<Note*> Sampler::getPlayingNotesQueue() const {
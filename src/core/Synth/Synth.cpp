@@ -24,9 +24,11 @@
 #include <core/Synth/Synth.h>
 #include <core/Basics/Note.h>
 #include <core/Globals.h>
+#include <core/IO/AudioOutput.h>
 
 #include <cassert>
 #include <cmath>
+#include <cstring>
 
 namespace H2Core
 {
@@ -38,8 +40,20 @@ Synth::Synth()
 
 	m_pOut_L = new float[ MAX_BUFFER_SIZE ];
 	m_pOut_R = new float[ MAX_BUFFER_SIZE ];
+	m_pVoice_L = new float[ MAX_BUFFER_SIZE ];
+	m_pVoice_R = new float[ MAX_BUFFER_SIZE ];
 
-	m_fTheta = 0.0;
+	m_pVoices = new Voice[ nMaxVoices ];
+	m_nActiveVoices = 0;
+	m_nVoiceCounter = 0;
+
+	// Create the wavetables up front instead of in the audio thread.
+	Wavetable::get( Wavetable::Shape::Sine );
+	Wavetable::get( Wavetable::Shape::Saw );
+	Wavetable::get( Wavetable::Shape::Square );
+
+	// Ensures the uninitialized buffers are cleared once.
+	m_bActive = true;
 
 	m_pAudioOutput = nullptr;
 }
@@ -49,19 +63,64 @@ Synth::Synth()
 Synth::~Synth()
 {
 	INFOLOG( "DESTROY" );
+	for ( int ii = 0; ii < nMaxVoices; ++ii ) {
+		if ( m_pVoices[ ii ].pNote != nullptr ) {
+			freeVoice( &m_pVoices[ ii ] );
+		}
+	}
+	delete[] m_pVoices;
 	delete[] m_pOut_L;
 	delete[] m_pOut_R;
+	delete[] m_pVoice_L;
+	delete[] m_pVoice_R;
 }
 
 
 
 
-void Synth::noteOn( Note* pNote )
+void Synth::noteOn( Note* pNote, Wavetable::Shape shape )
 {
 	INFOLOG( "NOTE ON" );
 	assert( pNote );
 
-	m_playingNotesQueue.push_back( pNote );
+	// Use a free voice or take over the oldest one.
+	Voice* pVoice = nullptr;
+	for ( int ii = 0; ii < nMaxVoices; ++ii ) {
+		Voice* pCandidate = &m_pVoices[ ii ];
+		if ( pCandidate->pNote == nullptr ) {
+			pVoice = pCandidate;
+			break;
+		}
+		if ( pVoice == nullptr || pCandidate->nStarted < pVoice->nStarted ) {
+			pVoice = pCandidate;
+		}
+	}
+	if ( pVoice->pNote != nullptr ) {
+		freeVoice( pVoice );
+	}
+
+	auto pADSR = pNote->get_adsr();
+	if ( pADSR != nullptr ) {
+		pVoice->adsr.set_attack( pADSR->get_attack() );
+		pVoice->adsr.set_decay( pADSR->get_decay() );
+		pVoice->adsr.set_sustain( pADSR->get_sustain() );
+		pVoice->adsr.set_release( pADSR->get_release() );
+	} else {
+		pVoice->adsr.set_attack( 0 );
+		pVoice->adsr.set_decay( 0 );
+		pVoice->adsr.set_sustain( 1.0 );
+		pVoice->adsr.set_release( 1000 );
+	}
+	pVoice->adsr.attack();
+
+	pVoice->pNote = pNote;
+	pVoice->pWavetable = Wavetable::get( shape );
+	pVoice->fFrequency = 220.0 * std::pow( 2.0, pNote->get_total_pitch() / 12.0 );
+	pVoice->fAmplitude = pNote->get_velocity();
+	pVoice->fPhase = 0;
+	pVoice->bReleased = false;
+	pVoice->nStarted = ++m_nVoiceCounter;
+	++m_nActiveVoices;
 }
 
 
@@ -69,49 +128,89 @@ void Synth::noteOn( Note* pNote )
 
 void Synth::noteOff( Note* pNote )
 {
-	INFOLOG( "NOTE OFF - not implemented yet" );
+	INFOLOG( "NOTE OFF" );
 	assert( pNote );
 
-	// delete the older note...
-	for ( uint i = 0; i < m_playingNotesQueue.size(); ++i ) {
-		Note *pPlayingNote = m_playingNotesQueue[ i ];
-		if ( pPlayingNote->get_instrument() == pNote->get_instrument() ) {
-			m_playingNotesQueue.erase( m_playingNotesQueue.begin() + i );
-			delete pPlayingNote;
-
-			delete pNote;
-			pNote = nullptr;
-			break;
+	// release the oldest note still held...
+	Voice* pVoice = nullptr;
+	for ( int ii = 0; ii < nMaxVoices; ++ii ) {
+		Voice* pCandidate = &m_pVoices[ ii ];
+		if ( pCandidate->pNote != nullptr && ! pCandidate->bReleased &&
+			 pCandidate->pNote->get_instrument() == pNote->get_instrument() &&
+			 ( pVoice == nullptr || pCandidate->nStarted < pVoice->nStarted ) ) {
+			pVoice = pCandidate;
 		}
 	}
 
-	ERRORLOG( "note not found" );
+	if ( pVoice != nullptr ) {
+		pVoice->adsr.release();
+		pVoice->bReleased = true;
+	} else {
+		ERRORLOG( "note not found" );
+	}
+
+	delete pNote;
+}
+
+
+
+void Synth::freeVoice( Voice* pVoice )
+{
+	delete pVoice->pNote;
+	pVoice->pNote = nullptr;
+	--m_nActiveVoices;
 }
 
 
 
-// perche' viene passata anche la canzone? E' davvero necessaria?
 void Synth::process( uint32_t nFrames )
 {
 	//INFOLOG( "process" );
 
-	// cleanup of the output buffers
-	memset( m_pOut_L, 0, nFrames * sizeof( float ) );
-	memset( m_pOut_R, 0, nFrames * sizeof( float ) );
+	// cleanup of the output buffers. In case nothing was written
+	// to them in the previous cycle they are still silent.
+	if ( m_bActive ) {
+		memset( m_pOut_L, 0, nFrames * sizeof( float ) );
+		memset( m_pOut_R, 0, nFrames * sizeof( float ) );
+	}
+	m_bActive = m_nActiveVoices > 0;
+	if ( ! m_bActive ) {
+		return;
+	}
+
+	float fSampleRate = 44100.0;
+	if ( m_pAudioOutput != nullptr && m_pAudioOutput->getSampleRate() > 0 ) {
+		fSampleRate = m_pAudioOutput->getSampleRate();
+	}
 
+	float* __restrict__ pOut_L = m_pOut_L;
+	float* __restrict__ pOut_R = m_pOut_R;
+	const float* __restrict__ pVoice_L = m_pVoice_L;
+	const float* __restrict__ pVoice_R = m_pVoice_R;
 
-	for ( const auto& pPlayingNote :  m_playingNotesQueue ) {
-		//pPlayingNote->dumpInfo();
+	for ( int ii = 0; ii < nMaxVoices; ++ii ) {
+		Voice* pVoice = &m_pVoices[ ii ];
+		if ( pVoice->pNote == nullptr ) {
+			continue;
+		}
+
+		pVoice->pWavetable->render( m_pVoice_L, nFrames, &pVoice->fPhase,
+									pVoice->fFrequency / fSampleRate );
+		memcpy( m_pVoice_R, m_pVoice_L, nFrames * sizeof( float ) );
 
-		float fAmplitude = pPlayingNote->get_velocity();
-		float fFrequency = TWOPI * 220.0 / 44100.0;
+		// Notes not released yet are sustained beyond this cycle.
+		const bool bFinished =
+			pVoice->adsr.applyADSR( m_pVoice_L, m_pVoice_R, nFrames,
+									pVoice->bReleased ? 0 : nFrames + 1, 1 );
 
-		for ( uint i = 0; i < nFrames; ++i ) {
-			float fVal = sin( m_fTheta ) * fAmplitude;
-			m_pOut_L[ i ] += fVal;
-			m_pOut_R[ i ] += fVal;
+		const float fAmplitude = pVoice->fAmplitude;
+		for ( uint32_t i = 0; i < nFrames; ++i ) {
+			pOut_L[ i ] += pVoice_L[ i ] * fAmplitude;
+			pOut_R[ i ] += pVoice_R[ i ] * fAmplitude;
+		}
 
-			m_fTheta += fFrequency;
+		if ( bFinished ) {
+			freeVoice( pVoice );
 		}
 	}
 }
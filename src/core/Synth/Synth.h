@@ -25,9 +25,10 @@
 #define SYNTH_H
 
 #include <cstdint>
-#include <vector>
 
 #include <core/Object.h>
+#include <core/Basics/Adsr.h>
+#include <core/Synth/Wavetable.h>
 
 
 namespace H2Core
@@ -38,6 +39,11 @@ class AudioOutput;
 ///
 /// A simple synthetizer...
 ///
+/// Notes are played by a fixed pool of #nMaxVoices voices, each
+/// consisting of a band-limited Wavetable oscillator and an ADSR
+/// envelope. All memory is allocated in the constructor. In case all
+/// voices are in use, the oldest one is taken over by a new note.
+///
 /** \ingroup docCore docAudioEngine*/
 class Synth : public H2Core::Object<Synth>
 {
@@ -46,6 +52,9 @@ public:
 	float *m_pOut_L;
 	float *m_pOut_R;
 
+	/** Maximum number of notes played at the same time.*/
+	static constexpr int nMaxVoices = 128;
+
 	/**
 	 * Constructor of the Synth.
 	 *
@@ -56,23 +65,61 @@ public:
 	~Synth();
 
 	/// Start playing a note
-	void noteOn( Note* pNote );
+	///
+	/// The Synth takes ownership of @a pNote. Its pitch is relative
+	/// to 220 Hz, its velocity sets the amplitude, and the envelope
+	/// is taken from its ADSR.
+	void noteOn( Note* pNote, Wavetable::Shape shape = Wavetable::Shape::Sine );
 
 	/// Stop playing a note.
+	///
+	/// Releases the oldest note of the same instrument still held.
+	/// @a pNote itself will be deleted.
 	void noteOff( Note* pNote );
 
 	void process( uint32_t nFrames );
 	void setAudioOutput( AudioOutput* pAudioOutput );
 
-	int getPlayingNotesNumber() {
-		return m_playingNotesQueue.size();
+	/** \return Number of voices in use, including those fading out
+	 * after being released.*/
+	int getPlayingNotesNumber() const {
+		return m_nActiveVoices;
+	}
+	/** Whether #m_pOut_L and #m_pOut_R were written to in the last
+	 * call to process(). If not, they contain silence only and do
+	 * not have to be mixed.*/
+	bool isActive() const {
+		return m_bActive;
 	}
 
 
 private:
-	std::vector<Note*> m_playingNotesQueue;
-
-	float m_fTheta;
+	struct Voice {
+		/** Note played. Owned by the voice. nullptr if unused.*/
+		Note* pNote = nullptr;
+		const Wavetable* pWavetable = nullptr;
+		ADSR adsr;
+		float fFrequency = 0;
+		float fAmplitude = 0;
+		float fPhase = 0;
+		bool bReleased = false;
+		/** Value of #m_nVoiceCounter when the note was started.*/
+		uint64_t nStarted = 0;
+	};
+
+	/** Deletes the note of @a pVoice and marks it unused.*/
+	void freeVoice( Voice* pVoice );
+
+	Voice* m_pVoices;
+	int m_nActiveVoices;
+	uint64_t m_nVoiceCounter;
+
+	/** Scratch buffers a single voice is rendered into before its
+	 * envelope is applied.*/
+	float* m_pVoice_L;
+	float* m_pVoice_R;
+
+	bool m_bActive;
 	AudioOutput *m_pAudioOutput;
 
 
@@ -82,4 +129,3 @@ private:
 
 #endif
 
-
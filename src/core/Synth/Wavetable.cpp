@@ -0,0 +1,147 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+#include <core/Synth/Wavetable.h>
+#include <core/Globals.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace H2Core
+{
+
+const Wavetable* Wavetable::get( Shape shape )
+{
+	static const Wavetable sine( Shape::Sine );
+	static const Wavetable saw( Shape::Saw );
+	static const Wavetable square( Shape::Square );
+
+	switch ( shape ) {
+	case Shape::Saw:
+		return &saw;
+	case Shape::Square:
+		return &square;
+	default:
+		return &sine;
+	}
+}
+
+Wavetable::Wavetable( Shape shape )
+	: m_shape( shape )
+{
+	// Harmonics are taken from a single sine cycle. Since the table
+	// size is a multiple of all harmonics' periods, index arithmetic
+	// is exact and no further calls to sin() are required.
+	std::vector<double> sine( nSize );
+	for ( int ii = 0; ii < nSize; ++ii ) {
+		sine[ ii ] = std::sin( TWOPI * ii / nSize );
+	}
+
+	const int nHarmonicsLowest = shape == Shape::Sine ? 1 : nMaxHarmonics;
+	for ( int nHarmonics = nHarmonicsLowest; nHarmonics >= 1; nHarmonics /= 2 ) {
+		std::vector<double> cycle( nSize, 0 );
+		for ( int nHarmonic = 1; nHarmonic <= nHarmonics; ++nHarmonic ) {
+			double fAmplitude;
+			if ( shape == Shape::Saw ) {
+				fAmplitude = ( nHarmonic % 2 == 1 ? 2 : -2 ) / ( M_PI * nHarmonic );
+			} else if ( shape == Shape::Square ) {
+				if ( nHarmonic % 2 == 0 ) {
+					continue;
+				}
+				fAmplitude = 4 / ( M_PI * nHarmonic );
+			} else {
+				fAmplitude = 1;
+			}
+
+			for ( int ii = 0; ii < nSize; ++ii ) {
+				cycle[ ii ] += fAmplitude * sine[ ( ii * nHarmonic ) % nSize ];
+			}
+		}
+
+		// Levels of the same shape should be equally loud regardless
+		// of the Gibbs overshoot.
+		double fPeak = 0;
+		for ( const auto fValue : cycle ) {
+			fPeak = std::max( fPeak, std::abs( fValue ) );
+		}
+
+		std::vector<float> table( nSize + 2 );
+		for ( int ii = 0; ii < nSize; ++ii ) {
+			table[ ii ] = cycle[ ii ] / fPeak;
+		}
+		table[ nSize ] = table[ 0 ];
+		table[ nSize + 1 ] = table[ 1 ];
+		m_levels.push_back( std::move( table ) );
+	}
+}
+
+int Wavetable::getLevel( float fIncrement ) const
+{
+	// Level n holds nMaxHarmonics / 2^n harmonics, the highest of
+	// which has to stay below half the sample rate.
+	int nLevel = 0;
+	int nHarmonics = m_shape == Shape::Sine ? 1 : nMaxHarmonics;
+	while ( nLevel < getLevelCount() - 1 && nHarmonics * fIncrement >= 0.5 ) {
+		nHarmonics /= 2;
+		++nLevel;
+	}
+	return nLevel;
+}
+
+void Wavetable::render( float* __restrict__ pOut, int nFrames, float* pfPhase,
+						float fIncrement ) const
+{
+	const float* __restrict__ pTable = getTable( getLevel( fIncrement ) );
+	float fPhase = *pfPhase;
+
+	int indices[ nBlockSize ];
+	float fractions[ nBlockSize ];
+
+	for ( int nOffset = 0; nOffset < nFrames; nOffset += nBlockSize ) {
+		const int nBlock = std::min( nBlockSize, nFrames - nOffset );
+
+		// The phase of each frame is derived from the start of the
+		// block instead of being accumulated. This removes the
+		// dependency between frames.
+		for ( int ii = 0; ii < nBlock; ++ii ) {
+			float fPosition = fPhase + ii * fIncrement;
+			fPosition = ( fPosition - static_cast<int>( fPosition ) ) * nSize;
+			const int nIndex = static_cast<int>( fPosition );
+			indices[ ii ] = nIndex;
+			fractions[ ii ] = fPosition - nIndex;
+		}
+
+		float* __restrict__ pBlock = &pOut[ nOffset ];
+		for ( int ii = 0; ii < nBlock; ++ii ) {
+			const float fA = pTable[ indices[ ii ] ];
+			const float fB = pTable[ indices[ ii ] + 1 ];
+			pBlock[ ii ] = fA + fractions[ ii ] * ( fB - fA );
+		}
+
+		fPhase += nBlock * fIncrement;
+		fPhase -= static_cast<int>( fPhase );
+	}
+
+	*pfPhase = fPhase;
+}
+
+};
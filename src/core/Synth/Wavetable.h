@@ -0,0 +1,113 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+#ifndef H2C_WAVETABLE_H
+#define H2C_WAVETABLE_H
+
+#include <core/Object.h>
+
+#include <vector>
+
+namespace H2Core
+{
+
+/**
+ * Band-limited single cycle waveform used by the oscillators of the
+ * Synth.
+ *
+ * For each waveform one table per octave is computed by additive
+ * synthesis. Starting with #nMaxHarmonics, the number of harmonics
+ * is halved in each level. The oscillator picks the level of the
+ * highest harmonic still below the Nyquist frequency, so the output
+ * does not alias.
+ *
+ * The tables are created once on first access of get() and shared
+ * by all oscillators.
+ */
+/** \ingroup docCore docAudioEngine */
+class Wavetable : public H2Core::Object<Wavetable>
+{
+	H2_OBJECT(Wavetable)
+public:
+
+	enum class Shape {
+		Sine,
+		Saw,
+		Square
+	};
+
+	/** Number of samples in a single cycle.*/
+	static constexpr int nSize = 2048;
+	/** Number of harmonics of the lowest level. Half the number the
+	 * table could hold, so linear interpolation between its
+	 * samples stays accurate.*/
+	static constexpr int nMaxHarmonics = nSize / 4;
+	/** Frames rendered in a single pass by render().*/
+	static constexpr int nBlockSize = 64;
+
+	/** \return Shared tables of @a shape. Thread-safe.*/
+	static const Wavetable* get( Shape shape );
+
+	Shape getShape() const {
+		return m_shape;
+	}
+	int getLevelCount() const {
+		return m_levels.size();
+	}
+	/** \return Level with as many harmonics as possible without
+	 * aliasing at @a fIncrement.
+	 *
+	 * \param fIncrement Frequency of the oscillator divided by the
+	 * sample rate.*/
+	int getLevel( float fIncrement ) const;
+	/** \return #nSize + 2 samples. The last two repeat the first
+	 * ones for interpolation.*/
+	const float* getTable( int nLevel ) const {
+		return m_levels[ nLevel ].data();
+	}
+
+	/**
+	 * Renders @a nFrames of the waveform into @a pOut.
+	 *
+	 * Frames are processed in blocks of #nBlockSize. Phase,
+	 * interpolation weights, and table indices of a block are
+	 * computed in loops without dependencies between frames, which
+	 * the compiler turns into SIMD instructions.
+	 *
+	 * \param pOut Buffer to write to (it is overwritten).
+	 * \param nFrames Number of frames to render.
+	 * \param pfPhase Phase in [0,1). Will be advanced by @a nFrames.
+	 * \param fIncrement Frequency of the oscillator divided by the
+	 *   sample rate.
+	 */
+	void render( float* pOut, int nFrames, float* pfPhase, float fIncrement ) const;
+
+private:
+	Wavetable( Shape shape );
+
+	Shape m_shape;
+	std::vector< std::vector<float> > m_levels;
+};
+
+};
+
+#endif
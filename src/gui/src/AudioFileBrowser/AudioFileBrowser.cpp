@@ -31,6 +31,7 @@
 #include <core/Basics/Sample.h>
 #include <core/Hydrogen.h>
 #include <core/AudioEngine/AudioEngine.h>
+#include <core/Sampler/SamplePreview.h>
 
 #include <QFileSystemModel>
 #include <QModelIndex>
@@ -127,6 +128,8 @@ AudioFileBrowser::AudioFileBrowser ( QWidget* pParent, bool bAllowMultiSelect,
 							   QAbstractItemView::PositionAtCenter);} );
 	}
 
+	HydrogenApp::get_instance()->addEventListener( this );
+
 	connect( m_pTree, SIGNAL( clicked( const QModelIndex&) ), SLOT( clicked( const QModelIndex& ) ) );
 	connect( m_pTree, SIGNAL( doubleClicked( const QModelIndex&) ), SLOT( doubleClicked( const QModelIndex& ) ) );
 	connect( pathLineEdit, SIGNAL( returnPressed() ), SLOT( updateModelIndex() ) );	
@@ -136,8 +139,10 @@ AudioFileBrowser::AudioFileBrowser ( QWidget* pParent, bool bAllowMultiSelect,
 
 AudioFileBrowser::~AudioFileBrowser()
 {
-	auto pNewSample = Sample::load( m_sEmptySampleFilename );
-	H2Core::Hydrogen::get_instance()->getAudioEngine()->getSampler()->preview_sample( pNewSample, 100 );
+	if ( auto pH2App = HydrogenApp::get_instance() ) {
+		pH2App->removeEventListener( this );
+	}
+	H2Core::Hydrogen::get_instance()->getSamplePreview()->stop();
 	INFOLOG ( "DESTROY" );
 }
 
@@ -280,45 +285,25 @@ void AudioFileBrowser::browseTree( const QModelIndex& index )
 	QStringList path2List = path2.split("/");
 	QString fleTxt = path2List.last();
 
-	QApplication::setOverrideCursor(Qt::WaitCursor);
-
 	if( isFileSupported( path2 ) )
 	{
 
 		filelineedit->setText( fleTxt );
-		auto pNewSample = Sample::load( path2 );
+		m_pNameLabel->setText( message );
+		m_pPlayBtn->setEnabled( false );
+		openBTN->setEnabled( false );
 
+		// Decoding is done in the background. In case the sample is
+		// not cached yet, it will be displayed in
+		// previewLoadedEvent().
+		m_sLoadingFilename = path2;
+		auto pNewSample = Hydrogen::get_instance()->getSamplePreview()->loadSample( path2 );
 		if ( pNewSample != nullptr ) {
-			m_pNBytesLable->setText( tr( "Size: %1 bytes" ).arg( pNewSample->get_size() / 2 ) );
-			m_pSamplerateLable->setText( tr( "Samplerate: %1" ).arg( pNewSample->get_sample_rate() ) );
-			float sec = ( float )( pNewSample->get_frames() / (float)pNewSample->get_sample_rate() );
-			QString qsec;
-			qsec = QString::asprintf( "%2.2f", sec );
-			m_pLengthLable->setText( tr( "Sample length: " ) + qsec + tr( " s" ) );
-
-			m_pSampleFilename = path2;
-
-			m_pSampleWaveDisplay->updateDisplay( path2 );
-			m_pPlayBtn->setEnabled( true );
-			openBTN->setEnabled( true );
-
-			//important this will only working correct if m_pSampleWaveDisplay->updateDisplay( file )
-			//is ready with painting the wav file. else the playing sample get crackled sound!!
-			if (playSamplescheckBox->isChecked()){
-				if ( sec <= 600.00){
-					on_m_pPlayBtn_clicked();
-				}else
-				{
-					QMessageBox::information ( this, "Hydrogen", tr( "Please do not preview samples which are longer than 10 minutes!" )  );
-				}
-			}
-			m_pNameLabel->setText( message );
-		} else {
-			openBTN->setEnabled( false );
-			QMessageBox::information ( this, "Hydrogen", tr( "Unable to load that sample file." )  );
+			showSample( pNewSample );
 		}
 
 	}else{
+		m_sLoadingFilename = "";
 		m_pNameLabel->setText( tr( "Name:"));
 		m_pNBytesLable->setText( tr( "Size:" ) );
 		m_pSamplerateLable->setText( tr( "Samplerate:" ) );
@@ -329,7 +314,52 @@ void AudioFileBrowser::browseTree( const QModelIndex& index )
 		openBTN->setEnabled( false );
 		m_pSampleFilename = "";
 	}
-	QApplication::restoreOverrideCursor();
+}
+
+void AudioFileBrowser::showSample( std::shared_ptr<Sample> pNewSample )
+{
+	const QString sFilename = m_sLoadingFilename;
+	m_sLoadingFilename = "";
+
+	m_pNBytesLable->setText( tr( "Size: %1 bytes" ).arg( pNewSample->get_size() / 2 ) );
+	m_pSamplerateLable->setText( tr( "Samplerate: %1" ).arg( pNewSample->get_sample_rate() ) );
+	float sec = ( float )( pNewSample->get_frames() / (float)pNewSample->get_sample_rate() );
+	QString qsec;
+	qsec = QString::asprintf( "%2.2f", sec );
+	m_pLengthLable->setText( tr( "Sample length: " ) + qsec + tr( " s" ) );
+
+	m_pSampleFilename = sFilename;
+
+	m_pSampleWaveDisplay->updateDisplay( pNewSample, sFilename );
+	m_pPlayBtn->setEnabled( true );
+	openBTN->setEnabled( true );
+
+	if (playSamplescheckBox->isChecked()){
+		if ( sec <= 600.00){
+			on_m_pPlayBtn_clicked();
+		}else
+		{
+			QMessageBox::information ( this, "Hydrogen", tr( "Please do not preview samples which are longer than 10 minutes!" )  );
+		}
+	}
+}
+
+void AudioFileBrowser::previewLoadedEvent( int nValue )
+{
+	if ( m_sLoadingFilename.isEmpty() ) {
+		return;
+	}
+
+	auto pPreview = Hydrogen::get_instance()->getSamplePreview();
+	auto pNewSample = pPreview->getCachedSample( m_sLoadingFilename );
+	if ( pNewSample != nullptr ) {
+		showSample( pNewSample );
+	}
+	else if ( nValue == 0 && ! pPreview->isLoading( m_sLoadingFilename ) ) {
+		m_sLoadingFilename = "";
+		openBTN->setEnabled( false );
+		QMessageBox::information ( this, "Hydrogen", tr( "Unable to load that sample file." )  );
+	}
 }
 
 
@@ -343,21 +373,15 @@ void AudioFileBrowser::on_m_pPlayBtn_clicked()
 	
 	m_pStopBtn->setEnabled( true );
 	
-	auto pNewSample = Sample::load( m_pSampleFilename );
-	if ( pNewSample ) {
-		assert(pNewSample->get_sample_rate() != 0);
-		
-		int length = ( ( pNewSample->get_frames() / pNewSample->get_sample_rate() + 1) * 100 );
-		H2Core::Hydrogen::get_instance()->getAudioEngine()->getSampler()->preview_sample( pNewSample, length );
-	}
+	// Played right away in case the sample is cached.
+	H2Core::Hydrogen::get_instance()->getSamplePreview()->previewSample( m_pSampleFilename );
 }
 
 
 
 void AudioFileBrowser::on_m_pStopBtn_clicked()
 {
-	auto pNewSample = Sample::load( m_sEmptySampleFilename );
-	H2Core::Hydrogen::get_instance()->getAudioEngine()->getSampler()->preview_sample( pNewSample, 100 );
+	H2Core::Hydrogen::get_instance()->getSamplePreview()->stop();
 	m_pStopBtn->setEnabled( false );
 }
 
@@ -25,11 +25,17 @@
 
 #include "ui_AudioFileBrowser_UI.h"
 #include "InstrumentEditor/InstrumentEditor.h"
+#include "../EventListener.h"
 
 #include <QDialog>
 #include <core/Object.h>
 #include <core/Preferences/Preferences.h>
 
+#include <memory>
+
+namespace H2Core {
+	class Sample;
+}
 
 class Button;
 class SampleWaveDisplay;
@@ -38,7 +44,7 @@ class SampleWaveDisplay;
 /// This dialog is used to preview audiofiles
 ///
 /** \ingroup docGUI*/
-class AudioFileBrowser :  public QDialog, public Ui_AudioFileBrowser_UI,  public H2Core::Object<AudioFileBrowser>
+class AudioFileBrowser :  public QDialog, public Ui_AudioFileBrowser_UI, public EventListener,  public H2Core::Object<AudioFileBrowser>
 
 {
 	H2_OBJECT(AudioFileBrowser)
@@ -54,6 +60,8 @@ class AudioFileBrowser :  public QDialog, public Ui_AudioFileBrowser_UI,  public
 	QStringList getSelectedFiles();
 	QString getSelectedDirectory();
 
+	virtual void previewLoadedEvent( int nValue ) override;
+
 	private slots:
 		void on_cancelBTN_clicked();
 		void on_openBTN_clicked();
@@ -73,6 +81,9 @@ class AudioFileBrowser :  public QDialog, public Ui_AudioFileBrowser_UI,  public
 
 	private:
 		void browseTree( const QModelIndex& index );
+		/** Displays the information and waveform of the sample
+		 * selected last and plays it if requested.*/
+		void showSample( std::shared_ptr<H2Core::Sample> pNewSample );
 
 		void getEnvironment();
 		bool isFileSupported( QString filename );
@@ -80,6 +91,8 @@ class AudioFileBrowser :  public QDialog, public Ui_AudioFileBrowser_UI,  public
 		SampleWaveDisplay *	m_pSampleWaveDisplay;
 		
 		QString				m_pSampleFilename;
+		/** Selected file decoded in the background.*/
+		QString				m_sLoadingFilename;
 		QStringList			m_pSelectedFile;
 		QString				m_sSelectedDirectory;
 
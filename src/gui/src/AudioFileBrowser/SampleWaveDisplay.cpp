@@ -21,6 +21,7 @@
  */
 
 #include <core/Basics/Sample.h>
+#include <core/Basics/WaveformPeaks.h>
 #include <core/Basics/Song.h>
 #include <core/Basics/Instrument.h>
 using namespace H2Core;
@@ -84,9 +85,12 @@ void SampleWaveDisplay::paintEvent(QPaintEvent *ev)
 
 void SampleWaveDisplay::updateDisplay( QString filename )
 {
+	updateDisplay( Sample::load( filename ), filename );
+}
 
-	auto pNewSample = Sample::load( filename );
-
+void SampleWaveDisplay::updateDisplay( std::shared_ptr<H2Core::Sample> pNewSample,
+									   const QString& filename )
+{
 	if ( pNewSample != nullptr ) {
 		// Extract the filename from the complete path
 		QString sName = filename;
@@ -101,25 +105,20 @@ void SampleWaveDisplay::updateDisplay( QString filename )
 
 //		INFOLOG( "[updateDisplay] sample: " + m_sSampleName  );
 
-		int nSampleLength = pNewSample->get_frames();
-		float nScaleFactor = nSampleLength / width();
+		long long nSampleLength = pNewSample->get_frames();
 
 		float fGain = height() / 2.0 * 1.0;
 
+		auto pPeaks = pNewSample->getWaveformPeaks();
 		auto pSampleData = pNewSample->get_data_l();
 
-		int nSamplePos =0;
-		int nVal;
 		for ( int i = 0; i < width(); ++i ){
-			nVal = 0;
-			for ( int j = 0; j < nScaleFactor; ++j ) {
-				if ( j < nSampleLength ) {
-					int newVal = static_cast<int>( pSampleData[ nSamplePos ] * fGain );
-					if ( newVal > nVal ) {
-						nVal = newVal;
-					}
-				}
-				++nSamplePos;
+			int nVal = 0;
+			if ( pPeaks != nullptr ) {
+				auto peak = pPeaks->getPeak( 0, pSampleData,
+											 i * nSampleLength / width(),
+											 ( i + 1 ) * nSampleLength / width() );
+				nVal = static_cast<int>( peak.getMagnitude() * fGain );
 			}
 			m_pPeakData[ i ] = nVal;
 		}
@@ -27,6 +27,11 @@
 
 #include <core/Object.h>
 
+#include <memory>
+
+namespace H2Core {
+	class Sample;
+}
 
 
 /** \ingroup docGUI*/
@@ -40,6 +45,10 @@ class SampleWaveDisplay :  public QWidget,  public H2Core::Object<SampleWaveDisp
 		~SampleWaveDisplay();
 
 		void updateDisplay( QString filename );
+		/** Displays an already loaded sample. @a filename is used
+		 * for the label.*/
+		void updateDisplay( std::shared_ptr<H2Core::Sample> pNewSample,
+							const QString& filename );
 
 		virtual void paintEvent(QPaintEvent *ev) override;
 
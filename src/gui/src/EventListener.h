@@ -41,6 +41,7 @@ class EventListener
 		virtual void errorEvent( int nErrorCode ) { UNUSED( nErrorCode ); }
 		virtual void metronomeEvent( int nValue ) { UNUSED( nValue ); }
 		virtual void progressEvent( int nValue ) { UNUSED( nValue ); }
+		virtual void drumkitProgressEvent( int nValue ) { UNUSED( nValue ); }
 		virtual void jacksessionEvent( int nValue) { UNUSED( nValue ); }
 		virtual void playlistLoadSongEvent( int nIndex ){ UNUSED( nIndex ); }
 		virtual void undoRedoActionEvent( int nValue ){ UNUSED( nValue ); }
@@ -63,6 +64,7 @@ class EventListener
 	virtual void songSizeChangedEvent(){}
 	virtual void driverChangedEvent(){}
 	virtual void playbackTrackChangedEvent(){}
+	virtual void previewLoadedEvent( int nValue ){ UNUSED( nValue ); }
 
 		virtual ~EventListener() {}
 };
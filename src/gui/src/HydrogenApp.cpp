@@ -33,6 +33,7 @@
 #include "PreferencesDialog/PreferencesDialog.h"
 #include "MainForm.h"
 #include "PlayerControl.h"
+#include "RefreshScheduler.h"
 #include "AudioEngineInfoForm.h"
 #include "FilesystemInfoForm.h"
 #include "LadspaFXProperties.h"
@@ -88,6 +89,10 @@ HydrogenApp::HydrogenApp( MainForm *pMainForm )
 	connect( m_pEventQueueTimer, SIGNAL( timeout() ), this, SLOT( onEventQueueTimer() ) );
 	m_pEventQueueTimer->start( QUEUE_TIMER_PERIOD );
 
+	// Has to be created before all widgets displaying the state of
+	// the audio engine.
+	m_pRefreshScheduler = new RefreshScheduler( this );
+
 	// Wait for m_nPreferenceUpdateTimeout milliseconds of no update
 	// signal before propagating the update. Else importing/resetting a
 	// theme will slow down the GUI significantly.
@@ -195,6 +200,8 @@ HydrogenApp::~HydrogenApp()
 {
 	INFOLOG( "[~HydrogenApp]" );
 	m_pEventQueueTimer->stop();
+	delete m_pRefreshScheduler;
+	m_pRefreshScheduler = nullptr;
 
 
 	//delete the undo tmp directory
@@ -703,6 +710,9 @@ void HydrogenApp::onEventQueueTimer()
 
 	Event event;
 	while ( ( event = pQueue->pop_event() ).type != EVENT_NONE ) {
+
+		// Any event might change what is displayed.
+		m_pRefreshScheduler->wake();
 		
 		// Provide the event to all EventListeners registered to
 		// HydrogenApp. By registering itself as EventListener and
@@ -764,6 +774,10 @@ void HydrogenApp::onEventQueueTimer()
 				pListener->progressEvent( event.value );
 				break;
 
+			case EVENT_DRUMKIT_PROGRESS:
+				pListener->drumkitProgressEvent( event.value );
+				break;
+
 			case EVENT_JACK_SESSION:
 				pListener->jacksessionEvent( event.value );
 				break;
@@ -852,6 +866,10 @@ void HydrogenApp::onEventQueueTimer()
 				pListener->playbackTrackChangedEvent();
 				break;
 
+			case EVENT_PREVIEW_LOADED:
+				pListener->previewLoadedEvent( event.value );
+				break;
+
 			default:
 				ERRORLOG( QString("[onEventQueueTimer] Unhandled event: %1").arg( event.type ) );
 			}
@@ -914,6 +932,10 @@ void HydrogenApp::onEventQueueTimer()
 		pUndoStack->endMacro();
 		pQueue->m_addMidiNoteVector.erase( pQueue->m_addMidiNoteVector.begin() );
 	}
+
+	// Transport might be rolling or audio might be played back
+	// without any event being emitted.
+	m_pRefreshScheduler->poll();
 }
 
 
@@ -42,7 +42,9 @@
 /** Amount of time to pass between successive calls to
  * HydrogenApp::onEventQueueTimer() in milliseconds.
  *
- * This causes the GUI to update at 20 frames per second.*/
+ * Events are dispatched 20 times per second. Widgets showing the
+ * state of the audio engine are refreshed by the RefreshScheduler
+ * instead.*/
 constexpr uint16_t QUEUE_TIMER_PERIOD = 50;
 
 
@@ -70,6 +72,7 @@ class SampleEditor;
 class Director;
 class InfoBar;
 class CommonStrings;
+class RefreshScheduler;
 
 /** \ingroup docGUI*/
 class HydrogenApp :  public QObject, public EventListener,  public H2Core::Object<HydrogenApp>
@@ -125,6 +128,7 @@ class HydrogenApp :  public QObject, public EventListener,  public H2Core::Objec
 		PlayerControl*			getPlayerControl();
 		InstrumentRack*			getInstrumentRack();
 	std::shared_ptr<CommonStrings>			getCommonStrings();
+		RefreshScheduler*		getRefreshScheduler();
 		InfoBar *			addInfoBar();
 
 		QUndoStack*			m_pUndoStack;
@@ -208,6 +212,7 @@ private slots:
 		SampleEditor *				m_pSampleEditor;
 		Director *					m_pDirector;
 		QTimer *					m_pEventQueueTimer;
+		RefreshScheduler *			m_pRefreshScheduler;
 		std::vector<EventListener*> 	m_EventListeners;
 		QTabWidget *				m_pTab;
 		QSplitter *					m_pSplitter;
@@ -320,6 +325,11 @@ inline std::shared_ptr<CommonStrings> HydrogenApp::getCommonStrings()
 	return m_pCommonStrings;
 }
 
+inline RefreshScheduler* HydrogenApp::getRefreshScheduler()
+{
+	return m_pRefreshScheduler;
+}
+
 inline bool HydrogenApp::hideKeyboardCursor()
 {
 	return m_bHideKeyboardCursor;
@@ -21,6 +21,7 @@
  */
 
 #include <core/Basics/Sample.h>
+#include <core/Basics/WaveformPeaks.h>
 #include <core/Basics/Song.h>
 #include <core/Basics/Instrument.h>
 #include <core/Basics/InstrumentLayer.h>
@@ -135,25 +136,19 @@ void WaveDisplay::updateDisplay( std::shared_ptr<H2Core::InstrumentLayer> pLayer
 
 		//INFOLOG( "[updateDisplay] sample: " + m_sSampleName  );
 
-		int nSampleLength = pLayer->get_sample()->get_frames();
-		int nScaleFactor = nSampleLength / m_nCurrentWidth;
+		auto pSample = pLayer->get_sample();
+		auto pPeaks = pSample->getWaveformPeaks();
+		long long nSampleLength = pSample->get_frames();
 
 		float fGain = height() / 2.0 * pLayer->get_gain();
 
-		auto pSampleData = pLayer->get_sample()->get_data_l();
-
-		int nSamplePos =0;
-		int nVal;
 		for ( int i = 0; i < width(); ++i ){
-			nVal = 0;
-			for ( int j = 0; j < nScaleFactor; ++j ) {
-				if ( j < nSampleLength ) {
-					int newVal = (int)( pSampleData[ nSamplePos ] * fGain );
-					if ( newVal > nVal ) {
-						nVal = newVal;
-					}
-				}
-				++nSamplePos;
+			int nVal = 0;
+			if ( pPeaks != nullptr ) {
+				auto peak = pPeaks->getPeak( 0, pSample->get_data_l(),
+											 i * nSampleLength / width(),
+											 ( i + 1 ) * nSampleLength / width() );
+				nVal = (int)( peak.getMagnitude() * fGain );
 			}
 			m_pPeakData[ i ] = nVal;
 		}
@@ -228,6 +228,7 @@ MainForm::~MainForm()
 	
 	// Remove the autosave file in case all modifications already have
 	// been written to disk.
+	m_autoSaveWriter.waitForFinished();
 	if ( ! pHydrogen->getSong()->getIsModified() ) {
 		QFile file( getAutoSaveFilename() );
 		file.remove();
@@ -636,6 +637,7 @@ void MainForm::action_file_new()
 	QFileInfo autoSaveFile( QString( "%1/.%2.autosave.h2song" )
 							.arg( fileInfo.absoluteDir().absolutePath() )
 							.arg( sBaseName ) );
+	m_autoSaveWriter.waitForFinished();
 	if ( autoSaveFile.exists() ) {
 		Filesystem::rm( autoSaveFile.absoluteFilePath() );
 	}
@@ -2004,6 +2006,10 @@ void MainForm::errorEvent( int nErrorCode )
 		msg = tr( "Playback track couldn't be read" );
 		break;
 
+	case Hydrogen::ERROR_EXPORTING_FILE:
+		msg = tr( "Export file couldn't be written" );
+		break;
+
 	default:
 		msg = QString( tr( "Unknown error %1" ) ).arg( nErrorCode );
 	}
@@ -2148,21 +2154,21 @@ void MainForm::onAutoSaveTimer()
 
 	assert( pSong );
 	if ( pSong->getIsModified() ) {
-		QString sOldFilename = pSong->getFilename();
-
 		QString sAutoSaveFilename = getAutoSaveFilename();
 		if ( sAutoSaveFilename != m_sPreviousAutoSaveFilename ) {
 			if ( ! m_sPreviousAutoSaveFilename.isEmpty() ) {
+				// The previous file might still be written.
+				m_autoSaveWriter.waitForFinished();
 				QFile file( m_sPreviousAutoSaveFilename );
 				file.remove();
 			}
 			m_sPreviousAutoSaveFilename = sAutoSaveFilename;
 		}
-			
-		pSong->save( sAutoSaveFilename );
 
-		pSong->setFilename( sOldFilename );
-		pHydrogen->setIsModified( true );
+		// Only the serialization into memory is done in here. The
+		// file is written in the background and nothing is done at
+		// all in case the song did not change since the last call.
+		m_autoSaveWriter.save( pSong, sAutoSaveFilename );
 	}
 }
 
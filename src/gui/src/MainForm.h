@@ -34,6 +34,7 @@
 
 #include <core/config.h>
 #include <core/Object.h>
+#include <core/Helpers/AutoSaveWriter.h>
 #include <core/Preferences/Preferences.h>
 
 class HydrogenApp;
@@ -272,6 +273,8 @@ public slots:
 
 	void startAutosaveTimer();
 		QTimer		m_AutosaveTimer;
+		/** Writes the autosave files without blocking the GUI.*/
+		H2Core::AutoSaveWriter	m_autoSaveWriter;
 
 		/** Create the menubar */
 		void createMenuBar();
@@ -26,6 +26,7 @@
 #include "../CommonStrings.h"
 #include "../HydrogenApp.h"
 #include "../LadspaFXProperties.h"
+#include "../RefreshScheduler.h"
 #include "../InstrumentEditor/InstrumentEditorPanel.h"
 #include "../Widgets/Button.h"
 #include "../Widgets/PixmapWidget.h"
@@ -42,7 +43,9 @@
 #include <core/FX/Effects.h>
 using namespace H2Core;
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 
 #define MIXER_STRIP_WIDTH	56
 #define MASTERMIXER_STRIP_WIDTH	126
@@ -149,9 +152,8 @@ Mixer::Mixer( QWidget* pParent )
 	this->setLayout( pLayout );
 
 
-	m_pUpdateTimer = new QTimer( this );
-	connect( m_pUpdateTimer, SIGNAL( timeout() ), this, SLOT( updateMixer() ) );
-	m_pUpdateTimer->start(50);
+	connect( HydrogenApp::get_instance()->getRefreshScheduler(), &RefreshScheduler::frame,
+			 this, &Mixer::updateMixer );
 
 	connect( HydrogenApp::get_instance(), &HydrogenApp::preferencesChanged, this, &Mixer::onPreferencesChanged );
 
@@ -161,7 +163,6 @@ Mixer::Mixer( QWidget* pParent )
 
 Mixer::~Mixer()
 {
-	m_pUpdateTimer->stop();
 }
 
 MixerLine* Mixer::createMixerLine( int nInstr )
@@ -409,7 +410,19 @@ void Mixer::updateMixer()
 
 	uint nSelectedInstr = pHydrogen->getSelectedInstrumentNumber();
 
-	float fallOff = pPref->getMixerFalloffSpeed();
+	// The fall off speed and the activity decay refer to an update
+	// interval of 50 ms and are scaled to the actual frame rate.
+	auto pRefreshScheduler = HydrogenApp::get_instance()->getRefreshScheduler();
+	const float fFrameRatio =
+		static_cast<float>( pRefreshScheduler->getFrameInterval() ) / 50.0f;
+	float fallOff = std::pow( pPref->getMixerFalloffSpeed(), fFrameRatio );
+	const int nActivityDecay = std::max( static_cast<int>( std::round( 30 * fFrameRatio ) ), 1 );
+
+	// Peaks below this value (-60 dB) are not visible anymore. As
+	// long as any strip shows a larger one, another frame is
+	// requested.
+	const float fMinPeak = 0.001f;
+	bool bAnimating = false;
 
 	int nInstruments = pInstrList->size();
 	int nCompo = pDrumkitComponentList->size();
@@ -443,11 +456,14 @@ void Mixer::updateMixer()
 			auto pInstr = pInstrList->get( nInstr );
 			assert( pInstr );
 
-			float fNewPeak_L = pInstr->get_peak_l();
-			pInstr->set_peak_l( 0.0f );	// reset instrument peak
-
-			float fNewPeak_R = pInstr->get_peak_r();
-			pInstr->set_peak_r( 0.0f );	// reset instrument peak
+			// Without new values the peaks of the strip fall off.
+			Meter::Values meterValues;
+			float fNewPeak_L = 0.0f;
+			float fNewPeak_R = 0.0f;
+			if ( pInstr->get_meter().read( meterValues ) ) {
+				fNewPeak_L = meterValues.fPeak_L;
+				fNewPeak_R = meterValues.fPeak_R;
+			}
 
 			QString sName = pInstr->get_name();
 
@@ -495,8 +511,9 @@ void Mixer::updateMixer()
 
 			// activity
 			if ( pLine->getActivity() > 0 ) {
-				pLine->setActivity( m_pMixerLine[ nInstr ]->getActivity() - 30 );
+				pLine->setActivity( m_pMixerLine[ nInstr ]->getActivity() - nActivityDecay );
 				pLine->setPlayClicked( true );
+				bAnimating = true;
 			}
 			else {
 				pLine->setPlayClicked( false );
@@ -509,6 +526,10 @@ void Mixer::updateMixer()
 			pLine->setSelected( nInstr == nSelectedInstr );
 
 			pLine->updateMixerLine();
+
+			if ( pLine->getPeak_L() > fMinPeak || pLine->getPeak_R() > fMinPeak ) {
+				bAnimating = true;
+			}
 		}
 	}
 
@@ -527,11 +548,13 @@ void Mixer::updateMixer()
 
 		ComponentMixerLine *pLine = m_pComponentMixerLine[ pDrumkitComponent->get_id() ];
 
-		float fNewPeak_L = pDrumkitComponent->get_peak_l();
-		pDrumkitComponent->set_peak_l( 0.0f );	// reset instrument peak
-
-		float fNewPeak_R = pDrumkitComponent->get_peak_r();
-		pDrumkitComponent->set_peak_r( 0.0f );	// reset instrument peak
+		Meter::Values meterValues;
+		float fNewPeak_L = 0.0f;
+		float fNewPeak_R = 0.0f;
+		if ( pDrumkitComponent->get_meter().read( meterValues ) ) {
+			fNewPeak_L = meterValues.fPeak_L;
+			fNewPeak_R = meterValues.fPeak_R;
+		}
 
 		bool bMuted = pDrumkitComponent->is_muted();
 
@@ -572,6 +595,10 @@ void Mixer::updateMixer()
 		pLine->setName( sName );
 
 		pLine->updateMixerLine();
+
+		if ( pLine->getPeak_L() > fMinPeak || pLine->getPeak_R() > fMinPeak ) {
+			bAnimating = true;
+		}
 	}
 
 	if( pDrumkitComponentList->size() < m_pComponentMixerLine.size() ) {
@@ -603,13 +630,14 @@ void Mixer::updateMixer()
 	}
 
 
-	// update MasterPeak
+	// update MasterPeak. The master strip shows the true peaks in
+	// order to indicate inter-sample clipping.
 	float fOldPeak_L = m_pMasterLine->getPeak_L();
-	float fNewPeak_L = pAudioEngine->getMasterPeak_L();
-	pAudioEngine->setMasterPeak_L(0.0);
 	float fOldPeak_R = m_pMasterLine->getPeak_R();
-	float fNewPeak_R = pAudioEngine->getMasterPeak_R();
-	pAudioEngine->setMasterPeak_R(0.0);
+	// The master meter is read by the RefreshScheduler.
+	const Meter::Values& masterValues = pRefreshScheduler->getSnapshot().masterMeter;
+	float fNewPeak_L = masterValues.fTruePeak_L;
+	float fNewPeak_R = masterValues.fTruePeak_R;
 
 	if (!bShowPeaks) {
 		fNewPeak_L = 0.0;
@@ -638,6 +666,10 @@ void Mixer::updateMixer()
 	}
 	m_pMasterLine->updateMixerLine();
 
+	if ( m_pMasterLine->getPeak_L() > fMinPeak || m_pMasterLine->getPeak_R() > fMinPeak ) {
+		bAnimating = true;
+	}
+
 
 #ifdef H2CORE_HAVE_LADSPA
 	// LADSPA
@@ -645,8 +677,13 @@ void Mixer::updateMixer()
 		LadspaFX *pFX = Effects::get_instance()->getLadspaFX( nFX );
 		if ( pFX ) {
 			m_pLadspaFXLine[nFX]->setName( pFX->getPluginName() );
+			Meter::Values fxValues;
 			float fNewPeak_L = 0.0;
 			float fNewPeak_R = 0.0;
+			if ( pAudioEngine->getFXMeter( nFX ).read( fxValues ) ) {
+				fNewPeak_L = fxValues.fPeak_L;
+				fNewPeak_R = fxValues.fPeak_R;
+			}
 
 			float fOldPeak_L = 0.0;
 			float fOldPeak_R = 0.0;
@@ -655,6 +692,9 @@ void Mixer::updateMixer()
 			if (fNewPeak_L < fOldPeak_L)	fNewPeak_L = fOldPeak_L / fallOff;
 			if (fNewPeak_R < fOldPeak_R)	fNewPeak_R = fOldPeak_R / fallOff;
 			m_pLadspaFXLine[nFX]->setPeaks( fNewPeak_L, fNewPeak_R );
+			if ( fNewPeak_L > fMinPeak || fNewPeak_R > fMinPeak ) {
+				bAnimating = true;
+			}
 			m_pLadspaFXLine[nFX]->setFxBypassed( ! pFX->isEnabled() );
 			m_pLadspaFXLine[nFX]->setVolume( pFX->getVolume() );
 		}
@@ -666,6 +706,10 @@ void Mixer::updateMixer()
 	}
 	// ~LADSPA
 #endif
+
+	if ( bAnimating ) {
+		pRefreshScheduler->requestFrame();
+	}
 }
 
 
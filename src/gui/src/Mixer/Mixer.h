@@ -96,8 +96,6 @@ class Mixer :  public QWidget, public EventListener,  public H2Core::Object<Mixe
 
 		PixmapWidget *			m_pFXFrame;
 
-		QTimer *				m_pUpdateTimer;
-
 		uint					findMixerLineByRef(MixerLine* ref);
 		uint					findCompoMixerLineByRef(ComponentMixerLine* ref);
 		MixerLine*				createMixerLine( int );
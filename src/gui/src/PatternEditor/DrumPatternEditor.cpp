@@ -48,12 +48,19 @@
 #include <math.h>
 #include <cassert>
 #include <algorithm>
+#include <functional>
 #include <stack>
 
 using namespace H2Core;
 
+template <typename T>
+static void hashCombine( size_t& nSeed, const T& value ) {
+	nSeed ^= std::hash<T>()( value ) + 0x9e3779b9 + ( nSeed << 6 ) + ( nSeed >> 2 );
+}
+
 DrumPatternEditor::DrumPatternEditor(QWidget* parent, PatternEditorPanel *panel)
  : PatternEditor( parent, panel )
+ , m_nBackgroundSignature( 0 )
 {
 	m_editor = PatternEditor::Editor::DrumPattern;
 	auto pPref = H2Core::Preferences::get_instance();
@@ -1075,23 +1082,23 @@ void DrumPatternEditor::paste()
 ///
 /// Draws a pattern
 ///
-void DrumPatternEditor::drawPattern(QPainter& painter)
+void DrumPatternEditor::drawPattern( QPainter& painter, const QRect& rect )
 {
 	auto pPref = H2Core::Preferences::get_instance();
 
 	std::shared_ptr<Song> pSong = Hydrogen::get_instance()->getSong();
 	InstrumentList * pInstrList = pSong->getInstrumentList();
 
-	/*
-		BUGFIX
-
-		if m_pPattern is not renewed every time we draw a note,
-		hydrogen will crash after you save a song and create a new one.
-		-smoors
-	*/
-	updatePatternInfo();
-	validateSelection();
+	// m_pPattern and the selection are brought up to date once per
+	// paintEvent() and not for every tile.
 
+	// Only rows intersecting the area are drawn. Notes right of it
+	// (including the marker of superimposed notes drawn to their
+	// left) are skipped as well.
+	const int nFirstRow = rect.top() / static_cast<int>(m_nGridHeight) - 1;
+	const int nLastRow = rect.bottom() / static_cast<int>(m_nGridHeight) + 1;
+	const int nLastPosition = static_cast<int>(
+		( rect.right() + 140 - PatternEditor::nMargin ) / m_fGridWidth );
 
 	for ( Pattern *pPattern : getPatternsToShow() ) {
 		const Pattern::notes_t *pNotes = pPattern->get_notes();
@@ -1108,12 +1115,21 @@ void DrumPatternEditor::drawPattern(QPainter& painter)
 		// duplicates)
 		for ( auto posIt = pNotes->begin(); posIt != pNotes->end(); ) {
 			int nPosition = posIt->second->get_position();
+			if ( nPosition > nLastPosition ) {
+				break;
+			}
 
 			// Process all notes at this position
 			auto noteIt = posIt;
 			while ( noteIt != pNotes->end() && noteIt->second->get_position() == nPosition ) {
 				Note *pNote = noteIt->second;
 
+				int nRow = pInstrList->index( pNote->get_instrument() );
+				if ( nRow < nFirstRow || nRow > nLastRow ) {
+					++noteIt;
+					continue;
+				}
+
 				int nInstrumentID = pNote->get_instrument_id();
 				if ( nInstrumentID >= noteCount.size() ) {
 					noteCount.resize( nInstrumentID+1, 0 );
@@ -1176,7 +1192,7 @@ void DrumPatternEditor::drawNote( Note *note, QPainter& p, bool bIsForeground )
 	drawNoteSymbol( p, pos, note, bIsForeground );
 }
 
-void DrumPatternEditor::drawBackground( QPainter& p)
+void DrumPatternEditor::drawBackground( QPainter& p, const QRect& rect )
 {
 	auto pPref = H2Core::Preferences::get_instance();
 	auto pHydrogen = H2Core::Hydrogen::get_instance();
@@ -1192,17 +1208,19 @@ void DrumPatternEditor::drawBackground( QPainter& p)
 	int nInstruments = pSong->getInstrumentList()->size();
 	int nSelectedInstrument = pHydrogen->getSelectedInstrumentNumber();
 
-	if ( m_nEditorHeight != (int)( m_nGridHeight * nInstruments ) ) {
-		// the number of instruments is changed...recreate all
-		m_nEditorHeight = m_nGridHeight * nInstruments;
-		resize( width(), m_nEditorHeight );
-	}
-
-	p.fillRect(0, 0, m_nActiveWidth, height(), backgroundColor);
-	p.fillRect(m_nActiveWidth, 0, m_nEditorWidth - m_nActiveWidth, height(),
-			   backgroundInactiveColor);
+	p.fillRect( QRect( 0, 0, m_nActiveWidth, height() ) & rect,
+				backgroundColor );
+	p.fillRect( QRect( m_nActiveWidth, 0, m_nEditorWidth - m_nActiveWidth,
+					   height() ) & rect, backgroundInactiveColor );
+
+	// Only rows intersecting the area (and the one above, which
+	// bottom line may border it) are drawn.
+	const int nFirstRow = std::max(
+		0, rect.top() / static_cast<int>(m_nGridHeight) - 1 );
+	const int nLastRow = std::min(
+		nInstruments - 1, rect.bottom() / static_cast<int>(m_nGridHeight) );
 	
-	for ( int ii = 0; ii < nInstruments; ii++ ) {
+	for ( int ii = nFirstRow; ii <= nLastRow; ii++ ) {
 		int y = static_cast<int>(m_nGridHeight) * ii;
 		if ( ii == nSelectedInstrument ) {
 			p.fillRect( 0, y, m_nActiveWidth, m_nGridHeight,
@@ -1219,11 +1237,11 @@ void DrumPatternEditor::drawBackground( QPainter& p)
 	if ( m_pPattern == nullptr ) {
 		return;
 	}
-	drawGridLines( p );
+	drawGridLines( p, Qt::SolidLine, rect );
 
 	// The grid lines above are drawn full height. We will erase the
 	// upper part.
-	for ( int ii = 0; ii < nInstruments; ii++ ) {
+	for ( int ii = nFirstRow; ii <= nLastRow; ii++ ) {
 		int y = static_cast<int>(m_nGridHeight) * ii;
 		if ( ii == nSelectedInstrument ) {
 			p.fillRect( 0, y, m_nActiveWidth, (int)( m_nGridHeight * 0.7 ), selectedRowColor );
@@ -1242,14 +1260,14 @@ void DrumPatternEditor::drawBackground( QPainter& p)
 
 	// horizontal lines
 	p.setPen( QPen( lineColor, 1, Qt::SolidLine ) );
-	for ( uint i = 0; i < (uint)nInstruments; i++ ) {
+	for ( int i = nFirstRow; i <= nLastRow; i++ ) {
 		uint y = m_nGridHeight * i + m_nGridHeight;
 		p.drawLine( 0, y, m_nActiveWidth, y);
 	}
 
 	if ( m_nActiveWidth + 1 < m_nEditorWidth ) {
 		p.setPen( QPen( lineInactiveColor, 1, Qt::SolidLine ) );
-		for ( uint i = 0; i < (uint)nInstruments; i++ ) {
+		for ( int i = nFirstRow; i <= nLastRow; i++ ) {
 			uint y = m_nGridHeight * i + m_nGridHeight;
 			p.drawLine( m_nActiveWidth, y, m_nEditorWidth, y);
 		}
@@ -1269,23 +1287,103 @@ void DrumPatternEditor::drawBackground( QPainter& p)
 
 }
 
+size_t DrumPatternEditor::computeBackgroundSignature() const {
+	size_t nSignature = 0;
+	hashCombine( nSignature, m_nEditorWidth );
+	hashCombine( nSignature, m_nEditorHeight );
+	hashCombine( nSignature, m_nActiveWidth );
+	hashCombine( nSignature, m_fGridWidth );
+	hashCombine( nSignature, m_nGridHeight );
+	hashCombine( nSignature, m_nResolution );
+	hashCombine( nSignature, m_bUseTriplets );
+	hashCombine( nSignature, m_pPattern == nullptr );
+	// Border color of selected notes.
+	hashCombine( nSignature, hasFocus() );
+	hashCombine( nSignature,
+				 Hydrogen::get_instance()->getSelectedInstrumentNumber() );
+	// Moving notes are drawn at an offset and may end up in any row.
+	if ( m_selection.isMoving() ) {
+		QPoint offset = movingGridOffset();
+		hashCombine( nSignature, offset.x() );
+		hashCombine( nSignature, offset.y() );
+	}
+
+	return nSignature;
+}
+
+std::vector<size_t> DrumPatternEditor::computeRowSignatures( int nInstruments ) {
+	std::vector<size_t> signatures( nInstruments, 0 );
+
+	InstrumentList *pInstrList = Hydrogen::get_instance()->getSong()->getInstrumentList();
+
+	for ( Pattern *pPattern : getPatternsToShow() ) {
+		bool bIsForeground = ( pPattern == m_pPattern );
+
+		for ( const auto& [ nPosition, pNote ] : *pPattern->get_notes() ) {
+			int nRow = pInstrList->index( pNote->get_instrument() );
+			if ( nRow < 0 || nRow >= nInstruments ) {
+				continue;
+			}
+
+			// Everything affecting the appearance of the note symbol.
+			size_t& nSignature = signatures[ nRow ];
+			hashCombine( nSignature, nPosition );
+			hashCombine( nSignature, bIsForeground );
+			hashCombine( nSignature, pNote->get_length() );
+			hashCombine( nSignature, pNote->get_velocity() );
+			hashCombine( nSignature, pNote->get_note_off() );
+			hashCombine( nSignature, pNote->get_key() );
+			hashCombine( nSignature, pNote->get_octave() );
+			hashCombine( nSignature, m_selection.isSelected( pNote ) );
+		}
+	}
+
+	return signatures;
+}
+
 void DrumPatternEditor::createBackground() {
 
-	// Resize pixmap if pixel ratio has changed
-	qreal pixelRatio = devicePixelRatio();
-	if ( m_pBackgroundPixmap->width() != m_nEditorWidth ||
-		 m_pBackgroundPixmap->height() != m_nEditorHeight ||
-		 m_pBackgroundPixmap->devicePixelRatio() != pixelRatio ) {
-		delete m_pBackgroundPixmap;
-		m_pBackgroundPixmap = new QPixmap( width() * pixelRatio, height() * pixelRatio );
-		m_pBackgroundPixmap->setDevicePixelRatio( pixelRatio );
+	auto pHydrogen = Hydrogen::get_instance();
+	int nInstruments = pHydrogen->getSong()->getInstrumentList()->size();
+
+	if ( m_nEditorHeight != (int)( m_nGridHeight * nInstruments ) ) {
+		// the number of instruments is changed...recreate all
+		m_nEditorHeight = m_nGridHeight * nInstruments;
+		resize( width(), m_nEditorHeight );
 	}
-	
-	QPainter painter( m_pBackgroundPixmap );
 
-	drawBackground( painter );
-	
-	drawPattern( painter );
+	updatePatternInfo();
+	validateSelection();
+
+	// Instead of drawing the whole editor, only the tiles containing
+	// rows which notes changed are marked for being rendered again.
+	size_t nBackgroundSignature = computeBackgroundSignature();
+	std::vector<size_t> rowSignatures = computeRowSignatures( nInstruments );
+
+	if ( nBackgroundSignature != m_nBackgroundSignature ||
+		 rowSignatures.size() != m_rowSignatures.size() ) {
+		m_tiles.invalidateAll();
+	}
+	else {
+		for ( int ii = 0; ii < nInstruments; ++ii ) {
+			if ( rowSignatures[ ii ] != m_rowSignatures[ ii ] ) {
+				m_tiles.invalidate( QRect( 0, ii * m_nGridHeight - 2,
+										   width(), m_nGridHeight + 4 ) );
+			}
+		}
+	}
+
+	m_nBackgroundSignature = nBackgroundSignature;
+	m_rowSignatures.swap( rowSignatures );
+}
+
+void DrumPatternEditor::renderTile( QPainter& painter, const QRect& rect ) {
+
+	painter.fillRect( rect, Preferences::get_instance()->getColorTheme()->m_windowColor );
+
+	drawBackground( painter, rect );
+
+	drawPattern( painter, rect );
 }
 
 void DrumPatternEditor::paintEvent( QPaintEvent* ev )
@@ -1295,17 +1393,34 @@ void DrumPatternEditor::paintEvent( QPaintEvent* ev )
 	}
 	
 	auto pPref = Preferences::get_instance();
-	
-	qreal pixelRatio = devicePixelRatio();
-	if ( pixelRatio != m_pBackgroundPixmap->devicePixelRatio() ) {
-		createBackground();
+
+	/*
+		BUGFIX
+
+		if m_pPattern is not renewed every time we draw a note,
+		hydrogen will crash after you save a song and create a new one.
+		-smoors
+
+		Tiles are rendered lazily from here. A pattern deleted or
+		replaced since the last createBackground() must not be
+		accessed and the tiles showing it are outdated.
+	*/
+	Pattern* pPreviousPattern = m_pPattern;
+	updatePatternInfo();
+	validateSelection();
+	if ( m_pPattern != pPreviousPattern ) {
+		m_tiles.invalidateAll();
 	}
 	
 	QPainter painter( this );
-	painter.drawPixmap( ev->rect(), *m_pBackgroundPixmap, QRectF( pixelRatio * ev->rect().x(),
-															pixelRatio * ev->rect().y(),
-															pixelRatio * ev->rect().width(),
-															pixelRatio * ev->rect().height() ) );
+	m_tiles.paint( painter, ev->rect(), devicePixelRatio(),
+				   [&]( QPainter& p, const QRect& rect ) {
+					   renderTile( p, rect ); } );
+
+	// Release tiles scrolled out of view.
+	const int nTileSize = m_tiles.getTileSize();
+	m_tiles.prune( visibleRegion().boundingRect()
+				   .adjusted( -nTileSize, -nTileSize, nTileSize, nTileSize ) );
 
 	// Draw playhead
 	if ( m_nTick != -1 ) {
@@ -1453,6 +1568,7 @@ void DrumPatternEditor::onPreferencesChanged( H2Core::Preferences::Changes chang
 {
 	if ( changes & ( H2Core::Preferences::Changes::Colors |
 					 H2Core::Preferences::Changes::Font ) ) {
+		m_tiles.invalidateAll();
 		updateEditor();
 	}
 }
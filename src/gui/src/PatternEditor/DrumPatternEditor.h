@@ -25,6 +25,7 @@
 #define DRUM_PATTERN_EDITOR_H
 
 #include "../EventListener.h"
+#include "../PixmapTileCache.h"
 #include "../Selection.h"
 #include "PatternEditor.h"
 #include "NotePropertiesRuler.h"
@@ -135,8 +136,25 @@ class DrumPatternEditor : public PatternEditor, protected WidgetWithScalableFont
 	private:
 	void createBackground() override;
 		void drawNote( H2Core::Note* note, QPainter& painter, bool bIsForeground = true );
-		void drawPattern( QPainter& painter );
-		void drawBackground( QPainter& pointer );
+		/** Draws all notes intersecting @a rect.*/
+		void drawPattern( QPainter& painter, const QRect& rect );
+		/** Draws the rows and grid lines intersecting @a rect.*/
+		void drawBackground( QPainter& pointer, const QRect& rect );
+		/** Renders both background and notes within @a rect into a
+		 * tile of #m_tiles.*/
+		void renderTile( QPainter& painter, const QRect& rect );
+		/** Hash of all properties affecting the editor as a whole,
+		 * like its dimensions, the grid, and the selected row.*/
+		size_t computeBackgroundSignature() const;
+		/** Hashes of the notes drawn in each instrument row.*/
+		std::vector<size_t> computeRowSignatures( int nInstruments );
+
+		/** Rendered content of the editor. Tiles are allocated only
+		 * for the visible part and just the rows in which notes
+		 * changed are rendered again.*/
+		PixmapTileCache m_tiles;
+		size_t m_nBackgroundSignature;
+		std::vector<size_t> m_rowSignatures;
 		void drawFocus( QPainter& painter );
 
 		virtual void keyPressEvent (QKeyEvent *ev) override;
@@ -44,6 +44,8 @@
 #include <core/AudioEngine/AudioEngine.h>
 #include <core/Helpers/Xml.h>
 
+#include <algorithm>
+
 
 using namespace std;
 using namespace H2Core;
@@ -629,7 +631,7 @@ QPoint PatternEditor::movingGridOffset( ) const {
 
 
 //! Draw lines for note grid.
-void PatternEditor::drawGridLines( QPainter &p, Qt::PenStyle style ) const
+void PatternEditor::drawGridLines( QPainter &p, Qt::PenStyle style, const QRect& rect ) const
 {
 
 	auto pPref = H2Core::Preferences::get_instance();
@@ -650,6 +652,19 @@ void PatternEditor::drawGridLines( QPainter &p, Qt::PenStyle style ) const
 
 	int nGranularity = granularity() * m_nResolution;
 
+	// Lines outside of the area are skipped. The positions are still
+	// accumulated from the very left to get identical rounding in
+	// all areas.
+	const QRect area = rect.isNull() ?
+		QRect( 0, 0, m_nEditorWidth + 1, m_nEditorHeight ) : rect;
+	const int nTop = std::max( 1, area.top() );
+	const int nBottom = std::min( m_nEditorHeight - 1, area.bottom() + 1 );
+	auto drawLine = [&]( float x ) {
+		if ( x >= area.left() - 1 && x <= area.right() + 1 ) {
+			p.drawLine( x, nTop, x, nBottom );
+		}
+	};
+
 	if ( !m_bUseTriplets ) {
 
 		// Draw vertical lines. To minimise pen colour changes (and
@@ -670,12 +685,12 @@ void PatternEditor::drawGridLines( QPainter &p, Qt::PenStyle style ) const
 		if ( m_nResolution >= nRes ) {
 			p.setPen( QPen( colorsActive[ 0 ], 1, style ) );
 			for ( float x = PatternEditor::nMargin ; x < m_nActiveWidth; x += fStep ) {
-				p.drawLine( x, 1, x, m_nEditorHeight - 1 );
+				drawLine( x );
 			}
 			
 			p.setPen( QPen( colorsInactive[ 0 ], 1, style ) );
 			for ( float x = m_nActiveWidth ; x < m_nEditorWidth; x += fStep ) {
-				p.drawLine( x, 1, x, m_nEditorHeight - 1 );
+				drawLine( x );
 			}
 		}
 		nRes *= 2;
@@ -689,12 +704,12 @@ void PatternEditor::drawGridLines( QPainter &p, Qt::PenStyle style ) const
 			nColour++;
 			p.setPen( QPen( colorsActive[ nColour ], 1, style ) );
 			for ( float x = PatternEditor::nMargin + fStep; x < m_nActiveWidth + fStep; x += fStep * 2) {
-				p.drawLine( x, 1, x, m_nEditorHeight - 1 );
+				drawLine( x );
 			}
 			
 			p.setPen( QPen( colorsInactive[ nColour ], 1, style ) );
 			for ( float x = m_nActiveWidth + fStep; x < m_nEditorWidth; x += fStep * 2) {
-				p.drawLine( x, 1, x, m_nEditorHeight - 1 );
+				drawLine( x );
 			}
 			
 			nRes *= 2;
@@ -708,25 +723,25 @@ void PatternEditor::drawGridLines( QPainter &p, Qt::PenStyle style ) const
 		float fStep = granularity() * m_fGridWidth;
 		p.setPen(  QPen( colorsActive[ 0 ], 1, style ) );
 		for ( float x = PatternEditor::nMargin; x < m_nActiveWidth; x += fStep * 3 ) {
-			p.drawLine(x, 1, x, m_nEditorHeight - 1);
+			drawLine( x );
 		}
 		
 		p.setPen(  QPen( colorsInactive[ 0 ], 1, style ) );
 		for ( float x = m_nActiveWidth; x < m_nEditorWidth; x += fStep * 3 ) {
-			p.drawLine(x, 1, x, m_nEditorHeight - 1);
+			drawLine( x );
 		}
 		
 		// Second and third marks
 		p.setPen(  QPen( colorsActive[ 2 ], 1, style ) );
 		for ( float x = PatternEditor::nMargin + fStep; x < m_nActiveWidth + fStep; x += fStep * 3 ) {
-			p.drawLine(x, 1, x, m_nEditorHeight - 1);
-			p.drawLine(x + fStep, 1, x + fStep, m_nEditorHeight - 1);
+			drawLine( x );
+			drawLine( x + fStep );
 		}
 		
 		p.setPen( QPen( colorsInactive[ 2 ], 1, style ) );
 		for ( float x = m_nActiveWidth + fStep; x < m_nEditorWidth; x += fStep * 3 ) {
-			p.drawLine(x, 1, x, m_nEditorHeight - 1);
-			p.drawLine(x + fStep, 1, x + fStep, m_nEditorHeight - 1);
+			drawLine( x );
+			drawLine( x + fStep );
 		}
 	}
 
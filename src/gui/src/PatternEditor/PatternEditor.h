@@ -251,8 +251,10 @@ protected:
 	int getColumn( int x, bool bUseFineGrained = false ) const;
 	QPoint movingGridOffset() const;
 
-	//! Draw lines for note grid.
-	void drawGridLines( QPainter &p, Qt::PenStyle style = Qt::SolidLine ) const;
+	//! Draw lines for note grid. If @a rect is not null, only lines
+	//! intersecting it are drawn.
+	void drawGridLines( QPainter &p, Qt::PenStyle style = Qt::SolidLine,
+						const QRect& rect = QRect() ) const;
 
 	//! Colour to use for outlining selected notes
 	QColor selectedNoteColor() const;
@@ -39,6 +39,7 @@ using namespace H2Core;
 #include "InstrumentEditor/InstrumentEditorPanel.h"
 #include "DrumPatternEditor.h"
 #include "../HydrogenApp.h"
+#include "../RefreshScheduler.h"
 #include "../Widgets/Button.h"
 #include "../Skin.h"
 
@@ -777,9 +778,12 @@ PatternEditorInstrumentList::PatternEditorInstrumentList( QWidget *parent, Patte
 
 	updateInstrumentLines();
 
-	m_pUpdateTimer = new QTimer( this );
-	connect( m_pUpdateTimer, SIGNAL( timeout() ), this, SLOT( updateInstrumentLines() ) );
-	m_pUpdateTimer->start(50);
+	// Frames are emitted whenever an event was dispatched or the user
+	// interacted with the GUI, which covers all changes of the
+	// instruments shown.
+	connect( HydrogenApp::get_instance()->getRefreshScheduler(),
+			 &RefreshScheduler::frame, this,
+			 &PatternEditorInstrumentList::updateInstrumentLines );
 
 	QScrollArea *pScrollArea = dynamic_cast< QScrollArea *>( parentWidget()->parentWidget() );
 	assert( pScrollArea );
@@ -791,7 +795,6 @@ PatternEditorInstrumentList::PatternEditorInstrumentList( QWidget *parent, Patte
 PatternEditorInstrumentList::~PatternEditorInstrumentList()
 {
 	//INFOLOG( "DESTROY" );
-	m_pUpdateTimer->stop();
 }
 
 
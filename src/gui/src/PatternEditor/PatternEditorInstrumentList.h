@@ -161,7 +161,6 @@ class PatternEditorInstrumentList :  public QWidget,
 		uint m_nEditorWidth;
 		uint m_nEditorHeight;
 		InstrumentLine* m_pInstrumentLine[MAX_INSTRUMENTS];
-		QTimer *m_pUpdateTimer;
 		DragScroller *m_pDragScroller;
 
 		QPoint __drag_start_position;
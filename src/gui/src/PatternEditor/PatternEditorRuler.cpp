@@ -28,7 +28,6 @@
 
 using namespace H2Core;
 
-#include <QTimer>
 #include <QPainter>
 
 #include "DrumPatternEditor.h"
@@ -36,6 +35,7 @@ using namespace H2Core;
 #include "PatternEditorPanel.h"
 #include "NotePropertiesRuler.h"
 #include "../HydrogenApp.h"
+#include "../RefreshScheduler.h"
 #include "../Skin.h"
 
 
@@ -66,9 +66,10 @@ PatternEditorRuler::PatternEditorRuler( QWidget* parent )
 									   m_nRulerHeight * pixelRatio );
 	m_pBackgroundPixmap->setDevicePixelRatio( pixelRatio );
 
-	m_pTimer = new QTimer(this);
-	connect(m_pTimer, &QTimer::timeout, [=]() {
-		if ( H2Core::Hydrogen::get_instance()->getAudioEngine()->getState() ==
+	auto pRefreshScheduler = HydrogenApp::get_instance()->getRefreshScheduler();
+	connect( pRefreshScheduler, &RefreshScheduler::frame, this, [=]() {
+		if ( isVisible() &&
+			 pRefreshScheduler->getSnapshot().state ==
 			 H2Core::AudioEngine::State::Playing ) {
 			updatePosition();
 		}
@@ -143,22 +144,10 @@ void PatternEditorRuler::relocationEvent() {
 	updatePosition();
 }
 
-void PatternEditorRuler::updateStart(bool start) {
-	if (start) {
-		m_pTimer->start(50);	// update ruler at 20 fps
-	}
-	else {
-		m_pTimer->stop();
-	}
-}
-
-
-
 void PatternEditorRuler::showEvent( QShowEvent *ev )
 {
 	UNUSED( ev );
 	updatePosition();
-	updateStart(true);
 }
 
 
@@ -169,12 +158,6 @@ void PatternEditorRuler::leaveEvent( QEvent* ev ){
 	QWidget::leaveEvent( ev );
 }
 
-void PatternEditorRuler::hideEvent ( QHideEvent *ev )
-{
-	UNUSED( ev );
-	updateStart(false);
-}
-
 void PatternEditorRuler::mousePressEvent( QMouseEvent* ev ) {
 
 	if ( ev->button() == Qt::LeftButton &&
@@ -52,7 +52,6 @@ class PatternEditorRuler :  public QWidget, protected WidgetWithScalableFont<8,
 		PatternEditorRuler& operator=( const PatternEditorRuler& rhs ) = delete;
 
 		void paintEvent(QPaintEvent *ev) override;
-		void updateStart(bool start);
 	/**
 	 * Queries the audio engine to update the current position of the
 	 * playhead.
@@ -68,7 +67,6 @@ class PatternEditorRuler :  public QWidget, protected WidgetWithScalableFont<8,
 	void updatePosition( bool bForce = false );
 
 		void showEvent( QShowEvent *ev ) override;
-		void hideEvent( QHideEvent *ev ) override;
 	void mouseMoveEvent( QMouseEvent *ev ) override;
 	void mousePressEvent( QMouseEvent *ev ) override;
 	void leaveEvent( QEvent *ev ) override;
@@ -92,7 +90,6 @@ class PatternEditorRuler :  public QWidget, protected WidgetWithScalableFont<8,
 
 		QPixmap *m_pBackgroundPixmap;
 
-		QTimer *m_pTimer;
 		int m_nTick;
 		H2Core::Pattern *m_pPattern;
 
@@ -0,0 +1,142 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+#include "PixmapTileCache.h"
+
+#include <QPainter>
+
+#include <cmath>
+
+PixmapTileCache::PixmapTileCache( int nTileSize )
+	: m_nTileSize( std::max( nTileSize, 16 ) )
+	, m_fPixelRatio( 1.0 )
+{
+}
+
+void PixmapTileCache::tileRange( const QRect& rect, int* pnFirstColumn, int* pnLastColumn,
+								 int* pnFirstRow, int* pnLastRow ) const
+{
+	*pnFirstColumn = static_cast<int>( std::floor( static_cast<float>( rect.left() ) /
+												   static_cast<float>( m_nTileSize ) ) );
+	*pnLastColumn = static_cast<int>( std::floor( static_cast<float>( rect.right() ) /
+												  static_cast<float>( m_nTileSize ) ) );
+	*pnFirstRow = static_cast<int>( std::floor( static_cast<float>( rect.top() ) /
+												static_cast<float>( m_nTileSize ) ) );
+	*pnLastRow = static_cast<int>( std::floor( static_cast<float>( rect.bottom() ) /
+											   static_cast<float>( m_nTileSize ) ) );
+}
+
+void PixmapTileCache::invalidate( const QRect& rect )
+{
+	if ( rect.isEmpty() || m_tiles.empty() ) {
+		return;
+	}
+
+	int nFirstColumn, nLastColumn, nFirstRow, nLastRow;
+	tileRange( rect, &nFirstColumn, &nLastColumn, &nFirstRow, &nLastRow );
+
+	// Only allocated tiles need to be marked. Iterating them is
+	// cheaper than probing the (possibly huge) range of indices.
+	for ( auto& [ index, tile ] : m_tiles ) {
+		if ( index.first >= nFirstColumn && index.first <= nLastColumn &&
+			 index.second >= nFirstRow && index.second <= nLastRow ) {
+			tile.bDirty = true;
+		}
+	}
+}
+
+void PixmapTileCache::invalidateAll()
+{
+	for ( auto& [ index, tile ] : m_tiles ) {
+		tile.bDirty = true;
+	}
+}
+
+void PixmapTileCache::clear()
+{
+	m_tiles.clear();
+}
+
+void PixmapTileCache::prune( const QRect& rect )
+{
+	int nFirstColumn, nLastColumn, nFirstRow, nLastRow;
+	tileRange( rect, &nFirstColumn, &nLastColumn, &nFirstRow, &nLastRow );
+
+	for ( auto it = m_tiles.begin(); it != m_tiles.end(); ) {
+		if ( it->first.first < nFirstColumn || it->first.first > nLastColumn ||
+			 it->first.second < nFirstRow || it->first.second > nLastRow ) {
+			it = m_tiles.erase( it );
+		} else {
+			++it;
+		}
+	}
+}
+
+void PixmapTileCache::paint( QPainter& painter, const QRect& rect, qreal fPixelRatio,
+							 const Renderer& render )
+{
+	if ( rect.isEmpty() ) {
+		return;
+	}
+
+	if ( fPixelRatio != m_fPixelRatio ) {
+		m_tiles.clear();
+		m_fPixelRatio = fPixelRatio;
+	}
+
+	int nFirstColumn, nLastColumn, nFirstRow, nLastRow;
+	tileRange( rect, &nFirstColumn, &nLastColumn, &nFirstRow, &nLastRow );
+
+	for ( int nRow = nFirstRow; nRow <= nLastRow; ++nRow ) {
+		for ( int nColumn = nFirstColumn; nColumn <= nLastColumn; ++nColumn ) {
+			const QRect tileRect( nColumn * m_nTileSize, nRow * m_nTileSize,
+								  m_nTileSize, m_nTileSize );
+
+			auto it = m_tiles.find( TileIndex( nColumn, nRow ) );
+			if ( it == m_tiles.end() ) {
+				Tile tile;
+				tile.pixmap = QPixmap( m_nTileSize * fPixelRatio,
+									   m_nTileSize * fPixelRatio );
+				tile.pixmap.setDevicePixelRatio( fPixelRatio );
+				tile.bDirty = true;
+				it = m_tiles.insert( { TileIndex( nColumn, nRow ), tile } ).first;
+			}
+
+			Tile& tile = it->second;
+			if ( tile.bDirty ) {
+				QPainter tilePainter( &tile.pixmap );
+				tilePainter.translate( -tileRect.topLeft() );
+				tilePainter.setClipRect( tileRect );
+				render( tilePainter, tileRect );
+				tile.bDirty = false;
+			}
+
+			const QRect target = tileRect.intersected( rect );
+			const QRect source = target.translated( -tileRect.topLeft() );
+			painter.drawPixmap( target, tile.pixmap,
+								QRectF( source.x() * fPixelRatio,
+										source.y() * fPixelRatio,
+										source.width() * fPixelRatio,
+										source.height() * fPixelRatio ) );
+		}
+	}
+}
@@ -0,0 +1,101 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+#ifndef PIXMAP_TILE_CACHE_H
+#define PIXMAP_TILE_CACHE_H
+
+#include <QtGui>
+#include <QPixmap>
+
+#include <algorithm>
+
+#include <core/Object.h>
+
+#include <functional>
+#include <map>
+#include <utility>
+
+/** Caches the rendered content of a (potentially huge) widget in
+ * square tiles of fixed size.
+ *
+ * Only tiles intersecting an area actually painted get allocated and
+ * rendered. Changes of the content are announced using invalidate(),
+ * which marks all tiles overlapping the changed area dirty. Those are
+ * rendered again the next time they are painted. Tiles far away from
+ * the visible part of the widget can be released using prune().
+ *
+ * This way memory and drawing time scale with the size of the
+ * viewport and the amount of changes instead of the size of the
+ * widget.*/
+/** \ingroup docGUI*/
+class PixmapTileCache : public H2Core::Object<PixmapTileCache>
+{
+	H2_OBJECT(PixmapTileCache)
+public:
+	/** Renders the content of the provided rectangle (in widget
+	 * coordinates). The painter is already clipped to it.*/
+	typedef std::function<void(QPainter&, const QRect&)> Renderer;
+
+	PixmapTileCache( int nTileSize = 256 );
+
+	/** Marks all tiles intersecting @a rect dirty.*/
+	void invalidate( const QRect& rect );
+	/** Marks all tiles dirty while keeping their pixmaps around.*/
+	void invalidateAll();
+	/** Releases all tiles.*/
+	void clear();
+	/** Releases all tiles not intersecting @a rect.*/
+	void prune( const QRect& rect );
+
+	/** Copies the content of @a rect onto @a painter. Tiles not
+	 * rendered yet or marked dirty are rendered using @a render
+	 * beforehand.
+	 *
+	 * \param fPixelRatio Device pixel ratio of the target widget. In
+	 *   case it changes, all tiles are rendered again.*/
+	void paint( QPainter& painter, const QRect& rect, qreal fPixelRatio,
+				const Renderer& render );
+
+	int getTileSize() const {
+		return m_nTileSize;
+	}
+	int getTileCount() const {
+		return m_tiles.size();
+	}
+
+private:
+	struct Tile {
+		QPixmap pixmap;
+		bool bDirty;
+	};
+	typedef std::pair<int,int> TileIndex;
+
+	/** Range of tile indices (inclusive) covering @a rect.*/
+	void tileRange( const QRect& rect, int* pnFirstColumn, int* pnLastColumn,
+					int* pnFirstRow, int* pnLastRow ) const;
+
+	int m_nTileSize;
+	qreal m_fPixelRatio;
+	std::map<TileIndex, Tile> m_tiles;
+};
+
+#endif
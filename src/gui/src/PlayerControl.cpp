@@ -27,6 +27,7 @@ https://www.gnu.org/licenses
 #include "PlayerControl.h"
 #include "InstrumentRack.h"
 #include "HydrogenApp.h"
+#include "RefreshScheduler.h"
 
 #include "Widgets/ClickableLabel.h"
 #include "Widgets/LCDDisplay.h"
@@ -495,9 +496,8 @@ PlayerControl::PlayerControl(QWidget *parent)
 
 	hbox->addStretch( 1000 );	// this must be the last widget in the HBOX!!
 
-	QTimer *timer = new QTimer( this );
-	connect(timer, SIGNAL(timeout()), this, SLOT(updatePlayerControl()));
-	timer->start(100);	// update player control at 10 fps
+	connect( HydrogenApp::get_instance()->getRefreshScheduler(), &RefreshScheduler::frame,
+			 this, &PlayerControl::updatePlayerControl );
 
 	m_pStatusTimer = new QTimer( this );
 	connect( m_pStatusTimer, SIGNAL( timeout() ), this, SLOT( onStatusTimerEvent() ) );
@@ -0,0 +1,168 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+#include "RefreshScheduler.h"
+
+#include <core/Hydrogen.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace H2Core;
+
+RefreshScheduler::RefreshScheduler( QObject* pParent )
+	: QObject( pParent )
+	, m_nFrameInterval( 16 )
+	, m_bFrameRequested( false )
+	, m_bSnapshotPending( false )
+	, m_nIdleFrames( 0 )
+{
+	m_snapshot.state = AudioEngine::State::Uninitialized;
+	m_snapshot.nTick = -1;
+	m_snapshot.nColumn = -1;
+	m_snapshot.nPatternTickPosition = -1;
+	m_snapshot.fBpm = 0;
+	m_snapshot.fElapsedTime = 0;
+	m_snapshot.fProcessTime = 0;
+	m_snapshot.fMaxProcessTime = 0;
+	m_snapshot.masterMeter.clear();
+
+	// Align the frames with the refresh rate of the display. Very
+	// high rates are capped since the GUI would not keep up anyway.
+	QScreen* pScreen = QGuiApplication::primaryScreen();
+	if ( pScreen != nullptr && pScreen->refreshRate() > 0 ) {
+		m_nFrameInterval = std::clamp(
+			static_cast<int>( std::round( 1000.0 / pScreen->refreshRate() ) ), 8, 50 );
+	}
+	INFOLOG( QString( "Refreshing GUI every %1 ms" ).arg( m_nFrameInterval ) );
+
+	m_pTimer = new QTimer( this );
+	m_pTimer->setTimerType( Qt::PreciseTimer );
+	m_pTimer->setInterval( m_nFrameInterval );
+	connect( m_pTimer, &QTimer::timeout, this, &RefreshScheduler::onTimeout );
+
+	// User interaction might change anything displayed.
+	qApp->installEventFilter( this );
+
+	wake();
+}
+
+RefreshScheduler::~RefreshScheduler() {
+	qApp->removeEventFilter( this );
+}
+
+bool RefreshScheduler::isActive() const {
+	return m_pTimer->isActive();
+}
+
+void RefreshScheduler::requestFrame() {
+	wake();
+}
+
+void RefreshScheduler::wake() {
+	m_bFrameRequested = true;
+	m_nIdleFrames = 0;
+	if ( ! m_pTimer->isActive() ) {
+		m_pTimer->start();
+	}
+}
+
+void RefreshScheduler::poll() {
+	if ( m_pTimer->isActive() ) {
+		return;
+	}
+
+	if ( updateSnapshot() ) {
+		// The timer takes care of delivering the change and all
+		// following ones. The snapshot must not be replaced before
+		// it was delivered since the meter values were already
+		// consumed.
+		m_bSnapshotPending = true;
+		wake();
+	}
+}
+
+void RefreshScheduler::onTimeout() {
+	bool bChanged;
+	if ( m_bSnapshotPending ) {
+		m_bSnapshotPending = false;
+		bChanged = true;
+	} else {
+		bChanged = updateSnapshot();
+	}
+
+	if ( bChanged || m_bFrameRequested ) {
+		m_nIdleFrames = 0;
+		m_bFrameRequested = false;
+		emit frame();
+	}
+	else if ( ++m_nIdleFrames >= nMaxIdleFrames ) {
+		m_pTimer->stop();
+	}
+}
+
+bool RefreshScheduler::updateSnapshot() {
+	auto pAudioEngine = Hydrogen::get_instance()->getAudioEngine();
+
+	Snapshot snapshot;
+	snapshot.state = pAudioEngine->getState();
+	snapshot.nTick = pAudioEngine->getTick();
+	snapshot.nColumn = pAudioEngine->getColumn();
+	snapshot.nPatternTickPosition = pAudioEngine->getPatternTickPosition();
+	snapshot.fBpm = pAudioEngine->getBpm();
+	snapshot.fElapsedTime = pAudioEngine->getElapsedTime();
+	snapshot.fProcessTime = pAudioEngine->getProcessTime();
+	snapshot.fMaxProcessTime = pAudioEngine->getMaxProcessTime();
+	if ( ! pAudioEngine->getMasterMeter().read( snapshot.masterMeter ) ) {
+		snapshot.masterMeter.clear();
+	}
+
+	// The processing time fluctuates constantly and is not
+	// considered a change on its own.
+	bool bChanged = snapshot.state != m_snapshot.state ||
+		snapshot.nTick != m_snapshot.nTick ||
+		snapshot.nColumn != m_snapshot.nColumn ||
+		snapshot.nPatternTickPosition != m_snapshot.nPatternTickPosition ||
+		snapshot.fBpm != m_snapshot.fBpm ||
+		snapshot.masterMeter.fPeak_L != 0 || snapshot.masterMeter.fPeak_R != 0 ||
+		m_snapshot.masterMeter.fPeak_L != 0 || m_snapshot.masterMeter.fPeak_R != 0;
+
+	m_snapshot = snapshot;
+
+	return bChanged;
+}
+
+bool RefreshScheduler::eventFilter( QObject* pObject, QEvent* pEvent ) {
+	switch ( pEvent->type() ) {
+	case QEvent::MouseButtonPress:
+	case QEvent::MouseButtonRelease:
+	case QEvent::KeyPress:
+	case QEvent::KeyRelease:
+	case QEvent::Wheel:
+		wake();
+		break;
+	default:
+		break;
+	}
+
+	return QObject::eventFilter( pObject, pEvent );
+}
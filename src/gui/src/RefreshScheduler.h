@@ -0,0 +1,129 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+#ifndef REFRESH_SCHEDULER_H
+#define REFRESH_SCHEDULER_H
+
+#include <core/Object.h>
+#include <core/AudioEngine/AudioEngine.h>
+#include <core/AudioEngine/Meter.h>
+
+#include <QtGui>
+#include <QtWidgets>
+
+/**
+ * Central clock for all GUI elements displaying the state of the
+ * audio engine, like playheads, peak meters, or the transport
+ * controls.
+ *
+ * Instead of each widget polling the engine using its own timer, the
+ * scheduler takes a Snapshot of the engine once per display frame
+ * (with the interval derived from the refresh rate of the primary
+ * screen) and emits frame(). Widgets connect to this signal and read
+ * the values from getSnapshot().
+ *
+ * Frames are only emitted while something changes: transport is
+ * rolling, audio is metered at the master output, an event was
+ * dispatched by the event queue, the user interacted with the GUI,
+ * or a widget requested another frame using requestFrame() (e.g. for
+ * falling peaks). After a couple of frames without changes the timer
+ * is stopped entirely and the engine is only probed cheaply via
+ * poll() within the already existing event queue timer of
+ * HydrogenApp.
+ *
+ * The master meter is read exclusively by the scheduler. Widgets
+ * have to use Snapshot::masterMeter instead.
+ */
+/** \ingroup docGUI*/
+class RefreshScheduler : public QObject, public H2Core::Object<RefreshScheduler>
+{
+	H2_OBJECT(RefreshScheduler)
+	Q_OBJECT
+
+public:
+	struct Snapshot {
+		H2Core::AudioEngine::State state;
+		long nTick;
+		int nColumn;
+		long nPatternTickPosition;
+		float fBpm;
+		float fElapsedTime;
+		float fProcessTime;
+		float fMaxProcessTime;
+		/** Values of the master meter published since the last
+		 * frame. All zero in case there were none.*/
+		H2Core::Meter::Values masterMeter;
+	};
+
+	explicit RefreshScheduler( QObject* pParent );
+	~RefreshScheduler();
+
+	const Snapshot& getSnapshot() const {
+		return m_snapshot;
+	}
+	/** \return Time between two frames in milliseconds.*/
+	int getFrameInterval() const {
+		return m_nFrameInterval;
+	}
+	bool isActive() const;
+
+	/** Ensures another frame will be emitted. To be called during a
+	 * frame by widgets with ongoing animations.*/
+	void requestFrame();
+	/** Starts emitting frames (again). At least one frame will be
+	 * emitted.*/
+	void wake();
+	/** Checks the engine for changes while the scheduler is idle and
+	 * wakes it up if necessary.*/
+	void poll();
+
+signals:
+	void frame();
+
+private slots:
+	void onTimeout();
+
+private:
+	/** Takes a new snapshot.
+	 *
+	 * \return whether it differs from the previous one in a way
+	 *   visible to the user.*/
+	bool updateSnapshot();
+
+	virtual bool eventFilter( QObject* pObject, QEvent* pEvent ) override;
+
+	QTimer* m_pTimer;
+	Snapshot m_snapshot;
+	int m_nFrameInterval;
+	bool m_bFrameRequested;
+	/** Whether the snapshot taken in poll() was not delivered by
+	 * a frame yet.*/
+	bool m_bSnapshotPending;
+	/** Number of consecutive frames without any change.*/
+	int m_nIdleFrames;
+
+	/** Number of frames without changes after which the timer is
+	 * stopped.*/
+	static constexpr int nMaxIdleFrames = 8;
+};
+
+#endif
@@ -21,6 +21,7 @@
  */
 
 #include <core/Basics/Sample.h>
+#include <core/Basics/WaveformPeaks.h>
 #include <core/Basics/Song.h>
 #include <core/Basics/Instrument.h>
 #include "HydrogenApp.h"
@@ -177,36 +178,29 @@ void MainSampleWaveDisplay::updateDisplay( const QString& filename )
 
 		int nSampleLength = pNewSample->get_frames();
 		m_nSampleLength = nSampleLength;
-		float nScaleFactor = nSampleLength / (width() -50);
-		if ( nScaleFactor < 1 ){
-			nScaleFactor = 1;
-		}
+
+		// The waveform is drawn with a margin of 25 pixels on both
+		// sides. Samples shorter than the available space are drawn
+		// with one frame per column.
+		const int nColumns = std::max( width() - 50, 1 );
+		const long long nSpan = std::max( nSampleLength, nColumns );
 
 		float fGain = height() / 4.0 * 1.0;
 
+		auto pPeaks = pNewSample->getWaveformPeaks();
 		auto pSampleDatal = pNewSample->get_data_l();
 		auto pSampleDatar = pNewSample->get_data_r();
 
-		unsigned nSamplePos = 0;
-		int nVall = 0;
-		int nValr = 0;
-		int newVall = 0;
-		int newValr = 0;
 		for ( int i = 0; i < width(); ++i ){
-			for ( int j = 0; j < nScaleFactor; ++j ) {
-				if ( j < nSampleLength && nSamplePos < nSampleLength) {
-					if ( pSampleDatal[ nSamplePos ] && pSampleDatar[ nSamplePos ] ){
-						newVall = static_cast<int>( pSampleDatal[ nSamplePos ] * fGain );
-						newValr = static_cast<int>( pSampleDatar[ nSamplePos ] * fGain );
-						nVall = newVall;
-						nValr = newValr;
-					}else
-					{
-						nVall = 0;	
-						nValr = 0;
-					}
-				}
-				++nSamplePos;
+			int nVall = 0;
+			int nValr = 0;
+			if ( pPeaks != nullptr && i < nColumns ) {
+				const int nStart = i * nSpan / nColumns;
+				const int nEnd = ( i + 1 ) * nSpan / nColumns;
+				nVall = static_cast<int>(
+					pPeaks->getPeak( 0, pSampleDatal, nStart, nEnd ).getExtremum() * fGain );
+				nValr = static_cast<int>(
+					pPeaks->getPeak( 1, pSampleDatar, nStart, nEnd ).getExtremum() * fGain );
 			}
 			m_pPeakDatal[ i ] = nVall;
 			m_pPeakDatar[ i ] = nValr;
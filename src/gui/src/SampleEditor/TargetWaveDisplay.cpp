@@ -21,6 +21,7 @@
  */
 
 #include <core/Basics/Sample.h>
+#include <core/Basics/WaveformPeaks.h>
 #include <core/Basics/Song.h>
 #include <core/Basics/Instrument.h>
 #include <core/Basics/InstrumentLayer.h>
@@ -210,39 +211,24 @@ void TargetWaveDisplay::updateDisplay( std::shared_ptr<H2Core::InstrumentLayer>
 {
 	if ( pLayer && pLayer->get_sample() ) {
 
-		int nSampleLength = pLayer->get_sample()->get_frames();
-		float nScaleFactor = nSampleLength / width();
+		auto pSample = pLayer->get_sample();
+		auto pPeaks = pSample->getWaveformPeaks();
+		long long nSampleLength = pSample->get_frames();
 
 		float fGain = (height() - 8) / 2.0 * pLayer->get_gain();
 
-		auto pSampleDatal = pLayer->get_sample()->get_data_l();
-		auto pSampleDatar = pLayer->get_sample()->get_data_r();
-		int nSamplePos = 0;
-		int nVall;
-		int nValr;
 		for ( int i = 0; i < width(); ++i ){
-			nVall = 0;
-			nValr = 0;
-			for ( int j = 0; j < nScaleFactor; ++j ) {
-				if ( j < nSampleLength ) {
-					if ( pSampleDatal[ nSamplePos ] < 0 ){
-						int newVal = static_cast<int>( pSampleDatal[ nSamplePos ] * -fGain );
-						nVall = newVal;
-					}else
-					{
-						int newVal = static_cast<int>( pSampleDatal[ nSamplePos ] * fGain );
-						nVall = newVal;
-					}
-					if ( pSampleDatar[ nSamplePos ] > 0 ){
-						int newVal = static_cast<int>( pSampleDatar[ nSamplePos ] * -fGain );
-						nValr = newVal;
-					}else
-					{
-						int newVal = static_cast<int>( pSampleDatar[ nSamplePos ] * fGain );
-						nValr = newVal;
-					}
-				}
-				++nSamplePos;
+			int nVall = 0;
+			int nValr = 0;
+			if ( pPeaks != nullptr ) {
+				const int nStart = i * nSampleLength / width();
+				const int nEnd = ( i + 1 ) * nSampleLength / width();
+				// The left channel is drawn above and the right one
+				// below the center line.
+				nVall = static_cast<int>(
+					pPeaks->getPeak( 0, pSample->get_data_l(), nStart, nEnd ).getMagnitude() * fGain );
+				nValr = static_cast<int>(
+					pPeaks->getPeak( 1, pSample->get_data_r(), nStart, nEnd ).getMagnitude() * -fGain );
 			}
 			m_pPeakData_Left[ i ] = nVall;
 			m_pPeakData_Right[ i ] = nValr;
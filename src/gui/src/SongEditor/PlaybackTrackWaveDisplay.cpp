@@ -21,6 +21,7 @@
  */
 
 #include <core/Basics/Sample.h>
+#include <core/Basics/WaveformPeaks.h>
 #include <core/Basics/Song.h>
 #include <core/Hydrogen.h>
 #include <core/Preferences/Preferences.h>
@@ -128,6 +129,7 @@ void PlaybackTrackWaveDisplay::updateDisplay( std::shared_ptr<H2Core::Instrument
 		m_sSampleName = m_pLayer->get_sample()->get_filename();
 		
 		auto	pSampleData = pLayer->get_sample()->get_data_l();
+		auto	pPeaks = pLayer->get_sample()->getWaveformPeaks();
 		int		nSampleLength = m_pLayer->get_sample()->get_frames();
 		float	fLengthOfPlaybackTrackInSecs = ( float )( nSampleLength / (float) m_pLayer->get_sample()->get_sample_rate() );
 		float	fRemainingLengthOfPlaybackTrack = fLengthOfPlaybackTrackInSecs;		
@@ -184,16 +186,12 @@ void PlaybackTrackWaveDisplay::updateDisplay( std::shared_ptr<H2Core::Instrument
 						nVal = 0;
 						
 						int nSamplesToRenderInThisStep =  (nSamplesToRender / nSongEditorGridWith);
-						for ( int j = 0; j < nSamplesToRenderInThisStep; ++j ) {
-							if ( nSamplePos < nSampleLength ) {
-								int newVal = (int)( pSampleData[ nSamplePos ] * fGain );
-								if ( newVal > nVal ) {
-									nVal = newVal;
-								}
-							}
-							
-							++nSamplePos;
+						if ( pPeaks != nullptr ) {
+							auto peak = pPeaks->getPeak( 0, pSampleData, nSamplePos,
+														 nSamplePos + nSamplesToRenderInThisStep );
+							nVal = (int)( peak.getMagnitude() * fGain );
 						}
+						nSamplePos += nSamplesToRenderInThisStep;
 					
 						m_pPeakData[ i ] = nVal;
 					}
@@ -28,6 +28,7 @@
 #include <core/Hydrogen.h>
 #include <core/Basics/Pattern.h>
 #include <core/Basics/PatternList.h>
+#include <core/Basics/SequenceState.h>
 #include <core/AudioEngine/AudioEngine.h>
 #include <core/EventQueue.h>
 #include <core/Helpers/Files.h>
@@ -48,6 +49,7 @@ using namespace H2Core;
 #include "SoundLibrary/SoundLibraryDatastructures.h"
 #include "../PatternEditor/PatternEditorPanel.h"
 #include "../HydrogenApp.h"
+#include "../RefreshScheduler.h"
 #include "../CommonStrings.h"
 #include "../InstrumentRack.h"
 #include "../PatternPropertiesDialog.h"
@@ -982,7 +984,16 @@ void SongEditor::paintEvent( QPaintEvent *ev )
 	auto pPref = Preferences::get_instance();
 
 	QPainter painter(this);
-	painter.drawPixmap( ev->rect(), *m_pSequencePixmap, ev->rect() );
+	m_sequenceTiles.paint( painter, ev->rect(), devicePixelRatio(),
+						   [&]( QPainter& p, const QRect& rect ) {
+							   renderSequence( p, rect ); } );
+
+	// Tiles scrolled out of view are released. A margin of one tile
+	// avoids rendering them again right away when scrolling back and
+	// forth.
+	const int nTileSize = m_sequenceTiles.getTileSize();
+	m_sequenceTiles.prune( visibleRegion().boundingRect()
+						   .adjusted( -nTileSize, -nTileSize, nTileSize, nTileSize ) );
 
 	// Draw moving selected cells
 	QColor patternColor( 0, 0, 0 );
@@ -1074,73 +1085,24 @@ void SongEditor::leaveEvent( QEvent *ev ) {
 
 void SongEditor::createBackground()
 {
-	auto pPref = H2Core::Preferences::get_instance();
 	std::shared_ptr<Song> pSong = m_pHydrogen->getSong();
 
-	uint nPatterns = pSong->getPatternList()->size();
-	int nSelectedPatternNumber = m_pHydrogen->getSelectedPatternNumber();
-	int nMaxPatternSequence = pPref->getMaxBars();
-
-	static int nOldHeight = -1;
-	int nNewHeight = m_nGridHeight * nPatterns;
-
-	if (nOldHeight != nNewHeight) {
-		// cambiamento di dimensioni...
-		if (nNewHeight == 0) {
-			nNewHeight = 1;	// the pixmap should not be empty
-		}
-
-		m_pBackgroundPixmap = new QPixmap( width(), nNewHeight );	// initialize the pixmap
-		m_pSequencePixmap = new QPixmap( width(), nNewHeight );	// initialize the pixmap
-		this->resize( QSize( width(), nNewHeight ) );
-	}
-
-	
-	m_pBackgroundPixmap->fill( pPref->getColorTheme()->m_songEditor_backgroundColor );
-
-	QPainter p( m_pBackgroundPixmap );
-	
-	for ( int ii = 0; ii < nPatterns + 1; ii++) {
-		if ( ( ii % 2 ) == 0 &&
-			 ii != nSelectedPatternNumber ) {
-			continue;
-		}
-		
-		int y = m_nGridHeight * ii;
-		
-		if ( ii == nSelectedPatternNumber ) {
-			p.fillRect( 0, y, nMaxPatternSequence * m_nGridWidth, m_nGridHeight,
-						pPref->getColorTheme()->m_songEditor_selectedRowColor );
-		} else {
-			p.fillRect( 0, y, nMaxPatternSequence * m_nGridWidth, m_nGridHeight,
-						pPref->getColorTheme()->m_songEditor_alternateRowColor );
-		}
-	}
-
-	p.setPen( QPen( pPref->getColorTheme()->m_songEditor_lineColor, 1,
-					Qt::SolidLine ) );
-
-	// vertical lines
-	for ( float ii = 0; ii <= nMaxPatternSequence + 1; ii++) {
-		float x = SongEditor::nMargin + ii * m_nGridWidth;
-		p.drawLine( x, 0, x, m_nGridHeight * nPatterns );
+	int nNewHeight = m_nGridHeight * pSong->getPatternList()->size();
+	if ( nNewHeight == 0 ) {
+		nNewHeight = 1;	// the widget should not be empty
 	}
-	
-	// horizontal lines
-	for (uint i = 0; i < nPatterns; i++) {
-		uint y = m_nGridHeight * i;
-
-		p.drawLine( 0, y, (nMaxPatternSequence * m_nGridWidth), y );
+	if ( nNewHeight != height() ) {
+		this->resize( QSize( width(), nNewHeight ) );
 	}
 
-	//~ celle
+	// Row highlighting, grid size, and colors might have changed.
+	m_sequenceTiles.invalidateAll();
 	m_bSequenceChanged = true;
 }
 
 void SongEditor::cleanUp(){
 
-	delete m_pBackgroundPixmap;
-	delete m_pSequencePixmap;
+	m_sequenceTiles.clear();
 }
 
 // Update the GridCell representation.
@@ -1161,6 +1123,7 @@ void SongEditor::updateGridCells() {
 			assert( y != -1 );
 			GridCell *pCell = &( m_gridCells[ QPoint( nColumn, y ) ] );
 			pCell->m_bActive = true;
+			pCell->m_bSelected = m_selection.isSelected( QPoint( nColumn, y ) );
 			pCell->m_fWidth = (float) pPattern->get_length() / nMaxLength;
 
 			for ( Pattern *pVPattern : *( pPattern->get_flattened_virtual_patterns() ) ) {
@@ -1189,38 +1152,112 @@ QPoint SongEditor::movingGridOffset( ) const {
 }
 
 
+QRect SongEditor::cellRect( const QPoint& cell ) const
+{
+	// The border of a cell is drawn one pixel beyond its grid
+	// area. Another pixel is added to account for rounding.
+	return QRect( SongEditor::nMargin + m_nGridWidth * cell.x() - 1,
+				  m_nGridHeight * cell.y() - 1,
+				  m_nGridWidth + 3, m_nGridHeight + 3 );
+}
+
 void SongEditor::drawSequence()
 {
-	QPainter p;
-	p.begin( m_pSequencePixmap );
-	p.drawPixmap( rect(), *m_pBackgroundPixmap, rect() );
-	p.end();
+	std::map< QPoint, GridCell > oldGridCells;
+	oldGridCells.swap( m_gridCells );
 
 	updateGridCells();
 
-	// Draw using GridCells representation
-	for ( auto it : m_gridCells ) {
-		if ( ! m_selection.isSelected( QPoint( it.first.x(), it.first.y() ) ) ) {
-			drawPattern( it.first.x(), it.first.y(),
-						 it.second.m_bDrawnVirtual, it.second.m_fWidth );
+	// Only tiles containing cells which were added, removed, or
+	// changed their appearance have to be rendered again.
+	for ( const auto& [ cell, gridCell ] : m_gridCells ) {
+		auto it = oldGridCells.find( cell );
+		if ( it == oldGridCells.end() || ! ( it->second == gridCell ) ) {
+			m_sequenceTiles.invalidate( cellRect( cell ) );
 		}
 	}
-	// We draw all selected patterns in a second run to ensure their
-	// border does have the proper color (else the bottom and left one
-	// could be overwritten by an adjecent, unselected pattern).
-	for ( auto it : m_gridCells ) {
-		if ( m_selection.isSelected( QPoint( it.first.x(), it.first.y() ) ) ) {
-			drawPattern( it.first.x(), it.first.y(),
-						 it.second.m_bDrawnVirtual, it.second.m_fWidth );
+	for ( const auto& [ cell, gridCell ] : oldGridCells ) {
+		if ( m_gridCells.find( cell ) == m_gridCells.end() ) {
+			m_sequenceTiles.invalidate( cellRect( cell ) );
+		}
+	}
+}
+
+void SongEditor::renderSequence( QPainter& p, const QRect& rect )
+{
+	auto pPref = H2Core::Preferences::get_instance();
+	std::shared_ptr<Song> pSong = m_pHydrogen->getSong();
+
+	int nPatterns = pSong->getPatternList()->size();
+	int nSelectedPatternNumber = m_pHydrogen->getSelectedPatternNumber();
+	int nMaxPatternSequence = pPref->getMaxBars();
+
+	p.fillRect( rect, pPref->getColorTheme()->m_songEditor_backgroundColor );
+
+	// Rows and columns intersecting the rendered area.
+	const int nFirstRow = std::max( rect.top() / static_cast<int>(m_nGridHeight), 0 );
+	const int nLastRow = std::min( rect.bottom() / static_cast<int>(m_nGridHeight),
+								   nPatterns );
+	const int nFirstColumn =
+		std::max( ( rect.left() - SongEditor::nMargin ) / static_cast<int>(m_nGridWidth) - 1, 0 );
+	const int nLastColumn =
+		std::min( ( rect.right() - SongEditor::nMargin ) / static_cast<int>(m_nGridWidth) + 1,
+				  nMaxPatternSequence + 1 );
+
+	for ( int ii = nFirstRow; ii <= nLastRow; ii++) {
+		if ( ( ii % 2 ) == 0 &&
+			 ii != nSelectedPatternNumber ) {
+			continue;
+		}
+		
+		int y = m_nGridHeight * ii;
+		
+		if ( ii == nSelectedPatternNumber ) {
+			p.fillRect( 0, y, nMaxPatternSequence * m_nGridWidth, m_nGridHeight,
+						pPref->getColorTheme()->m_songEditor_selectedRowColor );
+		} else {
+			p.fillRect( 0, y, nMaxPatternSequence * m_nGridWidth, m_nGridHeight,
+						pPref->getColorTheme()->m_songEditor_alternateRowColor );
+		}
+	}
+
+	p.setPen( QPen( pPref->getColorTheme()->m_songEditor_lineColor, 1,
+					Qt::SolidLine ) );
+
+	// vertical lines
+	for ( int ii = nFirstColumn; ii <= nLastColumn; ii++) {
+		float x = SongEditor::nMargin + ii * m_nGridWidth;
+		p.drawLine( x, 0, x, m_nGridHeight * nPatterns );
+	}
+	
+	// horizontal lines
+	for ( int ii = nFirstRow; ii <= nLastRow && ii < nPatterns; ii++) {
+		uint y = m_nGridHeight * ii;
+
+		p.drawLine( 0, y, (nMaxPatternSequence * m_nGridWidth), y );
+	}
+
+	// Draw using GridCells representation. We draw all selected
+	// patterns in a second run to ensure their border does have the
+	// proper color (else the bottom and left one could be overwritten
+	// by an adjecent, unselected pattern).
+	for ( bool bSelected : { false, true } ) {
+		for ( auto it = m_gridCells.lower_bound( QPoint( nFirstColumn, 0 ) );
+			  it != m_gridCells.end() && it->first.x() <= nLastColumn; ++it ) {
+			if ( it->second.m_bSelected != bSelected ||
+				 it->first.y() < nFirstRow - 1 || it->first.y() > nLastRow + 1 ) {
+				continue;
+			}
+			drawPattern( p, it->first.x(), it->first.y(),
+						 it->second.m_bDrawnVirtual, it->second.m_fWidth );
 		}
 	}
 }
 
 
 
-void SongEditor::drawPattern( int nPos, int nNumber, bool bInvertColour, double fWidth )
+void SongEditor::drawPattern( QPainter& p, int nPos, int nNumber, bool bInvertColour, double fWidth )
 {
-	QPainter p( m_pSequencePixmap );
 	/*
 	 * The default color of the cubes in rgb is 97,167,251.
 	 */
@@ -1307,7 +1344,7 @@ QRect SongEditor::getKeyboardCursorRect() {
 				  QSize( m_nGridWidth, m_nGridHeight -1 ) );
 }
 
-void SongEditor::clearThePatternSequenceVector( QString filename )
+void SongEditor::clearThePatternSequenceVector()
 {
 	Hydrogen *pHydrogen = Hydrogen::get_instance();
 
@@ -1315,9 +1352,6 @@ void SongEditor::clearThePatternSequenceVector( QString filename )
 
 	std::shared_ptr<Song> pSong = pHydrogen->getSong();
 
-	//before deleting the sequence, write a temp sequence file to disk
-	pSong->writeTempPatternList( filename );
-
 	std::vector<PatternList*> *pPatternGroupsVect = pSong->getPatternGroupVector();
 	for (uint i = 0; i < pPatternGroupsVect->size(); i++) {
 		PatternList *pPatternList = (*pPatternGroupsVect)[i];
@@ -1877,25 +1911,16 @@ void SongEditorPatternList::patternPopup_load()
 	}
 	QString patternPath = fd.selectedFiles().first();
 
-	QString prevPatternPath =
-		Files::savePatternTmp( pPattern->get_name(), pPattern, pSong,
-							   pHydrogen->getCurrentDrumkitName() );
-	if ( prevPatternPath.isEmpty() ) {
-		QMessageBox::warning( this, "Hydrogen", tr("Could not save pattern to temporary directory.") );
-		setRowSelection( RowSelection::None );
-		return;
-	}
-	QString sequencePath = Filesystem::tmp_file_path( "SEQ.xml" );
-	if ( !pSong->writeTempPatternList( sequencePath ) ) {
-		QMessageBox::warning( this, "Hydrogen", tr("Could not export sequence.") );
+	auto pSequenceState = SequenceState::create( pSong );
+	if ( pSequenceState == nullptr ) {
 		setRowSelection( RowSelection::None );
 		return;
 	}
 	Preferences::get_instance()->setLastOpenPatternDirectory( fd.directory().absolutePath() );
 
 	SE_loadPatternAction *action =
-		new SE_loadPatternAction( patternPath, prevPatternPath, sequencePath,
-								  m_nRowClicked, false );
+		new SE_loadPatternAction( patternPath, new Pattern( pPattern ),
+								  pSequenceState, m_nRowClicked, false );
 	HydrogenApp *hydrogenApp = HydrogenApp::get_instance();
 	hydrogenApp->m_pUndoStack->push( action );
 	
@@ -2015,23 +2040,14 @@ void SongEditorPatternList::patternPopup_delete()
 	auto pSong = m_pHydrogen->getSong();
 	auto pPattern = pSong->getPatternList()->get( m_nRowClicked );
 
-	QString patternPath =
-		Files::savePatternTmp( pPattern->get_name(), pPattern, pSong,
-							   m_pHydrogen->getCurrentDrumkitName() );
-	if ( patternPath.isEmpty() ) {
-		QMessageBox::warning( this, "Hydrogen", tr("Could not save pattern to temporary directory.") );
-		setRowSelection( RowSelection::None );
-		return;
-	}
-	QString sequencePath = Filesystem::tmp_file_path( "SEQ.xml" );
-	if ( !pSong->writeTempPatternList( sequencePath ) ) {
-		QMessageBox::warning( this, "Hydrogen", tr("Could not export sequence.") );
+	auto pSequenceState = SequenceState::create( pSong );
+	if ( pSequenceState == nullptr ) {
 		setRowSelection( RowSelection::None );
 		return;
 	}
 
 	SE_deletePatternFromListAction *action =
-		new SE_deletePatternFromListAction( patternPath, sequencePath,
+		new SE_deletePatternFromListAction( new Pattern( pPattern ), pSequenceState,
 											m_nRowClicked );
 	HydrogenApp *hydrogenApp = HydrogenApp::get_instance();
 	hydrogenApp->m_pUndoStack->push( action );
@@ -2051,21 +2067,15 @@ void SongEditorPatternList::patternPopup_duplicate()
 	PatternPropertiesDialog *dialog = new PatternPropertiesDialog( this, pNewPattern, m_nRowClicked, true );
 
 	if ( dialog->exec() == QDialog::Accepted ) {
-		QString filePath = Files::savePatternTmp( pNewPattern->get_name(),
-												  pNewPattern, pSong,
-												  m_pHydrogen->getCurrentDrumkitName() );
-		if ( filePath.isEmpty() ) {
-			QMessageBox::warning( this, "Hydrogen", tr("Could not save pattern to temporary directory.") );
-			setRowSelection( RowSelection::None );
-			return;
-		}
+		// The action takes ownership of the pattern.
 		SE_duplicatePatternAction *action =
-			new SE_duplicatePatternAction( filePath, m_nRowClicked + 1 );
+			new SE_duplicatePatternAction( pNewPattern, m_nRowClicked + 1 );
 		HydrogenApp::get_instance()->m_pUndoStack->push( action );
+	} else {
+		delete pNewPattern;
 	}
 
 	delete dialog;
-	delete pNewPattern;
 
 	setRowSelection( RowSelection::None );
 }
@@ -2247,16 +2257,20 @@ void SongEditorPatternList::dropEvent(QDropEvent *event)
 		QStringList tokens = sText.split( "::" );
 		QString sPatternName = tokens.at( 1 );
 
-		//create a unique sequencefilename
 		Pattern *pPattern = pSong->getPatternList()->get( nTargetPattern );
 		HydrogenApp *pHydrogenApp = HydrogenApp::get_instance();
 
-		QString oldPatternName = pPattern->get_name();
+		auto pSequenceState = SequenceState::create( pSong );
+		if ( pSequenceState == nullptr ) {
+			return;
+		}
 
-		QString sequenceFilename = Filesystem::tmp_file_path( "SEQ.xml" );
 		bool drag = false;
 		if( QString( tokens.at(0) ).contains( "drag pattern" )) drag = true;
-		SE_loadPatternAction *pAction = new SE_loadPatternAction( sPatternName, oldPatternName, sequenceFilename, nTargetPattern, drag );
+		SE_loadPatternAction *pAction =
+			new SE_loadPatternAction( sPatternName,
+									  drag ? nullptr : new Pattern( pPattern ),
+									  pSequenceState, nTargetPattern, drag );
 
 		pHydrogenApp->m_pUndoStack->push( pAction );
 	}
@@ -2404,20 +2418,18 @@ SongEditorPositionRuler::SongEditorPositionRuler( QWidget *parent )
 	createBackground();	// create m_backgroundPixmap pixmap
 	update();
 
-	m_pTimer = new QTimer(this);
-	connect(m_pTimer, &QTimer::timeout, [=]() {
-		if ( H2Core::Hydrogen::get_instance()->getAudioEngine()->getState() ==
+	auto pRefreshScheduler = HydrogenApp::get_instance()->getRefreshScheduler();
+	connect( pRefreshScheduler, &RefreshScheduler::frame, this, [=]() {
+		if ( pRefreshScheduler->getSnapshot().state ==
 			 H2Core::AudioEngine::State::Playing ) {
 			updatePosition();
 		}
 	});
-	m_pTimer->start(200);
 }
 
 
 
 SongEditorPositionRuler::~SongEditorPositionRuler() {
-	m_pTimer->stop();
 }
 
 void SongEditorPositionRuler::relocationEvent() {
@@ -37,6 +37,7 @@
 #include <core/Timeline.h>
 #include "../EventListener.h"
 #include "PatternFillDialog.h"
+#include "../PixmapTileCache.h"
 #include "../Selection.h"
 #include "../Widgets/WidgetWithScalableFont.h"
 #include "../Widgets/WidgetWithHighlightedList.h"
@@ -76,7 +77,15 @@ class SongEditor : public QWidget
 		struct GridCell {
 			bool m_bActive;
 			bool m_bDrawnVirtual;
+			bool m_bSelected;
 			float m_fWidth;
+
+			bool operator==( const GridCell& other ) const {
+				return m_bActive == other.m_bActive &&
+					m_bDrawnVirtual == other.m_bDrawnVirtual &&
+					m_bSelected == other.m_bSelected &&
+					m_fWidth == other.m_fWidth;
+			}
 		};
 	
 	public:
@@ -99,7 +108,7 @@ class SongEditor : public QWidget
 		void modifyPatternCellsAction( std::vector<QPoint> & addCells, std::vector<QPoint> & deleteCells,
 									   std::vector<QPoint> & selectCells );
 
-		void clearThePatternSequenceVector( QString filename );
+		void clearThePatternSequenceVector();
 		void updateEditorandSetTrue();
 
 		int yScrollTarget( QScrollArea *pScrollArea, int *pnPatternInView );
@@ -145,16 +154,16 @@ class SongEditor : public QWidget
 		QMenu *					m_pPopupMenu;
 
 
-		//! @name Background pixmap caching
+		//! @name Sequence tile caching
 		//!
 		//! To make painting the song editor sequence grid more efficient, the drawing uses multiple levels of lazy painting.
-		//!   * The grid background pixmap is only updated when the size of the pattern grid changes.
-		//!   * The sequence pixmap are only updated when cells are added/removed or selections change
-		//!       * the cached grid background pixmap is used when repainting the pattern
-		//!   * selections and moving cells are painted on top of the cached sequence pixmap
+		//!   * Grid and cells are rendered into tiles which are only allocated once they become visible and
+		//!     are released again when scrolled out of view.
+		//!   * Changes of the grid itself (size, selected row, colors) invalidate all tiles.
+		//!   * Cells added, removed, or (de)selected only invalidate the tiles they are drawn on.
+		//!   * selections and moving cells are painted on top of the cached tiles
 		//! @{
-		QPixmap *				m_pBackgroundPixmap;
-		QPixmap *				m_pSequencePixmap;
+		PixmapTileCache			m_sequenceTiles;
 		//! @}
 
 		//! @name Position of the keyboard input cursor
@@ -204,9 +213,14 @@ class SongEditor : public QWidget
     	void togglePatternActive( int nColumn, int nRow );
 		void setPatternActive( int nColumn, int nRow, bool bActivate );
 
+		//! Updates the grid cells and invalidates the tiles of all cells which changed.
 		void drawSequence();
+		//! Renders background and cells within @a rect.
+		void renderSequence( QPainter& p, const QRect& rect );
+		//! Area (in widget coordinates) covered by a cell including its border.
+		QRect cellRect( const QPoint& cell ) const;
   
-		void drawPattern( int pos, int number, bool invertColour, double width );
+		void drawPattern( QPainter& p, int pos, int number, bool invertColour, double width );
 		void drawFocus( QPainter& painter );
 
 		std::map< QPoint, GridCell > m_gridCells;
@@ -385,7 +399,6 @@ class SongEditorPositionRuler :  public QWidget, protected WidgetWithScalableFon
 	private:
 		H2Core::Hydrogen* 		m_pHydrogen;
 		H2Core::AudioEngine* 	m_pAudioEngine;
-		QTimer *			m_pTimer;
 		uint				m_nGridWidth;
 		static constexpr uint	m_nHeight = 50;
 
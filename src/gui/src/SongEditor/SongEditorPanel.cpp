@@ -25,6 +25,7 @@
 #include "../AudioFileBrowser/AudioFileBrowser.h"
 #include "../HydrogenApp.h"
 #include "../PatternPropertiesDialog.h"
+#include "../RefreshScheduler.h"
 #include "../SongPropertiesDialog.h"
 #include "../Skin.h"
 #include "../Widgets/AutomationPathView.h"
@@ -46,6 +47,8 @@
 #include <core/IO/JackAudioDriver.h>
 #include <core/EventQueue.h>
 
+#include <cmath>
+
 #ifdef WIN32
 #include <time.h>
 #endif
@@ -402,19 +405,17 @@ SongEditorPanel::SongEditorPanel(QWidget *pParent)
 
 	HydrogenApp::get_instance()->addEventListener( this );
 
-	m_pTimer = new QTimer(this);
-	
-	connect(m_pTimer, SIGNAL(timeout()), this, SLOT( updatePlayHeadPosition() ) );
-	connect(m_pTimer, SIGNAL(timeout()), this, SLOT( updatePlaybackFaderPeaks() ) );
-	
-	m_pTimer->start(100);
+	auto pRefreshScheduler = HydrogenApp::get_instance()->getRefreshScheduler();
+	connect( pRefreshScheduler, &RefreshScheduler::frame,
+			 this, &SongEditorPanel::updatePlayHeadPosition );
+	connect( pRefreshScheduler, &RefreshScheduler::frame,
+			 this, &SongEditorPanel::updatePlaybackFaderPeaks );
 }
 
 
 
 SongEditorPanel::~SongEditorPanel()
 {
-	m_pTimer->stop();
 }
 
 
@@ -475,17 +476,23 @@ void SongEditorPanel::updatePlaybackFaderPeaks()
 
 	
 	bool bShowPeaks = pPref->showInstrumentPeaks();
-	float fallOff = pPref->getMixerFalloffSpeed();
+	// The fall off speed used to refer to an update interval of 100
+	// ms and is scaled to the actual frame rate.
+	auto pRefreshScheduler = HydrogenApp::get_instance()->getRefreshScheduler();
+	float fallOff = std::pow( pPref->getMixerFalloffSpeed(),
+							  static_cast<float>( pRefreshScheduler->getFrameInterval() ) / 100.0f );
 	
 	// fader
 	float fOldPeak_L = m_pPlaybackTrackFader->getPeak_L();
 	float fOldPeak_R = m_pPlaybackTrackFader->getPeak_R();
 	
-	float fNewPeak_L = pInstrument->get_peak_l();
-	pInstrument->set_peak_l( 0.0f );	// reset instrument peak
-
-	float fNewPeak_R = pInstrument->get_peak_r();
-	pInstrument->set_peak_r( 0.0f );	// reset instrument peak
+	Meter::Values meterValues;
+	float fNewPeak_L = 0.0f;
+	float fNewPeak_R = 0.0f;
+	if ( pInstrument->get_meter().read( meterValues ) ) {
+		fNewPeak_L = meterValues.fPeak_L;
+		fNewPeak_R = meterValues.fPeak_R;
+	}
 
 	if (!bShowPeaks) {
 		fNewPeak_L = 0.0f;
@@ -504,6 +511,12 @@ void SongEditorPanel::updatePlaybackFaderPeaks()
 	else {
 		m_pPlaybackTrackFader->setPeak_R( fOldPeak_R / fallOff );
 	}
+
+	// Keep the frames coming till the peaks have fallen off.
+	if ( m_pPlaybackTrackFader->getPeak_L() > 0.001f ||
+		 m_pPlaybackTrackFader->getPeak_R() > 0.001f ) {
+		pRefreshScheduler->requestFrame();
+	}
 }
 
 void SongEditorPanel::vScrollTo( int value )
@@ -687,35 +700,53 @@ void SongEditorPanel::clearSequence()
 		return;
 	}
 	
-	QString filename = Filesystem::tmp_file_path( "SEQ.xml" );
-	SE_deletePatternSequenceAction *pAction = new SE_deletePatternSequenceAction( filename );
+	auto pState = SequenceState::create( Hydrogen::get_instance()->getSong() );
+	if ( pState == nullptr ) {
+		return;
+	}
+	SE_deletePatternSequenceAction *pAction = new SE_deletePatternSequenceAction( pState );
 	HydrogenApp *pH2App = HydrogenApp::get_instance();
 
 	pH2App->m_pUndoStack->push( pAction );
 }
 
 
-void SongEditorPanel::restoreGroupVector( QString filename )
+bool SongEditorPanel::checkSequenceState( std::shared_ptr<SequenceState> pState )
 {
+	if ( pState != nullptr && ! pState->isExpired() ) {
+		return true;
+	}
+
+	QMessageBox::warning( this, "Hydrogen",
+						  tr( "This step can not be undone anymore. The pattern sequence stored for it was discarded to limit the memory used by the undo history." ) );
+	return false;
+}
+
+bool SongEditorPanel::restoreGroupVector( std::shared_ptr<SequenceState> pState )
+{
+	if ( ! checkSequenceState( pState ) ) {
+		return false;
+	}
+
 	auto pHydrogen = Hydrogen::get_instance();
 	auto pAudioEngine = pHydrogen->getAudioEngine();
-	//clear the old sequese
-	std::vector<PatternList*> *pPatternGroupsVect = pHydrogen->getSong()->getPatternGroupVector();
-	for (uint i = 0; i < pPatternGroupsVect->size(); i++) {
-		PatternList *pPatternList = (*pPatternGroupsVect)[i];
-		pPatternList->clear();
-		delete pPatternList;
-	}
-	pPatternGroupsVect->clear();
 
 	pAudioEngine->lock( RIGHT_HERE );
-	pHydrogen->getSong()->readTempPatternList( filename );
+	const bool bRestored = pState->restore( pHydrogen->getSong() );
 	pHydrogen->updateSongSize();
 	pHydrogen->updateSelectedPattern( false );
 	pAudioEngine->unlock();
+
+	if ( ! bRestored ) {
+		ERRORLOG( "Unable to restore pattern sequence" );
+		QMessageBox::warning( this, "Hydrogen",
+							  tr( "The pattern sequence could not be restored." ) );
+		return false;
+	}
 	
 	m_pSongEditor->updateEditorandSetTrue();
 	updateAll();
+	return true;
 }
 
 
@@ -27,6 +27,7 @@
 #include "../EventListener.h"
 #include <core/Object.h>
 #include <core/Basics/Pattern.h>
+#include <core/Basics/SequenceState.h>
 
 #include <QtGui>
 #include <QtWidgets>
@@ -77,7 +78,16 @@ class SongEditorPanel :  public QWidget, public EventListener,  public H2Core::O
 		 * signal the user her last action was not permitted.
 		 */
 		void highlightPatternEditorLocked( bool bUseRedBackground );	
-		void restoreGroupVector( QString filename );
+		/** Restores the pattern sequence and virtual patterns
+		 * stored in @a pState.
+		 *
+		 * \return false in case @a pState could not be restored.
+		 *   The user is informed in that case.*/
+		bool restoreGroupVector( std::shared_ptr<H2Core::SequenceState> pState );
+		/** \return Whether @a pState can still be restored. If it
+		 * was expired to stay within the memory budget of the undo
+		 * history, the user is informed.*/
+		bool checkSequenceState( std::shared_ptr<H2Core::SequenceState> pState );
 		//~ Implements EventListener interface
 		/** Disables and deactivates the Timeline when an external
 		 * JACK timebase master is detected and enables it when it's
@@ -185,8 +195,6 @@ class SongEditorPanel :  public QWidget, public EventListener,  public H2Core::O
 		Button *			m_pPatternEditorLockedBtn;
 		Button *			m_pPatternEditorUnlockedBtn;
 
-		QTimer*						m_pTimer;
-		
 		AutomationPathView *		m_pAutomationPathView;
 		LCDCombo*					m_pAutomationCombo;
 
@@ -55,6 +55,8 @@
 #include <core/Basics/Sample.h>
 #include <core/Basics/Song.h>
 #include <core/Helpers/Filesystem.h>
+#include <core/Helpers/LibraryIndex.h>
+#include <core/Sampler/SamplePreview.h>
 
 using namespace H2Core;
 
@@ -139,17 +141,6 @@ SoundLibraryPanel::~SoundLibraryPanel()
 	if ( auto pH2App = HydrogenApp::get_instance() ) {
 		pH2App->removeEventListener( this );
 	}
-
-	for (uint i = 0; i < __system_drumkit_info_list.size(); ++i ) {
-		delete __system_drumkit_info_list[i];
-	}
-	__system_drumkit_info_list.clear();
-
-	for (uint i = 0; i < __user_drumkit_info_list.size(); ++i ) {
-		delete __user_drumkit_info_list[i];
-	}
-	__user_drumkit_info_list.clear();
-
 }
 
 
@@ -176,55 +167,26 @@ void SoundLibraryPanel::updateDrumkitList()
 	__user_drumkits_item->setText( 0, tr( "User drumkits" ) );
 	__user_drumkits_item->setExpanded( true );
 	__user_drumkits_item->setFont( 0, boldFont );
-	
 
-	for (uint i = 0; i < __system_drumkit_info_list.size(); ++i ) {
-		delete __system_drumkit_info_list[i];
-	}
-	__system_drumkit_info_list.clear();
+	// Only drumkits added or altered since the last update are
+	// parsed. All others are read from the index.
+	auto pIndex = LibraryIndex::get_instance();
+	pIndex->update();
 
-	for (uint i = 0; i < __user_drumkit_info_list.size(); ++i ) {
-		delete __user_drumkit_info_list[i];
-	}
-	__user_drumkit_info_list.clear();
-
-	//User drumkit list
-	QStringList usr_dks = Filesystem::usr_drumkit_list();
-	for (int i = 0; i < usr_dks.size(); ++i) {
-		QString absPath = Filesystem::usr_drumkits_dir() + usr_dks[i];
-		Drumkit *pInfo = Drumkit::load( absPath, false );
-		if (pInfo) {
-			__user_drumkit_info_list.push_back( pInfo );
-			QTreeWidgetItem* pDrumkitItem = new QTreeWidgetItem( __user_drumkits_item );
-			pDrumkitItem->setText( 0, pInfo->get_name() );
-			if ( ! m_bInItsOwnDialog ) {
-				InstrumentList *pInstrList = pInfo->get_instruments();
-				for ( uint nInstr = 0; nInstr < pInstrList->size(); ++nInstr ) {
-					auto pInstr = pInstrList->get( nInstr );
-					QTreeWidgetItem* pInstrumentItem = new QTreeWidgetItem( pDrumkitItem );
-					pInstrumentItem->setText( 0, QString( "[%1] " ).arg( nInstr + 1 ) + pInstr->get_name() );
-					pInstrumentItem->setToolTip( 0, pInstr->get_name() );
-				}
-			}
-		}
-	}
+	for ( const auto& lookup : { Filesystem::Lookup::user,
+								 Filesystem::Lookup::system } ) {
+		QTreeWidgetItem* pParentItem = lookup == Filesystem::Lookup::user ?
+			__user_drumkits_item : __system_drumkits_item;
 
-	//System drumkit list
-	QStringList sys_dks = Filesystem::sys_drumkit_list();
-	for (int i = 0; i < sys_dks.size(); ++i) {
-		QString absPath = Filesystem::sys_drumkits_dir() + sys_dks[i];
-		Drumkit *pInfo = Drumkit::load( absPath, false );
-		if (pInfo) {
-			__system_drumkit_info_list.push_back( pInfo );
-			QTreeWidgetItem* pDrumkitItem = new QTreeWidgetItem( __system_drumkits_item );
-			pDrumkitItem->setText( 0, pInfo->get_name() );
+		for ( const auto& entry : pIndex->getDrumkits( lookup ) ) {
+			QTreeWidgetItem* pDrumkitItem = new QTreeWidgetItem( pParentItem );
+			pDrumkitItem->setText( 0, entry.sName );
 			if ( ! m_bInItsOwnDialog ) {
-				InstrumentList *pInstrList = pInfo->get_instruments();
-				for ( uint nInstr = 0; nInstr < pInstrList->size(); ++nInstr ) {
-					auto pInstr = pInstrList->get( nInstr );
+				for ( int nInstr = 0; nInstr < entry.instruments.size(); ++nInstr ) {
 					QTreeWidgetItem* pInstrumentItem = new QTreeWidgetItem( pDrumkitItem );
-					pInstrumentItem->setText( 0, QString( "[%1] " ).arg( nInstr + 1 ) + pInstr->get_name() );
-					pInstrumentItem->setToolTip( 0, pInstr->get_name() );
+					pInstrumentItem->setText( 0, QString( "[%1] " ).arg( nInstr + 1 ) +
+											  entry.instruments[ nInstr ] );
+					pInstrumentItem->setToolTip( 0, entry.instruments[ nInstr ] );
 				}
 			}
 		}
@@ -346,10 +308,8 @@ void SoundLibraryPanel::on_DrumkitList_itemActivated( QTreeWidgetItem * item, in
 		QString sDrumkitName = item->parent()->text(0);
 		INFOLOG( QString(sDrumkitName) + ", instr:" + sInstrName );
 
-		auto pInstrument = Instrument::load_instrument( sDrumkitName, sInstrName );
-		pInstrument->set_muted( false );
-
-		Hydrogen::get_instance()->getAudioEngine()->getSampler()->preview_instrument( pInstrument );
+		// Loaded in the background using the cached samples.
+		Hydrogen::get_instance()->getSamplePreview()->previewInstrument( sDrumkitName, sInstrName );
 	}
 }
 
@@ -512,22 +472,10 @@ void SoundLibraryPanel::on_drumkitLoadAction()
 	// vice versa.
 	if ( sDrumkitType == __system_drumkits_item->text(0) ) {
 		
-		for ( uint i = 0; i < __system_drumkit_info_list.size(); i++ ) {
-			Drumkit *pInfo = __system_drumkit_info_list[i];
-			if ( pInfo->get_name() == sDrumkitName ) {
-				pDrumkitInfo = pInfo;
-				break;
-			}
-		}
+		pDrumkitInfo = loadDrumkitInfo( sDrumkitName, Filesystem::Lookup::system );
 	} else if ( sDrumkitType == __user_drumkits_item->text(0) ) {
 		
-		for ( uint i = 0; i < __user_drumkit_info_list.size(); i++ ) {
-			Drumkit *pInfo = __user_drumkit_info_list[i];
-			if ( pInfo->get_name() == sDrumkitName ) {
-				pDrumkitInfo = pInfo;
-				break;
-			}
-		}
+		pDrumkitInfo = loadDrumkitInfo( sDrumkitName, Filesystem::Lookup::user );
 	} else {
 		ERRORLOG( QString( "Unknown drumkit type [%1] for drumkit [%2]" )
 				  .arg( sDrumkitType ).arg( sDrumkitName ) );
@@ -598,6 +546,7 @@ void SoundLibraryPanel::on_drumkitLoadAction()
 
 				case QMessageBox::Cancel:
 					// Cancel
+					delete pDrumkitInfo;
 					return;
 			}
 		}
@@ -608,6 +557,7 @@ void SoundLibraryPanel::on_drumkitLoadAction()
 	QApplication::setOverrideCursor(Qt::WaitCursor);
 
 	pHydrogen->getCoreActionController()->loadDrumkit( pDrumkitInfo, conditionalLoad );
+	delete pDrumkitInfo;
 
 	QApplication::restoreOverrideCursor();
 }
@@ -744,22 +694,10 @@ void SoundLibraryPanel::on_drumkitPropertiesAction()
 	// and vice versa.
 	if ( sDrumkitType == __system_drumkits_item->text(0) ) {
 		
-		for ( uint i = 0; i < __system_drumkit_info_list.size(); i++ ) {
-			Drumkit *pInfo = __system_drumkit_info_list[i];
-			if ( pInfo->get_name() == sDrumkitName ) {
-				pDrumkitInfo = pInfo;
-				break;
-			}
-		}
+		pDrumkitInfo = loadDrumkitInfo( sDrumkitName, Filesystem::Lookup::system );
 	} else if ( sDrumkitType == __user_drumkits_item->text(0) ) {
 		
-		for ( uint i = 0; i < __user_drumkit_info_list.size(); i++ ) {
-			Drumkit*pInfo = __user_drumkit_info_list[i];
-			if ( pInfo->get_name() == sDrumkitName ) {
-				pDrumkitInfo = pInfo;
-				break;
-			}
-		}
+		pDrumkitInfo = loadDrumkitInfo( sDrumkitName, Filesystem::Lookup::user );
 	} else {
 		ERRORLOG( QString( "Unknown drumkit type [%1] for drumkit [%2]" )
 				  .arg( sDrumkitType ).arg( sDrumkitName ) );
@@ -779,27 +717,16 @@ void SoundLibraryPanel::on_drumkitPropertiesAction()
 	// the current lookup to decide whether to search in the system or
 	// the user folder.
 	if ( Hydrogen::get_instance()->getCurrentDrumkitLookup() == Filesystem::Lookup::system ) {
-		for ( uint i = 0; i < __system_drumkit_info_list.size(); i++ ) {
-			Drumkit *prInfo = __system_drumkit_info_list[i];
-			if ( prInfo->get_name() == sPreDrumkitName ) {
-				pPreDrumkitInfo = prInfo;
-				break;
-			}
-		}
+		pPreDrumkitInfo = loadDrumkitInfo( sPreDrumkitName, Filesystem::Lookup::system );
 	} else {
-		for ( uint i = 0; i < __user_drumkit_info_list.size(); i++ ) {
-			Drumkit *prInfo = __user_drumkit_info_list[i];
-			if ( prInfo->get_name() == sPreDrumkitName ) {
-				pPreDrumkitInfo = prInfo;
-				break;
-			}
-		}
+		pPreDrumkitInfo = loadDrumkitInfo( sPreDrumkitName, Filesystem::Lookup::user );
 	}
 
 	if ( pPreDrumkitInfo == nullptr ){
 		QMessageBox::warning( this, "Hydrogen", QString( "%1 [%2]")
 							  .arg( HydrogenApp::get_instance()->getCommonStrings()->getSoundLibraryFailedPreDrumkitLoad() )
 							  .arg(sPreDrumkitName) );
+		delete pDrumkitInfo;
 		return;
 	}
 	assert( pPreDrumkitInfo );
@@ -807,6 +734,19 @@ void SoundLibraryPanel::on_drumkitPropertiesAction()
 	//open the soundlibrary save dialog
 	SoundLibraryPropertiesDialog dialog( this, pDrumkitInfo, pPreDrumkitInfo, false );
 	dialog.exec();
+
+	delete pDrumkitInfo;
+	delete pPreDrumkitInfo;
+}
+
+Drumkit* SoundLibraryPanel::loadDrumkitInfo( const QString& sDrumkitName,
+											 Filesystem::Lookup lookup )
+{
+	LibraryIndex::DrumkitEntry entry;
+	if ( ! LibraryIndex::get_instance()->findDrumkit( sDrumkitName, lookup, &entry ) ) {
+		return nullptr;
+	}
+	return Drumkit::load( entry.sPath, false );
 }
 
 
@@ -30,6 +30,7 @@
 #include <vector>
 
 #include <core/Object.h>
+#include <core/Helpers/Filesystem.h>
 #include <core/Preferences/Preferences.h>
 
 #include "../Widgets/WidgetWithScalableFont.h"
@@ -100,13 +101,18 @@ private:
 	QTreeWidgetItem* __pattern_item;
 	QTreeWidgetItem* __pattern_item_list;
 
-	std::vector<H2Core::Drumkit*> __system_drumkit_info_list;
-	std::vector<H2Core::Drumkit*> __user_drumkit_info_list;
 	bool __expand_pattern_list;
 	bool __expand_songs_list;
 	void restore_background_color();
 	void change_background_color();
 
+	/** Loads the drumkit (without samples) listed as @a sDrumkitName
+	 * in the tree using the path stored in the H2Core::LibraryIndex.
+	 *
+	 * \return Drumkit owned by the caller or nullptr on failure.*/
+	H2Core::Drumkit* loadDrumkitInfo( const QString& sDrumkitName,
+									  H2Core::Filesystem::Lookup lookup );
+
 	/** Whether the dialog was constructed via a click in the MainForm
 	 * or as part of the GUI.
 	 */
@@ -33,6 +33,7 @@
 #include <core/Basics/Note.h>
 #include <core/Basics/Pattern.h>
 #include <core/Basics/AutomationPath.h>
+#include <core/Basics/SequenceState.h>
 #include <core/Helpers/Filesystem.h>
 
 #include "HydrogenApp.h"
@@ -100,52 +101,68 @@ private:
 class SE_deletePatternSequenceAction : public QUndoCommand
 {
 public:
-	explicit SE_deletePatternSequenceAction(  QString pFilename ){
+	explicit SE_deletePatternSequenceAction( std::shared_ptr<H2Core::SequenceState> pSequenceState ){
 		setText( QObject::tr( "Delete complete pattern-sequence" ) );
-		__pFilename = pFilename ;
+		m_pSequenceState = pSequenceState;
 	}
 	virtual void undo()
 	{
 		//qDebug() << "Delete complete pattern-sequence  undo";
 		HydrogenApp* h2app = HydrogenApp::get_instance();
-		h2app->getSongEditorPanel()->restoreGroupVector( __pFilename );
+		if ( ! h2app->getSongEditorPanel()->restoreGroupVector( m_pSequenceState ) ) {
+			// Removes the command from the undo stack.
+			setObsolete( true );
+		}
 	}
 
 	virtual void redo()
 	{
 		//qDebug() << "Delete complete pattern-sequence redo " ;
 		HydrogenApp* h2app = HydrogenApp::get_instance();
-		h2app->getSongEditorPanel()->getSongEditor()->clearThePatternSequenceVector( __pFilename );
+		h2app->getSongEditorPanel()->getSongEditor()->clearThePatternSequenceVector();
 	}
 private:
-	QString __pFilename;
+	std::shared_ptr<H2Core::SequenceState> m_pSequenceState;
 };
 
 /** \ingroup docGUI*/
 class SE_deletePatternFromListAction : public QUndoCommand
 {
 public:
-	SE_deletePatternFromListAction( QString sPatternFilename,
-									QString sSequenceFilename,
+	/** Takes ownership of @a pPattern, a copy of the pattern to
+	 * be deleted.*/
+	SE_deletePatternFromListAction( H2Core::Pattern* pPattern,
+									std::shared_ptr<H2Core::SequenceState> pSequenceState,
 									int nPatternPosition ){
 		setText( QObject::tr( "Delete pattern from list" ) );
-		m_sPatternFilename =  sPatternFilename;
-		m_sSequenceFilename = sSequenceFilename;
+		m_pPattern = pPattern;
+		m_pSequenceState = pSequenceState;
 		m_nPatternPosition = nPatternPosition;
 	}
+	~SE_deletePatternFromListAction() {
+		delete m_pPattern;
+	}
 	virtual void undo() {
 		HydrogenApp* h2app = HydrogenApp::get_instance();
-		H2Core::Hydrogen::get_instance()->getCoreActionController()->openPattern( m_sPatternFilename,
-																		  m_nPatternPosition );
-		h2app->getSongEditorPanel()->restoreGroupVector( m_sSequenceFilename );
+		// Nothing is altered in case the sequence can not be
+		// restored.
+		if ( ! h2app->getSongEditorPanel()->checkSequenceState( m_pSequenceState ) ) {
+			setObsolete( true );
+			return;
+		}
+		H2Core::Hydrogen::get_instance()->getCoreActionController()->setPattern( new H2Core::Pattern( m_pPattern ),
+																				 m_nPatternPosition );
+		if ( ! h2app->getSongEditorPanel()->restoreGroupVector( m_pSequenceState ) ) {
+			setObsolete( true );
+		}
 	}
 
 	virtual void redo() {
 		H2Core::Hydrogen::get_instance()->getCoreActionController()->removePattern( m_nPatternPosition );
 	}
 private:
-	QString m_sPatternFilename;
-	QString m_sSequenceFilename;
+	H2Core::Pattern* m_pPattern;
+	std::shared_ptr<H2Core::SequenceState> m_pSequenceState;
 	int m_nPatternPosition;
 };
 
@@ -192,20 +209,25 @@ private:
 class SE_duplicatePatternAction : public QUndoCommand
 {
 public:
-	SE_duplicatePatternAction( QString patternFilename, int patternPosition ){
+	/** Takes ownership of @a pPattern.*/
+	SE_duplicatePatternAction( H2Core::Pattern* pPattern, int patternPosition ){
 		setText( QObject::tr( "Duplicate pattern" ) );
-		m_sPatternFilename = patternFilename;
+		m_pPattern = pPattern;
 		m_nPatternPosition = patternPosition;
 	}
+	~SE_duplicatePatternAction() {
+		delete m_pPattern;
+	}
 	virtual void undo() {
 		H2Core::Hydrogen::get_instance()->getCoreActionController()->removePattern( m_nPatternPosition );
 	}
 
 	virtual void redo() {
-		H2Core::Hydrogen::get_instance()->getCoreActionController()->openPattern( m_sPatternFilename, m_nPatternPosition );
+		H2Core::Hydrogen::get_instance()->getCoreActionController()->setPattern( new H2Core::Pattern( m_pPattern ),
+																				 m_nPatternPosition );
 	}
 private:
-	QString m_sPatternFilename;
+	H2Core::Pattern* m_pPattern;
 	int m_nPatternPosition;
 };
 
@@ -240,26 +262,39 @@ private:
 class SE_loadPatternAction : public QUndoCommand
 {
 public:
-	SE_loadPatternAction( QString sPatternName, QString sOldPatternName,
-						  QString sSequenceFilename, int nPatternPosition,
-						  bool bDragFromList){
+	/** Takes ownership of @a pOldPattern, a copy of the pattern to
+	 * be replaced. It may be nullptr in case @a bDragFromList is
+	 * set.*/
+	SE_loadPatternAction( QString sPatternName, H2Core::Pattern* pOldPattern,
+						  std::shared_ptr<H2Core::SequenceState> pSequenceState,
+						  int nPatternPosition, bool bDragFromList){
 		setText( QObject::tr( "Load/drag pattern" ) );
 		m_sPatternName =  sPatternName;
-		m_sOldPatternName = sOldPatternName;
-		m_sSequenceFilename = sSequenceFilename;
+		m_pOldPattern = pOldPattern;
+		m_pSequenceState = pSequenceState;
 		m_nPatternPosition = nPatternPosition;
 		m_bDragFromList = bDragFromList;
 	}
+	~SE_loadPatternAction() {
+		delete m_pOldPattern;
+	}
 	virtual void undo() {
 		auto pCoreActionController = H2Core::Hydrogen::get_instance()->getCoreActionController();
 		HydrogenApp* h2app = HydrogenApp::get_instance();
-		if( m_bDragFromList ){
-			pCoreActionController->removePattern( m_nPatternPosition );
-		} else {
-			pCoreActionController->removePattern( m_nPatternPosition );
-			pCoreActionController->openPattern( m_sOldPatternName, m_nPatternPosition );
+		// Nothing is altered in case the sequence can not be
+		// restored.
+		if ( ! h2app->getSongEditorPanel()->checkSequenceState( m_pSequenceState ) ) {
+			setObsolete( true );
+			return;
+		}
+		pCoreActionController->removePattern( m_nPatternPosition );
+		if( ! m_bDragFromList && m_pOldPattern != nullptr ){
+			pCoreActionController->setPattern( new H2Core::Pattern( m_pOldPattern ),
+											   m_nPatternPosition );
+		}
+		if ( ! h2app->getSongEditorPanel()->restoreGroupVector( m_pSequenceState ) ) {
+			setObsolete( true );
 		}
-		h2app->getSongEditorPanel()->restoreGroupVector( m_sSequenceFilename );
 	}
 
 	virtual void redo() {
@@ -271,8 +306,8 @@ public:
 	}
 private:
 	QString m_sPatternName;
-	QString m_sOldPatternName;
-	QString m_sSequenceFilename;
+	H2Core::Pattern* m_pOldPattern;
+	std::shared_ptr<H2Core::SequenceState> m_pSequenceState;
 	int m_nPatternPosition;
 	bool m_bDragFromList;
 };
@@ -26,11 +26,12 @@
 #include <core/AudioEngine/AudioEngine.h>
 
 #include "../HydrogenApp.h"
+#include "../RefreshScheduler.h"
 
 CpuLoadWidget::CpuLoadWidget( QWidget *pParent )
  : QWidget( pParent )
  , m_fValue( 0 )
- , m_nXRunValue( 0 )
+ , m_bXRun( false )
  , m_size( QSize( 96, 10 ) )
 {
 	setAttribute(Qt::WA_OpaquePaintEvent);
@@ -43,9 +44,8 @@ CpuLoadWidget::CpuLoadWidget( QWidget *pParent )
 		ii = 0;
 	}
 
-	QTimer* pTimer = new QTimer(this);
-	connect( pTimer, SIGNAL( timeout() ), this, SLOT( updateCpuLoadWidget() ) );
-	pTimer->start( 100 );	// update player control at 10 fps
+	connect( HydrogenApp::get_instance()->getRefreshScheduler(), &RefreshScheduler::frame,
+			 this, &CpuLoadWidget::updateCpuLoadWidget );
 
 	HydrogenApp::get_instance()->addEventListener( this );
 
@@ -91,7 +91,7 @@ void CpuLoadWidget::paintEvent( QPaintEvent*)
 	painter.fillRect( QRectF( fBorderWidth / 2, fBorderWidth / 2, fPeak, m_size.height() - fBorderWidth ), QBrush( gradient ) );
 		
 	QPen pen;
-	if ( m_nXRunValue > 0 ) {
+	if ( m_bXRun ) {
 		pen.setColor( colorGradientRed );
 	} else {
 		pen.setColor( colorBorder );
@@ -117,11 +117,29 @@ void CpuLoadWidget::paintEvent( QPaintEvent*)
 
 void CpuLoadWidget::updateCpuLoadWidget()
 {
+	auto pRefreshScheduler = HydrogenApp::get_instance()->getRefreshScheduler();
+	const auto now = std::chrono::steady_clock::now();
+
+	if ( m_bXRun ) {
+		if ( now - m_lastXRun >= std::chrono::milliseconds( nXRunDuration ) ) {
+			m_bXRun = false;
+			update();
+		} else {
+			// Ensure the red outline will be removed again.
+			pRefreshScheduler->requestFrame();
+		}
+	}
+
+	if ( now - m_lastSample < std::chrono::milliseconds( nSampleInterval ) ) {
+		return;
+	}
+	m_lastSample = now;
+
 	// Process time
-	H2Core::AudioEngine *pAudioEngine = H2Core::Hydrogen::get_instance()->getAudioEngine();
+	const auto& snapshot = pRefreshScheduler->getSnapshot();
 	float fPercentage = 0;
-	if ( pAudioEngine->getMaxProcessTime() != 0.0 ) {
-		fPercentage = ( pAudioEngine->getProcessTime() / pAudioEngine->getMaxProcessTime() );
+	if ( snapshot.fMaxProcessTime != 0.0 ) {
+		fPercentage = ( snapshot.fProcessTime / snapshot.fMaxProcessTime );
 	}
 
 	if ( fPercentage > 1.0 ) {
@@ -135,10 +153,6 @@ void CpuLoadWidget::updateCpuLoadWidget()
 	}
 	m_recentValues[ 0 ] = fPercentage;
 
-	if ( m_nXRunValue > 0 ){
-		m_nXRunValue--;
-	}
-
 	update();
 }
 
@@ -146,7 +160,9 @@ void CpuLoadWidget::updateCpuLoadWidget()
 
 void CpuLoadWidget::XRunEvent()
 {
-	m_nXRunValue = 31;
+	m_bXRun = true;
+	m_lastXRun = std::chrono::steady_clock::now();
+	HydrogenApp::get_instance()->getRefreshScheduler()->requestFrame();
 
 	update();
 }
@@ -61,7 +61,15 @@ private slots:
 private:
 	std::vector<float> m_recentValues;
 	float m_fValue;
-	uint m_nXRunValue;
+	/** Whether the outline is currently painted in red.*/
+	bool m_bXRun;
+	std::chrono::steady_clock::time_point m_lastXRun;
+	/** The load is sampled at most every #nSampleInterval
+	 * milliseconds regardless of the frame rate of the
+	 * RefreshScheduler.*/
+	std::chrono::steady_clock::time_point m_lastSample;
+	static constexpr int nSampleInterval = 100;
+	static constexpr int nXRunDuration = 1500;
 	QSize m_size;
 	
 	virtual void paintEvent( QPaintEvent *ev ) override;
@@ -21,18 +21,27 @@
 
 #include <cppunit/extensions/HelperMacros.h>
 
+#include <QDir>
 #include <QString>
 #include <core/EventQueue.h>
 #include <core/Helpers/Filesystem.h>
+#include <core/Helpers/Xml.h>
 #include <core/Hydrogen.h>
+#include <core/Basics/Instrument.h>
 #include <core/Basics/InstrumentList.h>
 #include <core/Basics/InstrumentComponent.h>
+#include <core/Basics/Pattern.h>
 #include <core/Basics/PatternList.h>
+#include <core/Basics/SequenceState.h>
+#include <core/Basics/Note.h>
+#include <core/Synth/Synth.h>
 #include "TestHelper.h"
 #include "AudioBenchmark.h"
 
+#include <algorithm>
 #include <memory>
 #include <ctime>
+#include <vector>
 
 using namespace H2Core;
 
@@ -51,6 +60,11 @@ static long long exportCurrentSong( const QString &fileName, int nSampleRate )
 		return 0;
 	}
 
+	// Events left over by previous tests must not end the export
+	// loop below prematurely.
+	while ( pQueue->pop_event().type != EVENT_NONE ) {
+	}
+
 	pHydrogen->startExportSession( nSampleRate, 16 );
 	pHydrogen->startExportSong( fileName );
 
@@ -128,6 +142,154 @@ static void timeADSR() {
 	qDebug() << "ADSR time: " << showTimes( times, nFrames );
 }
 
+/** Loads all demo songs several times using either a cold or a warm
+ * XML validation cache.*/
+static void timeSongLoading() {
+	QStringList songs;
+	for ( const auto& sSong : QDir( Filesystem::demos_dir() )
+			  .entryList( QStringList( "*.h2song" ), QDir::Files ) ) {
+		songs << Filesystem::demos_dir() + "/" + sSong;
+	}
+	const int nIterations = 5;
+	const bool bWasEnabled = XMLDoc::isValidationCacheEnabled();
+
+	for ( bool bCache : { false, true } ) {
+		XMLDoc::setValidationCacheEnabled( bCache );
+		XMLDoc::clearValidationCache();
+		if ( bCache ) {
+			// Populate the cache.
+			for ( const auto& sSong : songs ) {
+				Song::load( sSong );
+			}
+		}
+
+		std::vector< clock_t > times;
+		for ( int i = 0; i < nIterations; i++ ) {
+			std::clock_t start = std::clock();
+			for ( const auto& sSong : songs ) {
+				CPPUNIT_ASSERT( Song::load( sSong ) != nullptr );
+			}
+			times.push_back( std::clock() - start );
+		}
+
+		// "frames" in the output correspond to songs.
+		qDebug() << ( bCache ? "Song loading (validation cache):" :
+					  "Song loading (no validation cache):" )
+				 << showTimes( times, songs.size() );
+	}
+
+	XMLDoc::setValidationCacheEnabled( bWasEnabled );
+}
+
+/** Stores and restores the pattern sequence of a song with 1000
+ * patterns and 1000 columns, as done by the undo actions of the
+ * SongEditor, using either temporary XML files or SequenceState.*/
+static void timeSequenceUndo() {
+	const int nPatterns = 1000;
+	const int nIterations = 20;
+
+	auto pAudioEngine = Hydrogen::get_instance()->getAudioEngine();
+	pAudioEngine->lock( RIGHT_HERE );
+
+	auto pSong = Song::getEmptySong();
+	auto pPatternList = pSong->getPatternList();
+	while ( pPatternList->size() < nPatterns ) {
+		pPatternList->add( new Pattern( QString( "Pattern %1" )
+										.arg( pPatternList->size() + 1 ) ) );
+	}
+	auto pColumns = pSong->getPatternGroupVector();
+	auto clearSequence = [&]() {
+		for ( auto& pColumn : *pColumns ) {
+			pColumn->clear();
+			delete pColumn;
+		}
+		pColumns->clear();
+	};
+
+	clearSequence();
+	for ( int ii = 0; ii < nPatterns; ++ii ) {
+		auto pColumn = new PatternList();
+		pColumn->add( pPatternList->get( ii ) );
+		pColumn->add( pPatternList->get( ( ii * 7 ) % nPatterns ) );
+		pColumns->push_back( pColumn );
+	}
+
+	const QString sSequencePath = Filesystem::tmp_file_path( "SEQ.xml" );
+	std::vector< clock_t > times;
+	for ( int i = 0; i < nIterations; i++ ) {
+		std::clock_t start = std::clock();
+		CPPUNIT_ASSERT( pSong->writeTempPatternList( sSequencePath ) );
+		clearSequence();
+		pSong->readTempPatternList( sSequencePath );
+		times.push_back( std::clock() - start );
+		CPPUNIT_ASSERT( pColumns->size() == nPatterns );
+	}
+	Filesystem::rm( sSequencePath );
+	// "frames" in the output correspond to undo steps.
+	qDebug() << "Sequence undo (temporary file):" << showTimes( times, 1 );
+
+	times.clear();
+	for ( int i = 0; i < nIterations; i++ ) {
+		std::clock_t start = std::clock();
+		auto pState = SequenceState::create( pSong );
+		clearSequence();
+		CPPUNIT_ASSERT( pState->restore( pSong ) );
+		times.push_back( std::clock() - start );
+		CPPUNIT_ASSERT( pColumns->size() == nPatterns );
+	}
+	qDebug() << "Sequence undo (in memory):" << showTimes( times, 1 );
+
+	pAudioEngine->unlock();
+}
+
+/** Renders 128 notes using the scalar sin() loop the Synth used
+ * before and using the wavetable voices of the Synth.*/
+static void timeSynth() {
+	const int nFrames = 1024;
+	const int nNotes = Synth::nMaxVoices;
+	const int nIterations = 100;
+	std::vector<float> out_L( nFrames ), out_R( nFrames );
+	std::vector< clock_t > times;
+
+	// Reference: sin() per frame and note.
+	std::vector<float> thetas( nNotes, 0.0 );
+	for ( int i = 0; i < nIterations; i++ ) {
+		std::clock_t start = std::clock();
+		std::fill( out_L.begin(), out_L.end(), 0.0 );
+		std::fill( out_R.begin(), out_R.end(), 0.0 );
+		for ( auto& fTheta : thetas ) {
+			const float fFrequency = TWOPI * 220.0 / 44100.0;
+			for ( int j = 0; j < nFrames; j++ ) {
+				float fVal = sin( fTheta ) * 0.5;
+				out_L[ j ] += fVal;
+				out_R[ j ] += fVal;
+				fTheta += fFrequency;
+			}
+		}
+		times.push_back( std::clock() - start );
+	}
+	qDebug() << "Synth (sin() loop):" << showTimes( times, nFrames * nNotes );
+
+	auto pInstrument = std::make_shared<Instrument>();
+	for ( const auto shape : { Wavetable::Shape::Sine, Wavetable::Shape::Saw } ) {
+		Synth synth;
+		for ( int i = 0; i < nNotes; i++ ) {
+			synth.noteOn( new Note( pInstrument, 0, 0.5, 0.f, -1, i % 24 ), shape );
+		}
+
+		times.clear();
+		for ( int i = 0; i < nIterations; i++ ) {
+			std::clock_t start = std::clock();
+			synth.process( nFrames );
+			times.push_back( std::clock() - start );
+		}
+		CPPUNIT_ASSERT( synth.getPlayingNotesNumber() == nNotes );
+		qDebug() << ( shape == Wavetable::Shape::Sine ? "Synth (sine wavetable):" :
+					  "Synth (saw wavetable):" )
+				 << showTimes( times, nFrames * nNotes );
+	}
+}
+
 static void timeExport( int nSampleRate ) {
 	auto outFile = Filesystem::tmp_file_path("test.wav");
 	Hydrogen *pHydrogen = Hydrogen::get_instance();
@@ -172,6 +334,15 @@ void AudioBenchmark::audioBenchmark(void)
 	qDebug() << "Benchmark ADSR method:";
 	timeADSR();
 
+	qDebug() << "Benchmark song loading:";
+	timeSongLoading();
+
+	qDebug() << "Benchmark undo of the pattern sequence:";
+	timeSequenceUndo();
+
+	qDebug() << "Benchmark synth voices:";
+	timeSynth();
+
 	auto songFile = H2TEST_FILE("functional/test.h2song");
 	auto songADSRFile = H2TEST_FILE("functional/test_adsr.h2song");
 
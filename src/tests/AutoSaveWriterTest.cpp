@@ -0,0 +1,79 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+#include <core/Basics/Song.h>
+#include <core/Helpers/AutoSaveWriter.h>
+#include <core/Helpers/Filesystem.h>
+
+#include <QFile>
+#include <QTemporaryDir>
+
+#include "AutoSaveWriterTest.h"
+
+using namespace H2Core;
+
+void AutoSaveWriterTest::testSkipUnmodified() {
+	QTemporaryDir tmpDir;
+	CPPUNIT_ASSERT( tmpDir.isValid() );
+	const QString sPath = tmpDir.filePath( "autosave.h2song" );
+
+	const QString sSongPath = Filesystem::demos_dir() + "/GM_kit_demo1.h2song";
+	auto pSong = Song::load( sSongPath );
+	CPPUNIT_ASSERT( pSong != nullptr );
+	pSong->setIsModified( true );
+
+	AutoSaveWriter writer;
+	CPPUNIT_ASSERT( writer.save( pSong, sPath ) );
+	writer.waitForFinished();
+	CPPUNIT_ASSERT( writer.getWriteCount() == 1 );
+	CPPUNIT_ASSERT( QFile::exists( sPath ) );
+
+	// Neither the filename nor the modification state must be
+	// touched.
+	CPPUNIT_ASSERT( pSong->getFilename() == sSongPath );
+	CPPUNIT_ASSERT( pSong->getIsModified() );
+
+	auto pLoaded = Song::load( sPath );
+	CPPUNIT_ASSERT( pLoaded != nullptr );
+	CPPUNIT_ASSERT( pLoaded->getName() == pSong->getName() );
+	CPPUNIT_ASSERT( pLoaded->getPatternList()->size() ==
+					pSong->getPatternList()->size() );
+
+	// Nothing changed.
+	CPPUNIT_ASSERT( ! writer.save( pSong, sPath ) );
+
+	// Marked as modified but with identical content.
+	pSong->setIsModified( true );
+	CPPUNIT_ASSERT( writer.save( pSong, sPath ) );
+	writer.waitForFinished();
+	CPPUNIT_ASSERT( writer.getWriteCount() == 1 );
+
+	pSong->setName( pSong->getName() + " (modified)" );
+	pSong->setIsModified( true );
+	CPPUNIT_ASSERT( writer.save( pSong, sPath ) );
+	writer.waitForFinished();
+	CPPUNIT_ASSERT( writer.getWriteCount() == 2 );
+
+	pLoaded = Song::load( sPath );
+	CPPUNIT_ASSERT( pLoaded != nullptr );
+	CPPUNIT_ASSERT( pLoaded->getName() == pSong->getName() );
+}
@@ -0,0 +1,108 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#include "DrumkitInstallTest.h"
+
+#include <core/Basics/Drumkit.h>
+#include <core/Basics/InstrumentList.h>
+#include <core/Helpers/Filesystem.h>
+
+#include <QDir>
+#include <QTemporaryDir>
+
+#include <map>
+
+#include "TestHelper.h"
+
+using namespace H2Core;
+
+void DrumkitInstallTest::testInstallConcurrent()
+{
+	QTemporaryDir archiveDir( Filesystem::tmp_dir() + "-XXXXXX" );
+	CPPUNIT_ASSERT( archiveDir.isValid() );
+
+	// Number of instruments of each drumkit indexed by its folder
+	// name.
+	std::map<QString, int> expectedInstruments;
+	QStringList archives;
+
+	for ( const QString& sKit : QStringList() << "baseKit" << "legacy_GMkit" ) {
+		// Do not upgrade the kits in the test data folder.
+		Drumkit* pDrumkit = Drumkit::load(
+			H2TEST_FILE( "drumkits/" + sKit ), false, false, true );
+		CPPUNIT_ASSERT( pDrumkit != nullptr );
+		CPPUNIT_ASSERT( pDrumkit->exportTo( archiveDir.path(), "", true, true ) );
+		expectedInstruments[ pDrumkit->getExportName( "", true ) ] =
+			pDrumkit->get_instruments()->size();
+		archives << archiveDir.path() + "/" +
+			pDrumkit->getExportName( "", true ) + Filesystem::drumkit_ext;
+		delete pDrumkit;
+	}
+	archives << H2TEST_FILE( "drumkits/legacyKits/Boss_DR-110.h2drumkit" );
+	expectedInstruments[ "Boss_DR-110" ] = -1;
+
+	for ( const auto& sArchive : archives ) {
+		CPPUNIT_ASSERT( Filesystem::file_readable( sArchive, true ) );
+	}
+
+	QTemporaryDir target( Filesystem::tmp_dir() + "-XXXXXX" );
+	CPPUNIT_ASSERT( target.isValid() );
+	CPPUNIT_ASSERT( Drumkit::install( archives, target.path(), true ) );
+
+	const QStringList folders =
+		QDir( target.path() ).entryList( QDir::Dirs | QDir::NoDotAndDotDot );
+	CPPUNIT_ASSERT_EQUAL( archives.size(), folders.size() );
+
+	for ( const auto& sFolder : folders ) {
+		CPPUNIT_ASSERT( expectedInstruments.find( sFolder ) !=
+						expectedInstruments.end() );
+		const QString sKitPath = target.path() + "/" + sFolder;
+		CPPUNIT_ASSERT( Filesystem::file_exists(
+							Filesystem::drumkit_file( sKitPath ), true ) );
+
+		// All samples have to be loadable.
+		Drumkit* pInstalled = Drumkit::load( sKitPath, true, false, true );
+		CPPUNIT_ASSERT( pInstalled != nullptr );
+		CPPUNIT_ASSERT( pInstalled->samples_loaded() );
+		if ( expectedInstruments[ sFolder ] >= 0 ) {
+			CPPUNIT_ASSERT_EQUAL( expectedInstruments[ sFolder ],
+								  pInstalled->get_instruments()->size() );
+		}
+		delete pInstalled;
+	}
+}
+
+void DrumkitInstallTest::testInstallFailure()
+{
+	const QString sDrumkitPath =
+		H2TEST_FILE( "drumkits/legacyKits/Boss_DR-110.h2drumkit" );
+
+	QTemporaryDir target( Filesystem::tmp_dir() + "-XXXXXX" );
+	CPPUNIT_ASSERT( ! Drumkit::install( QStringList() << sDrumkitPath
+										<< sDrumkitPath + ".missing",
+										target.path(), true ) );
+	const QStringList folders =
+		QDir( target.path() ).entryList( QDir::Dirs | QDir::NoDotAndDotDot );
+	CPPUNIT_ASSERT_EQUAL( 1, folders.size() );
+	CPPUNIT_ASSERT( Filesystem::file_exists(
+						Filesystem::drumkit_file( target.path() + "/" +
+												  folders[ 0 ] ), true ) );
+}
@@ -0,0 +1,42 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#ifndef DRUMKIT_INSTALL_TEST_H
+#define DRUMKIT_INSTALL_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class DrumkitInstallTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE( DrumkitInstallTest );
+	CPPUNIT_TEST( testInstallConcurrent );
+	CPPUNIT_TEST( testInstallFailure );
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	// Several valid archives, exported from the test drumkits,
+	// installed at once must all result in complete drumkits.
+	void testInstallConcurrent();
+	// A single failing archive has to be reported while the other
+	// ones are still installed.
+	void testInstallFailure();
+};
+
+#endif
@@ -0,0 +1,188 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+#include "EngineContextTest.h"
+
+#include <core/EngineContext.h>
+#include <core/EventQueue.h>
+#include <core/Hydrogen.h>
+#include <core/AudioEngine/AudioEngine.h>
+#include <core/Preferences/Preferences.h>
+#include <core/Basics/InstrumentList.h>
+#include <core/Basics/Instrument.h>
+#include <core/Basics/Song.h>
+#include <core/Helpers/Filesystem.h>
+
+#include "TestHelper.h"
+#include "assertions/AudioFile.h"
+
+#include <thread>
+#include <unistd.h>
+
+using namespace H2Core;
+
+/** Renders @a sSongFile into @a sOutFile using the engine of the
+ * context current for the calling thread.
+ *
+ * Does not use CppUnit assertions itself as it is called from
+ * threads other than the one running the test.*/
+static bool exportSong( const QString& sSongFile, const QString& sOutFile )
+{
+	Hydrogen* pHydrogen = Hydrogen::get_instance();
+	EventQueue* pQueue = EventQueue::get_instance();
+
+	auto pSong = Song::load( sSongFile );
+	if ( pSong == nullptr ) {
+		return false;
+	}
+	pHydrogen->setSong( pSong );
+
+	InstrumentList* pInstrumentList = pSong->getInstrumentList();
+	for ( int ii = 0; ii < pInstrumentList->size(); ++ii ) {
+		pInstrumentList->get( ii )->set_currently_exported( true );
+	}
+
+	while ( pQueue->pop_event().type != EVENT_NONE ) {
+	}
+
+	pHydrogen->startExportSession( 44100, 16 );
+	pHydrogen->startExportSong( sOutFile );
+
+	bool bDone = false;
+	while ( ! bDone ) {
+		Event event = pQueue->pop_event();
+		if ( event.type == EVENT_PROGRESS && event.value == 100 ) {
+			bDone = true;
+		}
+		else if ( event.type == EVENT_NONE ) {
+			usleep( 10 * 1000 );
+		}
+	}
+	pHydrogen->stopExportSession();
+
+	return true;
+}
+
+void EngineContextTest::testScope()
+{
+	EventQueue* pDefaultQueue = EventQueue::get_instance();
+	CPPUNIT_ASSERT( EngineContext::current()->isDefault() );
+
+	EngineContext context;
+	{
+		EngineContext::Scope scope( &context );
+		CPPUNIT_ASSERT( EngineContext::current() == &context );
+		CPPUNIT_ASSERT( context.getEventQueue() == nullptr );
+
+		EventQueue::create_instance();
+		CPPUNIT_ASSERT( EventQueue::get_instance() != pDefaultQueue );
+		EventQueue::get_instance()->push_event( EVENT_METRONOME, 42 );
+
+		// Other threads are not affected by the scope.
+		EventQueue* pOtherThreadQueue = nullptr;
+		std::thread thread( [&]() {
+			pOtherThreadQueue = EventQueue::get_instance(); } );
+		thread.join();
+		CPPUNIT_ASSERT( pOtherThreadQueue == pDefaultQueue );
+	}
+
+	CPPUNIT_ASSERT( EventQueue::get_instance() == pDefaultQueue );
+	CPPUNIT_ASSERT( context.getEventQueue() != nullptr );
+
+	// The event was not pushed into the default queue.
+	Event event;
+	do {
+		event = pDefaultQueue->pop_event();
+		CPPUNIT_ASSERT( ! ( event.type == EVENT_METRONOME && event.value == 42 ) );
+	} while ( event.type != EVENT_NONE );
+}
+
+void EngineContextTest::testSecondaryEngine()
+{
+	Hydrogen* pDefaultHydrogen = Hydrogen::get_instance();
+	Preferences* pDefaultPreferences = Preferences::get_instance();
+
+	auto pContext = new EngineContext;
+	{
+		EngineContext::Scope scope( pContext );
+
+		Preferences::create_instance();
+		Preferences::get_instance()->m_sAudioDriver = "Fake";
+		Preferences::get_instance()->m_nBufferSize = 1024;
+		Hydrogen::create_instance();
+		EventQueue::get_instance()->setSilent( true );
+
+		Hydrogen* pHydrogen = Hydrogen::get_instance();
+		CPPUNIT_ASSERT( pHydrogen != nullptr );
+		CPPUNIT_ASSERT( pHydrogen != pDefaultHydrogen );
+		CPPUNIT_ASSERT( Preferences::get_instance() != pDefaultPreferences );
+
+		pHydrogen->setSong( Song::getEmptySong() );
+		CPPUNIT_ASSERT( pHydrogen->getSong() != pDefaultHydrogen->getSong() );
+		CPPUNIT_ASSERT( pHydrogen->getAudioEngine() != pDefaultHydrogen->getAudioEngine() );
+	}
+
+	CPPUNIT_ASSERT( Hydrogen::get_instance() == pDefaultHydrogen );
+	CPPUNIT_ASSERT( Preferences::get_instance() == pDefaultPreferences );
+
+	delete pContext;
+
+	// The default engine is still usable.
+	CPPUNIT_ASSERT( Hydrogen::get_instance()->getAudioEngine() != nullptr );
+	CPPUNIT_ASSERT( EngineContext::current()->getHydrogen() == pDefaultHydrogen );
+}
+
+void EngineContextTest::testParallelExport()
+{
+	const QString sSongFile = H2TEST_FILE( "functional/test.h2song" );
+	const QString sRefFile = H2TEST_FILE( "functional/test.ref.flac" );
+	const QString sDefaultOutFile =
+		Filesystem::tmp_file_path( "engine-context-default.wav" );
+	const QString sSecondaryOutFile =
+		Filesystem::tmp_file_path( "engine-context-secondary.wav" );
+
+	bool bSecondaryExported = false;
+	auto pContext = new EngineContext;
+	std::thread secondaryThread( [&]() {
+		EngineContext::Scope scope( pContext );
+
+		Preferences::create_instance();
+		Preferences::get_instance()->m_sAudioDriver = "Fake";
+		Hydrogen::create_instance();
+
+		bSecondaryExported = exportSong( sSongFile, sSecondaryOutFile );
+	} );
+
+	// Both engines render at the same time.
+	const bool bDefaultExported = exportSong( sSongFile, sDefaultOutFile );
+	secondaryThread.join();
+	delete pContext;
+
+	CPPUNIT_ASSERT( bDefaultExported );
+	CPPUNIT_ASSERT( bSecondaryExported );
+
+	H2TEST_ASSERT_AUDIO_FILES_EQUAL( sRefFile, sDefaultOutFile );
+	H2TEST_ASSERT_AUDIO_FILES_EQUAL( sDefaultOutFile, sSecondaryOutFile );
+
+	Filesystem::rm( sDefaultOutFile );
+	Filesystem::rm( sSecondaryOutFile );
+}
@@ -0,0 +1,47 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+#ifndef ENGINE_CONTEXT_TEST_H
+#define ENGINE_CONTEXT_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class EngineContextTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE( EngineContextTest );
+	CPPUNIT_TEST( testScope );
+	CPPUNIT_TEST( testSecondaryEngine );
+	CPPUNIT_TEST( testParallelExport );
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	// Instances are resolved using the context of the calling
+	// thread.
+	void testScope();
+	// A second engine can be created, used, and destroyed without
+	// affecting the default one.
+	void testSecondaryEngine();
+	// The default and a secondary engine export the same song at
+	// the same time and both yield the reference output.
+	void testParallelExport();
+};
+
+#endif
@@ -0,0 +1,73 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+
+#include "FXActivityTest.h"
+
+#include <core/FX/FXActivity.h>
+
+using namespace H2Core;
+
+void FXActivityTest::testBypassAndResume()
+{
+	const unsigned nFrames = 128;
+	const long long nTailFrames = 300;
+	FXActivity activity;
+
+	// Signal
+	activity.markInputActive();
+	CPPUNIT_ASSERT( activity.process( nFrames, nTailFrames ) );
+	CPPUNIT_ASSERT( ! activity.isIdle() );
+
+	// Silence. The effect keeps running until more than nTailFrames
+	// silent frames were processed, i.e. for two more cycles.
+	for ( int ii = 0; ii < 2; ++ii ) {
+		CPPUNIT_ASSERT( activity.process( nFrames, nTailFrames ) );
+		CPPUNIT_ASSERT( ! activity.isIdle() );
+	}
+	CPPUNIT_ASSERT( ! activity.process( nFrames, nTailFrames ) );
+	CPPUNIT_ASSERT( activity.isIdle() );
+
+	// Stays bypassed for arbitrarily long silence.
+	for ( int ii = 0; ii < 1000; ++ii ) {
+		CPPUNIT_ASSERT( ! activity.process( nFrames, nTailFrames ) );
+	}
+	CPPUNIT_ASSERT( activity.isIdle() );
+
+	// Signal again. Resumes immediately and the tail starts over.
+	activity.markInputActive();
+	CPPUNIT_ASSERT( activity.process( nFrames, nTailFrames ) );
+	CPPUNIT_ASSERT( ! activity.isIdle() );
+	for ( int ii = 0; ii < 2; ++ii ) {
+		CPPUNIT_ASSERT( activity.process( nFrames, nTailFrames ) );
+	}
+	CPPUNIT_ASSERT( ! activity.process( nFrames, nTailFrames ) );
+}
+
+void FXActivityTest::testBypassDisabled()
+{
+	FXActivity activity;
+	for ( int ii = 0; ii < 1000; ++ii ) {
+		CPPUNIT_ASSERT( activity.process( 128, -1 ) );
+	}
+	CPPUNIT_ASSERT( ! activity.isIdle() );
+}
@@ -0,0 +1,43 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+
+#ifndef FX_ACTIVITY_TEST_H
+#define FX_ACTIVITY_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class FXActivityTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE( FXActivityTest );
+	CPPUNIT_TEST( testBypassAndResume );
+	CPPUNIT_TEST( testBypassDisabled );
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	// An effect fed with silence is bypassed once the tail time has
+	// passed and resumes in the very cycle input arrives again.
+	void testBypassAndResume();
+	// A negative tail time keeps the effect running.
+	void testBypassDisabled();
+};
+
+#endif
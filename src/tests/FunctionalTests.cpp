@@ -53,6 +53,7 @@ using namespace H2Core;
 class FunctionalTest : public CppUnit::TestCase {
 	CPPUNIT_TEST_SUITE( FunctionalTest );
 	CPPUNIT_TEST( testExportAudio );
+	CPPUNIT_TEST( testExportAudioMultipleFormats );
 	CPPUNIT_TEST( testExportMIDISMF0 );
 	CPPUNIT_TEST( testExportMIDISMF1Single );
 	CPPUNIT_TEST( testExportMIDISMF1Multi );
@@ -159,6 +160,21 @@ public:
 		Filesystem::rm( outFile );
 	}
 
+	void testExportAudioMultipleFormats()
+	{
+		auto songFile = H2TEST_FILE("functional/test.h2song");
+		auto wavFile = Filesystem::tmp_file_path("test-multi.wav");
+		auto flacFile = Filesystem::tmp_file_path("test-multi.flac");
+		auto refFile = H2TEST_FILE("functional/test.ref.flac");
+
+		// Both files are encoded from a single render pass.
+		exportSong( songFile, QStringList() << wavFile << flacFile );
+		H2TEST_ASSERT_AUDIO_FILES_EQUAL( refFile, wavFile );
+		H2TEST_ASSERT_AUDIO_FILES_EQUAL( refFile, flacFile );
+		Filesystem::rm( wavFile );
+		Filesystem::rm( flacFile );
+	}
+
 	void testExportMIDISMF1Single()
 	{
 		auto songFile = H2TEST_FILE("functional/test.h2song");
@@ -248,9 +264,10 @@ private:
 	/**
 	 * \brief Export Hydrogon song to audio file
 	 * \param songFile Path to Hydrogen file
-	 * \param fileName Output file name
+	 * \param fileNames Output file names. All of them are written
+	 * using a single render pass.
 	 **/
-	void exportSong( const QString &songFile, const QString &fileName )
+	void exportSong( const QString &songFile, const QStringList &fileNames )
 	{
 		auto t0 = std::chrono::high_resolution_clock::now();
 
@@ -271,8 +288,13 @@ private:
 			pInstrumentList->get(i)->set_currently_exported( true );
 		}
 
+		// Events left over by previous tests must not end the export
+		// loop below prematurely.
+		while ( pQueue->pop_event().type != EVENT_NONE ) {
+		}
+
 		pHydrogen->startExportSession( 44100, 16 );
-		pHydrogen->startExportSong( fileName );
+		pHydrogen->startExportSong( fileNames );
 
 		bool done = false;
 		while ( ! done ) {
@@ -292,6 +314,11 @@ private:
 		___INFOLOG( QString("Audio export took %1 seconds").arg(t) );
 	}
 
+	void exportSong( const QString &songFile, const QString &fileName )
+	{
+		exportSong( songFile, QStringList() << fileName );
+	}
+
 	/**
 	 * \brief Export Hydrogon song to MIDI file
 	 * \param songFile Path to Hydrogen file
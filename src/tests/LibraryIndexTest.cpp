@@ -0,0 +1,95 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#include <core/Basics/Pattern.h>
+#include <core/Helpers/Filesystem.h>
+#include <core/Helpers/LibraryIndex.h>
+
+#include <QDateTime>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include "LibraryIndexTest.h"
+#include "TestHelper.h"
+
+using namespace H2Core;
+
+void LibraryIndexTest::testDrumkits() {
+	auto pIndex = LibraryIndex::get_instance();
+	CPPUNIT_ASSERT( pIndex != nullptr );
+
+	pIndex->update();
+	CPPUNIT_ASSERT( QFile::exists( LibraryIndex::getIndexPath() ) );
+
+	const QString sPath = Filesystem::sys_drumkits_dir() + "GMRockKit";
+	CPPUNIT_ASSERT( pIndex->containsDrumkitPath( sPath ) );
+
+	LibraryIndex::DrumkitEntry entry;
+	CPPUNIT_ASSERT( pIndex->findDrumkit( "GMRockKit", Filesystem::Lookup::system, &entry ) );
+	CPPUNIT_ASSERT( entry.sPath == sPath );
+	CPPUNIT_ASSERT( entry.lookup == Filesystem::Lookup::system );
+	CPPUNIT_ASSERT( entry.nModified ==
+					LibraryIndex::modificationTime( Filesystem::drumkit_file( sPath ) ) );
+	CPPUNIT_ASSERT( ! entry.instruments.isEmpty() );
+	CPPUNIT_ASSERT( ! entry.components.isEmpty() );
+	CPPUNIT_ASSERT( ! pIndex->findDrumkit( "GMRockKit", Filesystem::Lookup::user ) );
+
+	// Must match a lookup done by listing the drumkit folder.
+	CPPUNIT_ASSERT( Filesystem::drumkit_path_search( "GMRockKit",
+													 Filesystem::Lookup::system ) == sPath );
+
+	// A second update must not alter the content.
+	const auto drumkits = pIndex->getDrumkits( Filesystem::Lookup::stacked );
+	pIndex->update();
+	const auto drumkitsUpdated = pIndex->getDrumkits( Filesystem::Lookup::stacked );
+	CPPUNIT_ASSERT_EQUAL( drumkits.size(), drumkitsUpdated.size() );
+	for ( size_t ii = 0; ii < drumkits.size(); ++ii ) {
+		CPPUNIT_ASSERT( drumkits[ ii ].sPath == drumkitsUpdated[ ii ].sPath );
+		CPPUNIT_ASSERT( drumkits[ ii ].nModified == drumkitsUpdated[ ii ].nModified );
+		CPPUNIT_ASSERT( drumkits[ ii ].instruments == drumkitsUpdated[ ii ].instruments );
+	}
+}
+
+void LibraryIndexTest::testPatterns() {
+	auto pIndex = LibraryIndex::get_instance();
+	CPPUNIT_ASSERT( pIndex != nullptr );
+
+	QTemporaryDir tmpDir;
+	CPPUNIT_ASSERT( tmpDir.isValid() );
+	const QString sPatternPath = tmpDir.filePath( "pat.h2pattern" );
+	CPPUNIT_ASSERT( QFile::copy( H2TEST_FILE( "pattern/pat.h2pattern" ), sPatternPath ) );
+
+	QString sCached;
+	CPPUNIT_ASSERT( ! pIndex->findPatternDrumkitName( sPatternPath, &sCached ) );
+
+	const QString sDrumkitName = Pattern::loadDrumkitNameFrom( sPatternPath );
+	CPPUNIT_ASSERT( pIndex->findPatternDrumkitName( sPatternPath, &sCached ) );
+	CPPUNIT_ASSERT( sCached == sDrumkitName );
+	CPPUNIT_ASSERT( Pattern::loadDrumkitNameFrom( sPatternPath ) == sDrumkitName );
+
+	// Altering the file invalidates the entry.
+	QFile file( sPatternPath );
+	CPPUNIT_ASSERT( file.open( QIODevice::ReadWrite ) );
+	CPPUNIT_ASSERT( file.setFileTime( QDateTime::currentDateTime().addSecs( 60 ),
+									  QFileDevice::FileModificationTime ) );
+	file.close();
+	CPPUNIT_ASSERT( ! pIndex->findPatternDrumkitName( sPatternPath, &sCached ) );
+}
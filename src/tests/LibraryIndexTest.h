@@ -0,0 +1,42 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#ifndef LIBRARY_INDEX_TEST_H
+#define LIBRARY_INDEX_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class LibraryIndexTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE( LibraryIndexTest );
+	CPPUNIT_TEST( testDrumkits );
+	CPPUNIT_TEST( testPatterns );
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	// Drumkits are indexed, stored on disk, and used by the
+	// Filesystem lookup.
+	void testDrumkits();
+	// The drumkit name of patterns is cached and invalidated by
+	// changes of the pattern file.
+	void testPatterns();
+};
+
+#endif
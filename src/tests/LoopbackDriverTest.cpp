@@ -0,0 +1,277 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#include <core/AudioEngine/AudioEngine.h>
+#include <core/Basics/Drumkit.h>
+#include <core/Basics/Instrument.h>
+#include <core/Basics/InstrumentList.h>
+#include <core/Basics/Note.h>
+#include <core/Basics/Pattern.h>
+#include <core/Basics/PatternList.h>
+#include <core/CoreActionController.h>
+#include <core/Helpers/Filesystem.h>
+#include <core/Hydrogen.h>
+#include <core/IO/DriverThread.h>
+#include <core/IO/LoopbackDriver.h>
+#include <core/IO/MidiCommon.h>
+#include <core/Preferences/Preferences.h>
+#include <core/Sampler/Sampler.h>
+
+#include "LoopbackDriverTest.h"
+#include "TestHelper.h"
+
+using namespace H2Core;
+
+void LoopbackDriverTest::setUp() {
+	auto pPref = Preferences::get_instance();
+	auto pHydrogen = Hydrogen::get_instance();
+
+	m_pSong = Song::load( QString( "%1/GM_kit_demo3.h2song" ).arg( Filesystem::demos_dir() ) );
+	CPPUNIT_ASSERT( m_pSong != nullptr );
+	pHydrogen->getCoreActionController()->openSong( m_pSong );
+
+	m_sPreviousAudioDriver = pPref->m_sAudioDriver;
+	m_sPreviousMidiDriver = pPref->m_sMidiDriver;
+	pPref->m_sAudioDriver = "Loopback";
+	pPref->m_sMidiDriver = "Loopback";
+	pPref->m_nBufferSize = 1024;
+	pPref->m_nSampleRate = 44100;
+	pPref->m_bUseMetronome = false;
+	pHydrogen->restartDrivers();
+
+	auto pDriver = dynamic_cast<LoopbackDriver*>( pHydrogen->getAudioOutput() );
+	CPPUNIT_ASSERT( pDriver != nullptr );
+
+	// Start from silence.
+	pHydrogen->getAudioEngine()->getSampler()->stopPlayingNotes();
+	pDriver->processCycles( 2 );
+	pDriver->clearCapture();
+}
+
+void LoopbackDriverTest::tearDown() {
+	auto pPref = Preferences::get_instance();
+	auto pHydrogen = Hydrogen::get_instance();
+
+	if ( pHydrogen->getAudioEngine()->getState() == AudioEngine::State::Playing ) {
+		pHydrogen->sequencer_stop();
+	}
+
+	pPref->m_sAudioDriver = m_sPreviousAudioDriver;
+	pPref->m_sMidiDriver = m_sPreviousMidiDriver;
+	pHydrogen->restartDrivers();
+}
+
+void LoopbackDriverTest::testSimulatedClock() {
+	auto pDriver = dynamic_cast<LoopbackDriver*>( Hydrogen::get_instance()->getAudioOutput() );
+	CPPUNIT_ASSERT( pDriver != nullptr );
+
+	const long long nBufferSize = pDriver->getBufferSize();
+	const long long nStart = pDriver->getFrame();
+	const int nCycles = 10;
+
+	std::vector<long long> dispatchFrames;
+	for ( long long nOffset : { 0LL, nBufferSize - 1, nBufferSize, 5 * nBufferSize + 17 } ) {
+		pDriver->scheduleAction( nStart + nOffset, [&]() {
+			dispatchFrames.push_back( pDriver->getFrame() ); } );
+	}
+
+	CPPUNIT_ASSERT_EQUAL( nCycles, pDriver->processCycles( nCycles ) );
+	CPPUNIT_ASSERT_EQUAL( nStart + nCycles * nBufferSize, pDriver->getFrame() );
+	CPPUNIT_ASSERT_EQUAL( static_cast<size_t>( nCycles * nBufferSize ),
+						  pDriver->getCapturedOut_L().size() );
+	CPPUNIT_ASSERT_EQUAL( static_cast<size_t>( nCycles * nBufferSize ),
+						  pDriver->getCapturedOut_R().size() );
+	CPPUNIT_ASSERT_EQUAL( static_cast<size_t>( nCycles ),
+						  pDriver->getCycleTimes().size() );
+	for ( const auto& fTime : pDriver->getCycleTimes() ) {
+		CPPUNIT_ASSERT( fTime >= 0 );
+	}
+
+	// Actions are dispatched at the beginning of the cycle they
+	// fall into.
+	CPPUNIT_ASSERT_EQUAL( static_cast<size_t>( 4 ), dispatchFrames.size() );
+	CPPUNIT_ASSERT_EQUAL( nStart, dispatchFrames[ 0 ] );
+	CPPUNIT_ASSERT_EQUAL( nStart, dispatchFrames[ 1 ] );
+	CPPUNIT_ASSERT_EQUAL( nStart + nBufferSize, dispatchFrames[ 2 ] );
+	CPPUNIT_ASSERT_EQUAL( nStart + 5 * nBufferSize, dispatchFrames[ 3 ] );
+
+	// Nothing was played.
+	CPPUNIT_ASSERT_EQUAL( -1LL, LoopbackDriver::findOnset( pDriver->getCapturedOut_L() ) );
+}
+
+void LoopbackDriverTest::testDriverThread() {
+	auto pHydrogen = Hydrogen::get_instance();
+	auto pDriver = dynamic_cast<LoopbackDriver*>( pHydrogen->getAudioOutput() );
+	CPPUNIT_ASSERT( pDriver != nullptr );
+
+	const long long nBufferSize = pDriver->getBufferSize();
+	const int nCycles = 8;
+
+	for ( const bool bDoubleBuffering : { false, true } ) {
+		// Start from silence.
+		pHydrogen->getAudioEngine()->getSampler()->stopPlayingNotes();
+		pDriver->processCycles( 2 );
+		pDriver->clearCapture();
+		const long long nStart = pDriver->getFrame();
+
+		DriverThread::Settings settings;
+		settings.nPriority = 0;
+		settings.nCpu = -1;
+		settings.bLockMemory = false;
+		settings.bDoubleBuffering = bDoubleBuffering;
+
+		// A note in the very last cycle. It must not get lost when
+		// the thread stops.
+		MidiMessage msg;
+		msg.m_type = MidiMessage::NOTE_ON;
+		msg.m_nChannel = 0;
+		msg.m_nData1 = 36;
+		msg.m_nData2 = 100;
+		pDriver->scheduleMidiMessage( nStart + ( nCycles - 1 ) * nBufferSize, msg );
+
+		CPPUNIT_ASSERT_EQUAL( nCycles, pDriver->processCyclesThreaded( nCycles, settings ) );
+		CPPUNIT_ASSERT_EQUAL( nStart + nCycles * nBufferSize, pDriver->getFrame() );
+		CPPUNIT_ASSERT_EQUAL( static_cast<size_t>( nCycles * nBufferSize ),
+							  pDriver->getCapturedOut_L().size() );
+		CPPUNIT_ASSERT_EQUAL( static_cast<size_t>( nCycles * nBufferSize ),
+							  pDriver->getCapturedOut_R().size() );
+
+		const long long nOnset = LoopbackDriver::findOnset( pDriver->getCapturedOut_L() );
+		CPPUNIT_ASSERT( nOnset >= ( nCycles - 1 ) * nBufferSize );
+		CPPUNIT_ASSERT( nOnset < nCycles * nBufferSize );
+	}
+}
+
+void LoopbackDriverTest::testMidiToAudioLatency() {
+	auto pHydrogen = Hydrogen::get_instance();
+	auto pDriver = dynamic_cast<LoopbackDriver*>( pHydrogen->getAudioOutput() );
+	CPPUNIT_ASSERT( pDriver != nullptr );
+
+	// Note 36 is mapped to the first instrument.
+	auto pInstr = pHydrogen->getSong()->getInstrumentList()->get( 0 );
+	CPPUNIT_ASSERT( pInstr != nullptr );
+	pInstr->set_midi_out_channel( 0 );
+
+	const long long nBufferSize = pDriver->getBufferSize();
+	const long long nStart = pDriver->getFrame();
+	const long long nNoteCycle = nStart + 4 * nBufferSize;
+
+	MidiMessage msg;
+	msg.m_type = MidiMessage::NOTE_ON;
+	msg.m_nChannel = 0;
+	msg.m_nData1 = 36;
+	msg.m_nData2 = 100;
+	pDriver->scheduleMidiMessage( nNoteCycle + 100, msg );
+
+	CPPUNIT_ASSERT_EQUAL( 16, pDriver->processCycles( 16 ) );
+
+	CPPUNIT_ASSERT_EQUAL( static_cast<size_t>( 1 ),
+						  pDriver->getCapturedMidiInput().size() );
+	CPPUNIT_ASSERT_EQUAL( nNoteCycle, pDriver->getCapturedMidiInput()[ 0 ].nFrame );
+
+	// Audio output. The captured buffers start at nStart.
+	long long nOnset = LoopbackDriver::findOnset( pDriver->getCapturedOut_L() );
+	CPPUNIT_ASSERT( nOnset != -1 );
+	nOnset += nStart;
+	CPPUNIT_ASSERT( nOnset >= nNoteCycle );
+	CPPUNIT_ASSERT( nOnset < nNoteCycle + nBufferSize );
+
+	// MIDI output
+	long long nMidiOutFrame = -1;
+	for ( const auto& ev : pDriver->getCapturedMidiOutput() ) {
+		if ( ev.message.m_type == MidiMessage::NOTE_ON ) {
+			nMidiOutFrame = ev.nFrame;
+			break;
+		}
+	}
+	CPPUNIT_ASSERT_EQUAL( nNoteCycle, nMidiOutFrame );
+
+	pInstr->set_midi_out_channel( -1 );
+}
+
+void LoopbackDriverTest::testScheduledTransport() {
+	auto pHydrogen = Hydrogen::get_instance();
+	auto pAudioEngine = pHydrogen->getAudioEngine();
+	auto pDriver = dynamic_cast<LoopbackDriver*>( pHydrogen->getAudioOutput() );
+	CPPUNIT_ASSERT( pDriver != nullptr );
+
+	const long long nBufferSize = pDriver->getBufferSize();
+	const long long nStart = pDriver->getFrame();
+
+	long long nFramesFirst = -1;
+	long long nFramesSecond = -1;
+	pDriver->scheduleAction( nStart + nBufferSize, [&]() {
+		pHydrogen->getCoreActionController()->locateToColumn( 0 );
+		pHydrogen->sequencer_play(); } );
+	pDriver->scheduleAction( nStart + 3 * nBufferSize, [&]() {
+		nFramesFirst = pAudioEngine->getFrames(); } );
+	pDriver->scheduleAction( nStart + 7 * nBufferSize, [&]() {
+		nFramesSecond = pAudioEngine->getFrames(); } );
+
+	CPPUNIT_ASSERT_EQUAL( 8, pDriver->processCycles( 8 ) );
+	CPPUNIT_ASSERT( pAudioEngine->getState() == AudioEngine::State::Playing );
+	CPPUNIT_ASSERT_EQUAL( 4 * nBufferSize, nFramesSecond - nFramesFirst );
+
+	pHydrogen->sequencer_stop();
+	pDriver->processCycles( 1 );
+}
+
+void LoopbackDriverTest::testDrumkitSwapDuringPlayback() {
+	auto pHydrogen = Hydrogen::get_instance();
+	auto pAudioEngine = pHydrogen->getAudioEngine();
+	auto pSong = pHydrogen->getSong();
+	auto pDriver = dynamic_cast<LoopbackDriver*>( pHydrogen->getAudioOutput() );
+	CPPUNIT_ASSERT( pDriver != nullptr );
+
+	auto pDrumkit = Drumkit::load_by_name( "TR808EmulationKit", false,
+										   Filesystem::Lookup::system );
+	CPPUNIT_ASSERT( pDrumkit != nullptr );
+
+	const long long nBufferSize = pDriver->getBufferSize();
+	const long long nStart = pDriver->getFrame();
+
+	pDriver->scheduleAction( nStart, [&]() {
+		pHydrogen->getCoreActionController()->locateToColumn( 0 );
+		pHydrogen->sequencer_play(); } );
+	int nRet = -1;
+	pDriver->scheduleAction( nStart + 4 * nBufferSize, [&]() {
+		nRet = pHydrogen->loadDrumkit( pDrumkit, true ); } );
+
+	CPPUNIT_ASSERT_EQUAL( 16, pDriver->processCycles( 16 ) );
+	CPPUNIT_ASSERT_EQUAL( 0, nRet );
+	CPPUNIT_ASSERT( pAudioEngine->getState() == AudioEngine::State::Playing );
+	CPPUNIT_ASSERT( pSong->getCurrentDrumkitName() == pDrumkit->get_name() );
+	CPPUNIT_ASSERT( pSong->getInstrumentList()->size() >=
+					pDrumkit->get_instruments()->size() );
+
+	// All notes still reference instruments of the song.
+	auto pInstrList = pSong->getInstrumentList();
+	for ( const auto& pPattern : *pSong->getPatternList() ) {
+		for ( const auto& it : *pPattern->get_notes() ) {
+			CPPUNIT_ASSERT( pInstrList->index( it.second->get_instrument() ) != -1 );
+		}
+	}
+
+	pHydrogen->sequencer_stop();
+	pDriver->processCycles( 1 );
+
+	delete pDrumkit;
+}
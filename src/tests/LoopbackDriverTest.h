@@ -0,0 +1,65 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#ifndef LOOPBACK_DRIVER_TEST_H
+#define LOOPBACK_DRIVER_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <core/Basics/Song.h>
+
+class LoopbackDriverTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE( LoopbackDriverTest );
+	CPPUNIT_TEST( testSimulatedClock );
+	CPPUNIT_TEST( testDriverThread );
+	CPPUNIT_TEST( testMidiToAudioLatency );
+	CPPUNIT_TEST( testScheduledTransport );
+	CPPUNIT_TEST( testDrumkitSwapDuringPlayback );
+	CPPUNIT_TEST_SUITE_END();
+
+private:
+	std::shared_ptr<H2Core::Song> m_pSong;
+	QString m_sPreviousAudioDriver;
+	QString m_sPreviousMidiDriver;
+
+public:
+	// Switches to the LoopbackDriver and LoopbackMidiDriver.
+	void setUp();
+	// Restores the drivers used before.
+	void tearDown();
+
+	// Time advances in exact buffer steps and everything rendered
+	// is captured.
+	void testSimulatedClock();
+	// All cycles rendered within a DriverThread are written, with
+	// and without double buffering.
+	void testDriverThread();
+	// A MIDI note on is rendered and sent to the MIDI output in the
+	// cycle it was received in.
+	void testMidiToAudioLatency();
+	// Transport started by a scripted action advances by exactly one
+	// buffer per cycle.
+	void testScheduledTransport();
+	// Switching the drumkit while playing does neither interrupt the
+	// processing nor invalidate the instruments of the song.
+	void testDrumkitSwapDuringPlayback();
+};
+
+#endif
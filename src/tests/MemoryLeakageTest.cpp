@@ -16,6 +16,7 @@
 #include <core/Basics/Playlist.h>
 #include <core/Basics/Sample.h>
 #include <core/Basics/Song.h>
+#include <core/Basics/WaveformPeaks.h>
 #include <core/License.h>
 
 #include <core/Sampler/Sampler.h>
@@ -25,23 +26,29 @@
 
 #include "TestHelper.h"
 
+/** Loaded samples are handed to the worker creating their waveform
+ * peaks. Until it is done, it holds a reference to them.*/
+static int getAliveObjectCount() {
+	H2Core::WaveformPeaks::waitForScheduled();
+	return H2Core::Base::getAliveObjectCount();
+}
 
 void MemoryLeakageTest::testConstructors() {
 	auto mapSnapshot = H2Core::Base::getObjectMap();
-	int nAliveReference = H2Core::Base::getAliveObjectCount();
+	int nAliveReference = getAliveObjectCount();
 
 	{
 		auto ADSR = std::make_shared<H2Core::ADSR>();
 		auto ADSR2 = new H2Core::ADSR( ADSR );
 		ADSR = nullptr;
 		delete ADSR2;
-		CPPUNIT_ASSERT( nAliveReference == H2Core::Base::getAliveObjectCount() );
+		CPPUNIT_ASSERT( nAliveReference == getAliveObjectCount() );
 	}
 
 	{
 		auto AutomationPath = new H2Core::AutomationPath( 0, 1, 0.2 );
 		delete AutomationPath;
-		CPPUNIT_ASSERT( nAliveReference == H2Core::Base::getAliveObjectCount() );
+		CPPUNIT_ASSERT( nAliveReference == getAliveObjectCount() );
 	}
 
 	{
@@ -49,7 +56,7 @@ void MemoryLeakageTest::testConstructors() {
 		auto Drumkit2 = new H2Core::Drumkit( Drumkit );
 		delete Drumkit;
 		delete Drumkit2;
-		CPPUNIT_ASSERT( nAliveReference == H2Core::Base::getAliveObjectCount() );
+		CPPUNIT_ASSERT( nAliveReference == getAliveObjectCount() );
 	}
 
 	{
@@ -57,7 +64,7 @@ void MemoryLeakageTest::testConstructors() {
 		auto DrumkitComponent2 = new H2Core::DrumkitComponent( DrumkitComponent );
 		delete DrumkitComponent;
 		delete DrumkitComponent2;
-		CPPUNIT_ASSERT( nAliveReference == H2Core::Base::getAliveObjectCount() );
+		CPPUNIT_ASSERT( nAliveReference == getAliveObjectCount() );
 	}
 
 	{
@@ -67,7 +74,7 @@ void MemoryLeakageTest::testConstructors() {
 		delete Instrument2;
 		Instrument = nullptr;
 		pADSR = nullptr;
-		CPPUNIT_ASSERT( nAliveReference == H2Core::Base::getAliveObjectCount() );
+		CPPUNIT_ASSERT( nAliveReference == getAliveObjectCount() );
 	}
 
 	{
@@ -77,7 +84,7 @@ void MemoryLeakageTest::testConstructors() {
 		InstrumentLayer = nullptr;
 		pSample = nullptr;
 		delete InstrumentLayer2;
-		CPPUNIT_ASSERT( nAliveReference == H2Core::Base::getAliveObjectCount() );
+		CPPUNIT_ASSERT( nAliveReference == getAliveObjectCount() );
 	}
 
 	{
@@ -85,7 +92,7 @@ void MemoryLeakageTest::testConstructors() {
 		auto InstrumentList2 = new H2Core::InstrumentList( InstrumentList );
 		delete InstrumentList;
 		delete InstrumentList2;
-		CPPUNIT_ASSERT( nAliveReference == H2Core::Base::getAliveObjectCount() );
+		CPPUNIT_ASSERT( nAliveReference == getAliveObjectCount() );
 	}
 
 	{
@@ -93,7 +100,7 @@ void MemoryLeakageTest::testConstructors() {
 		auto InstrumentComponent2 = new H2Core::InstrumentComponent( InstrumentComponent );
 		InstrumentComponent = nullptr;
 		delete InstrumentComponent2;
-		CPPUNIT_ASSERT( nAliveReference == H2Core::Base::getAliveObjectCount() );
+		CPPUNIT_ASSERT( nAliveReference == getAliveObjectCount() );
 	}
 
 	{
@@ -105,7 +112,7 @@ void MemoryLeakageTest::testConstructors() {
 		delete Note2;
 		pInstrument = nullptr;
 		pADSR = nullptr;
-		CPPUNIT_ASSERT( nAliveReference == H2Core::Base::getAliveObjectCount() );
+		CPPUNIT_ASSERT( nAliveReference == getAliveObjectCount() );
 	}
 
 	{
@@ -113,7 +120,7 @@ void MemoryLeakageTest::testConstructors() {
 		auto Pattern2 = new H2Core::Pattern( Pattern );
 		delete Pattern;
 		delete Pattern2;
-		CPPUNIT_ASSERT( nAliveReference == H2Core::Base::getAliveObjectCount() );
+		CPPUNIT_ASSERT( nAliveReference == getAliveObjectCount() );
 	}
 
 	{
@@ -121,7 +128,7 @@ void MemoryLeakageTest::testConstructors() {
 		auto PatternList2 = new H2Core::PatternList( PatternList );
 		delete PatternList;
 		delete PatternList2;
-		CPPUNIT_ASSERT( nAliveReference == H2Core::Base::getAliveObjectCount() );
+		CPPUNIT_ASSERT( nAliveReference == getAliveObjectCount() );
 	}
 
 	{
@@ -129,19 +136,19 @@ void MemoryLeakageTest::testConstructors() {
 		auto Sample2 = new H2Core::Sample( Sample );
 		Sample = nullptr;
 		delete Sample2;
-		CPPUNIT_ASSERT( nAliveReference == H2Core::Base::getAliveObjectCount() );
+		CPPUNIT_ASSERT( nAliveReference == getAliveObjectCount() );
 	}
 
 	{
 		auto Song = new H2Core::Song( "ladida", "ladida", 120, 1 );
 		delete Song;
-		CPPUNIT_ASSERT( nAliveReference == H2Core::Base::getAliveObjectCount() );
+		CPPUNIT_ASSERT( nAliveReference == getAliveObjectCount() );
 	}
 	
 	{
 		auto pSampler = new H2Core::Sampler();
 		delete pSampler;
-		CPPUNIT_ASSERT( nAliveReference == H2Core::Base::getAliveObjectCount() );
+		CPPUNIT_ASSERT( nAliveReference == getAliveObjectCount() );
 	}
 
 	// Test copy constructors using real-live instead of new objects.
@@ -151,34 +158,34 @@ void MemoryLeakageTest::testConstructors() {
 	auto pSongProper = H2Core::Song::load( H2Core::Filesystem::demos_dir() + "GM_kit_Diddley.h2song" );
 	CPPUNIT_ASSERT( pSongProper != nullptr );
 
-	int nNewCount = H2Core::Base::getAliveObjectCount();
+	int nNewCount = getAliveObjectCount();
 
 	{
 		auto pDrumkit = new H2Core::Drumkit( pDrumkitProper );
 		CPPUNIT_ASSERT( pDrumkit != nullptr );
 		delete pDrumkit;
-		CPPUNIT_ASSERT( nNewCount == H2Core::Base::getAliveObjectCount() );
+		CPPUNIT_ASSERT( nNewCount == getAliveObjectCount() );
 	}
 
 	{
 		auto pInstrumentList = new H2Core::InstrumentList( pSongProper->getInstrumentList() );
 		CPPUNIT_ASSERT( pInstrumentList != nullptr );
 		delete pInstrumentList;
-		CPPUNIT_ASSERT( nNewCount == H2Core::Base::getAliveObjectCount() );
+		CPPUNIT_ASSERT( nNewCount == getAliveObjectCount() );
 	}
 
 	{
 		auto pPatternList = new H2Core::PatternList( pSongProper->getPatternList() );
 		CPPUNIT_ASSERT( pPatternList != nullptr );
 		delete pPatternList;
-		CPPUNIT_ASSERT( nNewCount == H2Core::Base::getAliveObjectCount() );
+		CPPUNIT_ASSERT( nNewCount == getAliveObjectCount() );
 	}
 	
 	{
 		auto pPattern = new H2Core::Pattern( pSongProper->getPatternList()->get( 0 ) );
 		CPPUNIT_ASSERT( pPattern != nullptr );
 		delete pPattern;
-		CPPUNIT_ASSERT( nNewCount == H2Core::Base::getAliveObjectCount() );
+		CPPUNIT_ASSERT( nNewCount == getAliveObjectCount() );
 	}
 
 	{
@@ -186,7 +193,7 @@ void MemoryLeakageTest::testConstructors() {
 		auto pNote = new H2Core::Note( notes->begin()->second );
 		CPPUNIT_ASSERT( pNote != nullptr );
 		delete pNote;
-		CPPUNIT_ASSERT( nNewCount == H2Core::Base::getAliveObjectCount() );
+		CPPUNIT_ASSERT( nNewCount == getAliveObjectCount() );
 	}
 
 	{
@@ -194,47 +201,47 @@ void MemoryLeakageTest::testConstructors() {
 		auto pDrumkitComponent = new H2Core::DrumkitComponent( (*pDrumkitComponents)[0] );
 		CPPUNIT_ASSERT( pDrumkitComponent != nullptr );
 		delete pDrumkitComponent;
-		CPPUNIT_ASSERT( nNewCount == H2Core::Base::getAliveObjectCount() );
+		CPPUNIT_ASSERT( nNewCount == getAliveObjectCount() );
 	}
 
 	{
 		auto pInstrument = new H2Core::Instrument( pDrumkitProper->get_instruments()->get( 0 ) );
 		CPPUNIT_ASSERT( pInstrument != nullptr );
 		delete pInstrument;
-		CPPUNIT_ASSERT( nNewCount == H2Core::Base::getAliveObjectCount() );
+		CPPUNIT_ASSERT( nNewCount == getAliveObjectCount() );
 	}
 
 	{
 		auto pADSR = new H2Core::ADSR( pDrumkitProper->get_instruments()->get( 0 )->get_adsr() );
 		CPPUNIT_ASSERT( pADSR != nullptr );
 		delete pADSR;
-		CPPUNIT_ASSERT( nNewCount == H2Core::Base::getAliveObjectCount() );
+		CPPUNIT_ASSERT( nNewCount == getAliveObjectCount() );
 	}
 
 	{
 		auto pInstrumentComponent = new H2Core::InstrumentComponent( pDrumkitProper->get_instruments()->get( 0 )->get_component( 0 ) );
 		CPPUNIT_ASSERT( pInstrumentComponent != nullptr );
 		delete pInstrumentComponent;
-		CPPUNIT_ASSERT( nNewCount == H2Core::Base::getAliveObjectCount() );
+		CPPUNIT_ASSERT( nNewCount == getAliveObjectCount() );
 	}
 
 	{
 		auto pInstrumentLayer = new H2Core::InstrumentLayer( pDrumkitProper->get_instruments()->get( 0 )->get_component( 0 )->get_layer( 0 ) );
 		CPPUNIT_ASSERT( pInstrumentLayer != nullptr );
 		delete pInstrumentLayer;
-		CPPUNIT_ASSERT( nNewCount == H2Core::Base::getAliveObjectCount() );
+		CPPUNIT_ASSERT( nNewCount == getAliveObjectCount() );
 	}
 
 	{
 		auto pSample = new H2Core::Sample( pDrumkitProper->get_instruments()->get( 0 )->get_component( 0 )->get_layer( 0 )->get_sample() );
 		CPPUNIT_ASSERT( pSample != nullptr );
 		delete pSample;
-		CPPUNIT_ASSERT( nNewCount == H2Core::Base::getAliveObjectCount() );
+		CPPUNIT_ASSERT( nNewCount == getAliveObjectCount() );
 	}
 	
 	delete pDrumkitProper;
 	pSongProper = nullptr;
-	CPPUNIT_ASSERT( nAliveReference == H2Core::Base::getAliveObjectCount() );
+	CPPUNIT_ASSERT( nAliveReference == getAliveObjectCount() );
 }
 
 void MemoryLeakageTest::testLoading() {
@@ -242,7 +249,7 @@ void MemoryLeakageTest::testLoading() {
 	H2Core::XMLNode node;
 
 	auto mapSnapshot = H2Core::Base::getObjectMap();
-	int nAliveReference = H2Core::Base::getAliveObjectCount();
+	int nAliveReference = getAliveObjectCount();
 
 	{
 		CPPUNIT_ASSERT( doc.read( H2TEST_FILE( "/memoryLeakage/drumkitComponent.xml" ) ) );
@@ -250,14 +257,14 @@ void MemoryLeakageTest::testLoading() {
 		auto pDrumkitComponent = H2Core::DrumkitComponent::load_from( &node );
 		CPPUNIT_ASSERT( pDrumkitComponent != nullptr );
 		delete pDrumkitComponent;
-		CPPUNIT_ASSERT( nAliveReference == H2Core::Base::getAliveObjectCount() );
+		CPPUNIT_ASSERT( nAliveReference == getAliveObjectCount() );
 	}
 
 	{
 		auto pDrumkit = H2Core::Drumkit::load_file( H2TEST_FILE( "drumkits/baseKit/drumkit.xml" ), true );
 		CPPUNIT_ASSERT( pDrumkit != nullptr );
 		delete pDrumkit;
-		CPPUNIT_ASSERT( nAliveReference == H2Core::Base::getAliveObjectCount() );
+		CPPUNIT_ASSERT( nAliveReference == getAliveObjectCount() );
 	}
 
 	{
@@ -266,14 +273,14 @@ void MemoryLeakageTest::testLoading() {
 		auto pInstrumentComponent = H2Core::InstrumentComponent::load_from( &node, H2TEST_FILE( "/drumkits/baseKit" ) );
 		CPPUNIT_ASSERT( pInstrumentComponent != nullptr );
 		pInstrumentComponent = nullptr;
-		CPPUNIT_ASSERT( nAliveReference == H2Core::Base::getAliveObjectCount() );
+		CPPUNIT_ASSERT( nAliveReference == getAliveObjectCount() );
 	}
 
 	{
 		auto pInstrument = H2Core::Instrument::load_instrument( "GMRockKit", "Kick", H2Core::Filesystem::Lookup::system );
 		CPPUNIT_ASSERT( pInstrument != nullptr );
 		pInstrument = nullptr;
-		CPPUNIT_ASSERT( nAliveReference == H2Core::Base::getAliveObjectCount() );
+		CPPUNIT_ASSERT( nAliveReference == getAliveObjectCount() );
 	}
 	
 	{
@@ -281,7 +288,7 @@ void MemoryLeakageTest::testLoading() {
 		pInstrument->load_from( "GMRockKit", "Snare", H2Core::Filesystem::Lookup::system );
 		CPPUNIT_ASSERT( pInstrument != nullptr );
 		pInstrument = nullptr;
-		CPPUNIT_ASSERT( nAliveReference == H2Core::Base::getAliveObjectCount() );
+		CPPUNIT_ASSERT( nAliveReference == getAliveObjectCount() );
 	}
 
 	{
@@ -290,7 +297,7 @@ void MemoryLeakageTest::testLoading() {
 		auto pInstrument = H2Core::Instrument::load_from( &node, H2TEST_FILE( "/drumkits/baseKit" ), "H2 test DK" );
 		CPPUNIT_ASSERT( pInstrument != nullptr );
 		pInstrument = nullptr;
-		CPPUNIT_ASSERT( nAliveReference == H2Core::Base::getAliveObjectCount() );
+		CPPUNIT_ASSERT( nAliveReference == getAliveObjectCount() );
 	}
 
 	{
@@ -299,7 +306,7 @@ void MemoryLeakageTest::testLoading() {
 		auto pInstrumentLayer = H2Core::InstrumentLayer::load_from( &node, H2TEST_FILE( "/drumkits/baseKit" ) );
 		CPPUNIT_ASSERT( pInstrumentLayer != nullptr );
 		pInstrumentLayer = nullptr;
-		CPPUNIT_ASSERT( nAliveReference == H2Core::Base::getAliveObjectCount() );
+		CPPUNIT_ASSERT( nAliveReference == getAliveObjectCount() );
 	}
 
 	{
@@ -308,7 +315,7 @@ void MemoryLeakageTest::testLoading() {
 		auto pInstrumentList = H2Core::InstrumentList::load_from( &node, H2TEST_FILE( "/drumkits/baseKit" ), "H2 test DK" );
 		CPPUNIT_ASSERT( pInstrumentList != nullptr );
 		delete pInstrumentList;
-		CPPUNIT_ASSERT( nAliveReference == H2Core::Base::getAliveObjectCount() );
+		CPPUNIT_ASSERT( nAliveReference == getAliveObjectCount() );
 	}
 
 	{
@@ -332,7 +339,7 @@ void MemoryLeakageTest::testLoading() {
 											   true ) );
 		delete pInstrumentList;
 		delete pDrumkitComponent;
-		CPPUNIT_ASSERT( nAliveReference == H2Core::Base::getAliveObjectCount() );
+		CPPUNIT_ASSERT( nAliveReference == getAliveObjectCount() );
 	}
 
 	{
@@ -346,7 +353,7 @@ void MemoryLeakageTest::testLoading() {
 		CPPUNIT_ASSERT( pNote != nullptr );
 		delete pNote;
 		delete pInstrumentList;
-		CPPUNIT_ASSERT( nAliveReference == H2Core::Base::getAliveObjectCount() );
+		CPPUNIT_ASSERT( nAliveReference == getAliveObjectCount() );
 	}
 
 	{
@@ -360,7 +367,7 @@ void MemoryLeakageTest::testLoading() {
 		CPPUNIT_ASSERT( pNote != nullptr );
 		delete pNote;
 		delete pInstrumentList;
-		CPPUNIT_ASSERT( nAliveReference == H2Core::Base::getAliveObjectCount() );
+		CPPUNIT_ASSERT( nAliveReference == getAliveObjectCount() );
 	}
 
 	{
@@ -372,42 +379,42 @@ void MemoryLeakageTest::testLoading() {
 		CPPUNIT_ASSERT( pPattern != nullptr );
 		delete pPattern;
 		delete pInstrumentList;
-		CPPUNIT_ASSERT( nAliveReference == H2Core::Base::getAliveObjectCount() );
+		CPPUNIT_ASSERT( nAliveReference == getAliveObjectCount() );
 	}
 
 	{
 		auto pPlaylist = H2Core::Playlist::load_file( H2TEST_FILE( "playlist/test.h2playlist" ), true );
 		CPPUNIT_ASSERT( pPlaylist != nullptr );
 		delete pPlaylist;
-		CPPUNIT_ASSERT( nAliveReference == H2Core::Base::getAliveObjectCount() );
+		CPPUNIT_ASSERT( nAliveReference == getAliveObjectCount() );
 	}
 
 	{
 		auto pSample = H2Core::Sample::load( H2TEST_FILE( "drumkits/baseKit/snare.wav" ) );
 		CPPUNIT_ASSERT( pSample != nullptr );
 		pSample = nullptr;
-		CPPUNIT_ASSERT( nAliveReference == H2Core::Base::getAliveObjectCount() );
+		CPPUNIT_ASSERT( nAliveReference == getAliveObjectCount() );
 	}
 
 	{
 		auto pSong = H2Core::Song::getEmptySong();
 		CPPUNIT_ASSERT( pSong != nullptr );
 		pSong = nullptr;
-		CPPUNIT_ASSERT( nAliveReference == H2Core::Base::getAliveObjectCount() );
+		CPPUNIT_ASSERT( nAliveReference == getAliveObjectCount() );
 	}
 
 	{
 		auto pSong = H2Core::Song::load( H2TEST_FILE( "functional/test.h2song" ) );
 		CPPUNIT_ASSERT( pSong != nullptr );
 		pSong = nullptr;
-		CPPUNIT_ASSERT( nAliveReference == H2Core::Base::getAliveObjectCount() );
+		CPPUNIT_ASSERT( nAliveReference == getAliveObjectCount() );
 	}
 
 	{
 		auto pSampler = new H2Core::Sampler();
 		pSampler->reinitializePlaybackTrack();
 		delete pSampler;
-		CPPUNIT_ASSERT( nAliveReference == H2Core::Base::getAliveObjectCount() );
+		CPPUNIT_ASSERT( nAliveReference == getAliveObjectCount() );
 	}
 
 	{
@@ -415,13 +422,13 @@ void MemoryLeakageTest::testLoading() {
 		auto pSampler = new H2Core::Sampler();
 		pSampler->reinitializePlaybackTrack();
 		delete pSampler;
-		CPPUNIT_ASSERT( nAliveReference == H2Core::Base::getAliveObjectCount() );
+		CPPUNIT_ASSERT( nAliveReference == getAliveObjectCount() );
 	}
 
 	{
 		auto pInstrument = H2Core::createInstrument( 0, H2TEST_FILE( "drumkits/baseKit/kick.wav" ), 0.7 );
 		pInstrument = nullptr;
-		CPPUNIT_ASSERT( nAliveReference == H2Core::Base::getAliveObjectCount() );
+		CPPUNIT_ASSERT( nAliveReference == getAliveObjectCount() );
 	}
 
 	{
@@ -433,7 +440,7 @@ void MemoryLeakageTest::testLoading() {
 		CPPUNIT_ASSERT( pPattern != nullptr );
 		delete pPattern;
 		delete pInstrumentList;
-		CPPUNIT_ASSERT( nAliveReference == H2Core::Base::getAliveObjectCount() );
+		CPPUNIT_ASSERT( nAliveReference == getAliveObjectCount() );
 	}
 
 	{
@@ -441,12 +448,12 @@ void MemoryLeakageTest::testLoading() {
 		auto pDrumkit2 = H2Core::Drumkit::load_by_name( "GMRockKit", true, H2Core::Filesystem::Lookup::system );
 	
 		H2Core::Hydrogen::get_instance()->loadDrumkit( pDrumkit );
-		int nLoaded = H2Core::Base::getAliveObjectCount();
+		int nLoaded = getAliveObjectCount();
 		H2Core::Hydrogen::get_instance()->loadDrumkit( pDrumkit );
-		CPPUNIT_ASSERT( nLoaded == H2Core::Base::getAliveObjectCount() );
+		CPPUNIT_ASSERT( nLoaded == getAliveObjectCount() );
 		H2Core::Hydrogen::get_instance()->loadDrumkit( pDrumkit2 );
 		H2Core::Hydrogen::get_instance()->loadDrumkit( pDrumkit );
-		CPPUNIT_ASSERT( nLoaded == H2Core::Base::getAliveObjectCount() );
+		CPPUNIT_ASSERT( nLoaded == getAliveObjectCount() );
 	}
 }
 
@@ -0,0 +1,135 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+
+#include "MeterTest.h"
+
+#include <core/AudioEngine/Meter.h>
+
+#include <cmath>
+#include <vector>
+
+using namespace H2Core;
+
+void MeterTest::testPeakAndRms()
+{
+	Meter meter;
+	Meter::Values values;
+
+	// Nothing published yet.
+	CPPUNIT_ASSERT( ! meter.read( values ) );
+	CPPUNIT_ASSERT_EQUAL( 0.f, values.fPeak_L );
+
+	Meter::Accumulator accumulator;
+	for ( int ii = 0; ii < 64; ++ii ) {
+		accumulator.process( -0.5, 0.25 );
+	}
+	accumulator.process( -0.9, 0.25 );
+	meter.add( accumulator );
+	// Second voice within the same period.
+	Meter::Accumulator accumulator2;
+	accumulator2.process( 0.1, -0.75 );
+	meter.add( accumulator2 );
+	meter.publish( 128 );
+
+	CPPUNIT_ASSERT( meter.read( values ) );
+	CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.9, values.fPeak_L, 1e-6 );
+	CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.75, values.fPeak_R, 1e-6 );
+	CPPUNIT_ASSERT_EQUAL( uint32_t( 128 ), values.nFrames );
+	CPPUNIT_ASSERT_DOUBLES_EQUAL( std::sqrt( ( 64 * 0.25 + 0.81 + 0.01 ) / 128 ),
+								  values.getRms_L(), 1e-6 );
+
+	// The GUI keeps the last values but is told they are old.
+	CPPUNIT_ASSERT( ! meter.read( values ) );
+	CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.9, values.fPeak_L, 1e-6 );
+
+	// A silent period.
+	meter.publish( 128 );
+	CPPUNIT_ASSERT( meter.read( values ) );
+	CPPUNIT_ASSERT_EQUAL( 0.f, values.fPeak_L );
+	CPPUNIT_ASSERT_EQUAL( 0.f, values.getRms_L() );
+}
+
+void MeterTest::testUnreadValuesAreMerged()
+{
+	Meter meter;
+	Meter::Values values;
+	const float fPeaks[] = { 0.3, 0.8, 0.2, 0.5, 0.1 };
+
+	float fTotalSquares = 0;
+	for ( const auto fPeak : fPeaks ) {
+		Meter::Accumulator accumulator;
+		accumulator.process( fPeak, fPeak );
+		meter.add( accumulator );
+		meter.publish( 16 );
+		fTotalSquares += fPeak * fPeak;
+	}
+
+	// Each period has to be part of exactly one of the values read.
+	float fMaxPeak = 0;
+	float fReadSquares = 0;
+	uint32_t nReadFrames = 0;
+	for ( int ii = 0; ii < 3; ++ii ) {
+		if ( meter.read( values ) ) {
+			fMaxPeak = std::max( fMaxPeak, values.fPeak_L );
+			fReadSquares += values.fSumSquares_L;
+			nReadFrames += values.nFrames;
+		}
+		meter.publish( 16 );
+	}
+	while ( meter.read( values ) ) {
+		fReadSquares += values.fSumSquares_L;
+		nReadFrames += values.nFrames;
+	}
+
+	CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.8, fMaxPeak, 1e-6 );
+	CPPUNIT_ASSERT_DOUBLES_EQUAL( fTotalSquares, fReadSquares, 1e-6 );
+	CPPUNIT_ASSERT_EQUAL( uint32_t( 8 * 16 ), nReadFrames );
+}
+
+void MeterTest::testTruePeak()
+{
+	// A sine at a quarter of the sample rate sampled at 45 degrees
+	// never hits its maximum.
+	const int nFrames = 256;
+	std::vector<float> buffer( nFrames );
+	for ( int ii = 0; ii < nFrames; ++ii ) {
+		buffer[ ii ] = std::sin( M_PI / 2 * ii + M_PI / 4 );
+	}
+
+	Meter meter( true );
+	Meter::Values values;
+	meter.process( buffer.data(), buffer.data(), nFrames );
+	meter.publish( nFrames );
+	CPPUNIT_ASSERT( meter.read( values ) );
+
+	CPPUNIT_ASSERT_DOUBLES_EQUAL( std::sqrt( 0.5 ), values.fPeak_L, 1e-5 );
+	CPPUNIT_ASSERT( values.fTruePeak_L > values.fPeak_L );
+	CPPUNIT_ASSERT( values.fTruePeak_L > 0.85 );
+
+	// Without true peak metering the field stays empty.
+	Meter plainMeter;
+	plainMeter.process( buffer.data(), buffer.data(), nFrames );
+	plainMeter.publish( nFrames );
+	CPPUNIT_ASSERT( plainMeter.read( values ) );
+	CPPUNIT_ASSERT_EQUAL( 0.f, values.fTruePeak_L );
+}
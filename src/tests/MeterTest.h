@@ -0,0 +1,46 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+
+#ifndef METER_TEST_H
+#define METER_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class MeterTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE( MeterTest );
+	CPPUNIT_TEST( testPeakAndRms );
+	CPPUNIT_TEST( testUnreadValuesAreMerged );
+	CPPUNIT_TEST( testTruePeak );
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	// Negative excursions are taken into account and the RMS refers
+	// to the period size.
+	void testPeakAndRms();
+	// Values published while the GUI did not read are not lost.
+	void testUnreadValuesAreMerged();
+	// Inter-sample peaks exceeding the sample values are detected.
+	void testTruePeak();
+};
+
+#endif
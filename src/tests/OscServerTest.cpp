@@ -26,6 +26,7 @@
 
 #include "OscServerTest.h"
 #include <core/Preferences/Preferences.h>
+#include <core/EventQueue.h>
 #include <core/OscServer.h>
 
 #include <QTest>
@@ -117,4 +118,30 @@ void OscServerTest::testSessionManagement(){
 	CPPUNIT_ASSERT( m_sValidPath == m_pHydrogen->getSong()->getFilename() );
 }
 
+void OscServerTest::testQuit(){
+
+	CPPUNIT_ASSERT( m_pHydrogen->getGUIState() ==
+					Hydrogen::GUIState::unavailable );
+
+	auto pQueue = EventQueue::get_instance();
+	// Drop events left over by previous tests.
+	while ( pQueue->pop_event().type != EVENT_NONE ) {
+	}
+
+	lo::Address hydrogenOSC("localhost", "7362" );
+	hydrogenOSC.send("/Hydrogen/QUIT");
+
+	bool bQuit = false;
+	WAIT( [&]() {
+			for ( auto event = pQueue->pop_event(); event.type != EVENT_NONE;
+				  event = pQueue->pop_event() ) {
+				if ( event.type == EVENT_QUIT ) {
+					bQuit = true;
+				}
+			}
+			return bQuit;
+		}() );
+	CPPUNIT_ASSERT( bQuit );
+}
+
 #endif
@@ -33,6 +33,7 @@
 class OscServerTest : public CppUnit::TestFixture {
 	CPPUNIT_TEST_SUITE( OscServerTest );
 	CPPUNIT_TEST( testSessionManagement );
+	CPPUNIT_TEST( testQuit );
 	CPPUNIT_TEST_SUITE_END();
 	
 private:
@@ -73,6 +74,13 @@ public:
 	 * current song does match the expected result.
 	 */
 	void testSessionManagement();
+	/**
+	 * Sends OscServer::QUIT_Handler() a message without a GUI being
+	 * present - the way h2cli in daemon mode is controlled - and
+	 * checks whether #H2Core::EVENT_QUIT, which ends the event loop
+	 * of h2cli, is emitted.
+	 */
+	void testQuit();
 };
 
 #endif
@@ -0,0 +1,194 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+#include <core/AudioEngine/AudioEngine.h>
+#include <core/Basics/Instrument.h>
+#include <core/Basics/InstrumentComponent.h>
+#include <core/Basics/InstrumentLayer.h>
+#include <core/Basics/Sample.h>
+#include <core/Basics/Song.h>
+#include <core/CoreActionController.h>
+#include <core/Helpers/Filesystem.h>
+#include <core/Hydrogen.h>
+#include <core/IO/LoopbackDriver.h>
+#include <core/Preferences/Preferences.h>
+#include <core/Sampler/SamplePreview.h>
+#include <core/Sampler/Sampler.h>
+
+#include "SamplePreviewTest.h"
+#include "TestHelper.h"
+
+using namespace H2Core;
+
+void SamplePreviewTest::setUp() {
+	auto pPref = Preferences::get_instance();
+	auto pHydrogen = Hydrogen::get_instance();
+
+	pHydrogen->getCoreActionController()->openSong( Song::getEmptySong() );
+
+	m_sPreviousAudioDriver = pPref->m_sAudioDriver;
+	m_sPreviousMidiDriver = pPref->m_sMidiDriver;
+	pPref->m_sAudioDriver = "Loopback";
+	pPref->m_sMidiDriver = "Loopback";
+	pPref->m_nBufferSize = 1024;
+	pPref->m_nSampleRate = 44100;
+	pPref->m_bUseMetronome = false;
+	pHydrogen->restartDrivers();
+
+	auto pDriver = dynamic_cast<LoopbackDriver*>( pHydrogen->getAudioOutput() );
+	CPPUNIT_ASSERT( pDriver != nullptr );
+
+	auto pPreview = pHydrogen->getSamplePreview();
+	pPreview->stop();
+	pPreview->waitForFinished();
+	pPreview->clearCache();
+	pDriver->processCycles( 2 );
+	pDriver->clearCapture();
+}
+
+void SamplePreviewTest::tearDown() {
+	auto pPref = Preferences::get_instance();
+	auto pHydrogen = Hydrogen::get_instance();
+
+	auto pPreview = pHydrogen->getSamplePreview();
+	pPreview->stop();
+	pPreview->waitForFinished();
+	pPreview->setCacheSize( SamplePreview::nDefaultCacheSize );
+	pPreview->clearCache();
+
+	pPref->m_sAudioDriver = m_sPreviousAudioDriver;
+	pPref->m_sMidiDriver = m_sPreviousMidiDriver;
+	pHydrogen->restartDrivers();
+}
+
+void SamplePreviewTest::testCache() {
+	auto pPreview = Hydrogen::get_instance()->getSamplePreview();
+	const QString sKick = H2TEST_FILE( "drumkits/baseKit/kick.wav" );
+	const QString sSnare = H2TEST_FILE( "drumkits/baseKit/snare.wav" );
+
+	// Not cached yet. Decoding is done in the background.
+	CPPUNIT_ASSERT( pPreview->loadSample( sKick ) == nullptr );
+	pPreview->waitForFinished();
+	CPPUNIT_ASSERT( ! pPreview->isLoading( sKick ) );
+
+	auto pKick = pPreview->getCachedSample( sKick );
+	CPPUNIT_ASSERT( pKick != nullptr );
+	CPPUNIT_ASSERT( pPreview->loadSample( sKick ) == pKick );
+	const size_t nKickBytes = static_cast<size_t>( pKick->get_frames() ) * 2 * sizeof( float );
+	CPPUNIT_ASSERT_EQUAL( nKickBytes, pPreview->getCacheUsage() );
+
+	// Only a single sample fits into the cache.
+	pPreview->setCacheSize( nKickBytes );
+	pPreview->loadSample( sSnare );
+	pPreview->waitForFinished();
+	auto pSnare = pPreview->getCachedSample( sSnare );
+	CPPUNIT_ASSERT( pSnare != nullptr );
+	CPPUNIT_ASSERT( pPreview->getCachedSample( sKick ) == nullptr );
+	CPPUNIT_ASSERT_EQUAL( static_cast<size_t>( pSnare->get_frames() ) * 2 * sizeof( float ),
+						  pPreview->getCacheUsage() );
+
+	// Files which can not be decoded are not cached.
+	const QString sInvalid = H2TEST_FILE( "drumkits/baseKit/drumkit.xml" );
+	CPPUNIT_ASSERT( pPreview->loadSample( sInvalid ) == nullptr );
+	pPreview->waitForFinished();
+	CPPUNIT_ASSERT( pPreview->getCachedSample( sInvalid ) == nullptr );
+	CPPUNIT_ASSERT( ! pPreview->isLoading( sInvalid ) );
+}
+
+void SamplePreviewTest::testPlayback() {
+	auto pHydrogen = Hydrogen::get_instance();
+	auto pPreview = pHydrogen->getSamplePreview();
+	auto pDriver = dynamic_cast<LoopbackDriver*>( pHydrogen->getAudioOutput() );
+	CPPUNIT_ASSERT( pDriver != nullptr );
+	const long long nBufferSize = pDriver->getBufferSize();
+	const QString sKick = H2TEST_FILE( "drumkits/baseKit/kick.wav" );
+
+	pPreview->previewSample( sKick );
+	pPreview->waitForFinished();
+	CPPUNIT_ASSERT_EQUAL( 1, pDriver->processCycles( 1 ) );
+	long long nOnset = LoopbackDriver::findOnset( pDriver->getCapturedOut_L() );
+	CPPUNIT_ASSERT( nOnset != -1 );
+	CPPUNIT_ASSERT( nOnset < nBufferSize );
+
+	pPreview->stop();
+	pDriver->processCycles( 1 );
+	pDriver->clearCapture();
+	pDriver->processCycles( 4 );
+	CPPUNIT_ASSERT( LoopbackDriver::findOnset( pDriver->getCapturedOut_L() ) == -1 );
+
+	// Cached samples are handed over to the Sampler right away.
+	pDriver->clearCapture();
+	pPreview->previewSample( sKick );
+	CPPUNIT_ASSERT_EQUAL( 1, pDriver->processCycles( 1 ) );
+	nOnset = LoopbackDriver::findOnset( pDriver->getCapturedOut_L() );
+	CPPUNIT_ASSERT( nOnset != -1 );
+	CPPUNIT_ASSERT( nOnset < nBufferSize );
+}
+
+void SamplePreviewTest::testSupersede() {
+	auto pHydrogen = Hydrogen::get_instance();
+	auto pPreview = pHydrogen->getSamplePreview();
+	auto pDriver = dynamic_cast<LoopbackDriver*>( pHydrogen->getAudioOutput() );
+	CPPUNIT_ASSERT( pDriver != nullptr );
+
+	const QString sKick = H2TEST_FILE( "drumkits/baseKit/kick.wav" );
+	const QString sSnare = H2TEST_FILE( "drumkits/baseKit/snare.wav" );
+
+	pPreview->previewSample( sKick );
+	pPreview->previewSample( sSnare );
+	pPreview->waitForFinished();
+	pDriver->processCycles( 1 );
+
+	auto pSnare = pPreview->getCachedSample( sSnare );
+	CPPUNIT_ASSERT( pSnare != nullptr );
+	auto pInstrument = pHydrogen->getAudioEngine()->getSampler()->getPreviewInstrument();
+	CPPUNIT_ASSERT( pInstrument != nullptr );
+	CPPUNIT_ASSERT( pInstrument->get_components()->front()->get_layer( 0 )->get_sample() == pSnare );
+
+	// Stopping discards requests not handled yet.
+	pPreview->previewSample( sKick );
+	pPreview->stop();
+	pPreview->waitForFinished();
+	pDriver->processCycles( 1 );
+	pDriver->clearCapture();
+	pDriver->processCycles( 4 );
+	CPPUNIT_ASSERT( LoopbackDriver::findOnset( pDriver->getCapturedOut_L() ) == -1 );
+}
+
+void SamplePreviewTest::testInstrument() {
+	auto pHydrogen = Hydrogen::get_instance();
+	auto pPreview = pHydrogen->getSamplePreview();
+	auto pDriver = dynamic_cast<LoopbackDriver*>( pHydrogen->getAudioOutput() );
+	CPPUNIT_ASSERT( pDriver != nullptr );
+
+	pPreview->previewInstrument( "GMRockKit", "Kick", Filesystem::Lookup::system );
+	pPreview->waitForFinished();
+	CPPUNIT_ASSERT_EQUAL( 1, pDriver->processCycles( 1 ) );
+
+	auto pInstrument = pHydrogen->getAudioEngine()->getSampler()->getPreviewInstrument();
+	CPPUNIT_ASSERT( pInstrument != nullptr );
+	CPPUNIT_ASSERT( pInstrument->get_name() == "Kick" );
+	CPPUNIT_ASSERT( LoopbackDriver::findOnset( pDriver->getCapturedOut_L() ) != -1 );
+
+	// Its samples were cached.
+	CPPUNIT_ASSERT( pPreview->getCacheUsage() > 0 );
+}
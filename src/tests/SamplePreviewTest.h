@@ -0,0 +1,58 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+#ifndef SAMPLE_PREVIEW_TEST_H
+#define SAMPLE_PREVIEW_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class SamplePreviewTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE( SamplePreviewTest );
+	CPPUNIT_TEST( testCache );
+	CPPUNIT_TEST( testPlayback );
+	CPPUNIT_TEST( testSupersede );
+	CPPUNIT_TEST( testInstrument );
+	CPPUNIT_TEST_SUITE_END();
+
+private:
+	QString m_sPreviousAudioDriver;
+	QString m_sPreviousMidiDriver;
+
+public:
+	// Switches to the LoopbackDriver.
+	void setUp();
+	// Restores the driver used before.
+	void tearDown();
+
+	// Decoded samples are cached and the least recently used ones
+	// are evicted once the cache is full.
+	void testCache();
+	// Previews start in the first cycle after the sample was
+	// decoded and can be stopped.
+	void testPlayback();
+	// Only the request issued last is played.
+	void testSupersede();
+	// Instruments of installed drumkits can be previewed too.
+	void testInstrument();
+};
+
+#endif
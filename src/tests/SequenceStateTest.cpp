@@ -0,0 +1,176 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+#include <core/AudioEngine/AudioEngine.h>
+#include <core/Basics/Pattern.h>
+#include <core/Basics/PatternList.h>
+#include <core/Basics/SequenceState.h>
+#include <core/Basics/Song.h>
+#include <core/Hydrogen.h>
+
+#include "SequenceStateTest.h"
+
+using namespace H2Core;
+
+/** Song with @a nPatterns patterns and @a nColumns columns, each
+ * holding one or two of them.*/
+static std::shared_ptr<Song> createSong( int nPatterns, int nColumns ) {
+	auto pSong = Song::getEmptySong();
+	auto pPatternList = pSong->getPatternList();
+	while ( pPatternList->size() < nPatterns ) {
+		pPatternList->add( new Pattern( QString( "Pattern %1" )
+										.arg( pPatternList->size() + 1 ) ) );
+	}
+
+	auto pColumns = pSong->getPatternGroupVector();
+	for ( auto& pColumn : *pColumns ) {
+		pColumn->clear();
+		delete pColumn;
+	}
+	pColumns->clear();
+	for ( int ii = 0; ii < nColumns; ++ii ) {
+		auto pColumn = new PatternList();
+		pColumn->add( pPatternList->get( ii % nPatterns ) );
+		pColumn->add( pPatternList->get( ( ii * 7 ) % nPatterns ) );
+		pColumns->push_back( pColumn );
+	}
+
+	return pSong;
+}
+
+static std::vector<std::vector<QString>> getSequence( std::shared_ptr<Song> pSong ) {
+	std::vector<std::vector<QString>> sequence;
+	for ( const auto& pColumn : *pSong->getPatternGroupVector() ) {
+		std::vector<QString> names;
+		for ( const auto& pPattern : *pColumn ) {
+			names.push_back( pPattern->get_name() );
+		}
+		sequence.push_back( names );
+	}
+	return sequence;
+}
+
+void SequenceStateTest::testRestore()
+{
+	auto pAudioEngine = Hydrogen::get_instance()->getAudioEngine();
+	pAudioEngine->lock( RIGHT_HERE );
+
+	auto pSong = createSong( 8, 32 );
+	auto pPatternList = pSong->getPatternList();
+	pPatternList->get( 1 )->virtual_patterns_add( pPatternList->get( 2 ) );
+	pPatternList->flattened_virtual_patterns_compute();
+	const auto sequence = getSequence( pSong );
+
+	auto pState = SequenceState::create( pSong );
+	CPPUNIT_ASSERT( pState != nullptr );
+	CPPUNIT_ASSERT( pState->getColumnCount() == 32 );
+
+	// Alter both sequence and virtual patterns.
+	auto pColumns = pSong->getPatternGroupVector();
+	for ( auto& pColumn : *pColumns ) {
+		pColumn->clear();
+		delete pColumn;
+	}
+	pColumns->clear();
+	pPatternList->get( 1 )->virtual_patterns_clear();
+	pPatternList->get( 3 )->virtual_patterns_add( pPatternList->get( 4 ) );
+
+	CPPUNIT_ASSERT( pState->restore( pSong ) );
+	CPPUNIT_ASSERT( getSequence( pSong ) == sequence );
+	CPPUNIT_ASSERT( pPatternList->get( 1 )->get_virtual_patterns()->size() == 1 );
+	CPPUNIT_ASSERT( *pPatternList->get( 1 )->get_virtual_patterns()->begin() ==
+					pPatternList->get( 2 ) );
+	CPPUNIT_ASSERT( pPatternList->get( 3 )->virtual_patterns_empty() );
+
+	// A state can not be applied to a different pattern list.
+	pPatternList->add( new Pattern( "Additional pattern" ) );
+	CPPUNIT_ASSERT( ! pState->restore( pSong ) );
+
+	pAudioEngine->unlock();
+}
+
+void SequenceStateTest::testStructuralSharing()
+{
+	auto pAudioEngine = Hydrogen::get_instance()->getAudioEngine();
+	pAudioEngine->lock( RIGHT_HERE );
+
+	// 1000 columns built from four distinct ones.
+	auto pSong = createSong( 4, 1000 );
+
+	// Each state holds one reference per column.
+	const size_t nReferenceBytes = 1000 * sizeof( std::shared_ptr<int> );
+
+	const size_t nBytesBefore = SequenceState::getTotalMemoryUsage();
+	auto pState = SequenceState::create( pSong );
+	const size_t nBytesState = SequenceState::getTotalMemoryUsage() - nBytesBefore;
+	CPPUNIT_ASSERT( nBytesState >= nReferenceBytes );
+	// Only the four distinct columns are stored.
+	CPPUNIT_ASSERT( nBytesState < nReferenceBytes + 1000 * sizeof( int ) );
+
+	// Unaltered song. All columns and the virtual patterns are
+	// shared.
+	auto pSameState = SequenceState::create( pSong );
+	const size_t nBytesSameState = SequenceState::getTotalMemoryUsage() -
+		nBytesBefore - nBytesState;
+	CPPUNIT_ASSERT( nBytesSameState >= nReferenceBytes );
+	CPPUNIT_ASSERT( nBytesSameState < nBytesState );
+
+	// Dropping a single pattern from one column only adds this
+	// column.
+	auto pColumn = pSong->getPatternGroupVector()->at( 501 );
+	pColumn->del( pColumn->get( 1 ) );
+	auto pAlteredState = SequenceState::create( pSong );
+	CPPUNIT_ASSERT( SequenceState::getTotalMemoryUsage() - nBytesBefore -
+					nBytesState - nBytesSameState < nBytesState );
+
+	pState = nullptr;
+	pSameState = nullptr;
+	pAlteredState = nullptr;
+	CPPUNIT_ASSERT( SequenceState::getTotalMemoryUsage() == nBytesBefore );
+
+	pAudioEngine->unlock();
+}
+
+void SequenceStateTest::testMemoryBudget()
+{
+	auto pAudioEngine = Hydrogen::get_instance()->getAudioEngine();
+	pAudioEngine->lock( RIGHT_HERE );
+
+	const size_t nBudget = SequenceState::getMemoryBudget();
+	auto pSong = createSong( 4, 16 );
+
+	auto pOldState = SequenceState::create( pSong );
+
+	// The most recent state is always kept.
+	SequenceState::setMemoryBudget( 0 );
+	CPPUNIT_ASSERT( ! pOldState->isExpired() );
+
+	auto pState = SequenceState::create( pSong );
+	CPPUNIT_ASSERT( pOldState->isExpired() );
+	CPPUNIT_ASSERT( ! pState->isExpired() );
+	CPPUNIT_ASSERT( ! pOldState->restore( pSong ) );
+	CPPUNIT_ASSERT( pState->restore( pSong ) );
+
+	SequenceState::setMemoryBudget( nBudget );
+
+	pAudioEngine->unlock();
+}
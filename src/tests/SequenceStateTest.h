@@ -0,0 +1,47 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+
+#ifndef SEQUENCE_STATE_TEST_H
+#define SEQUENCE_STATE_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class SequenceStateTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE( SequenceStateTest );
+	CPPUNIT_TEST( testRestore );
+	CPPUNIT_TEST( testStructuralSharing );
+	CPPUNIT_TEST( testMemoryBudget );
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	// The pattern sequence and the virtual patterns are restored
+	// exactly.
+	void testRestore();
+	// Identical columns and unaltered states do not occupy
+	// additional memory.
+	void testStructuralSharing();
+	// The oldest states are expired once the budget is exceeded.
+	void testMemoryBudget();
+};
+
+#endif
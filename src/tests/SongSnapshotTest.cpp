@@ -0,0 +1,195 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+#include <core/Basics/InstrumentList.h>
+#include <core/Basics/Note.h>
+#include <core/Basics/Pattern.h>
+#include <core/Basics/PatternList.h>
+#include <core/Basics/Song.h>
+#include <core/Basics/SongSnapshot.h>
+#include <core/Helpers/Filesystem.h>
+#include <core/Preferences/Preferences.h>
+
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include "SongSnapshotTest.h"
+
+using namespace H2Core;
+
+static void compareSongs( std::shared_ptr<Song> pSong,
+						  std::shared_ptr<Song> pOther ) {
+	CPPUNIT_ASSERT( pSong->getName() == pOther->getName() );
+	CPPUNIT_ASSERT( pSong->getBpm() == pOther->getBpm() );
+	CPPUNIT_ASSERT( pSong->getInstrumentList()->size() ==
+					pOther->getInstrumentList()->size() );
+
+	auto pPatterns = pSong->getPatternList();
+	auto pOtherPatterns = pOther->getPatternList();
+	CPPUNIT_ASSERT( pPatterns->size() == pOtherPatterns->size() );
+	for ( int ii = 0; ii < pPatterns->size(); ++ii ) {
+		auto pPattern = pPatterns->get( ii );
+		auto pOtherPattern = pOtherPatterns->get( ii );
+		CPPUNIT_ASSERT( pPattern->get_name() == pOtherPattern->get_name() );
+		CPPUNIT_ASSERT( pPattern->get_info() == pOtherPattern->get_info() );
+		CPPUNIT_ASSERT( pPattern->get_category() == pOtherPattern->get_category() );
+		CPPUNIT_ASSERT( pPattern->get_length() == pOtherPattern->get_length() );
+		CPPUNIT_ASSERT( pPattern->get_denominator() ==
+						pOtherPattern->get_denominator() );
+
+		auto pNotes = pPattern->get_notes();
+		auto pOtherNotes = pOtherPattern->get_notes();
+		CPPUNIT_ASSERT( pNotes->size() == pOtherNotes->size() );
+		for ( auto it = pNotes->begin(), itOther = pOtherNotes->begin();
+			  it != pNotes->end(); ++it, ++itOther ) {
+			Note* pNote = it->second;
+			Note* pOtherNote = itOther->second;
+			CPPUNIT_ASSERT( it->first == itOther->first );
+			CPPUNIT_ASSERT( pNote->get_position() == pOtherNote->get_position() );
+			CPPUNIT_ASSERT( pNote->get_length() == pOtherNote->get_length() );
+			CPPUNIT_ASSERT( pNote->get_velocity() == pOtherNote->get_velocity() );
+			CPPUNIT_ASSERT( pNote->getPan() == pOtherNote->getPan() );
+			CPPUNIT_ASSERT( pNote->get_pitch() == pOtherNote->get_pitch() );
+			CPPUNIT_ASSERT( pNote->get_lead_lag() == pOtherNote->get_lead_lag() );
+			CPPUNIT_ASSERT( pNote->get_probability() ==
+							pOtherNote->get_probability() );
+			CPPUNIT_ASSERT( pNote->get_key() == pOtherNote->get_key() );
+			CPPUNIT_ASSERT( pNote->get_octave() == pOtherNote->get_octave() );
+			CPPUNIT_ASSERT( pNote->get_note_off() == pOtherNote->get_note_off() );
+			CPPUNIT_ASSERT( pNote->get_instrument() != nullptr );
+			CPPUNIT_ASSERT( pOtherNote->get_instrument() != nullptr );
+			CPPUNIT_ASSERT( pNote->get_instrument()->get_id() ==
+							pOtherNote->get_instrument()->get_id() );
+		}
+
+		QStringList virtualPatterns, otherVirtualPatterns;
+		for ( const auto& pVirtualPattern : *pPattern->get_virtual_patterns() ) {
+			virtualPatterns << pVirtualPattern->get_name();
+		}
+		for ( const auto& pVirtualPattern : *pOtherPattern->get_virtual_patterns() ) {
+			otherVirtualPatterns << pVirtualPattern->get_name();
+		}
+		virtualPatterns.sort();
+		otherVirtualPatterns.sort();
+		CPPUNIT_ASSERT( virtualPatterns == otherVirtualPatterns );
+	}
+
+	auto pColumns = pSong->getPatternGroupVector();
+	auto pOtherColumns = pOther->getPatternGroupVector();
+	CPPUNIT_ASSERT( pColumns->size() == pOtherColumns->size() );
+	for ( size_t ii = 0; ii < pColumns->size(); ++ii ) {
+		auto pColumn = ( *pColumns )[ ii ];
+		auto pOtherColumn = ( *pOtherColumns )[ ii ];
+		CPPUNIT_ASSERT( pColumn->size() == pOtherColumn->size() );
+		for ( int nn = 0; nn < pColumn->size(); ++nn ) {
+			CPPUNIT_ASSERT( pColumn->get( nn )->get_name() ==
+							pOtherColumn->get( nn )->get_name() );
+		}
+	}
+}
+
+void SongSnapshotTest::tearDown() {
+	Preferences::get_instance()->setSaveSongSnapshots( false );
+}
+
+void SongSnapshotTest::testRoundTrip() {
+	QTemporaryDir tmpDir;
+	CPPUNIT_ASSERT( tmpDir.isValid() );
+	auto pPref = Preferences::get_instance();
+
+	for ( const auto& sSong : QDir( Filesystem::demos_dir() )
+			  .entryList( QStringList( "*.h2song" ), QDir::Files ) ) {
+		pPref->setSaveSongSnapshots( false );
+		auto pSong = Song::load( Filesystem::demos_dir() + "/" + sSong );
+		CPPUNIT_ASSERT( pSong != nullptr );
+
+		// None of the demo songs contains virtual patterns.
+		auto pPatterns = pSong->getPatternList();
+		if ( pPatterns->size() > 1 ) {
+			pPatterns->get( 0 )->virtual_patterns_add( pPatterns->get( 1 ) );
+			pPatterns->flattened_virtual_patterns_compute();
+		}
+
+		const QString sPath = tmpDir.filePath( sSong );
+		CPPUNIT_ASSERT( pSong->save( sPath ) );
+		CPPUNIT_ASSERT( ! QFile::exists( SongSnapshot::pathFor( sPath ) ) );
+
+		// The snapshot is created from the result of the XML load.
+		pPref->setSaveSongSnapshots( true );
+		auto pXmlSong = Song::load( sPath );
+		CPPUNIT_ASSERT( pXmlSong != nullptr );
+		CPPUNIT_ASSERT( QFile::exists( SongSnapshot::pathFor( sPath ) ) );
+
+		auto pSnapshotSong = SongSnapshot::load( sPath );
+		CPPUNIT_ASSERT( pSnapshotSong != nullptr );
+		compareSongs( pSnapshotSong, pXmlSong );
+
+		// Loading again uses the snapshot.
+		auto pReloadedSong = Song::load( sPath );
+		CPPUNIT_ASSERT( pReloadedSong != nullptr );
+		compareSongs( pReloadedSong, pXmlSong );
+	}
+}
+
+void SongSnapshotTest::testOutdatedSnapshot() {
+	QTemporaryDir tmpDir;
+	CPPUNIT_ASSERT( tmpDir.isValid() );
+	auto pPref = Preferences::get_instance();
+	const QString sPath = tmpDir.filePath( "outdated.h2song" );
+	const QString sSnapshotPath = SongSnapshot::pathFor( sPath );
+
+	auto pSong = Song::load( Filesystem::demos_dir() + "/GM_kit_demo1.h2song" );
+	CPPUNIT_ASSERT( pSong != nullptr );
+	CPPUNIT_ASSERT( pSong->save( sPath ) );
+
+	pPref->setSaveSongSnapshots( true );
+	CPPUNIT_ASSERT( Song::load( sPath ) != nullptr );
+	CPPUNIT_ASSERT( SongSnapshot::load( sPath ) != nullptr );
+
+	// Alter the song file behind Hydrogen's back. The next load
+	// falls back to the XML file and replaces the snapshot.
+	QFile file( sPath );
+	CPPUNIT_ASSERT( file.open( QIODevice::Append ) );
+	file.write( "\n" );
+	file.close();
+	CPPUNIT_ASSERT( SongSnapshot::load( sPath ) == nullptr );
+	CPPUNIT_ASSERT( Song::load( sPath ) != nullptr );
+	CPPUNIT_ASSERT( SongSnapshot::load( sPath ) != nullptr );
+
+	// Pretend the snapshot was written by a different version of
+	// Hydrogen. The version string follows the magic number, the
+	// format version, and the size and modification time of the
+	// song. Its first character starts after the string length.
+	QFile snapshotFile( sSnapshotPath );
+	CPPUNIT_ASSERT( snapshotFile.open( QIODevice::ReadWrite ) );
+	CPPUNIT_ASSERT( snapshotFile.seek( 4 + 4 + 8 + 8 + 4 ) );
+	CPPUNIT_ASSERT( snapshotFile.write( QByteArray( 2, 'X' ) ) == 2 );
+	snapshotFile.close();
+	CPPUNIT_ASSERT( SongSnapshot::load( sPath ) == nullptr );
+	CPPUNIT_ASSERT( Song::load( sPath ) != nullptr );
+	CPPUNIT_ASSERT( SongSnapshot::load( sPath ) != nullptr );
+
+	// Saving removes the snapshot.
+	CPPUNIT_ASSERT( pSong->save( sPath ) );
+	CPPUNIT_ASSERT( ! QFile::exists( sSnapshotPath ) );
+}
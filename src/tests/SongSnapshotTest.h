@@ -0,0 +1,46 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+#ifndef SONG_SNAPSHOT_TEST_H
+#define SONG_SNAPSHOT_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class SongSnapshotTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE( SongSnapshotTest );
+	CPPUNIT_TEST( testRoundTrip );
+	CPPUNIT_TEST( testOutdatedSnapshot );
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	void tearDown() override;
+
+	// Snapshots are created from the result of the XML load and
+	// songs restored from them must match it.
+	void testRoundTrip();
+	// Snapshots must neither be used once the .h2song file changed
+	// or they were created by a different version of Hydrogen nor
+	// outlive saving the song.
+	void testOutdatedSnapshot();
+};
+
+#endif
@@ -0,0 +1,160 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+#include "SynthTest.h"
+
+#include <core/Basics/Adsr.h>
+#include <core/Basics/Instrument.h>
+#include <core/Basics/Note.h>
+#include <core/Globals.h>
+#include <core/Synth/Synth.h>
+#include <core/Synth/Wavetable.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace H2Core;
+
+static float getPeak( const float* pBuffer, int nFrames )
+{
+	float fPeak = 0;
+	for ( int ii = 0; ii < nFrames; ++ii ) {
+		fPeak = std::max( fPeak, std::abs( pBuffer[ ii ] ) );
+	}
+	return fPeak;
+}
+
+void SynthTest::testWavetable()
+{
+	const int nFrames = 1000;
+	const float fIncrement = 440.0 / 44100.0;
+	std::vector<float> buffer( nFrames );
+
+	// Sine
+	auto pSine = Wavetable::get( Wavetable::Shape::Sine );
+	CPPUNIT_ASSERT_EQUAL( 1, pSine->getLevelCount() );
+	float fPhase = 0;
+	pSine->render( buffer.data(), nFrames, &fPhase, fIncrement );
+	for ( int ii = 0; ii < nFrames; ++ii ) {
+		CPPUNIT_ASSERT_DOUBLES_EQUAL( std::sin( TWOPI * fIncrement * ii ),
+									  buffer[ ii ], 1e-4 );
+	}
+	CPPUNIT_ASSERT_DOUBLES_EQUAL( std::fmod( nFrames * fIncrement, 1.0 ), fPhase, 1e-4 );
+
+	// Rendering in several calls yields the same result.
+	std::vector<float> buffer2( nFrames );
+	fPhase = 0;
+	pSine->render( buffer2.data(), 77, &fPhase, fIncrement );
+	pSine->render( &buffer2[ 77 ], nFrames - 77, &fPhase, fIncrement );
+	for ( int ii = 0; ii < nFrames; ++ii ) {
+		CPPUNIT_ASSERT_DOUBLES_EQUAL( buffer[ ii ], buffer2[ ii ], 1e-4 );
+	}
+
+	// The highest harmonic of the level chosen is below the Nyquist
+	// frequency while the one of the next richer level is not.
+	for ( const auto shape : { Wavetable::Shape::Saw, Wavetable::Shape::Square } ) {
+		auto pTable = Wavetable::get( shape );
+		CPPUNIT_ASSERT_EQUAL( 10, pTable->getLevelCount() );
+		CPPUNIT_ASSERT_EQUAL( 0, pTable->getLevel( 20.0 / 44100.0 ) );
+
+		for ( const float fFrequency : { 110.0, 1000.0, 5000.0, 15000.0 } ) {
+			const float fInc = fFrequency / 44100.0;
+			const int nLevel = pTable->getLevel( fInc );
+			CPPUNIT_ASSERT( nLevel > 0 );
+			CPPUNIT_ASSERT( ( Wavetable::nMaxHarmonics >> nLevel ) * fInc < 0.5 );
+			CPPUNIT_ASSERT( ( Wavetable::nMaxHarmonics >> ( nLevel - 1 ) ) * fInc >= 0.5 );
+		}
+
+		// All levels are normalized.
+		for ( int nLevel = 0; nLevel < pTable->getLevelCount(); ++nLevel ) {
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(
+				1.0, getPeak( pTable->getTable( nLevel ), Wavetable::nSize ), 1e-6 );
+		}
+	}
+}
+
+void SynthTest::testEnvelope()
+{
+	const int nFrames = 512;
+	Synth synth;
+	auto pInstrument = std::make_shared<Instrument>();
+	pInstrument->set_adsr( std::make_shared<ADSR>( 0, 0, 0.5, 1000 ) );
+
+	synth.noteOn( new Note( pInstrument, 0, 0.8, 0.f, -1, 0 ) );
+	synth.process( nFrames );
+	CPPUNIT_ASSERT( synth.isActive() );
+	CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.4, getPeak( synth.m_pOut_L, nFrames ), 1e-3 );
+	CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.4, getPeak( synth.m_pOut_R, nFrames ), 1e-3 );
+
+	// Sustained across cycles.
+	synth.process( nFrames );
+	CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.4, getPeak( synth.m_pOut_L, nFrames ), 1e-3 );
+
+	// Fading out after the release.
+	synth.noteOff( new Note( pInstrument, 0, 0.8, 0.f, -1, 0 ) );
+	synth.process( nFrames );
+	CPPUNIT_ASSERT( std::abs( synth.m_pOut_L[ nFrames - 1 ] ) < 0.4 );
+	for ( int ii = 0; ii < 4; ++ii ) {
+		synth.process( nFrames );
+	}
+	CPPUNIT_ASSERT_EQUAL( 0, synth.getPlayingNotesNumber() );
+	CPPUNIT_ASSERT_EQUAL( 0.f, getPeak( synth.m_pOut_L, nFrames ) );
+}
+
+void SynthTest::testVoices()
+{
+	const int nFrames = 256;
+	Synth synth;
+	auto pInstrument = std::make_shared<Instrument>();
+	auto pOtherInstrument = std::make_shared<Instrument>();
+
+	synth.process( nFrames );
+	CPPUNIT_ASSERT( ! synth.isActive() );
+
+	for ( int ii = 0; ii < Synth::nMaxVoices + 10; ++ii ) {
+		synth.noteOn( new Note( pInstrument, 0, 0.01, 0.f, -1, ii % 12 ),
+					  ii % 2 == 0 ? Wavetable::Shape::Saw : Wavetable::Shape::Square );
+	}
+	CPPUNIT_ASSERT_EQUAL( Synth::nMaxVoices, synth.getPlayingNotesNumber() );
+
+	synth.process( nFrames );
+	CPPUNIT_ASSERT( synth.isActive() );
+	CPPUNIT_ASSERT( getPeak( synth.m_pOut_L, nFrames ) > 0 );
+
+	// Notes of other instruments are not affected.
+	synth.noteOff( new Note( pOtherInstrument, 0, 0.8, 0.f, -1, 0 ) );
+	for ( int ii = 0; ii < Synth::nMaxVoices; ++ii ) {
+		synth.noteOff( new Note( pInstrument, 0, 0.8, 0.f, -1, 0 ) );
+	}
+	CPPUNIT_ASSERT_EQUAL( Synth::nMaxVoices, synth.getPlayingNotesNumber() );
+
+	for ( int ii = 0; ii < 10; ++ii ) {
+		synth.process( nFrames );
+	}
+	CPPUNIT_ASSERT_EQUAL( 0, synth.getPlayingNotesNumber() );
+
+	// The buffers are cleared once more and not touched afterwards.
+	synth.process( nFrames );
+	CPPUNIT_ASSERT( ! synth.isActive() );
+	CPPUNIT_ASSERT_EQUAL( 0.f, getPeak( synth.m_pOut_L, nFrames ) );
+}
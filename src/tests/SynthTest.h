@@ -0,0 +1,46 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+#ifndef SYNTH_TEST_H
+#define SYNTH_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class SynthTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE( SynthTest );
+	CPPUNIT_TEST( testWavetable );
+	CPPUNIT_TEST( testEnvelope );
+	CPPUNIT_TEST( testVoices );
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	// The tables are accurate, do not alias, and rendering is
+	// independent of the block size.
+	void testWavetable();
+	// Velocity and the ADSR of the instrument shape the output.
+	void testEnvelope();
+	// The number of voices is bounded and released voices are
+	// freed once they faded out.
+	void testVoices();
+};
+
+#endif
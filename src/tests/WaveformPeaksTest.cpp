@@ -0,0 +1,124 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+#include <core/Basics/Sample.h>
+#include <core/Basics/WaveformPeaks.h>
+
+#include "WaveformPeaksTest.h"
+#include "TestHelper.h"
+
+#include <random>
+#include <vector>
+
+using namespace H2Core;
+
+void WaveformPeaksTest::testGetPeak()
+{
+	// Not a multiple of the block size to cover an incomplete last
+	// block.
+	const int nFrames = 100003;
+	std::vector<float> data_L( nFrames );
+	std::vector<float> data_R( nFrames );
+
+	std::mt19937 generator( 42 );
+	std::uniform_real_distribution<float> distribution( -1, 1 );
+	for ( int ii = 0; ii < nFrames; ++ii ) {
+		data_L[ ii ] = distribution( generator );
+		data_R[ ii ] = 0.5 * distribution( generator );
+	}
+
+	WaveformPeaks peaks( data_L.data(), data_R.data(), nFrames );
+	CPPUNIT_ASSERT( peaks.getFrames() == nFrames );
+	CPPUNIT_ASSERT( peaks.getLevelCount() > 1 );
+	// The peaks are considerably smaller than the audio data.
+	CPPUNIT_ASSERT( peaks.getMemoryUsage() < nFrames * sizeof( float ) / 16 );
+
+	std::uniform_int_distribution<int> position( 0, nFrames - 1 );
+	const std::vector<float>* channels[ 2 ] = { &data_L, &data_R };
+	for ( int nn = 0; nn < 1000; ++nn ) {
+		int nStart = position( generator );
+		int nEnd = position( generator );
+		if ( nStart > nEnd ) {
+			std::swap( nStart, nEnd );
+		}
+		// Aligned and short ranges are covered as well.
+		if ( nn % 3 == 0 ) {
+			nStart -= nStart % WaveformPeaks::nBlockSize;
+		}
+		if ( nn % 5 == 0 ) {
+			nEnd = std::min( nStart + nn % 300, nFrames );
+		}
+		if ( nStart == nEnd ) {
+			continue;
+		}
+
+		for ( int nChannel = 0; nChannel < 2; ++nChannel ) {
+			const auto& data = *channels[ nChannel ];
+			float fMin = data[ nStart ];
+			float fMax = data[ nStart ];
+			for ( int ii = nStart; ii < nEnd; ++ii ) {
+				fMin = std::min( fMin, data[ ii ] );
+				fMax = std::max( fMax, data[ ii ] );
+			}
+
+			const auto peak = peaks.getPeak( nChannel, data.data(), nStart, nEnd );
+			CPPUNIT_ASSERT_EQUAL( fMin, peak.fMin );
+			CPPUNIT_ASSERT_EQUAL( fMax, peak.fMax );
+		}
+	}
+
+	// Whole sample and ranges exceeding it.
+	const auto peak = peaks.getPeak( 0, data_L.data(), -100, nFrames + 100 );
+	CPPUNIT_ASSERT_EQUAL( *std::min_element( data_L.begin(), data_L.end() ), peak.fMin );
+	CPPUNIT_ASSERT_EQUAL( *std::max_element( data_L.begin(), data_L.end() ), peak.fMax );
+
+	const auto emptyPeak = peaks.getPeak( 0, data_L.data(), nFrames, nFrames + 100 );
+	CPPUNIT_ASSERT_EQUAL( 0.f, emptyPeak.fMin );
+	CPPUNIT_ASSERT_EQUAL( 0.f, emptyPeak.fMax );
+}
+
+void WaveformPeaksTest::testSample()
+{
+	auto pSample = Sample::load( H2TEST_FILE( "drumkits/baseKit/snare.wav" ) );
+	CPPUNIT_ASSERT( pSample != nullptr );
+
+	WaveformPeaks::waitForScheduled();
+	auto pPeaks = pSample->getWaveformPeaks();
+	CPPUNIT_ASSERT( pPeaks != nullptr );
+	CPPUNIT_ASSERT( pPeaks->getFrames() == pSample->get_frames() );
+
+	// The worker created the peaks. Requesting them again does not
+	// create new ones.
+	CPPUNIT_ASSERT( pSample->getWaveformPeaks() == pPeaks );
+
+	auto pCopy = std::make_shared<Sample>( pSample );
+	CPPUNIT_ASSERT( pCopy->getWaveformPeaks() == pPeaks );
+
+	// Reloading replaces the peaks.
+	CPPUNIT_ASSERT( pSample->load() );
+	CPPUNIT_ASSERT( pSample->getWaveformPeaks() != pPeaks );
+
+	pSample->unload();
+	CPPUNIT_ASSERT( pSample->getWaveformPeaks() == nullptr );
+
+	WaveformPeaks::waitForScheduled();
+}
@@ -0,0 +1,43 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+#ifndef WAVEFORM_PEAKS_TEST_H
+#define WAVEFORM_PEAKS_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class WaveformPeaksTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE( WaveformPeaksTest );
+	CPPUNIT_TEST( testGetPeak );
+	CPPUNIT_TEST( testSample );
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	// Peaks of arbitrary ranges match the ones obtained by scanning
+	// the raw data.
+	void testGetPeak();
+	// Peaks are created in the background after loading a sample,
+	// shared by its copies, and dropped on unload.
+	void testSample();
+};
+
+#endif
@@ -0,0 +1,99 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+
+#include "WorkerPoolTest.h"
+
+#include <core/AudioEngine/WorkerPool.h>
+
+#include <atomic>
+#include <thread>
+
+using namespace H2Core;
+
+namespace {
+
+struct Counters {
+	std::atomic<int> counts[ 8 ];
+	std::atomic<int> nForeignThreads;
+	std::thread::id callerId;
+};
+
+void countTask( void* pData, int nTask ) {
+	auto pCounters = static_cast<Counters*>( pData );
+	++pCounters->counts[ nTask ];
+	if ( std::this_thread::get_id() != pCounters->callerId ) {
+		++pCounters->nForeignThreads;
+	}
+}
+
+DriverThread::Settings testSettings() {
+	DriverThread::Settings settings;
+	settings.nPriority = 0;
+	settings.nCpu = -1;
+	settings.bLockMemory = false;
+	settings.bDoubleBuffering = false;
+	return settings;
+}
+
+}
+
+void WorkerPoolTest::testAllTasksExecutedOnce()
+{
+	WorkerPool pool( "WorkerPoolTest", 3, testSettings() );
+	CPPUNIT_ASSERT_EQUAL( 3, pool.getWorkers() );
+
+	Counters counters;
+	counters.callerId = std::this_thread::get_id();
+	counters.nForeignThreads = 0;
+
+	for ( int nCycle = 0; nCycle < 2000; ++nCycle ) {
+		const int nTasks = 1 + nCycle % 8;
+		for ( auto& count : counters.counts ) {
+			count = 0;
+		}
+		pool.run( nTasks, countTask, &counters );
+
+		for ( int ii = 0; ii < 8; ++ii ) {
+			CPPUNIT_ASSERT_EQUAL( ii < nTasks ? 1 : 0,
+								  counters.counts[ ii ].load() );
+		}
+	}
+}
+
+void WorkerPoolTest::testWithoutWorkers()
+{
+	WorkerPool pool( "WorkerPoolTest", 0, testSettings() );
+
+	Counters counters;
+	counters.callerId = std::this_thread::get_id();
+	counters.nForeignThreads = 0;
+	for ( auto& count : counters.counts ) {
+		count = 0;
+	}
+
+	pool.run( 8, countTask, &counters );
+	for ( const auto& count : counters.counts ) {
+		CPPUNIT_ASSERT_EQUAL( 1, count.load() );
+	}
+	CPPUNIT_ASSERT_EQUAL( 0, counters.nForeignThreads.load() );
+}
@@ -0,0 +1,44 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2022 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+
+#ifndef WORKER_POOL_TEST_H
+#define WORKER_POOL_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class WorkerPoolTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE( WorkerPoolTest );
+	CPPUNIT_TEST( testAllTasksExecutedOnce );
+	CPPUNIT_TEST( testWithoutWorkers );
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	// Over many consecutive cycles each task is run exactly once
+	// and all of them are done when run() returns.
+	void testAllTasksExecutedOnce();
+	// A pool without workers processes all tasks in the calling
+	// thread.
+	void testWithoutWorkers();
+};
+
+#endif
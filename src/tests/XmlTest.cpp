@@ -37,6 +37,7 @@
 #include <core/CoreActionController.h>
 
 #include <QDir>
+#include <QFile>
 #include <QTemporaryDir>
 
 #include <core/Helpers/Filesystem.h>
@@ -388,6 +389,77 @@ void XmlTest::checkTestPatterns()
 							  H2Core::Filesystem::pattern_xsd_path() ) );
 }
 
+void XmlTest::testValidationCache()
+{
+	QTemporaryDir tmpDir;
+	CPPUNIT_ASSERT( tmpDir.isValid() );
+	const QString sValidPath = tmpDir.filePath( "valid.h2pattern" );
+	const QString sInvalidPath = tmpDir.filePath( "invalid.h2pattern" );
+	const QString sSchemaPath = H2Core::Filesystem::pattern_xsd_path();
+
+	QFile patternFile( H2TEST_FILE( "/pattern/pat.h2pattern" ) );
+	CPPUNIT_ASSERT( patternFile.open( QIODevice::ReadOnly ) );
+	QByteArray content = patternFile.readAll();
+	patternFile.close();
+
+	QFile validFile( sValidPath );
+	CPPUNIT_ASSERT( validFile.open( QIODevice::WriteOnly ) );
+	validFile.write( content );
+	validFile.close();
+
+	// Well-formed but not valid with respect to the schema.
+	content.replace( "</drumkit_pattern>", "<unknown>1</unknown></drumkit_pattern>" );
+	QFile invalidFile( sInvalidPath );
+	CPPUNIT_ASSERT( invalidFile.open( QIODevice::WriteOnly ) );
+	invalidFile.write( content );
+	invalidFile.close();
+
+	const bool bWasEnabled = H2Core::XMLDoc::isValidationCacheEnabled();
+	H2Core::XMLDoc::setValidationCacheEnabled( true );
+	H2Core::XMLDoc::clearValidationCache();
+
+	for ( int ii = 0; ii < 2; ++ii ) {
+		H2Core::XMLDoc validDoc, invalidDoc;
+		CPPUNIT_ASSERT( validDoc.read( sValidPath, sSchemaPath ) );
+		CPPUNIT_ASSERT( ! validDoc.firstChildElement( "drumkit_pattern" ).isNull() );
+		CPPUNIT_ASSERT( ! invalidDoc.read( sInvalidPath, sSchemaPath, true ) );
+	}
+
+	// Changing a document replaces its entry in the cache file
+	// instead of adding another one.
+	for ( int ii = 0; ii < 3; ++ii ) {
+		CPPUNIT_ASSERT( validFile.open( QIODevice::Append ) );
+		validFile.write( "\n" );
+		validFile.close();
+		H2Core::XMLDoc validDoc;
+		CPPUNIT_ASSERT( validDoc.read( sValidPath, sSchemaPath ) );
+	}
+
+	// A copy of the valid document is removed before the cache is
+	// written and must not end up in the cache file.
+	const QString sRemovedPath = tmpDir.filePath( "removed.h2pattern" );
+	CPPUNIT_ASSERT( QFile::copy( sValidPath, sRemovedPath ) );
+	H2Core::XMLDoc removedDoc;
+	CPPUNIT_ASSERT( removedDoc.read( sRemovedPath, sSchemaPath ) );
+	CPPUNIT_ASSERT( QFile::remove( sRemovedPath ) );
+
+	CPPUNIT_ASSERT( H2Core::XMLDoc::saveValidationCache() );
+	QFile cacheFile( H2Core::Filesystem::cache_dir() + "/xml_validation_cache" );
+	CPPUNIT_ASSERT( cacheFile.open( QIODevice::ReadOnly | QIODevice::Text ) );
+	const QString sCacheContent = QString::fromUtf8( cacheFile.readAll() );
+	cacheFile.close();
+	CPPUNIT_ASSERT_EQUAL( 1, sCacheContent.count( sValidPath ) );
+	CPPUNIT_ASSERT_EQUAL( 0, sCacheContent.count( sInvalidPath ) );
+	CPPUNIT_ASSERT_EQUAL( 0, sCacheContent.count( sRemovedPath ) );
+
+	H2Core::XMLDoc::setValidationCacheEnabled( false );
+	H2Core::XMLDoc doc, invalidDoc;
+	CPPUNIT_ASSERT( doc.read( sValidPath, sSchemaPath ) );
+	CPPUNIT_ASSERT( ! invalidDoc.read( sInvalidPath, sSchemaPath, true ) );
+
+	H2Core::XMLDoc::setValidationCacheEnabled( bWasEnabled );
+}
+
 void XmlTest::testPlaylist()
 {
 	QString sPath = H2Core::Filesystem::tmp_dir()+"playlist.h2playlist";
@@ -426,3 +498,78 @@ void XmlTest::tearDown() {
 		}
 	}
 }
+
+void XmlTest::testStreamReader()
+{
+	auto pDrumkit = H2Core::Drumkit::load( H2TEST_FILE( "/drumkits/baseKit" ) );
+	CPPUNIT_ASSERT( pDrumkit != nullptr );
+	auto pInstrumentList = pDrumkit->get_instruments();
+	const QString sPatternPath = H2TEST_FILE( "/pattern/pat.h2pattern" );
+
+	auto pStreamed = H2Core::Pattern::load_file( sPatternPath, pInstrumentList );
+	CPPUNIT_ASSERT( pStreamed != nullptr );
+
+	H2Core::XMLDoc doc;
+	CPPUNIT_ASSERT( doc.read( sPatternPath ) );
+	H2Core::XMLNode patternNode =
+		doc.firstChildElement( "drumkit_pattern" ).firstChildElement( "pattern" );
+	auto pLoaded = H2Core::Pattern::load_from( &patternNode, pInstrumentList );
+	CPPUNIT_ASSERT( pLoaded != nullptr );
+
+	CPPUNIT_ASSERT( pStreamed->get_name() == pLoaded->get_name() );
+	CPPUNIT_ASSERT( pStreamed->get_info() == pLoaded->get_info() );
+	CPPUNIT_ASSERT( pStreamed->get_category() == pLoaded->get_category() );
+	CPPUNIT_ASSERT( pStreamed->get_length() == pLoaded->get_length() );
+	CPPUNIT_ASSERT( pStreamed->get_denominator() == pLoaded->get_denominator() );
+	CPPUNIT_ASSERT( ! pStreamed->get_notes()->empty() );
+	CPPUNIT_ASSERT( pStreamed->get_notes()->size() == pLoaded->get_notes()->size() );
+	for ( auto it = pStreamed->get_notes()->begin(), itLoaded = pLoaded->get_notes()->begin();
+		  it != pStreamed->get_notes()->end(); ++it, ++itLoaded ) {
+		auto pNote = it->second;
+		auto pLoadedNote = itLoaded->second;
+		CPPUNIT_ASSERT( pNote->get_position() == pLoadedNote->get_position() );
+		CPPUNIT_ASSERT( pNote->get_length() == pLoadedNote->get_length() );
+		CPPUNIT_ASSERT( pNote->get_velocity() == pLoadedNote->get_velocity() );
+		CPPUNIT_ASSERT( pNote->getPan() == pLoadedNote->getPan() );
+		CPPUNIT_ASSERT( pNote->get_pitch() == pLoadedNote->get_pitch() );
+		CPPUNIT_ASSERT( pNote->get_key() == pLoadedNote->get_key() );
+		CPPUNIT_ASSERT( pNote->get_octave() == pLoadedNote->get_octave() );
+		CPPUNIT_ASSERT( pNote->get_instrument() == pLoadedNote->get_instrument() );
+	}
+	delete pStreamed;
+	delete pLoaded;
+	delete pDrumkit;
+
+	// Subtrees handed over to the DOM-based loaders.
+	QTemporaryDir tmpDir;
+	CPPUNIT_ASSERT( tmpDir.isValid() );
+	const QString sPath = tmpDir.filePath( "stream.xml" );
+	QFile file( sPath );
+	CPPUNIT_ASSERT( file.open( QIODevice::WriteOnly ) );
+	file.write( "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+				"<root><skipped>1</skipped>\n"
+				"  <node attr=\"value\">\n"
+				"    <value>2.5</value>\n"
+				"    <child><flag>true</flag></child>\n"
+				"  </node>\n"
+				"</root>\n" );
+	file.close();
+
+	H2Core::XMLStreamReader reader;
+	CPPUNIT_ASSERT( reader.read( sPath ) );
+	CPPUNIT_ASSERT( reader.readNextStartElement() );
+	CPPUNIT_ASSERT( reader.readNextStartElement() );
+	CPPUNIT_ASSERT( reader.read_int( 0 ) == 1 );
+	CPPUNIT_ASSERT( reader.readNextStartElement() );
+
+	H2Core::XMLDoc nodeDoc;
+	H2Core::XMLNode node = reader.read_node( &nodeDoc );
+	CPPUNIT_ASSERT( node.nodeName() == "node" );
+	CPPUNIT_ASSERT( node.read_attribute( "attr", "", false, false ) == "value" );
+	CPPUNIT_ASSERT( node.read_float( "value", 0 ) == 2.5 );
+	H2Core::XMLNode childNode = node.firstChildElement( "child" );
+	CPPUNIT_ASSERT( childNode.read_bool( "flag", false ) );
+
+	CPPUNIT_ASSERT( ! reader.readNextStartElement() );
+	CPPUNIT_ASSERT( ! reader.hasError() );
+}
@@ -34,6 +34,8 @@ class XmlTest : public CppUnit::TestCase {
 	CPPUNIT_TEST(testPlaylist);
 	CPPUNIT_TEST(testShippedDrumkits);
 	CPPUNIT_TEST(checkTestPatterns);
+	CPPUNIT_TEST(testValidationCache);
+	CPPUNIT_TEST(testStreamReader);
 	CPPUNIT_TEST_SUITE_END();
 
 	public:
@@ -50,6 +52,13 @@ class XmlTest : public CppUnit::TestCase {
 		// Check whether the pattern used in the unit test is valid
 		// with respect to the shipped XSD file.
 		void checkTestPatterns();
+		// Cached validation results must neither accept invalid
+		// documents nor reject valid ones. Each document occupies
+		// at most one entry in the cache file.
+		void testValidationCache();
+		// Objects created while streaming must match the ones
+		// loaded from the DOM.
+		void testStreamReader();
 	
 };
 
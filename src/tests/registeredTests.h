@@ -25,39 +25,65 @@
 #include "AdsrTest.h"
 #include "AutomationPathSerializerTest.cpp"
 #include "AutomationPathTest.cpp"
+#include "AutoSaveWriterTest.h"
 #include "CoreActionControllerTest.h"
+#include "DrumkitInstallTest.h"
+#include "EngineContextTest.h"
 #include "FilesystemTest.h"
+#include "FXActivityTest.h"
 #include "FunctionalTests.cpp"
 #include "InstrumentListTest.cpp"
+#include "LibraryIndexTest.h"
 #include "LicenseTest.h"
+#include "LoopbackDriverTest.h"
 #include "MemoryLeakageTest.h"
+#include "MeterTest.h"
 #include "MidiNoteTest.cpp"
 #include "NoteTest.cpp"
 #include "OscServerTest.h"
 #include "PatternTest.h"
+#include "SamplePreviewTest.h"
 #include "SampleTest.cpp"
+#include "SequenceStateTest.h"
+#include "SongSnapshotTest.h"
+#include "SynthTest.h"
 #include "TimeTest.h"
 #include "Translations.cpp"
 #include "TransportTest.h"
+#include "WaveformPeaksTest.h"
+#include "WorkerPoolTest.h"
 #include "XmlTest.h"
 
 CPPUNIT_TEST_SUITE_REGISTRATION( ADSRTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( AutomationPathSerializerTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( AutomationPathTest );
+CPPUNIT_TEST_SUITE_REGISTRATION( AutoSaveWriterTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( CoreActionControllerTest );
+CPPUNIT_TEST_SUITE_REGISTRATION( DrumkitInstallTest );
+CPPUNIT_TEST_SUITE_REGISTRATION( EngineContextTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( FilesystemTest );
+CPPUNIT_TEST_SUITE_REGISTRATION( FXActivityTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( FunctionalTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( InstrumentListTest );
+CPPUNIT_TEST_SUITE_REGISTRATION( LibraryIndexTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( LicenseTest );
+CPPUNIT_TEST_SUITE_REGISTRATION( LoopbackDriverTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( MemoryLeakageTest );
+CPPUNIT_TEST_SUITE_REGISTRATION( MeterTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( MidiNoteTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( NoteTest );
 #ifdef H2CORE_HAVE_OSC
 CPPUNIT_TEST_SUITE_REGISTRATION( OscServerTest );
 #endif
 CPPUNIT_TEST_SUITE_REGISTRATION( PatternTest );
+CPPUNIT_TEST_SUITE_REGISTRATION( SamplePreviewTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( SampleTest );
+CPPUNIT_TEST_SUITE_REGISTRATION( SequenceStateTest );
+CPPUNIT_TEST_SUITE_REGISTRATION( SongSnapshotTest );
+CPPUNIT_TEST_SUITE_REGISTRATION( SynthTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( TimeTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( TransportTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( UITranslationTest );
+CPPUNIT_TEST_SUITE_REGISTRATION( WaveformPeaksTest );
+CPPUNIT_TEST_SUITE_REGISTRATION( WorkerPoolTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( XmlTest );